@@ -147,9 +147,10 @@ int main(int argc, char* argv[]) {
 
   int protocol = TSDB_SML_TELNET_PROTOCOL;
   int assembleSTables = 0;
+  int directInsert = -1;
 
   int opt;
-  while ((opt = getopt(argc, argv, "s:c:r:f:t:b:p:w:a:hv")) != -1) {
+  while ((opt = getopt(argc, argv, "s:c:r:f:t:b:p:w:a:d:hv")) != -1) {
     switch (opt) {
       case 's':
         numSuperTables = atoi(optarg);
@@ -175,6 +176,9 @@ int main(int argc, char* argv[]) {
       case 'a':
         assembleSTables = atoi(optarg);
         break;
+      case 'd':
+        directInsert = atoi(optarg);
+        break;
       case 'p':
         if (optarg[0] == 't') {
           protocol = TSDB_SML_TELNET_PROTOCOL;
@@ -185,11 +189,11 @@ int main(int argc, char* argv[]) {
         }
         break;
       case 'h':
-        fprintf(stderr, "Usage: %s -s supertable -c childtable -r rows -f fields -t threads -b maxlines_per_batch -p [t|l|j] -a assemble-stables -v\n",
+        fprintf(stderr, "Usage: %s -s supertable -c childtable -r rows -f fields -t threads -b maxlines_per_batch -p [t|l|j] -a assemble-stables -d direct-insert -v\n",
                 argv[0]);
         exit(0);
       default: /* '?' */
-        fprintf(stderr, "Usage: %s -s supertable -c childtable -r rows -f fields -t threads -b maxlines_per_batch -p [t|l|j] -a assemble-stables -v\n",
+        fprintf(stderr, "Usage: %s -s supertable -c childtable -r rows -f fields -t threads -b maxlines_per_batch -p [t|l|j] -a assemble-stables -d direct-insert -v\n",
                 argv[0]);
         exit(-1);
     }
@@ -201,6 +205,17 @@ int main(int argc, char* argv[]) {
   const char* user = "root";
   const char* passwd = "taosdata";
 
+  // compare the points/sec of writing values to submit blocks directly (1) and of SQL statements (0)
+  if (directInsert >= 0) {
+    char cfg[64];
+    snprintf(cfg, sizeof(cfg), "{\"smlDirectInsert\":\"%d\"}", directInsert);
+    setConfRet ret = taos_set_config(cfg);
+    if (ret.retCode != SET_CONF_RET_SUCC) {
+      printf("\033[31mfailed to set smlDirectInsert, reason:%s\033[0m\n", ret.retMsg);
+      exit(1);
+    }
+  }
+
   taos_options(TSDB_OPTION_TIMEZONE, "GMT-8");
   TAOS* taos = taos_connect(host, user, passwd, "", 0);
   if (taos == NULL) {
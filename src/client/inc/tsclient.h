@@ -441,6 +441,7 @@ void *tscAcquireClusterInfo(const char *clusterId);
 void tscReleaseClusterInfo(const char *clusterId);
 
 int tsParseSql(SSqlObj *pSql, bool initial);
+void tscStmtAttachSchema(TAOS_STMT *stmt);
 
 void tscProcessMsgFromServer(SRpcMsg *rpcMsg, SRpcEpSet *pEpSet);
 int  tscBuildAndSendRequest(SSqlObj *pSql, SQueryInfo* pQueryInfo);
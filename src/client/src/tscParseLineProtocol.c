@@ -1123,6 +1123,279 @@ cleanup:
   return code;
 }
 
+static void fillSmlColumnBinds(TAOS_MULTI_BIND* colBinds, SArray* colsSchema, SArray* cTablePoints, int fromIndex,
+                               int numRows) {
+  size_t numCols = taosArrayGetSize(colsSchema);
+
+  for (int i = 0; i < numCols; ++i) {
+    SSchema* colSchema = taosArrayGet(colsSchema, i);
+    colBinds[i].buffer_type = colSchema->type;
+    colBinds[i].buffer_length = IS_VAR_DATA_TYPE(colSchema->type) ? colSchema->bytes : tDataTypes[colSchema->type].bytes;
+    colBinds[i].num = numRows;
+    memset(colBinds[i].is_null, 1, numRows);
+  }
+
+  for (int r = 0; r < numRows; ++r) {
+    TAOS_SML_DATA_POINT* point = taosArrayGetP(cTablePoints, fromIndex + r);
+    for (int i = 0; i < point->fieldNum; ++i) {
+      TAOS_SML_KV*     kv = point->fields + i;
+      TAOS_MULTI_BIND* bind = colBinds + kv->fieldSchemaIdx;
+
+      bind->is_null[r] = 0;
+      bind->length[r] = IS_VAR_DATA_TYPE(bind->buffer_type) ? kv->length : (int32_t)bind->buffer_length;
+      memcpy((char*)bind->buffer + bind->buffer_length * r, kv->value, bind->length[r]);
+    }
+  }
+}
+
+/*
+ * Insert the points of all child tables of one super table by binding their values to a multiple table statement, so
+ * that the values are written to the submit blocks as they are instead of being printed into a SQL string and parsed
+ * back. Only the tags of each child table go through the parser to create the table if it does not exist.
+ */
+static int32_t insertSTablePointsWithStmt(TAOS* taos, SSmlSTableSchema* sTableSchema, SArray* cTables,
+                                          bool attachSchema, int32_t* affectedRows, SSmlLinesInfo* info) {
+  size_t  numTags = taosArrayGetSize(sTableSchema->tags);
+  size_t  numCols = taosArrayGetSize(sTableSchema->fields);
+  int32_t code = TSDB_CODE_SUCCESS;
+  int32_t rowBytes = 0;
+
+  for (int i = 0; i < numCols; ++i) {
+    SSchema* colSchema = taosArrayGet(sTableSchema->fields, i);
+    rowBytes += IS_VAR_DATA_TYPE(colSchema->type) ? colSchema->bytes : tDataTypes[colSchema->type].bytes;
+  }
+
+  // Keep each submit about the size of a SQL batch of the text path
+  int32_t maxRows = MAX(1, tsMaxSQLStringLen / rowBytes);
+  maxRows = MIN(INT16_MAX, maxRows);
+
+  TAOS_STMT*       stmt = NULL;
+  TAOS_BIND*       tagBinds = calloc(numTags, sizeof(TAOS_BIND));
+  uintptr_t*       tagLengths = calloc(numTags, sizeof(uintptr_t));
+  int*             tagNulls = calloc(numTags, sizeof(int));
+  TAOS_MULTI_BIND* colBinds = calloc(numCols, sizeof(TAOS_MULTI_BIND));
+  char*            sql = malloc(tsMaxSQLStringLen + 1);
+  if (tagBinds == NULL || tagLengths == NULL || tagNulls == NULL || colBinds == NULL || sql == NULL) {
+    code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+    goto _cleanup;
+  }
+
+  for (int i = 0; i < numCols; ++i) {
+    SSchema* colSchema = taosArrayGet(sTableSchema->fields, i);
+    int32_t  bytes = IS_VAR_DATA_TYPE(colSchema->type) ? colSchema->bytes : tDataTypes[colSchema->type].bytes;
+    colBinds[i].buffer = malloc((size_t)bytes * maxRows);
+    colBinds[i].length = malloc(sizeof(int32_t) * maxRows);
+    colBinds[i].is_null = malloc(maxRows);
+    if (colBinds[i].buffer == NULL || colBinds[i].length == NULL || colBinds[i].is_null == NULL) {
+      code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+      goto _cleanup;
+    }
+  }
+
+  int32_t totalLen = 0;
+  int     ret = smlSnprintf(sql, &totalLen, tsMaxSQLStringLen, "insert into ? using %s (", sTableSchema->sTableName);
+  for (int i = 0; i < numTags && ret == 0; ++i) {
+    SSchema* tagSchema = taosArrayGet(sTableSchema->tags, i);
+    ret = smlSnprintf(sql, &totalLen, tsMaxSQLStringLen, (i == 0) ? "%s" : ",%s", tagSchema->name);
+  }
+  if (ret == 0) ret = smlSnprintf(sql, &totalLen, tsMaxSQLStringLen, ") tags (");
+  for (int i = 0; i < numTags && ret == 0; ++i) {
+    ret = smlSnprintf(sql, &totalLen, tsMaxSQLStringLen, (i == 0) ? "?" : ",?");
+  }
+  if (ret == 0) ret = smlSnprintf(sql, &totalLen, tsMaxSQLStringLen, ") (");
+  for (int i = 0; i < numCols && ret == 0; ++i) {
+    SSchema* colSchema = taosArrayGet(sTableSchema->fields, i);
+    ret = smlSnprintf(sql, &totalLen, tsMaxSQLStringLen, (i == 0) ? "%s" : ",%s", colSchema->name);
+  }
+  if (ret == 0) ret = smlSnprintf(sql, &totalLen, tsMaxSQLStringLen, ") values (");
+  for (int i = 0; i < numCols && ret == 0; ++i) {
+    ret = smlSnprintf(sql, &totalLen, tsMaxSQLStringLen, (i == 0) ? "?" : ",?");
+  }
+  if (ret == 0) ret = smlSnprintf(sql, &totalLen, tsMaxSQLStringLen, ")");
+  if (ret != 0) {
+    tscError("SML:0x%" PRIx64 " no free space for building insert statement of %s", info->id,
+             sTableSchema->sTableName);
+    code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+    goto _cleanup;
+  }
+
+  tscDebug("SML:0x%" PRIx64 " insert statement: %s", info->id, sql);
+
+  stmt = taos_stmt_init(taos);
+  if (stmt == NULL) {
+    code = terrno;
+    goto _cleanup;
+  }
+
+  code = taos_stmt_prepare(stmt, sql, 0);
+  if (code != TSDB_CODE_SUCCESS) {
+    tscError("SML:0x%" PRIx64 " prepare insert statement failed. %s", info->id, taos_stmt_errstr(stmt));
+    goto _cleanup;
+  }
+  if (attachSchema) {
+    tscStmtAttachSchema(stmt);
+  }
+
+  int32_t pendingRows = 0;
+  size_t  numCTables = taosArrayGetSize(cTables);
+  for (int t = 0; t < numCTables; ++t) {
+    SArray*              cTablePoints = taosArrayGetP(cTables, t);
+    TAOS_SML_DATA_POINT* point = taosArrayGetP(cTablePoints, 0);
+    int                  rows = (int)taosArrayGetSize(cTablePoints);
+
+    for (int i = 0; i < numTags; ++i) {
+      SSchema* tagSchema = taosArrayGet(sTableSchema->tags, i);
+      tagBinds[i].buffer_type = tagSchema->type;
+      tagBinds[i].buffer = NULL;
+      tagBinds[i].length = tagLengths + i;
+      tagBinds[i].is_null = tagNulls + i;
+      tagNulls[i] = 1;
+    }
+    for (int r = 0; r < rows; ++r) {
+      TAOS_SML_DATA_POINT* pDataPoint = taosArrayGetP(cTablePoints, r);
+      for (int j = 0; j < pDataPoint->tagNum; ++j) {
+        TAOS_SML_KV* kv = pDataPoint->tags + j;
+        tagBinds[kv->fieldSchemaIdx].buffer = kv->value;
+        tagLengths[kv->fieldSchemaIdx] = kv->length;
+        tagNulls[kv->fieldSchemaIdx] = 0;
+      }
+    }
+
+    code = taos_stmt_set_tbname_tags(stmt, point->childTableName, tagBinds);
+    for (int fromIndex = 0; code == TSDB_CODE_SUCCESS && fromIndex < rows;) {
+      int numRows = MIN(rows - fromIndex, maxRows);
+
+      // A submit block holds at most INT16_MAX rows of a table, and the table must be set again after execution
+      if (pendingRows > 0 && pendingRows + numRows > maxRows) {
+        code = taos_stmt_execute(stmt);
+        pendingRows = 0;
+        if (code == TSDB_CODE_SUCCESS) code = taos_stmt_set_tbname_tags(stmt, point->childTableName, tagBinds);
+        continue;
+      }
+
+      fillSmlColumnBinds(colBinds, sTableSchema->fields, cTablePoints, fromIndex, numRows);
+      code = taos_stmt_bind_param_batch(stmt, colBinds);
+      if (code == TSDB_CODE_SUCCESS) code = taos_stmt_add_batch(stmt);
+
+      tscDebug("SML:0x%" PRIx64 " bind child table points. child table: %s of super table %s. range[%d-%d).",
+               info->id, point->childTableName, point->stableName, fromIndex, fromIndex + numRows);
+      pendingRows += numRows;
+      fromIndex += numRows;
+    }
+
+    if (code != TSDB_CODE_SUCCESS) {
+      tscError("SML:0x%" PRIx64 " insert points of child table %s failed. %s", info->id, point->childTableName,
+               taos_stmt_errstr(stmt));
+      goto _cleanup;
+    }
+  }
+
+  if (pendingRows > 0) {
+    code = taos_stmt_execute(stmt);
+    if (code != TSDB_CODE_SUCCESS) {
+      tscError("SML:0x%" PRIx64 " execute insert statement of %s failed. %s", info->id, sTableSchema->sTableName,
+               taos_stmt_errstr(stmt));
+      goto _cleanup;
+    }
+  }
+
+  *affectedRows = taos_stmt_affected_rows(stmt);
+
+_cleanup:
+  if (stmt != NULL) taos_stmt_close(stmt);
+  for (int i = 0; colBinds != NULL && i < numCols; ++i) {
+    free(colBinds[i].buffer);
+    free(colBinds[i].length);
+    free(colBinds[i].is_null);
+  }
+  free(colBinds);
+  free(tagBinds);
+  free(tagLengths);
+  free(tagNulls);
+  free(sql);
+  return code;
+}
+
+static int32_t applyDataPointsWithStmt(TAOS* taos, TAOS_SML_DATA_POINT* points, int32_t numPoints, SArray* stableSchemas, SSmlLinesInfo* info) {
+  int32_t code = TSDB_CODE_SUCCESS;
+
+  SHashObj* cname2points = taosHashInit(128, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, false);
+  arrangePointsByChildTableName(points, numPoints, cname2points, stableSchemas, info);
+
+  // child tables of each super table, SArray<SArray<TAOS_SML_DATA_POINT*>*>
+  size_t   numStables = taosArrayGetSize(stableSchemas);
+  SArray** sTableCTables = calloc(numStables, POINTER_BYTES);
+  if (sTableCTables == NULL) {
+    code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+    goto cleanup;
+  }
+
+  SArray** pCTablePoints = taosHashIterate(cname2points, NULL);
+  while (pCTablePoints) {
+    SArray*              cTablePoints = *pCTablePoints;
+    TAOS_SML_DATA_POINT* point = taosArrayGetP(cTablePoints, 0);
+    if (sTableCTables[point->schemaIdx] == NULL) {
+      sTableCTables[point->schemaIdx] = taosArrayInit(64, POINTER_BYTES);
+    }
+    taosArrayPush(sTableCTables[point->schemaIdx], &cTablePoints);
+    pCTablePoints = taosHashIterate(cname2points, pCTablePoints);
+  }
+
+  for (int i = 0; i < numStables; ++i) {
+    if (sTableCTables[i] == NULL) continue;
+
+    SSmlSTableSchema* sTableSchema = taosArrayGet(stableSchemas, i);
+    bool              attachSchema = false;
+    for (int32_t tryTimes = 1;; ++tryTimes) {
+      int32_t affectedRows = 0;
+      code = insertSTablePointsWithStmt(taos, sTableSchema, sTableCTables[i], attachSchema, &affectedRows, info);
+      if (code == TSDB_CODE_SUCCESS) {
+        info->affectedRows += affectedRows;
+        break;
+      }
+
+      // Points of the failed attempt may have been partially written, writing them again just overwrites the rows
+      if ((code != TSDB_CODE_TDB_INVALID_TABLE_ID && code != TSDB_CODE_VND_INVALID_VGROUP_ID &&
+           code != TSDB_CODE_TDB_TABLE_RECONFIGURE && code != TSDB_CODE_APP_NOT_READY &&
+           code != TSDB_CODE_RPC_NETWORK_UNAVAIL) || tryTimes >= TSDB_MAX_REPLICA) {
+        break;
+      }
+
+      if (code == TSDB_CODE_TDB_INVALID_TABLE_ID || code == TSDB_CODE_VND_INVALID_VGROUP_ID) {
+        TAOS_RES* res = taos_query(taos, "RESET QUERY CACHE");
+        taos_free_result(res);
+      }
+      if (code == TSDB_CODE_TDB_TABLE_RECONFIGURE) {
+        // the vnode has not seen the altered schema of the super table yet
+        attachSchema = true;
+      } else {
+        taosMsleep(100 * (2 << tryTimes));
+      }
+    }
+
+    if (code != TSDB_CODE_SUCCESS) {
+      tscError("SML:0x%" PRIx64 " insert points of super table %s failed: %s", info->id, sTableSchema->sTableName,
+               tstrerror(code));
+      break;
+    }
+  }
+
+cleanup:
+  for (int i = 0; sTableCTables != NULL && i < numStables; ++i) {
+    taosArrayDestroy(&sTableCTables[i]);
+  }
+  free(sTableCTables);
+
+  pCTablePoints = taosHashIterate(cname2points, NULL);
+  while (pCTablePoints) {
+    SArray* pPoints = *pCTablePoints;
+    taosArrayDestroy(&pPoints);
+    pCTablePoints = taosHashIterate(cname2points, pCTablePoints);
+  }
+  taosHashCleanup(cname2points);
+  return code;
+}
+
 static int doSmlInsertOneDataPoint(TAOS* taos, TAOS_SML_DATA_POINT* point, SSmlLinesInfo* info) {
   int32_t code = TSDB_CODE_SUCCESS;
 
@@ -1243,7 +1516,11 @@ int tscSmlInsert(TAOS* taos, TAOS_SML_DATA_POINT* points, int numPoint, SSmlLine
   }
 
   tscDebug("SML:0x%"PRIx64" apply data points", info->id);
-  code = applyDataPointsWithSqlInsert(taos, points, numPoint, stableSchemas, info);
+  if (tsSmlDirectInsert) {
+    code = applyDataPointsWithStmt(taos, points, numPoint, stableSchemas, info);
+  } else {
+    code = applyDataPointsWithSqlInsert(taos, points, numPoint, stableSchemas, info);
+  }
   if (code != 0) {
     tscError("SML:0x%"PRIx64" error apply data points : %s", info->id, tstrerror(code));
   }
@@ -1905,6 +1905,15 @@ int taos_stmt_set_tbname(TAOS_STMT* stmt, const char* name) {
   return taos_stmt_set_tbname_tags(stmt, name, NULL);
 }
 
+// Send the table schemas along with the submit blocks of an insert statement, so that a vnode with an older schema
+// of a table updates it instead of failing with TSDB_CODE_TDB_TABLE_RECONFIGURE again
+void tscStmtAttachSchema(TAOS_STMT* stmt) {
+  STscStmt* pStmt = (STscStmt*)stmt;
+  if (pStmt != NULL && pStmt->pSql != NULL) {
+    pStmt->pSql->cmd.insertParam.schemaAttached = 1;
+  }
+}
+
 int taos_stmt_close(TAOS_STMT* stmt) {
   STscStmt* pStmt = (STscStmt*)stmt;
   if (pStmt == NULL || pStmt->taos == NULL) {
@@ -329,18 +329,24 @@ typedef struct SDataCol {
   int             spaceSize;  // Total space size for this column
   int             len;        // column data length
   VarDataOffsetT *dataOff;    // For binary and nchar data, the offset in the data column
+  uint8_t *       dictCodes;  // For binary and nchar data decoded from a dictionary, the code of each row
+  int16_t         dictNum;    // number of distinct values the codes refer to, 0 if there are no codes
   void *          pData;      // Actual data pointer
   TSKEY           ts;         // only used in last NULL column
 } SDataCol;
 
 #define isAllRowsNull(pCol) ((pCol)->len == 0)
-static FORCE_INLINE void dataColReset(SDataCol *pDataCol) { pDataCol->len = 0; }
+static FORCE_INLINE void dataColReset(SDataCol *pDataCol) {
+  pDataCol->len = 0;
+  pDataCol->dictNum = 0;
+}
 
 int tdAllocMemForCol(SDataCol *pCol, int maxPoints);
 
 void dataColInit(SDataCol *pDataCol, STColumn *pCol, int maxPoints);
 
 int dataColAppendVal(SDataCol *pCol, const void *value, int numOfRows, int maxPoints, int rowOffset);
+int dataColAppendNVal(SDataCol *pCol, const void *values, int nEle, int numOfRows, int maxPoints);
 
 void dataColSetOffset(SDataCol *pCol, int nEle);
 
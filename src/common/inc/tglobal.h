@@ -64,6 +64,12 @@ extern char     tsCharset[];  // default encode string
 extern int8_t   tsEnableCoreFile;
 extern int32_t  tsCompressMsgSize;
 extern int32_t  tsCompressColData;
+extern int8_t   tsTimestampBitPack;
+extern int8_t   tsFloatDecimalPack;
+extern int8_t   tsIntBitPack;
+extern int8_t   tsStringDictEncode;
+extern int32_t  tsZstdTier;
+extern int32_t  tsZstdLevel;
 extern int32_t  tsMaxNumOfDistinctResults;
 extern char     tsTempDir[];
 extern int32_t  tsShortcutFlag;
@@ -73,6 +79,13 @@ extern int32_t tsQueryBufferSize;  // maximum allowed usage buffer size in MB fo
 extern int64_t
     tsQueryBufferSizeBytes;  // maximum allowed usage buffer size in byte for each data node during query processing
 extern int32_t tsRetrieveBlockingModel;  // retrieve threads will be blocked
+extern int32_t tsQueryParallelThreads;   // dnode-wide threads running the morsels of super table queries
+extern int32_t tsQueryParallelDegree;    // morsels a super table query on a vnode is split into
+extern int32_t tsQueryYieldTime;         // ms a query runs before it goes back to the query queue
+extern int32_t tsBatchQueryThreads;      // threads executing the queries of the batch class
+extern char    tsBatchQueryUsers[];      // users whose queries are of the batch class, separated by commas
+extern int32_t tsBatchQueryBufferSize;   // maximum query buffer size in MB of the batch class
+extern int64_t tsBatchQueryBufferSizeBytes;
 
 extern int8_t tsKeepOriginalColumnName;
 
@@ -117,6 +130,14 @@ extern int8_t  tsCacheLastRow;
 extern bool    tsdbForceKeepFile;
 extern bool    tsdbForceCompactFile;
 extern int32_t tsdbWalFlushSize;
+extern int32_t tsdbBlkDataCacheSize;
+extern int32_t tsdbBlkIdxCacheSize;
+extern int32_t tsdbBlkReadAhead;
+extern int32_t tsdbBlkDecodeThreads;
+extern int32_t tsdbMemColBuffer;
+extern int32_t tsdbCommitFSetThreads;
+extern int32_t tsdbTagInvertedIdx;
+extern int32_t tsdbEncodedAggr;
 
 // balance
 extern int8_t  tsEnableBalance;
@@ -234,6 +255,7 @@ extern int8_t tsDeadLockKillQuery;
 extern char tsDefaultJSONStrType[];
 extern char tsSmlChildTableName[];
 extern char tsSmlTagNullName[];
+extern int8_t tsSmlDirectInsert;
 
 
 typedef struct {
@@ -60,69 +60,9 @@ void calc_i32_i32_add(void *left, void *right, int32_t numLeft, int32_t numRight
   }
 }
 
-typedef double (*_arithmetic_getVectorDoubleValue_fn_t)(void *src, int32_t index);
-
-double getVectorDoubleValue_TINYINT(void *src, int32_t index) {
-  return (double)*((int8_t *)src + index);
-}
-double getVectorDoubleValue_UTINYINT(void *src, int32_t index) {
-  return (double)*((uint8_t *)src + index);
-}
-double getVectorDoubleValue_SMALLINT(void *src, int32_t index) {
-  return (double)*((int16_t *)src + index);
-}
-double getVectorDoubleValue_USMALLINT(void *src, int32_t index) {
-  return (double)*((uint16_t *)src + index);
-}
-double getVectorDoubleValue_INT(void *src, int32_t index) {
-  return (double)*((int32_t *)src + index);
-}
-double getVectorDoubleValue_UINT(void *src, int32_t index) {
-  return (double)*((uint32_t *)src + index);
-}
-double getVectorDoubleValue_BIGINT(void *src, int32_t index) {
-  return (double)*((int64_t *)src + index);
-}
-double getVectorDoubleValue_UBIGINT(void *src, int32_t index) {
-  return (double)*((uint64_t *)src + index);
-}
-double getVectorDoubleValue_FLOAT(void *src, int32_t index) {
-  return (double)*((float *)src + index);
-}
-double getVectorDoubleValue_DOUBLE(void *src, int32_t index) {
-  return (double)*((double *)src + index);
-}
 int64_t getVectorTimestampValue(void *src, int32_t index) {
   return (int64_t)*((int64_t *)src + index);
 }
-_arithmetic_getVectorDoubleValue_fn_t getVectorDoubleValueFn(int32_t srcType) {
-    _arithmetic_getVectorDoubleValue_fn_t p = NULL;
-    if(srcType==TSDB_DATA_TYPE_TINYINT) {
-        p = getVectorDoubleValue_TINYINT;
-    }else if(srcType==TSDB_DATA_TYPE_UTINYINT) {
-        p = getVectorDoubleValue_UTINYINT;
-    }else if(srcType==TSDB_DATA_TYPE_SMALLINT) {
-        p = getVectorDoubleValue_SMALLINT;
-    }else if(srcType==TSDB_DATA_TYPE_USMALLINT) {
-        p = getVectorDoubleValue_USMALLINT;
-    }else if(srcType==TSDB_DATA_TYPE_INT) {
-        p = getVectorDoubleValue_INT;
-    }else if(srcType==TSDB_DATA_TYPE_UINT) {
-        p = getVectorDoubleValue_UINT;
-    }else if(srcType==TSDB_DATA_TYPE_BIGINT) {
-        p = getVectorDoubleValue_BIGINT;
-    }else if(srcType==TSDB_DATA_TYPE_UBIGINT) {
-        p = getVectorDoubleValue_UBIGINT;
-    }else if(srcType==TSDB_DATA_TYPE_FLOAT) {
-        p = getVectorDoubleValue_FLOAT;
-    }else if(srcType==TSDB_DATA_TYPE_DOUBLE) {
-        p = getVectorDoubleValue_DOUBLE;
-    }else {
-        assert(0);
-    }
-    return p;
-}
-
 
 typedef void* (*_arithmetic_getVectorValueAddr_fn_t)(void *src, int32_t index);
 
@@ -192,42 +132,192 @@ _arithmetic_getVectorValueAddr_fn_t getVectorValueAddrFn(int32_t srcType) {
     return p;
 }
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ARITH_KERNEL_AVX2
+#endif
+
+// Operands are widened to double a block at a time by a loop of their own type, and the operators then run over
+// plain arrays of doubles. A block of both operands and their null flags stays in L1.
+#define ARITH_BLOCK_SIZE 256
+
+typedef void (*_arithmetic_load_fn_t)(const void *src, int32_t index, int32_t num, bool asc, double *val,
+                                      uint8_t *pNull);
+typedef void (*_arithmetic_block_fn_t)(const double *left, const uint8_t *leftNull, const double *right,
+                                       const uint8_t *rightNull, int32_t num, double *output);
+
+typedef struct SArithKernel {
+  _arithmetic_load_fn_t  load[TSDB_DATA_TYPE_UBIGINT + 1];
+  _arithmetic_block_fn_t add;
+  _arithmetic_block_fn_t sub;
+  _arithmetic_block_fn_t multiply;
+  _arithmetic_block_fn_t divide;
+  _arithmetic_block_fn_t remainder;
+} SArithKernel;
+
+// reads num values from index on, backwards if not asc, nulls are flagged by comparing the bits with the sentinel
+#define ARITH_LOAD_KERNEL(_name, _type, _btype, _null, _attr)                                                     \
+  static _attr void arithLoad##_name(const void *src, int32_t index, int32_t num, bool asc, double *val,         \
+                                     uint8_t *pNull) {                                                            \
+    const _type  *data = (const _type *)src + index;                                                              \
+    const _btype *bits = (const _btype *)src + index;                                                             \
+    if (asc) {                                                                                                    \
+      for (int32_t i = 0; i < num; ++i) {                                                                         \
+        val[i] = (double)data[i];                                                                                 \
+        pNull[i] = (bits[i] == (_btype)(_null));                                                                  \
+      }                                                                                                           \
+    } else {                                                                                                      \
+      for (int32_t i = 0; i < num; ++i) {                                                                         \
+        val[i] = (double)data[-i];                                                                                \
+        pNull[i] = (bits[-i] == (_btype)(_null));                                                                 \
+      }                                                                                                           \
+    }                                                                                                             \
+  }
+
+// the result is computed for every row, and a mask of the null flags replaces it by null without a branch
+#define ARITH_BLOCK_KERNEL(_name, _op, _invalid, _attr)                                                           \
+  static _attr void arithBlock##_name(const double *left, const uint8_t *leftNull, const double *right,          \
+                                      const uint8_t *rightNull, int32_t num, double *output) {                    \
+    uint64_t *pOutput = (uint64_t *)output;                                                                       \
+    for (int32_t i = 0; i < num; ++i) {                                                                           \
+      double   v = _op(left[i], right[i]);                                                                        \
+      uint64_t bits;                                                                                              \
+      memcpy(&bits, &v, sizeof(bits));                                                                            \
+      uint64_t mask = (uint64_t)0 - (uint64_t)(leftNull[i] | rightNull[i] | _invalid(right[i]));                 \
+      pOutput[i] = (bits & ~mask) | ((uint64_t)TSDB_DATA_DOUBLE_NULL & mask);                                     \
+    }                                                                                                             \
+  }
+
+#define ARITH_ADD(_l, _r)       ((_l) + (_r))
+#define ARITH_SUB(_l, _r)       ((_l) - (_r))
+#define ARITH_MULTIPLY(_l, _r)  ((_l) * (_r))
+#define ARITH_DIVIDE(_l, _r)    ((_l) / (_r))
+// the quotient is truncated as a double, as the cast to int64_t of the infinity or NaN of a zero divisor or a null
+// operand, which the mask replaces afterwards, is undefined
+#define ARITH_REMAINDER(_l, _r) ((_l) - trunc((_l) / (_r)) * (_r))
+
+#define ARITH_ANY_DIVISOR(_r)  0
+#define ARITH_ZERO_DIVISOR(_r) FLT_EQUAL((_r), 0.0)
+
+#define ARITH_KERNELS(_sfx, _attr)                                                                                \
+  ARITH_LOAD_KERNEL(Int8##_sfx, int8_t, uint8_t, TSDB_DATA_TINYINT_NULL, _attr)                                   \
+  ARITH_LOAD_KERNEL(Int16##_sfx, int16_t, uint16_t, TSDB_DATA_SMALLINT_NULL, _attr)                               \
+  ARITH_LOAD_KERNEL(Int32##_sfx, int32_t, uint32_t, TSDB_DATA_INT_NULL, _attr)                                    \
+  ARITH_LOAD_KERNEL(Int64##_sfx, int64_t, uint64_t, TSDB_DATA_BIGINT_NULL, _attr)                                 \
+  ARITH_LOAD_KERNEL(Uint8##_sfx, uint8_t, uint8_t, TSDB_DATA_UTINYINT_NULL, _attr)                                \
+  ARITH_LOAD_KERNEL(Uint16##_sfx, uint16_t, uint16_t, TSDB_DATA_USMALLINT_NULL, _attr)                            \
+  ARITH_LOAD_KERNEL(Uint32##_sfx, uint32_t, uint32_t, TSDB_DATA_UINT_NULL, _attr)                                 \
+  ARITH_LOAD_KERNEL(Uint64##_sfx, uint64_t, uint64_t, TSDB_DATA_UBIGINT_NULL, _attr)                              \
+  ARITH_LOAD_KERNEL(Float##_sfx, float, uint32_t, TSDB_DATA_FLOAT_NULL, _attr)                                    \
+  ARITH_LOAD_KERNEL(Double##_sfx, double, uint64_t, TSDB_DATA_DOUBLE_NULL, _attr)                                 \
+  ARITH_BLOCK_KERNEL(Add##_sfx, ARITH_ADD, ARITH_ANY_DIVISOR, _attr)                                              \
+  ARITH_BLOCK_KERNEL(Sub##_sfx, ARITH_SUB, ARITH_ANY_DIVISOR, _attr)                                              \
+  ARITH_BLOCK_KERNEL(Multiply##_sfx, ARITH_MULTIPLY, ARITH_ANY_DIVISOR, _attr)                                    \
+  ARITH_BLOCK_KERNEL(Divide##_sfx, ARITH_DIVIDE, ARITH_ZERO_DIVISOR, _attr)                                       \
+  ARITH_BLOCK_KERNEL(Remainder##_sfx, ARITH_REMAINDER, ARITH_ZERO_DIVISOR, _attr)                                 \
+                                                                                                                  \
+  static SArithKernel gArithKernel##_sfx = {                                                                      \
+      .load =                                                                                                     \
+          {                                                                                                       \
+              [TSDB_DATA_TYPE_TINYINT] = arithLoadInt8##_sfx,                                                     \
+              [TSDB_DATA_TYPE_SMALLINT] = arithLoadInt16##_sfx,                                                   \
+              [TSDB_DATA_TYPE_INT] = arithLoadInt32##_sfx,                                                        \
+              [TSDB_DATA_TYPE_BIGINT] = arithLoadInt64##_sfx,                                                     \
+              [TSDB_DATA_TYPE_FLOAT] = arithLoadFloat##_sfx,                                                      \
+              [TSDB_DATA_TYPE_DOUBLE] = arithLoadDouble##_sfx,                                                    \
+              [TSDB_DATA_TYPE_UTINYINT] = arithLoadUint8##_sfx,                                                   \
+              [TSDB_DATA_TYPE_USMALLINT] = arithLoadUint16##_sfx,                                                 \
+              [TSDB_DATA_TYPE_UINT] = arithLoadUint32##_sfx,                                                      \
+              [TSDB_DATA_TYPE_UBIGINT] = arithLoadUint64##_sfx,                                                   \
+          },                                                                                                      \
+      .add = arithBlockAdd##_sfx,                                                                                 \
+      .sub = arithBlockSub##_sfx,                                                                                 \
+      .multiply = arithBlockMultiply##_sfx,                                                                       \
+      .divide = arithBlockDivide##_sfx,                                                                           \
+      .remainder = arithBlockRemainder##_sfx,                                                                     \
+  };
+
+ARITH_KERNELS(Scalar, )
+#ifdef ARITH_KERNEL_AVX2
+ARITH_KERNELS(Avx2, __attribute__((target("avx2"))))
+#endif
+
+static SArithKernel  *gArithKernel = &gArithKernelScalar;
+static pthread_once_t arithKernelInit = PTHREAD_ONCE_INIT;
+
+static void arithInitKernels(void) {
+#ifdef ARITH_KERNEL_AVX2
+  if (__builtin_cpu_supports("avx2")) {
+    gArithKernel = &gArithKernelAvx2;
+  }
+#endif
+}
+
+static const SArithKernel *getArithKernel(void) {
+  pthread_once(&arithKernelInit, arithInitKernels);
+  return gArithKernel;
+}
+
+// a constant operand is widened once and repeated over the whole block, false if it is null
+static bool arithLoadConst(_arithmetic_load_fn_t loadFn, void *src, double *val, uint8_t *pNull) {
+  (*loadFn)(src, 0, 1, true, val, pNull);
+  if (pNull[0]) {
+    return false;
+  }
+
+  for (int32_t i = 1; i < ARITH_BLOCK_SIZE; ++i) {
+    val[i] = val[0];
+    pNull[i] = 0;
+  }
+  return true;
+}
+
+static void vectorArithmetic(void *left, int32_t len1, int32_t _left_type, void *right, int32_t len2,
+                             int32_t _right_type, void *out, int32_t _ord, _arithmetic_block_fn_t blockFn) {
+  const SArithKernel   *pKernel = getArithKernel();
+  _arithmetic_load_fn_t loadLeft = pKernel->load[_left_type];
+  _arithmetic_load_fn_t loadRight = pKernel->load[_right_type];
+  assert(loadLeft != NULL && loadRight != NULL);
+
+  double *output = (double *)out;
+  bool    leftConst = (len1 != len2 && len1 == 1);
+  bool    rightConst = (len1 != len2 && len2 == 1);
+  int32_t num = leftConst ? len2 : len1;
+  if (len1 != len2 && !leftConst && !rightConst) {
+    return;
+  }
+
+  double  leftVal[ARITH_BLOCK_SIZE], rightVal[ARITH_BLOCK_SIZE];
+  uint8_t leftNull[ARITH_BLOCK_SIZE], rightNull[ARITH_BLOCK_SIZE];
+
+  if ((leftConst && !arithLoadConst(loadLeft, left, leftVal, leftNull)) ||
+      (rightConst && !arithLoadConst(loadRight, right, rightVal, rightNull))) {
+    for (int32_t i = 0; i < num; ++i) {
+      SET_DOUBLE_NULL(output + i);
+    }
+    return;
+  }
+
+  bool asc = (_ord == TSDB_ORDER_ASC);
+  for (int32_t start = 0; start < num; start += ARITH_BLOCK_SIZE) {
+    int32_t n = MIN(ARITH_BLOCK_SIZE, num - start);
+    int32_t index = asc ? start : num - 1 - start;
+
+    if (!leftConst) {
+      (*loadLeft)(left, index, n, asc, leftVal, leftNull);
+    }
+    if (!rightConst) {
+      (*loadRight)(right, index, n, asc, rightVal, rightNull);
+    }
+    (*blockFn)(leftVal, leftNull, rightVal, rightNull, n, output + start);
+  }
+}
+
 void vectorAdd(void *left, int32_t len1, int32_t _left_type, void *right, int32_t len2, int32_t _right_type, void *out, int32_t _ord) {
   int32_t i = ((_ord) == TSDB_ORDER_ASC) ? 0 : MAX(len1, len2) - 1;
   int32_t step = ((_ord) == TSDB_ORDER_ASC) ? 1 : -1;
 
   if (!IS_TIMESTAMP_TYPE(_left_type) && !IS_TIMESTAMP_TYPE(_right_type)) {
-    double *output = (double*)out;
-    _arithmetic_getVectorValueAddr_fn_t getVectorValueAddrFnLeft = getVectorValueAddrFn(_left_type);
-    _arithmetic_getVectorValueAddr_fn_t getVectorValueAddrFnRight = getVectorValueAddrFn(_right_type);
-    _arithmetic_getVectorDoubleValue_fn_t getVectorDoubleValueFnLeft = getVectorDoubleValueFn(_left_type);
-    _arithmetic_getVectorDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(_right_type);
-
-    if ((len1) == (len2)) {
-      for (; i < (len2) && i >= 0; i += step, output += 1) {
-        if (isNull(getVectorValueAddrFnLeft(left,i), _left_type) || isNull(getVectorValueAddrFnRight(right,i), _right_type)) {
-          SET_DOUBLE_NULL(output);
-          continue;
-        }
-        SET_DOUBLE_VAL(output,getVectorDoubleValueFnLeft(left,i) + getVectorDoubleValueFnRight(right,i));
-      }
-    } else if ((len1) == 1) {
-      for (; i >= 0 && i < (len2); i += step, output += 1) {
-        if (isNull(getVectorValueAddrFnLeft(left,0), _left_type) || isNull(getVectorValueAddrFnRight(right,i), _right_type)) {
-          SET_DOUBLE_NULL(output);
-          continue;
-        }
-        SET_DOUBLE_VAL(output,getVectorDoubleValueFnLeft(left,0) + getVectorDoubleValueFnRight(right,i));
-      }
-    } else if ((len2) == 1) {
-      for (; i >= 0 && i < (len1); i += step, output += 1) {
-        if (isNull(getVectorValueAddrFnLeft(left,i), _left_type) || isNull(getVectorValueAddrFnRight(right,0), _right_type)) {
-          SET_DOUBLE_NULL(output);
-          continue;
-        }
-        SET_DOUBLE_VAL(output,getVectorDoubleValueFnLeft(left,i) + getVectorDoubleValueFnRight(right,0));
-      }
-    }
+    vectorArithmetic(left, len1, _left_type, right, len2, _right_type, out, _ord, getArithKernel()->add);
   } else {
     int64_t *output = (int64_t *)out;
     _arithmetic_getVectorValueAddr_fn_t getVectorValueAddrFnLeft = getVectorValueAddrFn(_left_type);
@@ -266,37 +356,7 @@ void vectorSub(void *left, int32_t len1, int32_t _left_type, void *right, int32_
   int32_t step = ((_ord) == TSDB_ORDER_ASC) ? 1 : -1;
 
   if (!IS_TIMESTAMP_TYPE(_left_type) && !IS_TIMESTAMP_TYPE(_right_type)) {
-    double *output=(double*)out;
-    _arithmetic_getVectorValueAddr_fn_t getVectorValueAddrFnLeft = getVectorValueAddrFn(_left_type);
-    _arithmetic_getVectorValueAddr_fn_t getVectorValueAddrFnRight = getVectorValueAddrFn(_right_type);
-    _arithmetic_getVectorDoubleValue_fn_t getVectorDoubleValueFnLeft = getVectorDoubleValueFn(_left_type);
-    _arithmetic_getVectorDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(_right_type);
-
-    if ((len1) == (len2)) {
-      for (; i < (len2) && i >= 0; i += step, output += 1) {
-        if (isNull(getVectorValueAddrFnLeft(left,i), _left_type) || isNull(getVectorValueAddrFnRight(right,i), _right_type)) {
-          SET_DOUBLE_NULL(output);
-          continue;
-        }
-        SET_DOUBLE_VAL(output,getVectorDoubleValueFnLeft(left,i) - getVectorDoubleValueFnRight(right,i));
-      }
-    } else if ((len1) == 1) {
-      for (; i >= 0 && i < (len2); i += step, output += 1) {
-        if (isNull(getVectorValueAddrFnLeft(left,0), _left_type) || isNull(getVectorValueAddrFnRight(right,i), _right_type)) {
-          SET_DOUBLE_NULL(output);
-          continue;
-        }
-        SET_DOUBLE_VAL(output,getVectorDoubleValueFnLeft(left,0) - getVectorDoubleValueFnRight(right,i));
-      }
-    } else if ((len2) == 1) {
-      for (; i >= 0 && i < (len1); i += step, output += 1) {
-        if (isNull(getVectorValueAddrFnLeft(left,i), _left_type) || isNull(getVectorValueAddrFnRight(right,0), _right_type)) {
-          SET_DOUBLE_NULL(output);
-          continue;
-        }
-        SET_DOUBLE_VAL(output,getVectorDoubleValueFnLeft(left,i) - getVectorDoubleValueFnRight(right,0));
-      }
-    }
+    vectorArithmetic(left, len1, _left_type, right, len2, _right_type, out, _ord, getArithKernel()->sub);
   } else {
     int64_t *output = (int64_t *)out;
     _arithmetic_getVectorValueAddr_fn_t getVectorValueAddrFnLeft = getVectorValueAddrFn(_left_type);
@@ -331,147 +391,15 @@ void vectorSub(void *left, int32_t len1, int32_t _left_type, void *right, int32_
 }
 
 void vectorMultiply(void *left, int32_t len1, int32_t _left_type, void *right, int32_t len2, int32_t _right_type, void *out, int32_t _ord) {
-  int32_t i = ((_ord) == TSDB_ORDER_ASC) ? 0 : MAX(len1, len2) - 1;
-  int32_t step = ((_ord) == TSDB_ORDER_ASC) ? 1 : -1;
-  double *output=(double*)out;
-  _arithmetic_getVectorValueAddr_fn_t getVectorValueAddrFnLeft = getVectorValueAddrFn(_left_type);
-  _arithmetic_getVectorValueAddr_fn_t getVectorValueAddrFnRight = getVectorValueAddrFn(_right_type);
-  _arithmetic_getVectorDoubleValue_fn_t getVectorDoubleValueFnLeft = getVectorDoubleValueFn(_left_type);
-  _arithmetic_getVectorDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(_right_type);
-
-  if ((len1) == (len2)) {
-    for (; i < (len2) && i >= 0; i += step, output += 1) {
-      if (isNull(getVectorValueAddrFnLeft(left,i), _left_type) || isNull(getVectorValueAddrFnRight(right,i), _right_type)) {
-        SET_DOUBLE_NULL(output);
-        continue;
-      }
-      SET_DOUBLE_VAL(output,getVectorDoubleValueFnLeft(left,i) * getVectorDoubleValueFnRight(right,i));
-    }
-  } else if ((len1) == 1) {
-    for (; i >= 0 && i < (len2); i += step, output += 1) {
-      if (isNull(getVectorValueAddrFnLeft(left,0), _left_type) || isNull(getVectorValueAddrFnRight(right,i), _right_type)) {
-        SET_DOUBLE_NULL(output);
-        continue;
-      }
-      SET_DOUBLE_VAL(output,getVectorDoubleValueFnLeft(left,0) * getVectorDoubleValueFnRight(right,i));
-    }
-  } else if ((len2) == 1) {
-    for (; i >= 0 && i < (len1); i += step, output += 1) {
-      if (isNull(getVectorValueAddrFnLeft(left,i), _left_type) || isNull(getVectorValueAddrFnRight(right,0), _right_type)) {
-        SET_DOUBLE_NULL(output);
-        continue;
-      }
-      SET_DOUBLE_VAL(output,getVectorDoubleValueFnLeft(left,i) * getVectorDoubleValueFnRight(right,0));
-    }
-  }
+  vectorArithmetic(left, len1, _left_type, right, len2, _right_type, out, _ord, getArithKernel()->multiply);
 }
 
 void vectorDivide(void *left, int32_t len1, int32_t _left_type, void *right, int32_t len2, int32_t _right_type, void *out, int32_t _ord) {
-  int32_t i = ((_ord) == TSDB_ORDER_ASC) ? 0 : MAX(len1, len2) - 1;
-  int32_t step = ((_ord) == TSDB_ORDER_ASC) ? 1 : -1;
-  double *output=(double*)out;
-  _arithmetic_getVectorValueAddr_fn_t getVectorValueAddrFnLeft = getVectorValueAddrFn(_left_type);
-  _arithmetic_getVectorValueAddr_fn_t getVectorValueAddrFnRight = getVectorValueAddrFn(_right_type);
-  _arithmetic_getVectorDoubleValue_fn_t getVectorDoubleValueFnLeft = getVectorDoubleValueFn(_left_type);
-  _arithmetic_getVectorDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(_right_type);
-
-  if ((len1) == (len2)) {
-    for (; i < (len2) && i >= 0; i += step, output += 1) {
-      if (isNull(getVectorValueAddrFnLeft(left,i), _left_type) || isNull(getVectorValueAddrFnRight(right,i), _right_type)) {
-        SET_DOUBLE_NULL(output);
-        continue;
-      }
-      double v, u = 0.0;
-      GET_TYPED_DATA(v, double, _right_type, getVectorValueAddrFnRight(right,i));
-      if (getComparFunc(TSDB_DATA_TYPE_DOUBLE, 0)(&v, &u) == 0) {
-        SET_DOUBLE_NULL(output);
-        continue;
-      }
-      SET_DOUBLE_VAL(output,getVectorDoubleValueFnLeft(left,i) /getVectorDoubleValueFnRight(right,i));
-    }
-  } else if ((len1) == 1) {
-    for (; i >= 0 && i < (len2); i += step, output += 1) {
-      if (isNull(getVectorValueAddrFnLeft(left,0), _left_type) || isNull(getVectorValueAddrFnRight(right,i), _right_type)) {
-        SET_DOUBLE_NULL(output);
-        continue;
-      }
-      double v, u = 0.0;
-      GET_TYPED_DATA(v, double, _right_type, getVectorValueAddrFnRight(right,i));
-      if (getComparFunc(TSDB_DATA_TYPE_DOUBLE, 0)(&v, &u) == 0) {
-        SET_DOUBLE_NULL(output);
-        continue;
-      }
-      SET_DOUBLE_VAL(output,getVectorDoubleValueFnLeft(left,0) /getVectorDoubleValueFnRight(right,i));
-    }
-  } else if ((len2) == 1) {
-    for (; i >= 0 && i < (len1); i += step, output += 1) {
-      if (isNull(getVectorValueAddrFnLeft(left,i), _left_type) || isNull(getVectorValueAddrFnRight(right,0), _right_type)) {
-        SET_DOUBLE_NULL(output);
-        continue;
-      }
-      double v, u = 0.0;
-      GET_TYPED_DATA(v, double, _right_type, getVectorValueAddrFnRight(right,0));
-      if (getComparFunc(TSDB_DATA_TYPE_DOUBLE, 0)(&v, &u) == 0) {
-        SET_DOUBLE_NULL(output);
-        continue;
-      }
-      SET_DOUBLE_VAL(output,getVectorDoubleValueFnLeft(left,i) /getVectorDoubleValueFnRight(right,0));
-    }
-  }
+  vectorArithmetic(left, len1, _left_type, right, len2, _right_type, out, _ord, getArithKernel()->divide);
 }
 
 void vectorRemainder(void *left, int32_t len1, int32_t _left_type, void *right, int32_t len2, int32_t _right_type, void *out, int32_t _ord) {
-  int32_t i = (_ord == TSDB_ORDER_ASC) ? 0 : MAX(len1, len2) - 1;
-  int32_t step = (_ord == TSDB_ORDER_ASC) ? 1 : -1;
-  double *output=(double*)out;
-  _arithmetic_getVectorValueAddr_fn_t getVectorValueAddrFnLeft = getVectorValueAddrFn(_left_type);
-  _arithmetic_getVectorValueAddr_fn_t getVectorValueAddrFnRight = getVectorValueAddrFn(_right_type);
-  _arithmetic_getVectorDoubleValue_fn_t getVectorDoubleValueFnLeft = getVectorDoubleValueFn(_left_type);
-  _arithmetic_getVectorDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(_right_type);
-
-  if (len1 == (len2)) {
-    for (; i >= 0 && i < (len2); i += step, output += 1) {
-      if (isNull(getVectorValueAddrFnLeft(left,i), _left_type) || isNull(getVectorValueAddrFnRight(right,i), _right_type)) {
-        SET_DOUBLE_NULL(output);
-        continue;
-      }
-      double v, u = 0.0;
-      GET_TYPED_DATA(v, double, _right_type, getVectorValueAddrFnRight(right,i));
-      if (getComparFunc(TSDB_DATA_TYPE_DOUBLE, 0)(&v, &u) == 0) {
-        SET_DOUBLE_NULL(output);
-        continue;
-      }
-      SET_DOUBLE_VAL(output,getVectorDoubleValueFnLeft(left,i) - ((int64_t)(getVectorDoubleValueFnLeft(left,i) / getVectorDoubleValueFnRight(right,i))) * getVectorDoubleValueFnRight(right,i));
-    }
-  } else if (len1 == 1) {
-    for (; i >= 0 && i < (len2); i += step, output += 1) {
-      if (isNull(getVectorValueAddrFnLeft(left,0), _left_type) || isNull(getVectorValueAddrFnRight(right,i), _right_type)) {
-        SET_DOUBLE_NULL(output);
-        continue;
-      }
-      double v, u = 0.0;
-      GET_TYPED_DATA(v, double, _right_type, getVectorValueAddrFnRight(right,i));
-      if (getComparFunc(TSDB_DATA_TYPE_DOUBLE, 0)(&v, &u) == 0) {
-        SET_DOUBLE_NULL(output);
-        continue;
-      }
-      SET_DOUBLE_VAL(output,getVectorDoubleValueFnLeft(left,0) - ((int64_t)(getVectorDoubleValueFnLeft(left,0) / getVectorDoubleValueFnRight(right,i))) * getVectorDoubleValueFnRight(right,i));
-    }
-  } else if ((len2) == 1) {
-    for (; i >= 0 && i < len1; i += step, output += 1) {
-      if (isNull(getVectorValueAddrFnLeft(left,i), _left_type) || isNull(getVectorValueAddrFnRight(right,0), _right_type)) {
-        SET_DOUBLE_NULL(output);
-        continue;
-      }
-      double v, u = 0.0;
-      GET_TYPED_DATA(v, double, _right_type, getVectorValueAddrFnRight(right,0));
-      if (getComparFunc(TSDB_DATA_TYPE_DOUBLE, 0)(&v, &u) == 0) {
-        SET_DOUBLE_NULL(output);
-        continue;
-      }
-      SET_DOUBLE_VAL(output,getVectorDoubleValueFnLeft(left,i) - ((int64_t)(getVectorDoubleValueFnLeft(left,i) / getVectorDoubleValueFnRight(right,0))) * getVectorDoubleValueFnRight(right,0));
-    }
-  }
+  vectorArithmetic(left, len1, _left_type, right, len2, _right_type, out, _ord, getArithKernel()->remainder);
 }
 
 void vectorBitand(void *left, int32_t len1, int32_t _left_type, void *right, int32_t len2, int32_t _right_type, void *out, int32_t _ord) {
@@ -26,7 +26,7 @@ static void tdMergeTwoDataCols(SDataCols *target, SDataCols *src1, int *iter1, i
 int tdAllocMemForCol(SDataCol *pCol, int maxPoints) {
   int spaceNeeded = pCol->bytes * maxPoints;
   if(IS_VAR_DATA_TYPE(pCol->type)) {
-    spaceNeeded += sizeof(VarDataOffsetT) * maxPoints;
+    spaceNeeded += (sizeof(VarDataOffsetT) + sizeof(uint8_t)) * maxPoints;
   }
   if(pCol->spaceSize < spaceNeeded) {
     void* ptr = realloc(pCol->pData, spaceNeeded);
@@ -41,6 +41,7 @@ int tdAllocMemForCol(SDataCol *pCol, int maxPoints) {
   }
   if(IS_VAR_DATA_TYPE(pCol->type)) {
     pCol->dataOff = POINTER_SHIFT(pCol->pData, pCol->bytes * maxPoints);
+    pCol->dictCodes = POINTER_SHIFT(pCol->dataOff, sizeof(VarDataOffsetT) * maxPoints);
   }
   return 0;
 }
@@ -288,6 +289,34 @@ int dataColAppendVal(SDataCol *pCol, const void *value, int numOfRows, int maxPo
   return 0;
 }
 
+/**
+ *  Append nEle contiguous values of a fixed length type, the columnar counterpart of dataColAppendVal.
+ */
+int dataColAppendNVal(SDataCol *pCol, const void *values, int nEle, int numOfRows, int maxPoints) {
+  ASSERT(pCol != NULL && values != NULL && !IS_VAR_DATA_TYPE(pCol->type));
+  int bytes = TYPE_BYTES[pCol->type];
+
+  if (isAllRowsNull(pCol)) {
+    int i = 0;
+    while (i < nEle && isNull(POINTER_SHIFT(values, i * bytes), pCol->type)) i++;
+    if (i >= nEle) {
+      // all null value yet, just return
+      return 0;
+    }
+
+    if (tdAllocMemForCol(pCol, maxPoints) < 0) return -1;
+
+    if (numOfRows > 0) {
+      dataColSetNEleNull(pCol, numOfRows);
+    }
+  }
+
+  ASSERT(pCol->len == bytes * numOfRows);
+  memcpy(POINTER_SHIFT(pCol->pData, pCol->len), values, bytes * nEle);
+  pCol->len += bytes * nEle;
+  return 0;
+}
+
 static FORCE_INLINE const void *tdGetColDataOfRowUnsafe(SDataCol *pCol, int row) {
   if (IS_VAR_DATA_TYPE(pCol->type)) {
     return POINTER_SHIFT(pCol->pData, pCol->dataOff[row]);
@@ -368,6 +397,8 @@ SDataCols *tdNewDataCols(int maxCols, int maxRows) {
       pCols->cols[i].len = 0;
       pCols->cols[i].pData = NULL;
       pCols->cols[i].dataOff = NULL;
+      pCols->cols[i].dictCodes = NULL;
+      pCols->cols[i].dictNum = 0;
     }
   }
 
@@ -385,6 +416,8 @@ int tdInitDataCols(SDataCols *pCols, STSchema *pSchema) {
     for(i = oldMaxCols; i < pCols->maxCols; i++) {
       pCols->cols[i].pData = NULL;
       pCols->cols[i].dataOff = NULL;
+      pCols->cols[i].dictCodes = NULL;
+      pCols->cols[i].dictNum = 0;
       pCols->cols[i].spaceSize = 0;
     }
   }
@@ -566,6 +599,9 @@ int tdMergeDataCols(SDataCols *target, SDataCols *source, int rowsToMerge, int *
 
   if ((target->numOfRows == 0) || (dataColsKeyLast(target) < dataColsKeyAtRow(source, *pOffset))) {  // No overlap
     ASSERT(target->numOfRows + rowsToMerge <= target->maxPoints);
+    for (int j = 0; j < target->numOfCols; j++) {
+      target->cols[j].dictNum = 0;  // the appended rows have no codes
+    }
     for (int i = 0; i < rowsToMerge; i++) {
       for (int j = 0; j < source->numOfCols; j++) {
         if (source->cols[j].len > 0 || target->cols[j].len > 0) {
@@ -86,6 +86,44 @@ int32_t tsCompressMsgSize = 512 * 1024;
  */
 int32_t tsCompressColData = -1;
 
+/* The encodings below write blocks that older versions cannot read, so they are off until every dnode and replica runs
+ * a version that reads them. Blocks written with them are read whatever these options are.
+ */
+
+/* denote if timestamps of a fixed interval, or whose deltas stay in a 32 bit range, may be compressed as the interval
+ * or as bit packed deltas, when that is smaller than the delta of delta encoding.
+ * 0: always use the delta of delta encoding
+ */
+int8_t tsTimestampBitPack = 0;
+
+/* denote if blocks of float and double values with a few decimal digits may be compressed as bit packed integers
+ * scaled by a power of ten, when that is smaller than the XOR encoding.
+ * 0: always use the XOR encoding
+ */
+int8_t tsFloatDecimalPack = 0;
+
+/* denote if integers may be compressed as bit packed miniblocks above a base, when that is smaller than the simple8b
+ * encoding.
+ * 0: always use the simple8b encoding
+ */
+int8_t tsIntBitPack = 0;
+
+/* denote if blocks of binary and nchar values with at most TSDB_STR_DICT_MAX_VALUES distinct values may be compressed
+ * as a dictionary and the bit packed code of each row, when that is smaller than LZ4. Query filters then compare each
+ * distinct value once.
+ * 0: always use LZ4
+ */
+int8_t tsStringDictEncode = 0;
+
+/* denote the tier of storage, as the level of a data directory, from which the file sets of databases with two stage
+ * compression take zstd at tsZstdLevel as the second stage instead of LZ4. File sets are recompressed when they move
+ * to a tier of another second stage, and when they are compacted after this option changed. TSDB_MAX_TIERS: always
+ * use LZ4
+ * Zstd is built in only with TD_TSZ, builds without it write LZ4 at any tier and cannot read zstd compressed files.
+ */
+int32_t tsZstdTier = TSDB_DEFAULT_ZSTD_TIER;
+int32_t tsZstdLevel = TSDB_DEFAULT_ZSTD_LEVEL;
+
 // client
 int32_t tsMaxSQLStringLen = TSDB_MAX_ALLOWED_SQL_LEN;
 int32_t tsMaxWildCardsLen = TSDB_PATTERN_STRING_DEFAULT_LEN;
@@ -131,6 +169,22 @@ int64_t tsQueryBufferSizeBytes = -1;
 // in retrieve blocking model, the retrieve threads will wait for the completion of the query processing.
 int32_t tsRetrieveBlockingModel = 0;
 
+// the child tables of a super table query on a vnode are split into up to tsQueryParallelDegree morsels, which run on
+// a pool of tsQueryParallelThreads threads besides the query worker thread.
+int32_t tsQueryParallelThreads = TSDB_DEFAULT_QUERY_PARALLEL_THREADS;
+int32_t tsQueryParallelDegree = TSDB_DEFAULT_QUERY_PARALLEL_DEGREE;
+
+// an aggregation query that has run for tsQueryYieldTime ms stops between two data blocks and is put back at the tail
+// of the query queue of its vnode, so that the queries behind it are not held up by a long scan. 0: disabled
+int32_t tsQueryYieldTime = TSDB_DEFAULT_QUERY_YIELD_TIME;
+
+// the queries of the users in tsBatchQueryUsers are of the batch class, they are executed by tsBatchQueryThreads threads
+// of their own and take at most tsBatchQueryBufferSize MB of the query buffer. The other queries are interactive.
+int32_t tsBatchQueryThreads = TSDB_DEFAULT_BATCH_QUERY_THREADS;
+char    tsBatchQueryUsers[TSDB_BATCH_QUERY_USERS_LEN] = {0};
+int32_t tsBatchQueryBufferSize = -1;
+int64_t tsBatchQueryBufferSizeBytes = -1;
+
 // last_row(*), first(*), last_row(ts, col1, col2) query, the result fields will be the original column name
 int8_t tsKeepOriginalColumnName = 0;
 
@@ -162,6 +216,14 @@ int32_t tsTsdbMetaCompactRatio = TSDB_META_COMPACT_RATIO;
 bool    tsdbForceKeepFile = false;
 bool    tsdbForceCompactFile = false;                    // compact TSDB fileset forcibly
 int32_t tsdbWalFlushSize = TSDB_DEFAULT_WAL_FLUSH_SIZE;  // MB
+int32_t tsdbBlkDataCacheSize = TSDB_DEFAULT_BLK_DATA_CACHE_SIZE;  // MB of decompressed block data cached per vnode
+int32_t tsdbBlkIdxCacheSize = TSDB_DEFAULT_BLK_IDX_CACHE_SIZE;    // MB of decoded block indexes cached per vnode
+int32_t tsdbBlkReadAhead = TSDB_DEFAULT_BLK_READ_AHEAD;          // data blocks read ahead by a query
+int32_t tsdbBlkDecodeThreads = TSDB_DEFAULT_BLK_DECODE_THREADS;  // dnode-wide threads decoding columns of a block
+int32_t tsdbMemColBuffer = TSDB_DEFAULT_MEM_COL_BUFFER;          // append in-order rows to memtable column buffers
+int32_t tsdbCommitFSetThreads = TSDB_DEFAULT_COMMIT_FSET_THREADS;  // commit threads sharing the file sets of a vnode
+int32_t tsdbTagInvertedIdx = TSDB_DEFAULT_TAG_INVERTED_IDX;        // inverted indexes on the tags of super tables
+int32_t tsdbEncodedAggr = TSDB_DEFAULT_ENCODED_AGGR;               // aggregate cut file blocks on their encoded columns
 
 // balance
 int8_t  tsEnableBalance = 1;
@@ -292,6 +354,8 @@ char tsSmlChildTableName[TSDB_TABLE_NAME_LEN] = ""; //user defined child table n
 char tsSmlTagNullName[TSDB_COL_NAME_LEN] = "_tag_null"; //for line protocol if tag is omitted, add a tag with NULL value
                                                         //to make sure inserted records belongs to the same measurement
                                                         //default name is _tag_null and can be user configurable
+int8_t tsSmlDirectInsert = 0; //bind the values of schemaless points to a prepared statement for each super table
+                              //instead of printing them into INSERT statements which are parsed again
 
 int32_t (*monStartSystemFp)() = NULL;
 void (*monStopSystemFp)() = NULL;
@@ -1060,6 +1124,66 @@ static void doInitGlobalConfig(void) {
   cfg.unitType = TAOS_CFG_UTYPE_NONE;
   taosInitConfigOption(cfg);
 
+  cfg.option = "timestampBitPack";
+  cfg.ptr = &tsTimestampBitPack;
+  cfg.valType = TAOS_CFG_VTYPE_INT8;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_CLIENT | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 1;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "floatDecimalPack";
+  cfg.ptr = &tsFloatDecimalPack;
+  cfg.valType = TAOS_CFG_VTYPE_INT8;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_CLIENT | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 1;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "intBitPack";
+  cfg.ptr = &tsIntBitPack;
+  cfg.valType = TAOS_CFG_VTYPE_INT8;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_CLIENT | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 1;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "stringDictEncode";
+  cfg.ptr = &tsStringDictEncode;
+  cfg.valType = TAOS_CFG_VTYPE_INT8;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_CLIENT | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 1;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "zstdTier";
+  cfg.ptr = &tsZstdTier;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = TSDB_MIN_ZSTD_TIER;
+  cfg.maxValue = TSDB_MAX_ZSTD_TIER;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "zstdLevel";
+  cfg.ptr = &tsZstdLevel;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = TSDB_MIN_ZSTD_LEVEL;
+  cfg.maxValue = TSDB_MAX_ZSTD_LEVEL;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
   cfg.option = "maxSQLLength";
   cfg.ptr = &tsMaxSQLStringLen;
   cfg.valType = TAOS_CFG_VTYPE_INT32;
@@ -1120,6 +1244,69 @@ static void doInitGlobalConfig(void) {
   cfg.unitType = TAOS_CFG_UTYPE_NONE;
   taosInitConfigOption(cfg);
 
+  // 0 disables the parallel execution of super table queries on a vnode
+  cfg.option = "queryParallelThreads";
+  cfg.ptr = &tsQueryParallelThreads;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = TSDB_MIN_QUERY_PARALLEL_THREADS;
+  cfg.maxValue = TSDB_MAX_QUERY_PARALLEL_THREADS;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "queryParallelDegree";
+  cfg.ptr = &tsQueryParallelDegree;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = TSDB_MIN_QUERY_PARALLEL_DEGREE;
+  cfg.maxValue = TSDB_MAX_QUERY_PARALLEL_DEGREE;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  // 0 disables the yield of long queries
+  cfg.option = "queryYieldTime";
+  cfg.ptr = &tsQueryYieldTime;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = TSDB_MIN_QUERY_YIELD_TIME;
+  cfg.maxValue = TSDB_MAX_QUERY_YIELD_TIME;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_MS;
+  taosInitConfigOption(cfg);
+
+  // 0 disables the batch query class
+  cfg.option = "batchQueryThreads";
+  cfg.ptr = &tsBatchQueryThreads;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = TSDB_MIN_BATCH_QUERY_THREADS;
+  cfg.maxValue = TSDB_MAX_BATCH_QUERY_THREADS;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "batchQueryUsers";
+  cfg.ptr = tsBatchQueryUsers;
+  cfg.valType = TAOS_CFG_VTYPE_STRING;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 0;
+  cfg.ptrLength = tListLen(tsBatchQueryUsers);
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "batchQueryBufferSize";
+  cfg.ptr = &tsBatchQueryBufferSize;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = -1;
+  cfg.maxValue = 500000000000.0f;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_BYTE;
+  taosInitConfigOption(cfg);
+
   cfg.option = "keepColumnName";
   cfg.ptr = &tsKeepOriginalColumnName;
   cfg.valType = TAOS_CFG_VTYPE_INT8;
@@ -1711,6 +1898,17 @@ static void doInitGlobalConfig(void) {
   cfg.unitType = TAOS_CFG_UTYPE_NONE;
   taosInitConfigOption(cfg);
 
+  // 0 inserts schemaless points with INSERT statements
+  cfg.option = "smlDirectInsert";
+  cfg.ptr = &tsSmlDirectInsert;
+  cfg.valType = TAOS_CFG_VTYPE_INT8;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW | TSDB_CFG_CTYPE_B_CLIENT;
+  cfg.minValue = 0;
+  cfg.maxValue = 1;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
   // flush vnode wal file if walSize > walFlushSize and walSize > cache*0.5*blocks
   cfg.option = "walFlushSize";
   cfg.ptr = &tsdbWalFlushSize;
@@ -1722,6 +1920,94 @@ static void doInitGlobalConfig(void) {
   cfg.unitType = TAOS_CFG_UTYPE_MB;
   taosInitConfigOption(cfg);
 
+  // 0 disables the decompressed block data cache
+  cfg.option = "blockDataCacheSize";
+  cfg.ptr = &tsdbBlkDataCacheSize;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = TSDB_MIN_BLK_DATA_CACHE_SIZE;
+  cfg.maxValue = TSDB_MAX_BLK_DATA_CACHE_SIZE;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_MB;
+  taosInitConfigOption(cfg);
+
+  // 0 disables the block index cache
+  cfg.option = "blockIndexCacheSize";
+  cfg.ptr = &tsdbBlkIdxCacheSize;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = TSDB_MIN_BLK_IDX_CACHE_SIZE;
+  cfg.maxValue = TSDB_MAX_BLK_IDX_CACHE_SIZE;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_MB;
+  taosInitConfigOption(cfg);
+
+  // 0 disables the read ahead of data blocks
+  cfg.option = "blockReadAhead";
+  cfg.ptr = &tsdbBlkReadAhead;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = TSDB_MIN_BLK_READ_AHEAD;
+  cfg.maxValue = TSDB_MAX_BLK_READ_AHEAD;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  // 0 disables the parallel decoding of the columns in a data block
+  cfg.option = "blockDecodeThreads";
+  cfg.ptr = &tsdbBlkDecodeThreads;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = TSDB_MIN_BLK_DECODE_THREADS;
+  cfg.maxValue = TSDB_MAX_BLK_DECODE_THREADS;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  // 0 keeps every memtable row in the per-table skiplist
+  cfg.option = "memColumnBuffer";
+  cfg.ptr = &tsdbMemColBuffer;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = TSDB_MIN_MEM_COL_BUFFER;
+  cfg.maxValue = TSDB_MAX_MEM_COL_BUFFER;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  // 1 commits the file sets of a vnode one by one on the thread that started the commit
+  cfg.option = "commitFileSetThreads";
+  cfg.ptr = &tsdbCommitFSetThreads;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = TSDB_MIN_COMMIT_FSET_THREADS;
+  cfg.maxValue = TSDB_MAX_COMMIT_FSET_THREADS;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  // 0 resolves conditions on tags other than the first one by scanning all child tables
+  cfg.option = "tagInvertedIndex";
+  cfg.ptr = &tsdbTagInvertedIdx;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = TSDB_MIN_TAG_INVERTED_IDX;
+  cfg.maxValue = TSDB_MAX_TAG_INVERTED_IDX;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  // 0 decodes all columns of a file block the query window cuts through to aggregate its rows
+  cfg.option = "encodedAggregate";
+  cfg.ptr = &tsdbEncodedAggr;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = TSDB_MIN_ENCODED_AGGR;
+  cfg.maxValue = TSDB_MAX_ENCODED_AGGR;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
   // shortcut flag to facilitate debugging
   cfg.option = "shortcutFlag";
   cfg.ptr = &tsShortcutFlag;
@@ -1880,6 +2166,10 @@ int32_t taosCheckGlobalCfg() {
     tsQueryBufferSizeBytes = tsQueryBufferSize * 1048576UL;
   }
 
+  if (tsBatchQueryBufferSize >= 0) {
+    tsBatchQueryBufferSizeBytes = tsBatchQueryBufferSize * 1048576UL;
+  }
+
   uInfo("   check global cfg completed");
   uInfo("==================================");
   taosPrintGlobalCfg();
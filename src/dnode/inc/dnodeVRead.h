@@ -26,8 +26,10 @@ void    dnodeCleanupVRead();
 void    dnodeDispatchToVReadQueue(SRpcMsg *pMsg);
 void *  dnodeAllocVQueryQueue(void *pVnode);
 void *  dnodeAllocVFetchQueue(void *pVnode);
+void *  dnodeAllocVBatchQueue(void *pVnode);
 void    dnodeFreeVQueryQueue(void *pQqueue);
 void    dnodeFreeVFetchQueue(void *pFqueue);
+void    dnodeFreeVBatchQueue(void *pBqueue);
 
 #ifdef __cplusplus
 }
@@ -24,6 +24,7 @@ static void *dnodeProcessReadQueue(void *pWorker);
 // module global variable
 static SWorkerPool tsVQueryWP;
 static SWorkerPool tsVFetchWP;
+static SWorkerPool tsVBatchWP;
 
 int32_t dnodeInitVRead() {
   const int32_t maxFetchThreads = 4;
@@ -43,10 +44,23 @@ int32_t dnodeInitVRead() {
   tsVFetchWP.max = tsVFetchWP.min;
   if (tWorkerInit(&tsVFetchWP) != 0) return -1;
 
+  // the queries of the batch class get threads of their own, so that they never hold up the interactive ones
+  if (tsBatchQueryThreads > 0) {
+    tsVBatchWP.name = "vbatch";
+    tsVBatchWP.workerFp = dnodeProcessReadQueue;
+    tsVBatchWP.min = tsBatchQueryThreads;
+    tsVBatchWP.max = tsVBatchWP.min;
+    if (tWorkerInit(&tsVBatchWP) != 0) return -1;
+  }
+
   return 0;
 }
 
 void dnodeCleanupVRead() {
+  if (tsVBatchWP.qset != NULL) {
+    tWorkerCleanup(&tsVBatchWP);
+  }
+
   tWorkerCleanup(&tsVFetchWP);
   tWorkerCleanup(&tsVQueryWP);
 }
@@ -90,6 +104,14 @@ void *dnodeAllocVFetchQueue(void *pVnode) {
   return tWorkerAllocQueue(&tsVFetchWP, pVnode);
 }
 
+void *dnodeAllocVBatchQueue(void *pVnode) {
+  if (tsVBatchWP.qset == NULL) {
+    return NULL;
+  }
+
+  return tWorkerAllocQueue(&tsVBatchWP, pVnode);
+}
+
 void dnodeFreeVQueryQueue(void *pQqueue) {
   tWorkerFreeQueue(&tsVQueryWP, pQqueue);
 }
@@ -98,6 +120,10 @@ void dnodeFreeVFetchQueue(void *pFqueue) {
   tWorkerFreeQueue(&tsVFetchWP, pFqueue);
 }
 
+void dnodeFreeVBatchQueue(void *pBqueue) {
+  tWorkerFreeQueue(&tsVBatchWP, pBqueue);
+}
+
 void dnodeSendRpcVReadRsp(void *pVnode, SVReadMsg *pRead, int32_t code) {
   SRpcMsg rpcRsp = {
     .handle  = pRead->rpcHandle,
@@ -119,7 +145,8 @@ static void *dnodeProcessReadQueue(void *wparam) {
   int32_t      qtype;
   void *       pVnode;
 
-  char* threadname  = strcmp(pPool->name, "vquery") == 0? "dnodeQueryQ":"dnodeFetchQ";
+  char* threadname  = strcmp(pPool->name, "vquery") == 0? "dnodeQueryQ":
+                      (strcmp(pPool->name, "vbatch") == 0? "dnodeBatchQ":"dnodeFetchQ");
 
   char name[16] = {0};
   snprintf(name, tListLen(name), "%s", threadname);
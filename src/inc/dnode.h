@@ -58,8 +58,10 @@ void  dnodeFreeVWriteQueue(void *pWqueue);
 void  dnodeSendRpcVWriteRsp(void *pVnode, void *pWrite, int32_t code);
 void *dnodeAllocVQueryQueue(void *pVnode);
 void *dnodeAllocVFetchQueue(void *pVnode);
+void *dnodeAllocVBatchQueue(void *pVnode);
 void  dnodeFreeVQueryQueue(void *pQqueue);
 void  dnodeFreeVFetchQueue(void *pFqueue);
+void  dnodeFreeVBatchQueue(void *pBqueue);
 
 int32_t dnodeAllocateMPeerQueue();
 void    dnodeFreeMPeerQueue();
@@ -28,7 +28,8 @@ typedef void* qinfo_t;
  * @param qinfo
  * @return
  */
-int32_t qCreateQueryInfo(void* tsdb, int32_t vgId, SQueryTableMsg* pQueryTableMsg, qinfo_t* qinfo, uint64_t qId);
+int32_t qCreateQueryInfo(void* tsdb, int32_t vgId, SQueryTableMsg* pQueryTableMsg, qinfo_t* qinfo, uint64_t qId,
+                         int8_t queryClass);
 
 
 /**
@@ -83,12 +84,33 @@ bool qSolveCommitNoBlock(void* pRepo, void* pMgmt);
 
 int32_t qQueryCompleted(qinfo_t qinfo);
 
+/**
+ * Whether the last execution of the query stopped at a yield point before it had results, the query then needs to be
+ * put back into the query queue to go on
+ * @param qinfo
+ * @return
+ */
+bool qQueryYielded(qinfo_t qinfo);
+
+/**
+ * The class of the query, TSDB_QUERY_CLASS_INTERACTIVE or TSDB_QUERY_CLASS_BATCH
+ * @param qinfo
+ * @return
+ */
+int8_t qGetQueryClass(qinfo_t qinfo);
+
 /**
  * destroy query info structure
  * @param qHandle
  */
 void qDestroyQueryInfo(qinfo_t qHandle);
 
+/**
+ * The dnode-wide pool running the morsels of super table queries, it is not created if queryParallelThreads is 0
+ */
+int32_t qInitParallelPool();
+void    qCleanupParallelPool();
+
 void* qOpenQueryMgmt(int32_t vgId);
 void  qQueryMgmtNotifyClosed(void* pExecutor);
 void  qQueryMgmtReOpen(void *pExecutor);
@@ -298,6 +298,67 @@ do { \
 #define TSDB_MAX_WAL_FLUSH_SIZE         10000000 // MB
 #define TSDB_DEFAULT_WAL_FLUSH_SIZE     1024 // MB
 
+#define TSDB_MIN_BLK_DATA_CACHE_SIZE    0        // MB, 0 means disabled
+#define TSDB_MAX_BLK_DATA_CACHE_SIZE    65536    // MB
+#define TSDB_DEFAULT_BLK_DATA_CACHE_SIZE 0       // MB
+
+#define TSDB_MIN_BLK_IDX_CACHE_SIZE     0        // MB, 0 means disabled
+#define TSDB_MAX_BLK_IDX_CACHE_SIZE     65536    // MB
+#define TSDB_DEFAULT_BLK_IDX_CACHE_SIZE 0        // MB
+
+#define TSDB_MIN_BLK_READ_AHEAD         0        // 0 means disabled
+#define TSDB_MAX_BLK_READ_AHEAD         64
+#define TSDB_DEFAULT_BLK_READ_AHEAD     0
+
+#define TSDB_MIN_BLK_DECODE_THREADS     0        // 0 means columns are decoded by the loading thread only
+#define TSDB_MAX_BLK_DECODE_THREADS     64
+#define TSDB_DEFAULT_BLK_DECODE_THREADS 0
+
+#define TSDB_MIN_MEM_COL_BUFFER         0        // 0 means all rows of the memtable are kept in skiplists
+#define TSDB_MAX_MEM_COL_BUFFER         1
+#define TSDB_DEFAULT_MEM_COL_BUFFER     0
+
+#define TSDB_MIN_COMMIT_FSET_THREADS     1        // 1 means the file sets of a vnode are committed one by one
+#define TSDB_MAX_COMMIT_FSET_THREADS     64
+#define TSDB_DEFAULT_COMMIT_FSET_THREADS 1
+
+#define TSDB_MIN_QUERY_PARALLEL_THREADS     0    // 0 means each query runs on its query worker thread only
+#define TSDB_MAX_QUERY_PARALLEL_THREADS     256
+#define TSDB_DEFAULT_QUERY_PARALLEL_THREADS 0
+
+#define TSDB_MIN_QUERY_PARALLEL_DEGREE      1
+#define TSDB_MAX_QUERY_PARALLEL_DEGREE      64
+#define TSDB_DEFAULT_QUERY_PARALLEL_DEGREE  4
+
+#define TSDB_MIN_QUERY_YIELD_TIME           0    // 0 means a query runs until it has results
+#define TSDB_MAX_QUERY_YIELD_TIME           3600000
+#define TSDB_DEFAULT_QUERY_YIELD_TIME       0
+
+#define TSDB_QUERY_CLASS_INTERACTIVE        0
+#define TSDB_QUERY_CLASS_BATCH              1
+#define TSDB_QUERY_CLASS_NUM                2
+#define TSDB_BATCH_QUERY_USERS_LEN          512
+
+#define TSDB_MIN_BATCH_QUERY_THREADS        0    // 0 means all queries are of the interactive class
+#define TSDB_MAX_BATCH_QUERY_THREADS        256
+#define TSDB_DEFAULT_BATCH_QUERY_THREADS    0
+
+#define TSDB_MIN_TAG_INVERTED_IDX       0        // 0 means tag conditions are resolved by the skiplist of the first tag
+#define TSDB_MAX_TAG_INVERTED_IDX       1
+#define TSDB_DEFAULT_TAG_INVERTED_IDX   0
+
+#define TSDB_MIN_ENCODED_AGGR           0        // 0 means cut file blocks are decoded to be aggregated
+#define TSDB_MAX_ENCODED_AGGR           1
+#define TSDB_DEFAULT_ENCODED_AGGR       0
+
+#define TSDB_MIN_ZSTD_TIER              0
+#define TSDB_MAX_ZSTD_TIER              TSDB_MAX_TIERS  // no tier, file sets are always compressed with LZ4
+#define TSDB_DEFAULT_ZSTD_TIER          TSDB_MAX_TIERS
+
+#define TSDB_MIN_ZSTD_LEVEL             1
+#define TSDB_MAX_ZSTD_LEVEL             19
+#define TSDB_DEFAULT_ZSTD_LEVEL         9
+
 #define TSDB_MIN_TABLES                 4
 #define TSDB_MAX_TABLES                 10000000
 #define TSDB_DEFAULT_TABLES             1000000
@@ -320,6 +381,8 @@ do { \
 #define TSDB_MIN_MAX_ROW_FBLOCK         200
 #define TSDB_MAX_MAX_ROW_FBLOCK         10000
 
+#define TSDB_STR_DICT_MAX_VALUES        256      // distinct values of a dictionary encoded binary or nchar block
+
 #define TSDB_MIN_COMMIT_TIME            30
 #define TSDB_MAX_COMMIT_TIME            40960
 #define TSDB_DEFAULT_COMMIT_TIME        3600
@@ -178,6 +178,7 @@ typedef struct STsdbQueryCond {
   int32_t      numOfCols;
   SColumnInfo *colList;
   bool         loadExternalRows;  // load external rows or not
+  bool         statisQuery;       // only keys and block statistics are needed, not the rows of the other columns
   int32_t      type;              // data block load type:
 } STsdbQueryCond;
 
@@ -344,12 +345,26 @@ int32_t tsdbRetrieveDataBlockStatisInfo(TsdbQueryHandleT *pQueryHandle, SDataSta
  * the returned data block must be satisfied with the time window condition in any cases,
  * which means the SData data block is not actually the completed disk data blocks.
  *
+ * If pColumnIdList is not NULL, only the listed columns (and the primary timestamp column) of a file block are
+ * loaded and the remaining columns are left as they are until the function is called again with a NULL list.
+ *
  * @param pQueryHandle      query handle
  * @param pColumnIdList     required data columns id list
  * @return
  */
 SArray *tsdbRetrieveDataBlock(TsdbQueryHandleT *pQueryHandle, SArray *pColumnIdList);
 
+/**
+ * Get the dictionary codes of a binary or nchar column of the data block returned by tsdbRetrieveDataBlock. There are
+ * codes only if the block is a whole file block whose column was dictionary encoded, rows of the same code have the
+ * same value.
+ *
+ * @param pQueryHandle      query handle
+ * @param colId             column id
+ * @return the code of each row of the data block, NULL if there are none
+ */
+const uint8_t *tsdbRetrieveDataBlockDictCodes(TsdbQueryHandleT *pQueryHandle, int16_t colId);
+
 /**
  * Get the qualified table id for a super table according to the tag query expression.
  * @param stableid. super table sid
@@ -407,8 +422,17 @@ int64_t tsdbSkipOffset(TsdbQueryHandleT queryHandle);
  */
 void tsdbReportStat(void *repo, int64_t *totalPoints, int64_t *totalStorage, int64_t *compStorage);
 
+/**
+ * get and reset the dnode-wide hit/miss counters of the decompressed block data cache
+ * @param hit. number of column chunks served from the cache
+ * @param miss. number of column chunks read and decompressed from the data files
+ */
+void tsdbGetBlkCacheStatis(int64_t *hit, int64_t *miss);
+
 int  tsdbInitCommitQueue();
 void tsdbDestroyCommitQueue();
+int  tsdbInitDecodePool();
+void tsdbDestroyDecodePool();
 int  tsdbSyncCommit(STsdbRepo *repo);
 void tsdbIncCommitRef(int vgId);
 void tsdbDecCommitRef(int vgId);
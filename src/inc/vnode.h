@@ -26,6 +26,11 @@ typedef struct {
   int64_t submitReqSucNum;
   int64_t submitRowNum;
   int64_t submitRowSucNum;
+  int64_t blkCacheHit;
+  int64_t blkCacheMiss;
+  int64_t queryNum[TSDB_QUERY_CLASS_NUM];        // query queue items taken by the query threads, by the queue
+  int64_t queryWaitUs[TSDB_QUERY_CLASS_NUM];     // total time the items waited in the queue
+  int64_t queryMaxWaitUs[TSDB_QUERY_CLASS_NUM];
 } SVnodeStatisInfo;
 
 typedef struct {
@@ -44,6 +49,7 @@ typedef struct {
   void *  pVnode;
   int8_t  qtype;
   int8_t  msgType;
+  int64_t queuedUs;  // when it is put into the queue
   SRspRet rspRet;
   char    pCont[];
 } SVReadMsg;
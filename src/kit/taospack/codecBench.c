@@ -0,0 +1,598 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if !defined(WINDOWS)
+
+#include "os.h"
+#include "taosdef.h"
+#include "tglobal.h"
+#include "tscompression.h"
+#include "ttype.h"
+#include "codecBench.h"
+
+#define BENCH_DEFAULT_ROWS  1000000
+#define BENCH_DEFAULT_BLOCK 4096
+#define BENCH_DEFAULT_LOOPS 5
+#define BENCH_STR_BYTES     (VARSTR_HEADER_SIZE + 16)  // of the synthetic strings, binary(16)
+#define BENCH_LINE_LEN      (TSDB_MAX_BINARY_LEN + 64)
+#define BENCH_DICT_SAMPLES  100000
+#define BENCH_DICT_BYTES    (16 * 1024)
+
+enum { BENCH_KIND_INT, BENCH_KIND_BOOL, BENCH_KIND_TS, BENCH_KIND_FLOAT, BENCH_KIND_STR };
+
+// A codec is a kind of column and the settings selecting its algorithm in tcompression.c
+typedef struct {
+  const char *name;
+  int8_t      kind;
+  int8_t      intBitPack;  // tsIntBitPack
+  int8_t      tsBitPack;   // tsTimestampBitPack
+  int8_t      decimal;     // tsFloatDecimalPack
+  int8_t      dict;        // tsStringDictEncode
+  bool        lossy;       // lossyFloat and lossyDouble, TSZ
+  bool        zstdDict;    // zstd with a dictionary trained on the values of the column
+} SBenchCodec;
+
+// The rows of a column as tsdb holds them, var data types packed one after the other
+typedef struct {
+  char    name[64];
+  int8_t  type;
+  int32_t rows;
+  int32_t size;
+  char   *data;
+  int32_t *offsets;  // of each row and of the end of the data, var data types only
+} SBenchColumn;
+
+typedef struct {
+  int32_t rows;
+  int32_t blockRows;
+  int32_t loops;
+  bool    json;
+  int32_t results;  // printed so far
+} SBenchOpt;
+
+static SBenchCodec benchCodecs[] = {
+    {"simple8b", BENCH_KIND_INT, 0, 1, 1, 1, false},
+    {"bitpack", BENCH_KIND_INT, 1, 1, 1, 1, false},
+    {"bool", BENCH_KIND_BOOL, 1, 1, 1, 1, false},
+    {"delta-of-delta", BENCH_KIND_TS, 1, 0, 1, 1, false},
+    {"ts-bitpack", BENCH_KIND_TS, 1, 1, 1, 1, false},
+    {"xor", BENCH_KIND_FLOAT, 1, 1, 0, 1, false},
+    {"decimal", BENCH_KIND_FLOAT, 1, 1, 1, 1, false},
+#ifdef TD_TSZ
+    {"tsz", BENCH_KIND_FLOAT, 1, 1, 1, 1, true},
+#endif
+    {"lz4", BENCH_KIND_STR, 1, 1, 1, 0, false},
+    {"dict", BENCH_KIND_STR, 1, 1, 1, 1, false},
+#ifdef TD_TSZ
+    {"zstd-dict", BENCH_KIND_STR, 1, 1, 1, 0, false, true},
+#endif
+};
+
+static uint32_t benchDictId = 0;  // of the zstd-dict codec, trained for each column
+
+static const char *benchStatus[] = {"running", "stopped", "error", "starting", "maintenance", "idle", "offline", "ok"};
+
+static int8_t benchKindOf(int8_t type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+      return BENCH_KIND_BOOL;
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      return BENCH_KIND_TS;
+    case TSDB_DATA_TYPE_FLOAT:
+    case TSDB_DATA_TYPE_DOUBLE:
+      return BENCH_KIND_FLOAT;
+    case TSDB_DATA_TYPE_BINARY:
+      return BENCH_KIND_STR;
+    default:
+      return BENCH_KIND_INT;
+  }
+}
+
+static int8_t benchParseType(const char *name) {
+  int8_t types[] = {TSDB_DATA_TYPE_BOOL,  TSDB_DATA_TYPE_TINYINT, TSDB_DATA_TYPE_SMALLINT,  TSDB_DATA_TYPE_INT,
+                    TSDB_DATA_TYPE_BIGINT, TSDB_DATA_TYPE_FLOAT,   TSDB_DATA_TYPE_DOUBLE,    TSDB_DATA_TYPE_BINARY,
+                    TSDB_DATA_TYPE_TIMESTAMP, TSDB_DATA_TYPE_UTINYINT, TSDB_DATA_TYPE_USMALLINT, TSDB_DATA_TYPE_UINT,
+                    TSDB_DATA_TYPE_UBIGINT};
+
+  for (int i = 0; i < tListLen(types); i++) {
+    if (strcasecmp(name, tDataTypes[types[i]].name) == 0) return types[i];
+  }
+  return TSDB_DATA_TYPE_NULL;
+}
+
+static int benchInitColumn(SBenchColumn *pCol, const char *name, int8_t type, int32_t rows, int32_t size) {
+  memset(pCol, 0, sizeof(SBenchColumn));
+  tstrncpy(pCol->name, name, sizeof(pCol->name));
+  pCol->type = type;
+  pCol->rows = rows;
+  pCol->size = size;
+  pCol->data = calloc(1, size);
+  if (IS_VAR_DATA_TYPE(type)) pCol->offsets = calloc(rows + 1, sizeof(int32_t));
+
+  return (pCol->data == NULL || (IS_VAR_DATA_TYPE(type) && pCol->offsets == NULL)) ? -1 : 0;
+}
+
+static void benchFreeColumn(SBenchColumn *pCol) {
+  tfree(pCol->data);
+  tfree(pCol->offsets);
+}
+
+// The position of row in the column and the bytes of the rows [row, row + rows)
+static int32_t benchRowsPos(SBenchColumn *pCol, int32_t row, int32_t rows, int32_t *size) {
+  if (pCol->offsets == NULL) {
+    *size = rows * tDataTypes[pCol->type].bytes;
+    return row * tDataTypes[pCol->type].bytes;
+  }
+
+  *size = pCol->offsets[row + rows] - pCol->offsets[row];
+  return pCol->offsets[row];
+}
+
+//
+//  synthetic columns
+//
+static int benchGenRandomWalk(SBenchColumn *pCol, int8_t type, int32_t rows) {
+  int32_t bytes = tDataTypes[type].bytes;
+  int64_t lo = (type == TSDB_DATA_TYPE_TINYINT) ? INT8_MIN + 1 : ((type == TSDB_DATA_TYPE_SMALLINT) ? INT16_MIN + 1 : -1000000);
+  int64_t hi = (type == TSDB_DATA_TYPE_TINYINT) ? INT8_MAX : ((type == TSDB_DATA_TYPE_SMALLINT) ? INT16_MAX : 1000000);
+  int64_t v = 0;
+
+  char name[64];
+  snprintf(name, sizeof(name), "random-walk-%s", tDataTypes[type].name);
+  if (benchInitColumn(pCol, name, type, rows, rows * bytes) < 0) return -1;
+
+  for (int32_t i = 0; i < rows; i++) {
+    char *p = pCol->data + i * bytes;
+
+    v += rand() % 7 - 3;
+    v = MAX(v, lo);
+    v = MIN(v, hi);
+    switch (type) {
+      case TSDB_DATA_TYPE_TINYINT:  *(int8_t *)p = (int8_t)v; break;
+      case TSDB_DATA_TYPE_SMALLINT: *(int16_t *)p = (int16_t)v; break;
+      case TSDB_DATA_TYPE_INT:      *(int32_t *)p = (int32_t)v; break;
+      case TSDB_DATA_TYPE_BIGINT:   *(int64_t *)p = v; break;
+      case TSDB_DATA_TYPE_FLOAT:    *(float *)p = (float)(v / 100.0); break;  // a reading of two decimals
+      case TSDB_DATA_TYPE_DOUBLE:   *(double *)p = v / 100.0; break;
+      default: break;
+    }
+  }
+
+  return 0;
+}
+
+static int benchGenTimestamp(SBenchColumn *pCol, int32_t rows, bool jitter) {
+  if (benchInitColumn(pCol, jitter ? "jitter-ts" : "regular-ts", TSDB_DATA_TYPE_TIMESTAMP, rows, rows * LONG_BYTES) < 0) {
+    return -1;
+  }
+
+  int64_t *ts = (int64_t *)pCol->data;
+  for (int32_t i = 0; i < rows; i++) {
+    ts[i] = 1600000000000L + i * 1000L + (jitter ? rand() % 7 : 0);
+  }
+
+  return 0;
+}
+
+static int benchGenStatus(SBenchColumn *pCol, int32_t rows) {
+  if (benchInitColumn(pCol, "low-card-str", TSDB_DATA_TYPE_BINARY, rows, rows * BENCH_STR_BYTES) < 0) return -1;
+
+  int32_t pos = 0;
+  for (int32_t i = 0; i < rows; i++) {
+    const char *v = benchStatus[(rand() % 20 == 0) ? rand() % tListLen(benchStatus) : 0];
+
+    pCol->offsets[i] = pos;
+    varDataSetLen(pCol->data + pos, strlen(v));
+    memcpy(varDataVal(pCol->data + pos), v, strlen(v));
+    pos += varDataTLen(pCol->data + pos);
+  }
+  pCol->offsets[rows] = pos;
+  pCol->size = pos;
+
+  return 0;
+}
+
+static int benchGenFlags(SBenchColumn *pCol, int32_t rows) {
+  if (benchInitColumn(pCol, "flags", TSDB_DATA_TYPE_BOOL, rows, rows) < 0) return -1;
+
+  for (int32_t i = 0; i < rows; i++) {
+    pCol->data[i] = (rand() % 50 == 0) ? TSDB_DATA_BOOL_NULL : (rand() % 20 == 0);
+  }
+
+  return 0;
+}
+
+//
+//  a column dumped from real data, one value a line, the first field of a CSV line
+//
+static char *benchFirstField(char *line) {
+  line[strcspn(line, "\r\n")] = 0;
+
+  if (line[0] == '"' || line[0] == '\'') {
+    char *end = strchr(line + 1, line[0]);
+    if (end != NULL) *end = 0;
+    return line + 1;
+  }
+
+  line[strcspn(line, ",")] = 0;
+  return line;
+}
+
+static bool benchParseValue(char *str, int8_t type, char *p) {
+  char *end = NULL;
+
+  if (strcasecmp(str, "NULL") == 0) {
+    setNull(p, type, tDataTypes[type].bytes);
+    return true;
+  }
+
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+      *(int8_t *)p = (strcasecmp(str, "true") == 0 || strcmp(str, "1") == 0);
+      return strcasecmp(str, "true") == 0 || strcasecmp(str, "false") == 0 || strcmp(str, "1") == 0 ||
+             strcmp(str, "0") == 0;
+    case TSDB_DATA_TYPE_FLOAT:
+      *(float *)p = strtof(str, &end);
+      break;
+    case TSDB_DATA_TYPE_DOUBLE:
+      *(double *)p = strtod(str, &end);
+      break;
+    case TSDB_DATA_TYPE_TIMESTAMP: {
+      int64_t ts = strtoll(str, &end, 10);
+      if (*end != 0 && taosParseTime(str, &ts, (int32_t)strlen(str), TSDB_TIME_PRECISION_MILLI, 0) != 0) return false;
+      *(int64_t *)p = ts;
+      return true;
+    }
+    default: {
+      int64_t v = IS_UNSIGNED_NUMERIC_TYPE(type) ? (int64_t)strtoull(str, &end, 10) : strtoll(str, &end, 10);
+      memcpy(p, &v, tDataTypes[type].bytes);
+      break;
+    }
+  }
+
+  return end != str && *end == 0;
+}
+
+static int benchLoadFile(SBenchColumn *pCol, const char *file, int8_t type, bool header) {
+  FILE *fp = fopen(file, "r");
+  if (fp == NULL) {
+    fprintf(stderr, "failed to open %s since %s\n", file, strerror(errno));
+    return -1;
+  }
+
+  int32_t bytes = IS_VAR_DATA_TYPE(type) ? 0 : tDataTypes[type].bytes;
+  int32_t capacity = 1024, size = 0, rows = 0, skipped = 0;
+  char   *line = malloc(BENCH_LINE_LEN);
+
+  if (benchInitColumn(pCol, file, type, capacity, capacity * MAX(bytes, 64)) < 0) {
+    fclose(fp);
+    free(line);
+    return -1;
+  }
+
+  while (fgets(line, BENCH_LINE_LEN, fp) != NULL) {
+    if (header) {
+      header = false;
+      continue;
+    }
+
+    char   *str = benchFirstField(line);
+    int32_t len = IS_VAR_DATA_TYPE(type) ? VARSTR_HEADER_SIZE + (int32_t)strlen(str) : bytes;
+
+    if (rows + 1 >= capacity || size + len > pCol->size) {
+      capacity *= 2;
+      pCol->size = MAX(pCol->size * 2, size + len);
+      pCol->data = realloc(pCol->data, pCol->size);
+      if (pCol->offsets) pCol->offsets = realloc(pCol->offsets, (capacity + 1) * sizeof(int32_t));
+    }
+
+    char *p = pCol->data + size;
+    if (IS_VAR_DATA_TYPE(type)) {
+      pCol->offsets[rows] = size;
+      if (strcasecmp(str, "NULL") == 0) {
+        setVardataNull(p, type);
+      } else {
+        varDataSetLen(p, len - VARSTR_HEADER_SIZE);
+        memcpy(varDataVal(p), str, len - VARSTR_HEADER_SIZE);
+      }
+      len = varDataTLen(p);
+    } else if (!benchParseValue(str, type, p)) {
+      skipped++;
+      continue;
+    }
+
+    size += len;
+    rows++;
+  }
+
+  fclose(fp);
+  free(line);
+
+  if (pCol->offsets) pCol->offsets[rows] = size;
+  pCol->rows = rows;
+  pCol->size = size;
+
+  if (skipped > 0) fprintf(stderr, "%d lines of %s are skipped, they are not %s values\n", skipped, file, tDataTypes[type].name);
+  return (rows > 0) ? 0 : -1;
+}
+
+//
+//  run one codec with one stage or with LZ4 or zstd as the second stage over a column
+//
+static int benchCompareLatency(const void *a, const void *b) {
+  int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+  return (x < y) ? -1 : ((x > y) ? 1 : 0);
+}
+
+static double benchP99(int64_t *ns, int32_t n) {
+  qsort(ns, n, sizeof(int64_t), benchCompareLatency);
+  return ns[MIN((int32_t)(n * 0.99), n - 1)] / 1000.0;
+}
+
+static int benchCompressZstdDict(const char *const input, int inputSize, const int nelements, char *const output,
+                                 int outputSize, char algorithm, char *const buffer, int bufferSize) {
+  return tsCompressStringZstdImp(input, inputSize, output, outputSize, benchDictId);
+}
+
+// Trains the dictionary on the values of the first rows, each of them a sample
+static int benchTrainDict(SBenchColumn *pCol) {
+  int32_t rows = MIN(pCol->rows, BENCH_DICT_SAMPLES);
+  size_t *sizes = malloc(sizeof(size_t) * rows);
+  if (sizes == NULL) return -1;
+
+  for (int32_t i = 0; i < rows; i++) {
+    sizes[i] = pCol->offsets[i + 1] - pCol->offsets[i];
+  }
+
+  benchDictId = tsZstdTrainDict(pCol->data, sizes, rows, BENCH_DICT_BYTES);
+  free(sizes);
+
+  if (benchDictId == 0) {
+    fprintf(stderr, "failed to train zstd dictionary on %d rows of %s\n", rows, pCol->name);
+    return -1;
+  }
+  return 0;
+}
+
+static void benchApplyCodec(SBenchCodec *pCodec) {
+  tsIntBitPack = pCodec->intBitPack;
+  tsTimestampBitPack = pCodec->tsBitPack;
+  tsFloatDecimalPack = pCodec->decimal;
+  tsStringDictEncode = pCodec->dict;
+#ifdef TD_TSZ
+  lossyFloat = lossyDouble = pCodec->lossy;
+#endif
+}
+
+static void benchPrint(SBenchOpt *pOpt, SBenchColumn *pCol, SBenchCodec *pCodec, char algo, int64_t comp, double encMBs,
+                       double decMBs, double encP99, double decP99, bool lossless) {
+  const char *stage = (algo == ONE_STAGE_COMP) ? "one" : ((algo == TWO_STAGE_COMP) ? "two" : "two-zstd");
+  double      ratio = (double)pCol->size / MAX(comp, 1);
+
+  if (pOpt->json) {
+    printf("%s\n  {\"column\": \"%s\", \"type\": \"%s\", \"codec\": \"%s\", \"stage\": \"%s\", \"rows\": %d, "
+           "\"raw_bytes\": %d, \"comp_bytes\": %" PRId64 ", \"ratio\": %.3f, \"encode_mbps\": %.1f, "
+           "\"decode_mbps\": %.1f, \"encode_p99_us\": %.1f, \"decode_p99_us\": %.1f, \"lossless\": %s}",
+           (pOpt->results == 0) ? "[" : ",", pCol->name, tDataTypes[pCol->type].name, pCodec->name, stage, pCol->rows,
+           pCol->size, comp, ratio, encMBs, decMBs, encP99, decP99, lossless ? "true" : "false");
+  } else {
+    if (pOpt->results == 0) {
+      printf("column,type,codec,stage,rows,raw_bytes,comp_bytes,ratio,encode_mbps,decode_mbps,encode_p99_us,"
+             "decode_p99_us,lossless\n");
+    }
+    printf("%s,%s,%s,%s,%d,%d,%" PRId64 ",%.3f,%.1f,%.1f,%.1f,%.1f,%d\n", pCol->name, tDataTypes[pCol->type].name,
+           pCodec->name, stage, pCol->rows, pCol->size, comp, ratio, encMBs, decMBs, encP99, decP99, lossless);
+  }
+
+  pOpt->results++;
+}
+
+static int benchRun(SBenchOpt *pOpt, SBenchColumn *pCol, SBenchCodec *pCodec, char algo) {
+  int32_t nblocks = (pCol->rows + pOpt->blockRows - 1) / pOpt->blockRows;
+  int32_t maxBlockSize = 0;
+
+  for (int32_t b = 0; b < nblocks; b++) {
+    int32_t size = 0;
+    benchRowsPos(pCol, b * pOpt->blockRows, MIN(pOpt->blockRows, pCol->rows - b * pOpt->blockRows), &size);
+    maxBlockSize = MAX(maxBlockSize, size);
+  }
+
+  int32_t  bufLen = maxBlockSize + COMP_OVERFLOW_BYTES + 1024;
+  char    *comp = malloc((size_t)nblocks * bufLen);
+  char    *buf = malloc(bufLen);
+  char    *out = calloc(1, pCol->size + COMP_OVERFLOW_BYTES);
+  int32_t *lens = calloc(nblocks, sizeof(int32_t));
+  int64_t *encNs = malloc(sizeof(int64_t) * nblocks * pOpt->loops);
+  int64_t *decNs = malloc(sizeof(int64_t) * nblocks * pOpt->loops);
+  int64_t  encTotal = 0, decTotal = 0, compSize = 0;
+  int      code = 0;
+
+  int (*compFunc)(const char *const, int, const int, char *const, int, char, char *const, int) =
+      pCodec->zstdDict ? benchCompressZstdDict : tDataTypes[pCol->type].compFunc;
+
+  if (comp == NULL || buf == NULL || out == NULL || lens == NULL || encNs == NULL || decNs == NULL) {
+    fprintf(stderr, "out of memory\n");
+    code = -1;
+    goto _exit;
+  }
+
+  benchApplyCodec(pCodec);
+
+  for (int32_t l = 0; l < pOpt->loops; l++) {
+    for (int32_t b = 0; b < nblocks; b++) {
+      int32_t rows = MIN(pOpt->blockRows, pCol->rows - b * pOpt->blockRows);
+      int32_t size = 0;
+      int32_t pos = benchRowsPos(pCol, b * pOpt->blockRows, rows, &size);
+
+      int64_t st = taosGetTimestampNs();
+      lens[b] = (*compFunc)(pCol->data + pos, size, rows, comp + (int64_t)b * bufLen, bufLen, algo, buf, bufLen);
+      encNs[l * nblocks + b] = taosGetTimestampNs() - st;
+      encTotal += encNs[l * nblocks + b];
+
+      if (lens[b] <= 0) {
+        fprintf(stderr, "failed to compress block %d of %s with %s\n", b, pCol->name, pCodec->name);
+        code = -1;
+        goto _exit;
+      }
+    }
+  }
+
+  for (int32_t l = 0; l < pOpt->loops; l++) {
+    for (int32_t b = 0; b < nblocks; b++) {
+      int32_t rows = MIN(pOpt->blockRows, pCol->rows - b * pOpt->blockRows);
+      int32_t size = 0;
+      int32_t pos = benchRowsPos(pCol, b * pOpt->blockRows, rows, &size);
+
+      int64_t st = taosGetTimestampNs();
+      (*tDataTypes[pCol->type].decompFunc)(comp + (int64_t)b * bufLen, lens[b], rows, out + pos,
+                                           size + COMP_OVERFLOW_BYTES, algo, buf, bufLen);
+      decNs[l * nblocks + b] = taosGetTimestampNs() - st;
+      decTotal += decNs[l * nblocks + b];
+    }
+  }
+
+  for (int32_t b = 0; b < nblocks; b++) {
+    compSize += lens[b];
+  }
+
+  double mb = (double)pCol->size * pOpt->loops / 1024 / 1024;
+  benchPrint(pOpt, pCol, pCodec, algo, compSize, mb * 1e9 / MAX(encTotal, 1), mb * 1e9 / MAX(decTotal, 1),
+             benchP99(encNs, nblocks * pOpt->loops), benchP99(decNs, nblocks * pOpt->loops),
+             memcmp(out, pCol->data, pCol->size) == 0);
+
+_exit:
+  free(comp);
+  free(buf);
+  free(out);
+  free(lens);
+  free(encNs);
+  free(decNs);
+  return code;
+}
+
+static int benchColumn(SBenchOpt *pOpt, SBenchColumn *pCol) {
+  for (int i = 0; i < tListLen(benchCodecs); i++) {
+    if (benchCodecs[i].kind != benchKindOf(pCol->type)) continue;
+
+    // the dictionary is only used by zstd, as the second stage
+    if (benchCodecs[i].zstdDict) {
+      if (benchTrainDict(pCol) == 0 && benchRun(pOpt, pCol, &benchCodecs[i], TWO_STAGE_COMP_ZSTD) < 0) return -1;
+      continue;
+    }
+
+    for (char algo = ONE_STAGE_COMP; algo <= TWO_STAGE_COMP_ZSTD; algo++) {
+      if (benchRun(pOpt, pCol, &benchCodecs[i], algo) < 0) return -1;
+    }
+  }
+
+  return 0;
+}
+
+static void benchUsage() {
+  printf("usage: taospack -bench [-rows n] [-block n] [-loops n] [-level n] [-json] [-file csv -type type [-header]]\n"
+         "  -rows    rows of each synthetic column, default %d\n"
+         "  -block   rows of a block, as the maxRows of a database, default %d\n"
+         "  -loops   times each block is compressed and decompressed, default %d\n"
+         "  -level   zstd compression level, as zstdLevel, default %d\n"
+         "  -json    print the results as JSON instead of CSV\n"
+         "  -file    a column dumped with \"select col from tb >> file\", one value a line, instead of the\n"
+         "           synthetic columns\n"
+         "  -type    the type of the column in the file: bool, tinyint, smallint, int, bigint, float, double,\n"
+         "           binary, timestamp or an unsigned one\n"
+         "  -header  the first line of the file is the column name\n",
+         BENCH_DEFAULT_ROWS, BENCH_DEFAULT_BLOCK, BENCH_DEFAULT_LOOPS, TSDB_DEFAULT_ZSTD_LEVEL);
+}
+
+int codecBench(int argc, char *argv[]) {
+  SBenchOpt   opt = {.rows = BENCH_DEFAULT_ROWS, .blockRows = BENCH_DEFAULT_BLOCK, .loops = BENCH_DEFAULT_LOOPS};
+  const char *file = NULL;
+  int8_t      type = TSDB_DATA_TYPE_NULL;
+  bool        header = false;
+  int         code = 0;
+
+  for (int i = 0; i < argc; i++) {
+    bool hasValue = (i + 1 < argc);
+    if (strcmp(argv[i], "-rows") == 0 && hasValue) {
+      opt.rows = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-block") == 0 && hasValue) {
+      opt.blockRows = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-loops") == 0 && hasValue) {
+      opt.loops = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-level") == 0 && hasValue) {
+      tsZstdLevel = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-json") == 0) {
+      opt.json = true;
+    } else if (strcmp(argv[i], "-file") == 0 && hasValue) {
+      file = argv[++i];
+    } else if (strcmp(argv[i], "-type") == 0 && hasValue) {
+      type = benchParseType(argv[++i]);
+    } else if (strcmp(argv[i], "-header") == 0) {
+      header = true;
+    } else {
+      benchUsage();
+      return -1;
+    }
+  }
+
+  if (opt.rows <= 0 || opt.blockRows < TSDB_MIN_MAX_ROW_FBLOCK || opt.blockRows > TSDB_MAX_MAX_ROW_FBLOCK ||
+      opt.loops <= 0 || tsZstdLevel < TSDB_MIN_ZSTD_LEVEL || tsZstdLevel > TSDB_MAX_ZSTD_LEVEL || (file != NULL && type == TSDB_DATA_TYPE_NULL)) {
+    benchUsage();
+    return -1;
+  }
+
+  SBenchCodec saved = {"saved", 0, tsIntBitPack, tsTimestampBitPack, tsFloatDecimalPack, tsStringDictEncode, false};
+  SBenchColumn col;
+
+#ifdef TD_TSZ
+  // the lossy codec compresses the float and double columns
+  strcpy(lossyColumns, "float|double");
+  tsCompressInit();
+#endif
+
+  srand(0);
+  if (file != NULL) {
+    code = benchLoadFile(&col, file, type, header);
+    if (code == 0) code = benchColumn(&opt, &col);
+    benchFreeColumn(&col);
+  } else {
+    int8_t walkTypes[] = {TSDB_DATA_TYPE_TINYINT, TSDB_DATA_TYPE_SMALLINT, TSDB_DATA_TYPE_INT,
+                          TSDB_DATA_TYPE_BIGINT,  TSDB_DATA_TYPE_FLOAT,    TSDB_DATA_TYPE_DOUBLE};
+
+    for (int i = 0; i < tListLen(walkTypes) + 4 && code == 0; i++) {
+      if (i < tListLen(walkTypes)) {
+        code = benchGenRandomWalk(&col, walkTypes[i], opt.rows);
+      } else if (i < tListLen(walkTypes) + 2) {
+        code = benchGenTimestamp(&col, opt.rows, i == tListLen(walkTypes) + 1);
+      } else if (i == tListLen(walkTypes) + 2) {
+        code = benchGenStatus(&col, opt.rows);
+      } else {
+        code = benchGenFlags(&col, opt.rows);
+      }
+
+      if (code == 0) code = benchColumn(&opt, &col);
+      benchFreeColumn(&col);
+    }
+  }
+
+  if (opt.json && opt.results > 0) printf("\n]\n");
+
+  benchApplyCodec(&saved);
+#ifdef TD_TSZ
+  tsCompressExit();
+#endif
+  return code;
+}
+
+#endif
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_CODEC_BENCH_H
+#define TDENGINE_CODEC_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Benchmark of the column codecs, run by "taospack -bench [options]".
+ *
+ * Every codec of tcompression.c runs with one stage and with LZ4 or zstd as the second stage over synthetic columns, or
+ * over a column dumped from real data with "select col from tb >> file.csv", compressed block by block as tsdb does. Each run reports the
+ * compression ratio, the encode and decode throughput and the 99th percentile latency of one block, as CSV or JSON.
+ */
+int codecBench(int argc, char *argv[]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_CODEC_BENCH_H
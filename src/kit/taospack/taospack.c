@@ -17,6 +17,8 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include "codecBench.h"
 
 
 #if defined(WINDOWS) 
@@ -25,6 +27,9 @@ int main(int argc, char *argv[]) {
 }
 #elif !defined(TD_TSZ) 
 int main(int argc, char *argv[]) {
+  if (argc >= 2 && strcmp(argv[1], "-bench") == 0) {
+    return codecBench(argc - 2, argv + 2);
+  }
   printf(" welcome taospack. \n You not open TSZ , please define TD_TSZ to open TSZ algo.\n");
 }
 #else
@@ -32,6 +37,7 @@ int main(int argc, char *argv[]) {
 #include "os.h"
 #include "tscompression.h"
 #include "tdataformat.h"
+#include "tglobal.h"
 
 
 
@@ -341,6 +347,139 @@ bool testFile(const char* inFile, char algorithm, bool lossy){
   free(floats);
   return true;
 }
+//
+//  read double
+//
+double* read_double(const char* inFile, int* pcount){
+  FILE* pfin =  fopen(inFile, "r");
+  if(pfin == NULL){
+    printf(" open IN file %s error. errno=%d\n", inFile, errno);
+    return NULL;
+  }
+
+  char buf[256]={0};
+  int  malloc_cnt = 100000;
+  double* doubles = malloc(malloc_cnt*sizeof(double));
+  int  fi = 0;
+  while(doubles && fgets(buf, sizeof(buf), pfin) != NULL) {
+    if(buf[0] == 0 || strcmp(buf, " ") == 0)
+        continue;
+    doubles[fi] = atof(buf);
+    if ( ++fi == malloc_cnt ) {
+      malloc_cnt += 100000;
+      double* doubles1 = realloc(doubles, malloc_cnt*sizeof(double));
+      if(doubles1 == NULL)
+         break;
+      doubles = doubles1;
+    }
+    memset(buf, 0, sizeof(buf));
+  }
+
+  fclose(pfin);
+  if(pcount)
+    *pcount = fi;
+  return doubles;
+}
+
+//
+//  compare the float codecs on the values of a file, compressed block by block as tsdb does
+//
+#define CMP_BLOCK_ROWS 4096
+#define CMP_LOOPS      10
+
+typedef struct {
+  const char* name;
+  int8_t      decimal;  // floatDecimalPack
+  bool        lossy;
+} SCodec;
+
+void compareCodec(const char* input, int cnt, int bytes, SCodec* codec){
+  int   bufLen = CMP_BLOCK_ROWS * bytes + COMP_OVERFLOW_BYTES + 1024;
+  char* output = (char*) malloc(cnt * bytes + (cnt / CMP_BLOCK_ROWS + 1) * bufLen);
+  char* buff = (char*) malloc(bufLen);
+  char* ft2 = (char*) malloc(cnt * bytes);
+  int*  lens = (int*) malloc((cnt / CMP_BLOCK_ROWS + 1) * sizeof(int));
+  int   nblocks = (cnt + CMP_BLOCK_ROWS - 1) / CMP_BLOCK_ROWS;
+  int   total = 0;
+
+  tsFloatDecimalPack = codec->decimal;
+  lossyFloat = lossyDouble = codec->lossy;
+
+  // compress
+  int64_t st = taosGetTimestampUs();
+  for(int l = 0; l < CMP_LOOPS; l++) {
+    char* out = output;
+    for(int b = 0; b < nblocks; b++) {
+      int rows = MIN(CMP_BLOCK_ROWS, cnt - b * CMP_BLOCK_ROWS);
+      const char* in = input + b * CMP_BLOCK_ROWS * bytes;
+      lens[b] = (bytes == sizeof(double))
+          ? tsCompressDouble(in, rows * bytes, rows, out, bufLen, TWO_STAGE_COMP, buff, bufLen)
+          : tsCompressFloat(in, rows * bytes, rows, out, bufLen, TWO_STAGE_COMP, buff, bufLen);
+      out += lens[b];
+    }
+    total = (int)(out - output);
+  }
+  int64_t use_us1 = taosGetTimestampUs() - st;
+
+  // decompress
+  st = taosGetTimestampUs();
+  for(int l = 0; l < CMP_LOOPS; l++) {
+    char* in = output;
+    for(int b = 0; b < nblocks; b++) {
+      int rows = MIN(CMP_BLOCK_ROWS, cnt - b * CMP_BLOCK_ROWS);
+      char* out = ft2 + b * CMP_BLOCK_ROWS * bytes;
+      if(bytes == sizeof(double))
+        tsDecompressDouble(in, lens[b], rows, out, rows * bytes, TWO_STAGE_COMP, buff, bufLen);
+      else
+        tsDecompressFloat(in, lens[b], rows, out, rows * bytes, TWO_STAGE_COMP, buff, bufLen);
+      in += lens[b];
+    }
+  }
+  int64_t use_us2 = taosGetTimestampUs() - st;
+
+  double mb = (double)cnt * bytes * CMP_LOOPS / 1024 / 1024;
+  printf("    %-8s  rate=%7.2f%%  compress=%8.1f MB/s  decompress=%8.1f MB/s  %s\n", codec->name,
+         100.0 * total / ((double)cnt * bytes), mb * 1000000 / MAX(use_us1, 1), mb * 1000000 / MAX(use_us2, 1),
+         memcmp(input, ft2, cnt * bytes) == 0 ? "lossless" : "lossy");
+
+  free(lens);
+  free(ft2);
+  free(buff);
+  free(output);
+}
+
+bool compareFile(const char* inFile, bool isDouble){
+  int cnt = 0;
+  double* doubles = read_double(inFile, &cnt);
+  if(doubles == NULL || cnt == 0) {
+    free(doubles);
+    return false;
+  }
+
+  float* floats = (float*) malloc(cnt * sizeof(float));
+  for(int i = 0; i < cnt; i++) {
+    floats[i] = (float)doubles[i];
+  }
+
+  SCodec codecs[] = {{"XOR", 0, false}, {"DECIMAL", 1, false}, {"SZ", 1, true}};
+  int8_t decimal = tsFloatDecimalPack;
+  printf("\n ------------------  %s count:%d block rows:%d ---------------- \n", isDouble ? "double" : "float", cnt,
+         CMP_BLOCK_ROWS);
+  for(int i = 0; i < tListLen(codecs); i++) {
+    if(isDouble)
+      compareCodec((const char*)doubles, cnt, sizeof(double), &codecs[i]);
+    else
+      compareCodec((const char*)floats, cnt, sizeof(float), &codecs[i]);
+  }
+  printf("\n");
+
+  tsFloatDecimalPack = decimal;
+  lossyFloat = lossyDouble = false;
+  free(floats);
+  free(doubles);
+  return true;
+}
+
 //
 //  txt to binary file
 //
@@ -743,6 +882,11 @@ extern char Compressor [];
 //   -----------------  main ----------------------
 //
 int main(int argc, char *argv[]) {
+  // the results go to stdout as CSV or JSON, nothing else may be printed there
+  if (argc >= 2 && strcmp(argv[1], "-bench") == 0) {
+    return codecBench(argc - 2, argv + 2);
+  }
+
   printf("welcome to use taospack tools v1.6\n");
 
   //printf(" sizeof(int)=%d\n",  (int)sizeof(int));
@@ -797,9 +941,17 @@ int main(int argc, char *argv[]) {
         test_same_double(atoi(argv[2]));
         return 0;
     }
+
+    // compare the XOR, decimal and SZ codecs on a file of one value per line
+    if(strcmp(argv[1], "-cmpf") == 0 || strcmp(argv[1], "-cmpd") == 0) {
+        bool ret = compareFile(argv[2], strcmp(argv[1], "-cmpd") == 0);
+        printf(" compare file %s. \n", ret ? "ok" : "err");
+        tsCompressExit();
+        return 0;
+    }
  
     if(algo == 0){
-      printf(" no param -tone -tw \n");
+      printf(" no param -tone -tw -cmpf -cmpd -bench \n");
       return 0;
     }
      
@@ -377,6 +377,8 @@ int32_t taosFsync(FileFd fd) {
   return FlushFileBuffers(h)-1;
 }
 
+int32_t taosReadAhead(FileFd fd, int64_t offset, int64_t count) { return 0; }
+
 int32_t taosRename(char *oldName, char *newName) {
   int32_t code = MoveFileEx(oldName, newName, MOVEFILE_REPLACE_EXISTING | MOVEFILE_COPY_ALLOWED);
   if (code < 0) {
@@ -393,6 +395,23 @@ int32_t taosRename(char *oldName, char *newName) {
 int32_t taosFtruncate(FileFd fd, int64_t length) { return ftruncate(fd, length); }
 int32_t taosFsync(FileFd fd) { return fsync(fd); }
 
+// Only a hint, the kernel reads the range into the page cache in the background
+int32_t taosReadAhead(FileFd fd, int64_t offset, int64_t count) {
+#if defined(_TD_DARWIN_64)
+  struct radvisory ra;
+  ra.ra_offset = (off_t)offset;
+  ra.ra_count = (int)count;
+  return fcntl(fd, F_RDADVISE, &ra);
+#else
+  int32_t code = posix_fadvise(fd, (off_t)offset, (off_t)count, POSIX_FADV_WILLNEED);
+  if (code != 0) {
+    errno = code;
+    return -1;
+  }
+  return 0;
+#endif
+}
+
 int32_t taosRename(char *oldName, char *newName) {
   int32_t code = rename(oldName, newName);
   if (code < 0) {
@@ -130,6 +130,10 @@ typedef enum {
   MON_CMD_CREATE_TB_GRANTS,
   MON_CMD_CREATE_MT_RESTFUL,
   MON_CMD_CREATE_TB_RESTFUL,
+  MON_CMD_CREATE_MT_TSDB_CACHE,
+  MON_CMD_CREATE_TB_TSDB_CACHE,
+  MON_CMD_CREATE_MT_QUERY_QUEUE,
+  MON_CMD_CREATE_TB_QUERY_QUEUE,
   MON_CMD_MAX
 } EMonCmd;
 
@@ -172,6 +176,8 @@ static void  monSaveClusterInfo();
 static void  monSaveDnodesInfo();
 static void  monSaveVgroupsInfo();
 static void  monSaveDisksInfo();
+static void  monSaveTsdbCacheInfo();
+static void  monSaveQueryQueueInfo();
 static void  monSaveGrantsInfo();
 static void  monSaveHttpReqInfo();
 static void  monGetSysStats();
@@ -321,6 +327,8 @@ static void *monThreadFunc(void *param) {
         }
         monSaveVgroupsInfo();
         monSaveDisksInfo();
+        monSaveTsdbCacheInfo();
+        monSaveQueryQueueInfo();
         monSaveGrantsInfo();
         monSaveHttpReqInfo();
         monSaveSystemInfo();
@@ -475,6 +483,27 @@ static void monBuildMonitorSql(char *sql, int32_t cmd) {
   } else if (cmd == MON_CMD_CREATE_TB_RESTFUL) {
     snprintf(sql, SQL_LENGTH, "create table if not exists %s.restful_%d using %s.restful_info tags(%d, '%s')", tsMonitorDbName,
              dnodeGetDnodeId(), tsMonitorDbName, dnodeGetDnodeId(), tsLocalEp);
+  } else if (cmd == MON_CMD_CREATE_MT_TSDB_CACHE) {
+    snprintf(sql, SQL_LENGTH,
+             "create table if not exists %s.tsdb_cache_info(ts timestamp"
+             ", blk_data_hit bigint, blk_data_miss bigint, blk_data_hit_rate float"
+             ") tags (dnode_id int, dnode_ep binary(%d))",
+             tsMonitorDbName, TSDB_EP_LEN);
+  } else if (cmd == MON_CMD_CREATE_TB_TSDB_CACHE) {
+    snprintf(sql, SQL_LENGTH, "create table if not exists %s.tsdb_cache_%d using %s.tsdb_cache_info tags(%d, '%s')",
+             tsMonitorDbName, dnodeGetDnodeId(), tsMonitorDbName, dnodeGetDnodeId(), tsLocalEp);
+  } else if (cmd == MON_CMD_CREATE_MT_QUERY_QUEUE) {
+    // the waits are those of the queue items: the first message of a batch query waits in the interactive queue, as
+    // its class is known only when it is processed, so interactive_* count it and batch_* only its later executions
+    snprintf(sql, SQL_LENGTH,
+             "create table if not exists %s.query_queue_info(ts timestamp"
+             ", interactive_num bigint, interactive_avg_wait_ms float, interactive_max_wait_ms float"
+             ", batch_num bigint, batch_avg_wait_ms float, batch_max_wait_ms float"
+             ") tags (dnode_id int, dnode_ep binary(%d))",
+             tsMonitorDbName, TSDB_EP_LEN);
+  } else if (cmd == MON_CMD_CREATE_TB_QUERY_QUEUE) {
+    snprintf(sql, SQL_LENGTH, "create table if not exists %s.query_queue_%d using %s.query_queue_info tags(%d, '%s')",
+             tsMonitorDbName, dnodeGetDnodeId(), tsMonitorDbName, dnodeGetDnodeId(), tsLocalEp);
   }
 
   sql[SQL_LENGTH] = 0;
@@ -1226,6 +1255,58 @@ static void monSaveDisksInfo() {
   }
 }
 
+static void monSaveTsdbCacheInfo() {
+  int64_t ts = taosGetTimestampUs();
+  char *  sql = tsMonitor.sql;
+  int64_t blkHit = tsMonStat.vInfo.blkCacheHit;
+  int64_t blkMiss = tsMonStat.vInfo.blkCacheMiss;
+  float   blkHitRate = (blkHit + blkMiss) > 0 ? (float)blkHit / (blkHit + blkMiss) : 0;
+
+  snprintf(sql, SQL_LENGTH, "insert into %s.tsdb_cache_%d values(%" PRId64 ", %" PRId64 ", %" PRId64 ", %f)",
+           tsMonitorDbName, dnodeGetDnodeId(), ts, blkHit, blkMiss, blkHitRate);
+
+  monDebug("save tsdb cache, sql:%s", sql);
+
+  void *res = taos_query(tsMonitor.conn, tsMonitor.sql);
+  int32_t code = taos_errno(res);
+  taos_free_result(res);
+
+  if (code != 0) {
+    monError("failed to save tsdb_cache_%d info, reason:%s, sql:%s", dnodeGetDnodeId(), tstrerror(code), tsMonitor.sql);
+  } else {
+    monIncSubmitReqCnt();
+    monDebug("successfully to save tsdb_cache_%d info, sql:%s", dnodeGetDnodeId(), tsMonitor.sql);
+  }
+}
+
+static void monSaveQueryQueueInfo() {
+  int64_t ts = taosGetTimestampUs();
+  char *  sql = tsMonitor.sql;
+  int32_t pos = snprintf(sql, SQL_LENGTH, "insert into %s.query_queue_%d values(%" PRId64, tsMonitorDbName,
+                         dnodeGetDnodeId(), ts);
+
+  SVnodeStatisInfo *pInfo = &tsMonStat.vInfo;
+  for (int32_t i = 0; i < TSDB_QUERY_CLASS_NUM; ++i) {
+    float avgWaitMs = pInfo->queryNum[i] > 0 ? (float)pInfo->queryWaitUs[i] / pInfo->queryNum[i] / 1000 : 0;
+    pos += snprintf(sql + pos, SQL_LENGTH - pos, ", %" PRId64 ", %f, %f", pInfo->queryNum[i], avgWaitMs,
+                    (float)pInfo->queryMaxWaitUs[i] / 1000);
+  }
+  snprintf(sql + pos, SQL_LENGTH - pos, ")");
+
+  monDebug("save query queue, sql:%s", sql);
+
+  void *res = taos_query(tsMonitor.conn, tsMonitor.sql);
+  int32_t code = taos_errno(res);
+  taos_free_result(res);
+
+  if (code != 0) {
+    monError("failed to save query_queue_%d info, reason:%s, sql:%s", dnodeGetDnodeId(), tstrerror(code), tsMonitor.sql);
+  } else {
+    monIncSubmitReqCnt();
+    monDebug("successfully to save query_queue_%d info, sql:%s", dnodeGetDnodeId(), tsMonitor.sql);
+  }
+}
+
 static void monSaveGrantsInfo() {
   int64_t ts = taosGetTimestampUs();
   char *  sql = tsMonitor.sql;
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_QAGGKERNEL_H
+#define TDENGINE_QAGGKERNEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "os.h"
+
+/*
+ * Type-specialized loops of sum, avg, min, max and count over the column of one block. Nulls are sentinel values, so
+ * hasNull is checked once per block: without nulls a kernel is a plain reduction, with nulls the sentinels are
+ * masked out without branches. Every kernel returns the number of values that are not null.
+ */
+typedef struct SAggKernel {
+  // adds to the int64_t, uint64_t or double sum of the signed, unsigned or float type
+  int32_t (*sum)(const void *pData, int32_t numOfRows, bool hasNull, void *pSum);
+
+  // adds to the sum of avg, which is always a double
+  int32_t (*avg)(const void *pData, int32_t numOfRows, bool hasNull, double *pSum);
+
+  // updates pOutput, of the type of the column, as min_function and max_function do row by row: max takes the first
+  // row of a greater value, min the last row of a value not greater. pIndex is that row, or -1 if pOutput is kept
+  int32_t (*minMax)(const void *pData, int32_t numOfRows, bool hasNull, bool isMin, void *pOutput, int32_t *pIndex);
+
+  int32_t (*count)(const void *pData, int32_t numOfRows);
+} SAggKernel;
+
+/**
+ * The kernels of a numeric, bool or timestamp type, built for avx2 when the CPU supports it. Functions a type does not
+ * have are NULL, and so is the result for other types.
+ */
+const SAggKernel *aggGetKernel(int32_t type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_QAGGKERNEL_H
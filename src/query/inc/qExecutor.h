@@ -20,6 +20,7 @@
 #include "hash.h"
 #include "qAggMain.h"
 #include "qFill.h"
+#include "qGroupbyHash.h"
 #include "qResultbuf.h"
 #include "qSqlparser.h"
 #include "qTableMeta.h"
@@ -118,12 +119,25 @@ typedef struct SRspResultInfo {
   int32_t threshold;  // result size threshold in rows.
 } SRspResultInfo;
 
+/**
+ * The windows of a fixed interval start at skey + n * sliding, so the result row of a window is found by its number
+ * instead of through the result row hash tables.
+ */
+typedef struct SWindowIndex {
+  TSKEY     skey;        // start key of the window in the first slot
+  int64_t   sliding;
+  uint64_t  groupId;
+  int32_t   numOfSlots;
+  int32_t  *pos;         // index of the window in pResult, -1 if the window has no result row
+} SWindowIndex;
+
 typedef struct SResultRowInfo {
   SResultRow** pResult;    // result list
   int16_t      type:8;     // data type for hash key
   int32_t      size:24;    // number of result set
   int32_t      capacity;   // max capacity
   int32_t      curPos;     // current active result row index of pResult list
+  SWindowIndex *pWindowIndex;  // the windows are kept in the result row hash tables if it is NULL
 } SResultRowInfo;
 
 typedef struct SColumnFilterElem {
@@ -331,6 +345,7 @@ typedef struct SQueryRuntimeEnv {
   bool                  udfIsCopy;
   SHashObj             *pTablesRead;    // record child tables already read rows by tid hash
   int32_t              cntTableReadOver; // read table over count  
+  SArray               *pFilterColList;  // columns of the filter, loaded before the other columns of a data block
 } SQueryRuntimeEnv;
 
 enum {
@@ -365,6 +380,7 @@ enum OPERATOR_TYPE_E {
   OP_TimeEvery         = 23,
   OP_AllMultiTableTimeInterval = 24,
   OP_Order             = 25,
+  OP_ParallelMerge     = 26,   // append the results of the other morsels of a super table query
 };
 
 typedef struct SOperatorInfo {
@@ -413,6 +429,11 @@ typedef struct SQInfo {
   int64_t          lastRetrieveTs; // last retrieve timestamp  
   char*            sql;         // query sql string
   SQueryCostInfo   summary;
+  struct SQInfo*   pParent;     // the query this one is a morsel of, it is killed together with its parent
+  int64_t          yieldTs;     // the scan stops before the next data block after this time, 0 if it never stops
+  bool             yielded;     // the last execution stopped at a yield point
+  int8_t           queryClass;  // TSDB_QUERY_CLASS_INTERACTIVE or TSDB_QUERY_CLASS_BATCH
+  size_t           queryBufTables;  // the tables whose query buffer is charged to the budgets of the dnode and the class
 } SQInfo;
 
 typedef struct SQueryParam {
@@ -559,8 +580,11 @@ typedef struct SGroupbyDataInfo {
 typedef struct SGroupbyOperatorInfo {
   SOptrBasicInfo binfo;
   SArray         *pGroupbyDataInfo;
-  int32_t        totalBytes;
-  char           *prevData;   // previous data buf
+  int32_t        totalBytes;  // length of the key of the group by columns, one slot of their length each
+  char           *prevData;   // key of the current run of rows, followed by the group index
+  SGroupbyHash   *pGroupHash; // result row of each key and group index
+  uint64_t       *pRowHash;   // hash of each row of the block
+  int32_t        rowHashSize;
 } SGroupbyOperatorInfo;
 
 typedef struct SSWindowOperatorInfo {
@@ -628,6 +652,28 @@ typedef struct SOrderOperatorInfo {
   SSDataBlock *pDataBlock;
 } SOrderOperatorInfo;
 
+typedef struct SQueryMorsel {
+  SQInfo      *pQInfo;
+  SSDataBlock *pBlock;    // the result block the morsel is paused at
+  bool         pending;   // pBlock is not returned yet
+  tsem_t      *finished;  // posted once the morsel has produced its first result block
+} SQueryMorsel;
+
+/*
+ * The upstream runs the first morsel of a super table query on the query worker thread, while the other morsels run
+ * on the parallel pool. The partial results of all the morsels are returned one after the other, they are merged with
+ * those of the other vnodes by the client.
+ */
+typedef struct SParallelMergeOperatorInfo {
+  SQueryMorsel *pMorsels;
+  int32_t       numOfMorsels;
+  int32_t       numOfLaunched;
+  int32_t       numOfFinished;
+  int32_t       current;  // the morsel whose results are returned
+  bool          upstreamDone;
+  tsem_t        finished;
+} SParallelMergeOperatorInfo;
+
 void appendUpstream(SOperatorInfo* p, SOperatorInfo* pUpstream);
 
 SOperatorInfo* createDataBlocksOptScanInfo(void* pTsdbQueryHandle, SQueryRuntimeEnv* pRuntimeEnv, int32_t repeatTime, int32_t reverseTime);
@@ -657,6 +703,7 @@ SOperatorInfo* createFilterOperatorInfo(SQueryRuntimeEnv* pRuntimeEnv, SOperator
 
 SOperatorInfo* createJoinOperatorInfo(SOperatorInfo** pUpstream, int32_t numOfUpstream, SSchema* pSchema, int32_t numOfOutput);
 SOperatorInfo* createOrderOperatorInfo(SQueryRuntimeEnv* pRuntimeEnv, SOperatorInfo* upstream, SExprInfo* pExpr, int32_t numOfOutput, SOrderVal* pOrderVal);
+SOperatorInfo* createParallelMergeOperatorInfo(SQueryRuntimeEnv* pRuntimeEnv, SOperatorInfo* upstream, SQInfo** pMorsels, int32_t numOfMorsels);
 
 SSDataBlock* doGlobalAggregate(void* param, bool* newgroup);
 SSDataBlock* doMultiwayMergeSort(void* param, bool* newgroup);
@@ -692,7 +739,8 @@ int32_t createQueryFilter(char *data, int32_t len, void** pFilters);
 
 SGroupbyExpr *createGroupbyExprFromMsg(SQueryTableMsg *pQueryMsg, SColIndex *pColIndex, int32_t *code);
 SQInfo *createQInfoImpl(SQueryTableMsg *pQueryMsg, SGroupbyExpr *pGroupbyExpr, SExprInfo *pExprs,
-                        SExprInfo *pSecExprs, STableGroupInfo *pTableGroupInfo, SColumnInfo* pTagCols, void* pFilters, int32_t vgId, char* sql, uint64_t qId, SUdfInfo* pUdfInfo);
+                        SExprInfo *pSecExprs, STableGroupInfo *pTableGroupInfo, SColumnInfo* pTagCols, void* pFilters, int32_t vgId, char* sql, uint64_t qId, SUdfInfo* pUdfInfo,
+                        int8_t queryClass);
 
 int32_t initQInfo(STsBufInfo* pTsBufInfo, void* tsdb, void* sourceOptr, SQInfo* pQInfo, SQueryParam* param, char* start,
                   int32_t prevResultLen, void* merger);
@@ -706,9 +754,12 @@ STableQueryInfo* createTmpTableQueryInfo(STimeWindow win);
 int32_t buildScalarExprFromMsg(SExprInfo * pExprInfo, void *pQueryMsg);
 
 bool isQueryKilled(SQInfo *pQInfo);
-int32_t checkForQueryBuf(size_t numOfTables);
+int32_t checkForQueryBuf(size_t numOfTables, int8_t queryClass);
+void releaseQueryBuf(size_t numOfTables, int8_t queryClass);
 bool checkNeedToCompressQueryCol(SQInfo *pQInfo);
 bool doBuildResCheck(SQInfo* pQInfo);
+bool canQueryYield(SQInfo* pQInfo);
+void setQueryYielded(SQInfo* pQInfo);
 void setQueryStatus(SQueryRuntimeEnv *pRuntimeEnv, int8_t status);
 
 bool onlyQueryTags(SQueryAttr* pQueryAttr);
@@ -727,6 +778,7 @@ void calculateOperatorProfResults(SQInfo* pQInfo);
 void queryCostStatis(SQInfo *pQInfo);
 
 void freeQInfo(SQInfo *pQInfo);
+int32_t getQueryParallelDegree(SQueryTableMsg *pQueryMsg, SQueryParam *param, uint32_t numOfTables);
 void freeQueryAttr(SQueryAttr *pQuery);
 
 int32_t getMaximumIdleDurationSec();
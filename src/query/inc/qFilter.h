@@ -22,6 +22,7 @@ extern "C" {
 
 #include "texpr.h"
 #include "hash.h"
+#include "tcompare.h"
 #include "tname.h"
 
 #define FILTER_DEFAULT_GROUP_SIZE 4
@@ -58,6 +59,21 @@ enum {
   RANGE_FLG_NULL    = 4,
 };
 
+enum {
+  FILTER_KERNEL_NONE = 0,
+  FILTER_KERNEL_RANGE,
+  FILTER_KERNEL_NOT_EQUAL,
+  FILTER_KERNEL_ISNULL,
+  FILTER_KERNEL_NOTNULL,
+};
+
+enum {
+  KERNEL_FLG_NO_LOW   = 1,
+  KERNEL_FLG_LOW_INC  = 2,
+  KERNEL_FLG_NO_HIGH  = 4,
+  KERNEL_FLG_HIGH_INC = 8,
+};
+
 enum {
   FI_OPTION_NO_REWRITE = 1,
   FI_OPTION_TIMESTAMP = 2,
@@ -106,6 +122,13 @@ typedef int32_t(*filter_desc_compare_func)(const void *, const void *);
 typedef bool(*filter_exec_func)(void *, int32_t, int8_t**, SDataStatis *, int16_t);
 typedef int32_t (*filer_get_col_from_id)(void *, int32_t, void **);
 typedef int32_t (*filer_get_col_from_name)(void *, int32_t, char*, void **);
+typedef int32_t (*filer_get_col_dict_from_id)(void *, int32_t, const uint8_t **);
+
+typedef union SFilterKernelVal {
+  int64_t  i;
+  uint64_t u;
+  double   d;
+} SFilterKernelVal;
 
 typedef struct SFilterRangeCompare {
   int64_t s;
@@ -212,8 +235,16 @@ typedef struct SFilterComUnit {
   uint8_t optr;
   int8_t func;
   int8_t rfunc;
+  int8_t kernel;     // FILTER_KERNEL_*, evaluate all rows of a numeric column at once
+  uint8_t kflag;     // KERNEL_FLG_*, only float bounds need them, integer bounds are always inclusive
+  SFilterKernelVal lo;
+  SFilterKernelVal hi;
+  const uint8_t *dictCodes;  // code of each row of a dictionary encoded binary or nchar column, NULL if none
+  SCompiledPattern *pattern; // the MATCH, NMATCH or LIKE pattern compiled for the whole query, NULL if none
 } SFilterComUnit;
 
+typedef void (*filter_kernel_func)(const SFilterComUnit *, int32_t, int8_t *);
+
 typedef struct SFilterPCtx {
   SHashObj *valHash;
   SHashObj *unitHash;
@@ -238,6 +269,10 @@ typedef struct SFilterInfo {
   uint32_t          blkGroupNum;
   uint32_t         *blkUnits;
   int8_t           *blkUnitRes;
+  bool              kernelAll;   // all units have a kernel
+  int32_t           kernelRows;
+  int8_t           *kernelRes;   // 2 * kernelRows, results of a group and of a unit
+  bool              dictAny;     // some units have the dictionary codes of the current block
   void             *pTable;
 
   SFilterPCtx       pctx;
@@ -328,7 +363,9 @@ typedef struct SFilterInfo {
 extern int32_t filterInitFromTree(tExprNode* tree, void **pinfo, uint32_t options);
 extern bool filterExecute(SFilterInfo *info, int32_t numOfRows, int8_t** p, SDataStatis *statis, int16_t numOfCols);
 extern int32_t filterSetColFieldData(SFilterInfo *info, void *param, filer_get_col_from_id fp);
+extern int32_t filterGetColIdList(SFilterInfo *info, SArray *colIdList);
 extern int32_t filterSetJsonColFieldData(SFilterInfo *info, void *param, filer_get_col_from_name fp);
+extern int32_t filterSetColFieldDict(SFilterInfo *info, void *param, filer_get_col_dict_from_id fp);
 extern int32_t filterGetTimeRange(SFilterInfo *info, STimeWindow *win);
 extern int32_t filterConverNcharColumns(SFilterInfo* pFilterInfo, int32_t rows, bool *gotNchar);
 extern int32_t filterFreeNcharColumns(SFilterInfo* pFilterInfo);
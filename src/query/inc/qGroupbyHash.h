@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_QGROUPBYHASH_H
+#define TDENGINE_QGROUPBYHASH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "os.h"
+
+/*
+ * The hash table of the groups of a group by query. Every key has the same length, the keys are stored one after the
+ * other in an arena and the table itself is an open addressing array of group numbers, so that looking a group up
+ * touches the slot, the hash of the group and its key.
+ */
+typedef struct SGroupbyHash SGroupbyHash;
+
+SGroupbyHash *groupbyHashCreate(int32_t keyLen);
+
+void groupbyHashDestroy(SGroupbyHash *pHash);
+
+int32_t groupbyHashGetSize(const SGroupbyHash *pHash);
+
+/**
+ * The value of the key, or NULL if the group is not there yet.
+ */
+void *groupbyHashGet(const SGroupbyHash *pHash, uint64_t hash, const char *key);
+
+/**
+ * Adds a group that is not in the table yet, returns TSDB_CODE_QRY_OUT_OF_MEMORY if it cannot grow.
+ */
+int32_t groupbyHashPut(SGroupbyHash *pHash, uint64_t hash, const char *key, void *pData);
+
+/**
+ * Mixes one group by column of a block into the hash of each row. The hashes are started from the same seed and the
+ * columns are mixed in the same order, so that equal keys get equal hashes.
+ */
+void groupbyHashColumn(const char *pData, int32_t type, int32_t bytes, int32_t numOfRows, uint64_t *hash);
+
+/**
+ * Writes the slot of the value in a key: a slot is as long as the column, var data is kept with its header and
+ * padded with zero, and -0.0 is stored as 0.0.
+ */
+void groupbyKeyColumn(char *pSlot, const char *val, int32_t type, int32_t bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_QGROUPBYHASH_H
@@ -50,6 +50,19 @@ void    resetResultRowInfo(SQueryRuntimeEnv* pRuntimeEnv, SResultRowInfo* pResul
 int32_t numOfClosedResultRows(SResultRowInfo* pResultRowInfo);
 void    closeAllResultRows(SResultRowInfo* pResultRowInfo);
 
+int32_t initWindowIndex(SResultRowInfo* pResultRowInfo, int64_t sliding, uint64_t groupId);
+void    destroyWindowIndex(SResultRowInfo* pResultRowInfo);
+int32_t getWindowIndexPos(SResultRowInfo* pResultRowInfo, TSKEY skey);
+int32_t putWindowIndexPos(SResultRowInfo* pResultRowInfo, TSKEY skey, int32_t pos);
+void    rebuildWindowIndex(SResultRowInfo* pResultRowInfo);
+
+/*
+ * Splits the tables of a super table query into morsels of about the same number of tables. The tables keep their
+ * order and their group, a morsel leaves out the groups it has no table of, and the references of the tables move
+ * from pGroupInfo to the morsels.
+ */
+int32_t splitTableGroupInfo(STableGroupInfo* pGroupInfo, int32_t numOfMorsels, STableGroupInfo* pMorsels);
+
 int32_t initResultRow(SResultRow *pResultRow);
 void    closeResultRow(SResultRowInfo* pResultRowInfo, int32_t slot);
 bool    isResultRowClosed(SResultRowInfo *pResultRowInfo, int32_t slot);
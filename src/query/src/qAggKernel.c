@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+#include "qAggKernel.h"
+#include "queryLog.h"
+#include "taosdef.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define AGG_KERNEL_AVX2
+#endif
+
+// Float reductions are not reordered by the compiler, they are spread over independent lanes that fill a vector
+#define AGG_LANES 8
+
+#define AGG_INT_KERNEL(_name, _type, _stype, _null, _tmin, _tmax, _attr)                                          \
+  static _attr int32_t aggSum##_name(const void *pData, int32_t numOfRows, bool hasNull, void *pSum) {           \
+    const _type *data = (const _type *)pData;                                                                     \
+    _stype       sum = 0;                                                                                         \
+    int32_t      num = numOfRows;                                                                                 \
+    if (hasNull) {                                                                                                \
+      num = 0;                                                                                                    \
+      for (int32_t i = 0; i < numOfRows; ++i) {                                                                   \
+        int32_t valid = (data[i] != (_type)(_null));                                                              \
+        sum += valid ? data[i] : 0;                                                                               \
+        num += valid;                                                                                             \
+      }                                                                                                           \
+    } else {                                                                                                      \
+      for (int32_t i = 0; i < numOfRows; ++i) sum += data[i];                                                     \
+    }                                                                                                             \
+    *(_stype *)pSum += sum;                                                                                       \
+    return num;                                                                                                   \
+  }                                                                                                               \
+                                                                                                                  \
+  static _attr int32_t aggMinMax##_name(const void *pData, int32_t numOfRows, bool hasNull, bool isMin,          \
+                                        void *pOutput, int32_t *pIndex) {                                        \
+    const _type *data = (const _type *)pData;                                                                     \
+    const _type  null = (_type)(_null);                                                                           \
+    _type        m = isMin ? (_tmax) : (_tmin);                                                                   \
+    int32_t      num = numOfRows, i = 0;                                                                          \
+    *pIndex = -1;                                                                                                 \
+    if (numOfRows <= 0) return 0;                                                                                 \
+    if (hasNull) {                                                                                                \
+      num = 0;                                                                                                    \
+      if (isMin) {                                                                                                \
+        for (i = 0; i < numOfRows; ++i) {                                                                         \
+          int32_t valid = (data[i] != null);                                                                      \
+          _type   v = valid ? data[i] : (_tmax);                                                                  \
+          m = (v < m) ? v : m;                                                                                    \
+          num += valid;                                                                                           \
+        }                                                                                                         \
+      } else {                                                                                                    \
+        for (i = 0; i < numOfRows; ++i) {                                                                         \
+          int32_t valid = (data[i] != null);                                                                      \
+          _type   v = valid ? data[i] : (_tmin);                                                                  \
+          m = (v > m) ? v : m;                                                                                    \
+          num += valid;                                                                                           \
+        }                                                                                                         \
+      }                                                                                                           \
+      if (num == 0) return 0;                                                                                     \
+    } else if (isMin) {                                                                                           \
+      for (i = 0; i < numOfRows; ++i) m = (data[i] < m) ? data[i] : m;                                            \
+    } else {                                                                                                      \
+      for (i = 0; i < numOfRows; ++i) m = (data[i] > m) ? data[i] : m;                                            \
+    }                                                                                                             \
+    if (isMin ? (m > *(_type *)pOutput) : !(*(_type *)pOutput < m)) return num;                                   \
+    if (isMin) {                                                                                                  \
+      for (i = numOfRows - 1; data[i] != m || (hasNull && data[i] == null); --i) {                                \
+      }                                                                                                           \
+    } else {                                                                                                      \
+      for (i = 0; data[i] != m || (hasNull && data[i] == null); ++i) {                                            \
+      }                                                                                                           \
+    }                                                                                                             \
+    *(_type *)pOutput = m;                                                                                        \
+    *pIndex = i;                                                                                                  \
+    return num;                                                                                                   \
+  }
+
+// Sums of integers narrower than 64 bits cannot overflow an int64 within a block, so avg adds them exactly once
+#define AGG_AVG_EXACT_KERNEL(_name, _stype, _attr)                                                                \
+  static _attr int32_t aggAvg##_name(const void *pData, int32_t numOfRows, bool hasNull, double *pSum) {         \
+    _stype  sum = 0;                                                                                              \
+    int32_t num = aggSum##_name(pData, numOfRows, hasNull, &sum);                                                 \
+    *pSum += (double)sum;                                                                                         \
+    return num;                                                                                                   \
+  }
+
+// The null of a float type is a NaN, it is told apart by its bits
+#define AGG_LANE_SUM_KERNEL(_fname, _type, _btype, _null, _attr)                                                  \
+  static _attr int32_t _fname(const void *pData, int32_t numOfRows, bool hasNull, double *pSum) {                \
+    const _type  *data = (const _type *)pData;                                                                    \
+    const _btype *bits = (const _btype *)pData;                                                                   \
+    double        lane[AGG_LANES] = {0};                                                                          \
+    int32_t       num = numOfRows, i = 0;                                                                         \
+    if (hasNull) {                                                                                                \
+      num = 0;                                                                                                    \
+      for (; i + AGG_LANES <= numOfRows; i += AGG_LANES) {                                                        \
+        for (int32_t j = 0; j < AGG_LANES; ++j) {                                                                 \
+          int32_t valid = (bits[i + j] != (_btype)(_null));                                                       \
+          lane[j] += valid ? (double)data[i + j] : 0;                                                             \
+          num += valid;                                                                                           \
+        }                                                                                                         \
+      }                                                                                                           \
+      for (; i < numOfRows; ++i) {                                                                                \
+        int32_t valid = (bits[i] != (_btype)(_null));                                                            \
+        lane[0] += valid ? (double)data[i] : 0;                                                                   \
+        num += valid;                                                                                             \
+      }                                                                                                           \
+    } else {                                                                                                      \
+      for (; i + AGG_LANES <= numOfRows; i += AGG_LANES) {                                                        \
+        for (int32_t j = 0; j < AGG_LANES; ++j) lane[j] += (double)data[i + j];                                   \
+      }                                                                                                           \
+      for (; i < numOfRows; ++i) lane[0] += (double)data[i];                                                      \
+    }                                                                                                             \
+    double sum = 0;                                                                                               \
+    for (int32_t j = 0; j < AGG_LANES; ++j) sum += lane[j];                                                       \
+    *pSum += sum;                                                                                                 \
+    return num;                                                                                                   \
+  }
+
+// A NaN never wins a comparison, so the null values drop out of the lanes by themselves
+#define AGG_FLT_KERNEL(_name, _type, _btype, _null, _attr)                                                        \
+  AGG_LANE_SUM_KERNEL(aggAvg##_name, _type, _btype, _null, _attr)                                                 \
+                                                                                                                  \
+  static _attr int32_t aggSum##_name(const void *pData, int32_t numOfRows, bool hasNull, void *pSum) {           \
+    return aggAvg##_name(pData, numOfRows, hasNull, (double *)pSum);                                              \
+  }                                                                                                               \
+                                                                                                                  \
+  static _attr int32_t aggMinMax##_name(const void *pData, int32_t numOfRows, bool hasNull, bool isMin,          \
+                                        void *pOutput, int32_t *pIndex) {                                        \
+    const _type  *data = (const _type *)pData;                                                                    \
+    const _btype *bits = (const _btype *)pData;                                                                   \
+    _type         lane[AGG_LANES];                                                                                \
+    int32_t       num = numOfRows, i = 0;                                                                         \
+    *pIndex = -1;                                                                                                 \
+    if (hasNull) {                                                                                                \
+      num = 0;                                                                                                    \
+      for (i = 0; i < numOfRows; ++i) num += (bits[i] != (_btype)(_null));                                        \
+    }                                                                                                             \
+    if (num == 0) return 0;                                                                                       \
+    for (int32_t j = 0; j < AGG_LANES; ++j) lane[j] = isMin ? (_type)INFINITY : (_type)-INFINITY;                 \
+    if (isMin) {                                                                                                  \
+      for (i = 0; i + AGG_LANES <= numOfRows; i += AGG_LANES) {                                                   \
+        for (int32_t j = 0; j < AGG_LANES; ++j) lane[j] = (data[i + j] < lane[j]) ? data[i + j] : lane[j];        \
+      }                                                                                                           \
+      for (; i < numOfRows; ++i) lane[0] = (data[i] < lane[0]) ? data[i] : lane[0];                               \
+    } else {                                                                                                      \
+      for (i = 0; i + AGG_LANES <= numOfRows; i += AGG_LANES) {                                                   \
+        for (int32_t j = 0; j < AGG_LANES; ++j) lane[j] = (data[i + j] > lane[j]) ? data[i + j] : lane[j];        \
+      }                                                                                                           \
+      for (; i < numOfRows; ++i) lane[0] = (data[i] > lane[0]) ? data[i] : lane[0];                               \
+    }                                                                                                             \
+    _type m = lane[0];                                                                                            \
+    if (isMin) {                                                                                                  \
+      for (int32_t j = 1; j < AGG_LANES; ++j) m = (lane[j] < m) ? lane[j] : m;                                    \
+      if (m > *(_type *)pOutput) return num;                                                                      \
+      for (i = numOfRows - 1; i >= 0 && data[i] != m; --i) {                                                      \
+      }                                                                                                           \
+    } else {                                                                                                      \
+      for (int32_t j = 1; j < AGG_LANES; ++j) m = (lane[j] > m) ? lane[j] : m;                                    \
+      if (!(*(_type *)pOutput < m)) return num;                                                                   \
+      for (i = 0; i < numOfRows && data[i] != m; ++i) {                                                           \
+      }                                                                                                           \
+    }                                                                                                             \
+    if (i < 0 || i >= numOfRows) return num;                                                                      \
+    *(_type *)pOutput = m;                                                                                        \
+    *pIndex = i;                                                                                                  \
+    return num;                                                                                                   \
+  }
+
+#define AGG_COUNT_KERNEL(_name, _btype, _null, _attr)                                                             \
+  static _attr int32_t aggCount##_name(const void *pData, int32_t numOfRows) {                                   \
+    const _btype *bits = (const _btype *)pData;                                                                   \
+    int32_t       num = 0;                                                                                        \
+    for (int32_t i = 0; i < numOfRows; ++i) num += (bits[i] != (_btype)(_null));                                  \
+    return num;                                                                                                   \
+  }
+
+#define AGG_KERNEL_ENTRY(_name) {aggSum##_name, aggAvg##_name, aggMinMax##_name, aggCount##_name}
+
+#define AGG_KERNELS(_sfx, _attr)                                                                                  \
+  AGG_INT_KERNEL(Int8##_sfx, int8_t, int64_t, TSDB_DATA_TINYINT_NULL, INT8_MIN, INT8_MAX, _attr)                  \
+  AGG_INT_KERNEL(Int16##_sfx, int16_t, int64_t, TSDB_DATA_SMALLINT_NULL, INT16_MIN, INT16_MAX, _attr)             \
+  AGG_INT_KERNEL(Int32##_sfx, int32_t, int64_t, TSDB_DATA_INT_NULL, INT32_MIN, INT32_MAX, _attr)                  \
+  AGG_INT_KERNEL(Int64##_sfx, int64_t, int64_t, TSDB_DATA_BIGINT_NULL, INT64_MIN, INT64_MAX, _attr)               \
+  AGG_INT_KERNEL(Uint8##_sfx, uint8_t, uint64_t, TSDB_DATA_UTINYINT_NULL, 0, UINT8_MAX, _attr)                    \
+  AGG_INT_KERNEL(Uint16##_sfx, uint16_t, uint64_t, TSDB_DATA_USMALLINT_NULL, 0, UINT16_MAX, _attr)                \
+  AGG_INT_KERNEL(Uint32##_sfx, uint32_t, uint64_t, TSDB_DATA_UINT_NULL, 0, UINT32_MAX, _attr)                     \
+  AGG_INT_KERNEL(Uint64##_sfx, uint64_t, uint64_t, TSDB_DATA_UBIGINT_NULL, 0, UINT64_MAX, _attr)                  \
+  AGG_AVG_EXACT_KERNEL(Int8##_sfx, int64_t, _attr)                                                                \
+  AGG_AVG_EXACT_KERNEL(Int16##_sfx, int64_t, _attr)                                                               \
+  AGG_AVG_EXACT_KERNEL(Int32##_sfx, int64_t, _attr)                                                               \
+  AGG_AVG_EXACT_KERNEL(Uint8##_sfx, uint64_t, _attr)                                                              \
+  AGG_AVG_EXACT_KERNEL(Uint16##_sfx, uint64_t, _attr)                                                             \
+  AGG_AVG_EXACT_KERNEL(Uint32##_sfx, uint64_t, _attr)                                                             \
+  AGG_LANE_SUM_KERNEL(aggAvgInt64##_sfx, int64_t, uint64_t, TSDB_DATA_BIGINT_NULL, _attr)                         \
+  AGG_LANE_SUM_KERNEL(aggAvgUint64##_sfx, uint64_t, uint64_t, TSDB_DATA_UBIGINT_NULL, _attr)                      \
+  AGG_FLT_KERNEL(Float##_sfx, float, uint32_t, TSDB_DATA_FLOAT_NULL, _attr)                                       \
+  AGG_FLT_KERNEL(Double##_sfx, double, uint64_t, TSDB_DATA_DOUBLE_NULL, _attr)                                    \
+  AGG_COUNT_KERNEL(Bool##_sfx, uint8_t, TSDB_DATA_BOOL_NULL, _attr)                                               \
+  AGG_COUNT_KERNEL(Int8##_sfx, uint8_t, TSDB_DATA_TINYINT_NULL, _attr)                                            \
+  AGG_COUNT_KERNEL(Int16##_sfx, uint16_t, TSDB_DATA_SMALLINT_NULL, _attr)                                         \
+  AGG_COUNT_KERNEL(Int32##_sfx, uint32_t, TSDB_DATA_INT_NULL, _attr)                                              \
+  AGG_COUNT_KERNEL(Int64##_sfx, uint64_t, TSDB_DATA_BIGINT_NULL, _attr)                                           \
+  AGG_COUNT_KERNEL(Uint8##_sfx, uint8_t, TSDB_DATA_UTINYINT_NULL, _attr)                                          \
+  AGG_COUNT_KERNEL(Uint16##_sfx, uint16_t, TSDB_DATA_USMALLINT_NULL, _attr)                                       \
+  AGG_COUNT_KERNEL(Uint32##_sfx, uint32_t, TSDB_DATA_UINT_NULL, _attr)                                            \
+  AGG_COUNT_KERNEL(Uint64##_sfx, uint64_t, TSDB_DATA_UBIGINT_NULL, _attr)                                         \
+  AGG_COUNT_KERNEL(Float##_sfx, uint32_t, TSDB_DATA_FLOAT_NULL, _attr)                                            \
+  AGG_COUNT_KERNEL(Double##_sfx, uint64_t, TSDB_DATA_DOUBLE_NULL, _attr)                                          \
+                                                                                                                  \
+  static SAggKernel gAggKernel##_sfx[TSDB_DATA_TYPE_UBIGINT + 1] = {                                              \
+      [TSDB_DATA_TYPE_BOOL] = {NULL, NULL, NULL, aggCountBool##_sfx},                                             \
+      [TSDB_DATA_TYPE_TINYINT] = AGG_KERNEL_ENTRY(Int8##_sfx),                                                    \
+      [TSDB_DATA_TYPE_SMALLINT] = AGG_KERNEL_ENTRY(Int16##_sfx),                                                  \
+      [TSDB_DATA_TYPE_INT] = AGG_KERNEL_ENTRY(Int32##_sfx),                                                       \
+      [TSDB_DATA_TYPE_BIGINT] = AGG_KERNEL_ENTRY(Int64##_sfx),                                                    \
+      [TSDB_DATA_TYPE_FLOAT] = AGG_KERNEL_ENTRY(Float##_sfx),                                                     \
+      [TSDB_DATA_TYPE_DOUBLE] = AGG_KERNEL_ENTRY(Double##_sfx),                                                   \
+      [TSDB_DATA_TYPE_TIMESTAMP] = {NULL, NULL, NULL, aggCountInt64##_sfx},                                       \
+      [TSDB_DATA_TYPE_UTINYINT] = AGG_KERNEL_ENTRY(Uint8##_sfx),                                                  \
+      [TSDB_DATA_TYPE_USMALLINT] = AGG_KERNEL_ENTRY(Uint16##_sfx),                                                \
+      [TSDB_DATA_TYPE_UINT] = AGG_KERNEL_ENTRY(Uint32##_sfx),                                                     \
+      [TSDB_DATA_TYPE_UBIGINT] = AGG_KERNEL_ENTRY(Uint64##_sfx),                                                  \
+  };
+
+AGG_KERNELS(Scalar, )
+#ifdef AGG_KERNEL_AVX2
+AGG_KERNELS(Avx2, __attribute__((target("avx2"))))
+#endif
+
+static SAggKernel    *gAggKernel = gAggKernelScalar;
+static pthread_once_t aggKernelInit = PTHREAD_ONCE_INIT;
+
+static void aggInitKernels(void) {
+#ifdef AGG_KERNEL_AVX2
+  if (__builtin_cpu_supports("avx2")) {
+    gAggKernel = gAggKernelAvx2;
+  }
+#endif
+  qDebug("aggregate kernels use %s", gAggKernel == gAggKernelScalar ? "scalar code" : "avx2");
+}
+
+const SAggKernel *aggGetKernel(int32_t type) {
+  pthread_once(&aggKernelInit, aggInitKernels);
+
+  if (type < 0 || type > TSDB_DATA_TYPE_UBIGINT || gAggKernel[type].count == NULL) {
+    return NULL;
+  }
+
+  return &gAggKernel[type];
+}
@@ -30,6 +30,7 @@
 #include "qUdf.h"
 #include "tcompare.h"
 #include "hashfunc.h"
+#include "qAggKernel.h"
 
 #define GET_INPUT_DATA_LIST(x) ((char *)((x)->pInput))
 #define GET_INPUT_DATA(x, y) (GET_INPUT_DATA_LIST(x) + (y) * (x)->inputBytes)
@@ -911,7 +912,10 @@ static void count_function(SQLFunctionCtx *pCtx) {
   if (pCtx->preAggVals.isSet) {
     numOfElem = pCtx->size - pCtx->preAggVals.statis.numOfNull;
   } else {
-    if (pCtx->hasNull) {
+    const SAggKernel *pKernel = aggGetKernel(pCtx->inputType);
+    if (pCtx->hasNull && pKernel != NULL) {
+      numOfElem = (*pKernel->count)(GET_INPUT_DATA_LIST(pCtx), pCtx->size);
+    } else if (pCtx->hasNull) {
       for (int32_t i = 0; i < pCtx->size; ++i) {
         char *val = GET_INPUT_DATA(pCtx, i);
         if (isNull(val, pCtx->inputType)) {
@@ -963,41 +967,6 @@ int32_t countRequired(SQLFunctionCtx *pCtx, STimeWindow* w, int32_t colId) {
 int32_t noDataRequired(SQLFunctionCtx *pCtx, STimeWindow* w, int32_t colId) {
   return BLK_DATA_NO_NEEDED;
 }
-#define LIST_ADD_N_DOUBLE_FLOAT(x, ctx, p, t, numOfElem, tsdbType)              \
-  do {                                                                \
-    t *d = (t *)(p);                                               \
-    for (int32_t i = 0; i < (ctx)->size; ++i) {                    \
-      if (((ctx)->hasNull) && isNull((char *)&(d)[i], tsdbType)) { \
-        continue;                                                  \
-      };                                                           \
-      SET_DOUBLE_VAL(&(x) , GET_DOUBLE_VAL(&(x)) + GET_FLOAT_VAL(&(d)[i]));                                               \
-      (numOfElem)++;                                               \
-    }                                                              \
-  } while(0)
-#define LIST_ADD_N_DOUBLE(x, ctx, p, t, numOfElem, tsdbType)              \
-  do {                                                                \
-    t *d = (t *)(p);                                               \
-    for (int32_t i = 0; i < (ctx)->size; ++i) {                    \
-      if (((ctx)->hasNull) && isNull((char *)&(d)[i], tsdbType)) { \
-        continue;                                                  \
-      };                                                           \
-      SET_DOUBLE_VAL(&(x) , (x) + (d)[i]);                                               \
-      (numOfElem)++;                                               \
-    }                                                              \
-  } while(0)
-
-#define LIST_ADD_N(x, ctx, p, t, numOfElem, tsdbType)              \
-  do {                                                                \
-    t *d = (t *)(p);                                               \
-    for (int32_t i = 0; i < (ctx)->size; ++i) {                    \
-      if (((ctx)->hasNull) && isNull((char *)&(d)[i], tsdbType)) { \
-        continue;                                                  \
-      };                                                           \
-      (x) += (d)[i];                                               \
-      (numOfElem)++;                                               \
-    }                                                              \
-  } while(0)
-
 #define UPDATE_DATA(ctx, left, right, num, sign, k) \
   do {                                              \
     if (((left) < (right)) ^ (sign)) {              \
@@ -1016,22 +985,6 @@ int32_t noDataRequired(SQLFunctionCtx *pCtx, STimeWindow* w, int32_t colId) {
     }                                                       \
   } while (0)
 
-#define LOOPCHECK_N(val, list, ctx, tsdbType, sign, num)          \
-  for (int32_t i = 0; i < ((ctx)->size); ++i) {                   \
-    if ((ctx)->hasNull && isNull((char *)&(list)[i], tsdbType)) { \
-      continue;                                                   \
-    }                                                             \
-    TSKEY key = (ctx)->ptsList != NULL? GET_TS_DATA(ctx, i):0;    \
-    UPDATE_DATA(ctx, val, (list)[i], num, sign, key);             \
-  }
-
-#define TYPED_LOOPCHECK_N(type, data, list, ctx, tsdbType, sign, notNullElems) \
-  do {                                                                         \
-    type *_data = (type *)data;                                                \
-    type *_list = (type *)list;                                                \
-    LOOPCHECK_N(*_data, _list, ctx, tsdbType, sign, notNullElems);             \
-  } while (0)
-
 static void do_sum(SQLFunctionCtx *pCtx) {
   int32_t notNullElems = 0;
 
@@ -1051,39 +1004,9 @@ static void do_sum(SQLFunctionCtx *pCtx) {
       SET_DOUBLE_VAL(retVal, *retVal + GET_DOUBLE_VAL((const char*)&(pCtx->preAggVals.statis.sum)));
     }
   } else {  // computing based on the true data block
-    void *pData = GET_INPUT_DATA_LIST(pCtx);
-    notNullElems = 0;
-
-    if (IS_SIGNED_NUMERIC_TYPE(pCtx->inputType)) {
-      int64_t *retVal = (int64_t *)pCtx->pOutput;
-
-      if (pCtx->inputType == TSDB_DATA_TYPE_TINYINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, int8_t, notNullElems, pCtx->inputType);
-      } else if (pCtx->inputType == TSDB_DATA_TYPE_SMALLINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, int16_t, notNullElems, pCtx->inputType);
-      } else if (pCtx->inputType == TSDB_DATA_TYPE_INT) {
-        LIST_ADD_N(*retVal, pCtx, pData, int32_t, notNullElems, pCtx->inputType);
-      } else if (pCtx->inputType == TSDB_DATA_TYPE_BIGINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, int64_t, notNullElems, pCtx->inputType);
-      }
-    } else if (IS_UNSIGNED_NUMERIC_TYPE(pCtx->inputType)) {
-      uint64_t *retVal = (uint64_t *)pCtx->pOutput;
-
-      if (pCtx->inputType == TSDB_DATA_TYPE_UTINYINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, uint8_t, notNullElems, pCtx->inputType);
-      } else if (pCtx->inputType == TSDB_DATA_TYPE_USMALLINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, uint16_t, notNullElems, pCtx->inputType);
-      } else if (pCtx->inputType == TSDB_DATA_TYPE_UINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, uint32_t, notNullElems, pCtx->inputType);
-      } else if (pCtx->inputType == TSDB_DATA_TYPE_UBIGINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, uint64_t, notNullElems, pCtx->inputType);
-      }
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_DOUBLE) {
-      double *retVal = (double *)pCtx->pOutput;
-      LIST_ADD_N_DOUBLE(*retVal, pCtx, pData, double, notNullElems, pCtx->inputType);
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_FLOAT) {
-      double *retVal = (double *)pCtx->pOutput;
-      LIST_ADD_N_DOUBLE_FLOAT(*retVal, pCtx, pData, float, notNullElems, pCtx->inputType);
+    const SAggKernel *pKernel = aggGetKernel(pCtx->inputType);
+    if (pKernel != NULL && pKernel->sum != NULL) {
+      notNullElems = (*pKernel->sum)(GET_INPUT_DATA_LIST(pCtx), pCtx->size, pCtx->hasNull, pCtx->pOutput);
     }
   }
 
@@ -1257,28 +1180,9 @@ static void avg_function(SQLFunctionCtx *pCtx) {
       *pVal += GET_DOUBLE_VAL((const char *)&(pCtx->preAggVals.statis.sum));
     }
   } else {
-    void *pData = GET_INPUT_DATA_LIST(pCtx);
-
-    if (pCtx->inputType == TSDB_DATA_TYPE_TINYINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, int8_t, notNullElems, pCtx->inputType);
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_SMALLINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, int16_t, notNullElems, pCtx->inputType);
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_INT) {
-      LIST_ADD_N(*pVal, pCtx, pData, int32_t, notNullElems, pCtx->inputType);
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_BIGINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, int64_t, notNullElems, pCtx->inputType);
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_DOUBLE) {
-      LIST_ADD_N_DOUBLE(*pVal, pCtx, pData, double, notNullElems, pCtx->inputType);
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_FLOAT) {
-      LIST_ADD_N_DOUBLE_FLOAT(*pVal, pCtx, pData, float, notNullElems, pCtx->inputType);
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_UTINYINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, uint8_t, notNullElems, pCtx->inputType);
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_USMALLINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, uint16_t, notNullElems, pCtx->inputType);
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_UINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, uint32_t, notNullElems, pCtx->inputType);
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_UBIGINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, uint64_t, notNullElems, pCtx->inputType);
+    const SAggKernel *pKernel = aggGetKernel(pCtx->inputType);
+    if (pKernel != NULL && pKernel->avg != NULL) {
+      notNullElems = (*pKernel->avg)(GET_INPUT_DATA_LIST(pCtx), pCtx->size, pCtx->hasNull, pVal);
     }
   }
 
@@ -1452,54 +1356,19 @@ static void minMax_function(SQLFunctionCtx *pCtx, char *pOutput, int32_t isMin,
     return;
   }
 
-  void  *p = GET_INPUT_DATA_LIST(pCtx);
-  TSKEY *tsList = GET_TS_LIST(pCtx);
+  // the tag columns take the row of the new min or max, once per block instead of at every row that improves it
+  const SAggKernel *pKernel = aggGetKernel(pCtx->inputType);
+  int32_t           index = -1;
 
   *notNullElems = 0;
+  if (pKernel == NULL || pKernel->minMax == NULL) {
+    return;
+  }
 
-  if (IS_SIGNED_NUMERIC_TYPE(pCtx->inputType)) {
-    if (pCtx->inputType == TSDB_DATA_TYPE_TINYINT) {
-      TYPED_LOOPCHECK_N(int8_t, pOutput, p, pCtx, pCtx->inputType, isMin, *notNullElems);
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_SMALLINT) {
-      TYPED_LOOPCHECK_N(int16_t, pOutput, p, pCtx, pCtx->inputType, isMin, *notNullElems);
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_INT) {
-      int32_t *pData = p;
-      int32_t *retVal = (int32_t*) pOutput;
-
-      for (int32_t i = 0; i < pCtx->size; ++i) {
-        if (pCtx->hasNull && isNull((const char*)&pData[i], pCtx->inputType)) {
-          continue;
-        }
-
-        if ((*retVal < pData[i]) ^ isMin) {
-          *retVal = pData[i];
-          if(tsList) {
-            TSKEY k = tsList[i];
-            DO_UPDATE_TAG_COLUMNS(pCtx, k);
-          }
-        }
-        *notNullElems += 1;
-      }
-#if defined(_DEBUG_VIEW)
-      qDebug("max value updated:%d", *retVal);
-#endif
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_BIGINT) {
-      TYPED_LOOPCHECK_N(int64_t, pOutput, p, pCtx, pCtx->inputType, isMin, *notNullElems);
-    }
-  } else if (IS_UNSIGNED_NUMERIC_TYPE(pCtx->inputType)) {
-    if (pCtx->inputType == TSDB_DATA_TYPE_UTINYINT) {
-      TYPED_LOOPCHECK_N(uint8_t, pOutput, p, pCtx, pCtx->inputType, isMin, *notNullElems);
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_USMALLINT) {
-      TYPED_LOOPCHECK_N(uint16_t, pOutput, p, pCtx, pCtx->inputType, isMin, *notNullElems);
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_UINT) {
-      TYPED_LOOPCHECK_N(uint32_t, pOutput, p, pCtx, pCtx->inputType, isMin, *notNullElems);
-    } else if (pCtx->inputType == TSDB_DATA_TYPE_UBIGINT) {
-      TYPED_LOOPCHECK_N(uint64_t, pOutput, p, pCtx, pCtx->inputType, isMin, *notNullElems);
-    }
-  } else if (pCtx->inputType == TSDB_DATA_TYPE_DOUBLE) {
-    TYPED_LOOPCHECK_N(double, pOutput, p, pCtx, pCtx->inputType, isMin, *notNullElems);
-  } else if (pCtx->inputType == TSDB_DATA_TYPE_FLOAT) {
-    TYPED_LOOPCHECK_N(float, pOutput, p, pCtx, pCtx->inputType, isMin, *notNullElems);
+  *notNullElems = (*pKernel->minMax)(GET_INPUT_DATA_LIST(pCtx), pCtx->size, pCtx->hasNull, isMin, pOutput, &index);
+  if (index >= 0) {
+    TSKEY key = (pCtx->ptsList != NULL) ? GET_TS_DATA(pCtx, index) : 0;
+    DO_UPDATE_TAG_COLUMNS(pCtx, key);
   }
 }
 
@@ -32,6 +32,7 @@
 #include "tscLog.h"
 #include "cJSON.h"
 #include "tsdbMeta.h"
+#include "tsched.h"
 #include "tscUtil.h"
 
 #define IS_MASTER_SCAN(runtime)        ((runtime)->scanFlag == MASTER_SCAN)
@@ -216,7 +217,6 @@ static bool hasMainOutput(SQueryAttr *pQueryAttr);
 static SColumnInfo* extractColumnFilterInfo(SExprInfo* pExpr, int32_t numOfOutput, int32_t* numOfFilterCols);
 
 static int32_t setTimestampListJoinInfo(SQueryRuntimeEnv* pRuntimeEnv, tVariant* pTag, STableQueryInfo *pTableQueryInfo);
-static void releaseQueryBuf(size_t numOfTables);
 static int32_t binarySearchForKey(char *pValue, int num, TSKEY key, int order);
 static STsdbQueryCond createTsdbQueryCond(SQueryAttr* pQueryAttr, STimeWindow* win);
 static STableIdInfo createTableIdInfo(STableQueryInfo* pTableQueryInfo);
@@ -246,7 +246,7 @@ static void doSetOperatorCompleted(SOperatorInfo* pOperator) {
 static int32_t doCopyToSDataBlock(SQueryRuntimeEnv* pRuntimeEnv, SGroupResInfo* pGroupResInfo, int32_t orderType, SSDataBlock* pBlock);
 
 static int32_t getGroupbyColumnIndex(SGroupbyExpr *pGroupbyExpr, SSDataBlock* pDataBlock);
-static int32_t setGroupResultOutputBuf(SQueryRuntimeEnv *pRuntimeEnv, SOptrBasicInfo *binf, int32_t numOfCols, char *pData, int16_t type, int16_t bytes, int32_t groupIndex);
+static int32_t setGroupResultOutputBuf(SQueryRuntimeEnv *pRuntimeEnv, SOptrBasicInfo *binf, int32_t numOfCols, SResultRow *pResultRow, int32_t groupIndex);
 
 static void initCtxOutputBuffer(SQLFunctionCtx* pCtx, int32_t size);
 static void getAlignQueryTimeWindow(SQueryAttr *pQueryAttr, int64_t key, int64_t keyFirst, int64_t keyLast, STimeWindow *win);
@@ -457,6 +457,35 @@ static bool isProjQuery(SQueryAttr *pQueryAttr) {
   return true;
 }
 
+// The functions of the query are computed from the keys and the statistics of the data blocks, so the rows of the other
+// columns are loaded only for blocks that some time window cuts through
+static bool isBlockStatisQuery(SQueryAttr *pQueryAttr) {
+  if (pQueryAttr->pFilters || pQueryAttr->groupbyColumn || pQueryAttr->sw.gap > 0 || pQueryAttr->stateWindow ||
+      pQueryAttr->pointInterpQuery || pQueryAttr->tsCompQuery || pQueryAttr->numOfOutput <= 0) {
+    return false;
+  }
+
+  for (int32_t i = 0; i < pQueryAttr->numOfOutput; ++i) {
+    switch (pQueryAttr->pExpr1[i].base.functionId) {
+      case TSDB_FUNC_COUNT:
+      case TSDB_FUNC_SUM:
+      case TSDB_FUNC_AVG:
+      case TSDB_FUNC_MIN:
+      case TSDB_FUNC_MAX:
+      case TSDB_FUNC_SPREAD:
+      case TSDB_FUNC_TS:
+      case TSDB_FUNC_TAG_DUMMY:
+      case TSDB_FUNC_TAG:
+      case TSDB_FUNC_TAGPRJ:
+        break;
+      default:
+        return false;
+    }
+  }
+
+  return true;
+}
+
 static bool hasNull(SColIndex* pColIndex, SDataStatis *pStatis) {
   if (TSDB_COL_IS_TAG(pColIndex->flag) || TSDB_COL_IS_UD_COL(pColIndex->flag) ||
       TSDB_COL_IS_TSWIN_COL(pColIndex->colId) || pColIndex->colId == PRIMARYKEY_TIMESTAMP_COL_INDEX) {
@@ -496,8 +525,87 @@ static void prepareResultListBuffer(SResultRowInfo* pResultRowInfo, SQueryRuntim
   pResultRowInfo->capacity = (int32_t)newCapacity;
 }
 
+// the window index is not used any more, its result rows are put into the result row hash tables
+static void moveWindowIndexToHash(SQueryRuntimeEnv* pRuntimeEnv, SResultRowInfo* pResultRowInfo, int64_t tid) {
+  uint64_t groupId = pResultRowInfo->pWindowIndex->groupId;
+
+  for (int32_t i = 0; i < pResultRowInfo->size; ++i) {
+    SResultRow* pResult = pResultRowInfo->pResult[i];
+
+    SET_RES_WINDOW_KEY(pRuntimeEnv->keyBuf, &pResult->win.skey, TSDB_KEYSIZE, groupId);
+    taosHashPut(pRuntimeEnv->pResultRowHashTable, pRuntimeEnv->keyBuf, GET_RES_WINDOW_KEY_LEN(TSDB_KEYSIZE), &pResult, POINTER_BYTES);
+
+    int64_t index = i;
+    SET_RES_EXT_WINDOW_KEY(pRuntimeEnv->keyBuf, &pResult->win.skey, TSDB_KEYSIZE, tid, pResultRowInfo);
+    taosHashPut(pRuntimeEnv->pResultRowListSet, pRuntimeEnv->keyBuf, GET_RES_EXT_WINDOW_KEY_LEN(TSDB_KEYSIZE), &index, POINTER_BYTES);
+  }
+
+  destroyWindowIndex(pResultRowInfo);
+}
+
+/*
+ * The window of a fixed interval is found in the window index of the result row info. Returns false if the window
+ * cannot be kept in the index, and the result row hash tables need to be used instead.
+ */
+static bool doSetResultOutBufByWindowIndex(SQueryRuntimeEnv* pRuntimeEnv, SResultRowInfo* pResultRowInfo, TSKEY skey,
+                                           bool masterscan, uint64_t tableGroupId, SResultRow** pResult) {
+  if (pResultRowInfo->pWindowIndex->groupId != tableGroupId) {
+    return false;
+  }
+
+  int32_t pos = getWindowIndexPos(pResultRowInfo, skey);
+  if (pos >= 0) {
+    if (masterscan) {
+      pResultRowInfo->curPos = pos;
+    }
+
+    *pResult = pResultRowInfo->pResult[pos];
+    return true;
+  }
+
+  // in case of repeat scan/reverse scan, no new time window added.
+  if (!masterscan) {
+    *pResult = NULL;
+    return true;
+  }
+
+  if (putWindowIndexPos(pResultRowInfo, skey, pResultRowInfo->size) != TSDB_CODE_SUCCESS) {
+    return false;
+  }
+
+  prepareResultListBuffer(pResultRowInfo, pRuntimeEnv);
+
+  SResultRow* pRow = getNewResultRow(pRuntimeEnv->pool);
+  if (initResultRow(pRow) != TSDB_CODE_SUCCESS) {
+    longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_OUT_OF_MEMORY);
+  }
+
+  SResultRowCell cell = {.groupId = tableGroupId, .pRow = pRow};
+  taosArrayPush(pRuntimeEnv->pResultRowArrayList, &cell);
+
+  pResultRowInfo->curPos = pResultRowInfo->size;
+  pResultRowInfo->pResult[pResultRowInfo->size++] = pRow;
+
+  // too many time window in query
+  if (pResultRowInfo->size > MAX_INTERVAL_TIME_WINDOW) {
+    longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_TOO_MANY_TIMEWINDOW);
+  }
+
+  *pResult = pRow;
+  return true;
+}
+
 static SResultRow* doSetResultOutBufByKey(SQueryRuntimeEnv* pRuntimeEnv, SResultRowInfo* pResultRowInfo, int64_t tid,
                                           char* pData, int16_t bytes, bool masterscan, uint64_t tableGroupId) {
+  if (pResultRowInfo->pWindowIndex != NULL) {
+    SResultRow* pResult = NULL;
+    if (doSetResultOutBufByWindowIndex(pRuntimeEnv, pResultRowInfo, *(TSKEY*)pData, masterscan, tableGroupId, &pResult)) {
+      return pResult;
+    }
+
+    moveWindowIndexToHash(pRuntimeEnv, pResultRowInfo, tid);
+  }
+
   bool existed = false;
   SET_RES_WINDOW_KEY(pRuntimeEnv->keyBuf, pData, bytes, tableGroupId);
 
@@ -1472,6 +1580,92 @@ static void doWindowBorderInterpolation(SOperatorInfo* pOperatorInfo, SSDataBloc
   }
 }
 
+// tumbling windows of a fixed length, the rows of the block are all in the query time range
+static bool isFixedIntervalBlock(SQueryAttr* pQueryAttr, SSDataBlock* pSDataBlock) {
+  SInterval* pInterval = &pQueryAttr->interval;
+  if (pInterval->intervalUnit == 'n' || pInterval->intervalUnit == 'y' || pInterval->sliding != pInterval->interval ||
+      pQueryAttr->timeWindowInterpo) {
+    return false;
+  }
+
+  if (QUERY_IS_ASC_QUERY(pQueryAttr)) {
+    return pSDataBlock->info.window.ekey <= pQueryAttr->window.ekey;
+  } else {
+    return pSDataBlock->info.window.skey >= pQueryAttr->window.ekey;
+  }
+}
+
+/*
+ * The next window starts from the first row after the current one, so the windows of the block are found by
+ * comparing the rows with the window border, instead of binary searching the block for each window.
+ */
+static void hashFixedIntervalAgg(SOperatorInfo* pOperatorInfo, SResultRowInfo* pResultRowInfo, SSDataBlock* pSDataBlock,
+                                 TSKEY* tsCols, int32_t tableGroupId) {
+  STableIntervalOperatorInfo* pInfo = (STableIntervalOperatorInfo*)pOperatorInfo->info;
+
+  SQueryRuntimeEnv* pRuntimeEnv = pOperatorInfo->pRuntimeEnv;
+  int32_t           numOfOutput = pOperatorInfo->numOfOutput;
+  SQueryAttr*       pQueryAttr = pRuntimeEnv->pQueryAttr;
+
+  int32_t rows = pSDataBlock->info.rows;
+  int64_t interval = pQueryAttr->interval.interval;
+  bool    ascQuery = QUERY_IS_ASC_QUERY(pQueryAttr);
+  bool    masterScan = IS_MASTER_SCAN(pRuntimeEnv);
+
+  int32_t     startPos = ascQuery ? 0 : (rows - 1);
+  STimeWindow win = getActiveTimeWindow(pResultRowInfo, tsCols[startPos], pQueryAttr);
+
+  while (1) {
+    SResultRow* pResult = NULL;
+    int32_t ret = setResultOutputBufByKey(pRuntimeEnv, pResultRowInfo, pSDataBlock->info.tid, &win, masterScan, &pResult,
+                                          tableGroupId, pInfo->pCtx, numOfOutput, pInfo->rowCellInfoOffset);
+    if (ret != TSDB_CODE_SUCCESS || pResult == NULL) {
+      longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_OUT_OF_MEMORY);
+    }
+
+    int32_t endPos = startPos;
+    int32_t forwardStep = 0;
+    if (ascQuery) {
+      if (tsCols[rows - 1] <= win.ekey) {
+        endPos = rows;
+      } else {
+        while (tsCols[endPos] <= win.ekey) {
+          ++endPos;
+        }
+      }
+
+      forwardStep = endPos - startPos;
+    } else {
+      if (tsCols[0] >= win.skey) {
+        endPos = -1;
+      } else {
+        while (tsCols[endPos] >= win.skey) {
+          --endPos;
+        }
+      }
+
+      forwardStep = startPos - endPos;
+    }
+
+    doApplyFunctions(pRuntimeEnv, pInfo->pCtx, &win, startPos, forwardStep, tsCols, rows, numOfOutput);
+    if (endPos < 0 || endPos >= rows) {
+      break;
+    }
+
+    // skip the windows without any rows
+    startPos = endPos;
+    if (ascQuery) {
+      win.skey += ((tsCols[startPos] - win.skey) / interval) * interval;
+    } else {
+      win.skey -= ((win.skey - tsCols[startPos] + interval - 1) / interval) * interval;
+    }
+
+    win.ekey = win.skey + interval - 1;
+  }
+
+  pRuntimeEnv->current->lastKey = (ascQuery ? tsCols[rows - 1] : tsCols[0]) + GET_FORWARD_DIRECTION_FACTOR(pQueryAttr->order.order);
+}
+
 static void hashIntervalAgg(SOperatorInfo* pOperatorInfo, SResultRowInfo* pResultRowInfo, SSDataBlock* pSDataBlock, int32_t tableGroupId) {
   STableIntervalOperatorInfo* pInfo = (STableIntervalOperatorInfo*)pOperatorInfo->info;
 
@@ -1492,6 +1686,12 @@ static void hashIntervalAgg(SOperatorInfo* pOperatorInfo, SResultRowInfo* pResul
            tsCols[pSDataBlock->info.rows - 1] == pSDataBlock->info.window.ekey);
   }
 
+  if (tsCols != NULL && isFixedIntervalBlock(pQueryAttr, pSDataBlock)) {
+    hashFixedIntervalAgg(pOperatorInfo, pResultRowInfo, pSDataBlock, tsCols, tableGroupId);
+    updateResultRowInfoActiveIndex(pResultRowInfo, pQueryAttr, pRuntimeEnv->current->lastKey);
+    return;
+  }
+
   int32_t startPos = ascQuery ? 0 : (pSDataBlock->info.rows - 1);
   TSKEY   ts = getStartTsKey(pQueryAttr, &pSDataBlock->info.window, tsCols, pSDataBlock->info.rows);
 
@@ -1583,7 +1783,7 @@ static void hashIntervalAgg(SOperatorInfo* pOperatorInfo, SResultRowInfo* pResul
 }
 
 static bool initGroupbyInfo(const SSDataBlock *pSDataBlock, const SGroupbyExpr *pGroupbyExpr, SGroupbyOperatorInfo *pInfo) {
-  if (pInfo->pGroupbyDataInfo != NULL) {
+  if (pInfo->pGroupHash != NULL) {
     // no need build group-by info
     return true;
   }
@@ -1597,10 +1797,6 @@ static bool initGroupbyInfo(const SSDataBlock *pSDataBlock, const SGroupbyExpr *
     for (int32_t i = 0; i < pSDataBlock->info.numOfCols; ++i) {
       SColumnInfoData* pColInfo = taosArrayGet(pSDataBlock->pDataBlock, i);
       if (pColInfo->info.colId == pColIndex->colId) {
-        int32_t type = pColInfo->info.type;
-        if (type == TSDB_DATA_TYPE_FLOAT || type == TSDB_DATA_TYPE_DOUBLE) {
-          return false;
-        }
         pInfo->totalBytes += pColInfo->info.bytes;
 
         SGroupbyDataInfo info =  {.index = i, .type = pColInfo->info.type, .bytes = pColInfo->info.bytes};
@@ -1609,65 +1805,76 @@ static bool initGroupbyInfo(const SSDataBlock *pSDataBlock, const SGroupbyExpr *
       }
       if (i == pSDataBlock->info.numOfCols - 1) {
         // not found groupby col in dataBlock, error
+        taosArrayDestroy(&pInfo->pGroupbyDataInfo);
+        pInfo->totalBytes = 0;
         return false;
       }
     }
   }
-  pInfo->totalBytes += (int32_t)strlen(MULTI_KEY_DELIM) * pGroupbyExpr->numOfGroupCols;
+
+  // the group index follows the key, rows of different table groups are different groups
+  pInfo->prevData = calloc(1, pInfo->totalBytes + sizeof(int32_t));
+  pInfo->pGroupHash = groupbyHashCreate(pInfo->totalBytes + sizeof(int32_t));
+  if (pInfo->prevData == NULL || pInfo->pGroupHash == NULL) {
+    taosArrayDestroy(&pInfo->pGroupbyDataInfo);
+    tfree(pInfo->prevData);
+    groupbyHashDestroy(pInfo->pGroupHash);
+    pInfo->pGroupHash = NULL;
+    pInfo->totalBytes = 0;
+    return false;
+  }
 
   return true;
 }
 
-static void buildGroupbyKeyBuf(const SSDataBlock *pSDataBlock, SGroupbyOperatorInfo *pInfo, int32_t rowId, char **buf) {
-  char *p = calloc(1, pInfo->totalBytes);
-  if (p == NULL) {
-    *buf = NULL;
-    return;
-  }
-  *buf  = p;
+static void buildGroupbyKeyBuf(const SSDataBlock *pSDataBlock, SGroupbyOperatorInfo *pInfo, int32_t rowId, int32_t groupIndex, char *buf) {
+  char *p = buf;
   for (int32_t i = 0; i < taosArrayGetSize(pInfo->pGroupbyDataInfo); i++) {
     SGroupbyDataInfo *pDataInfo = taosArrayGet(pInfo->pGroupbyDataInfo, i);
 
     SColumnInfoData* pColData = taosArrayGet(pSDataBlock->pDataBlock, pDataInfo->index);
-    //TODO(yihaoDeng): handle float & double
     char *val = ((char *)pColData->pData) + pDataInfo->bytes * rowId;
-    if (isNull(val, pDataInfo->type)) {
-      p += pDataInfo->bytes;
-      continue;
-    }
-    if (IS_VAR_DATA_TYPE(pDataInfo->type)) {
-      memcpy(p, varDataVal(val), varDataLen(val));
-      p +=  varDataLen(val);
-    } else {
-      memcpy(p, val, pDataInfo->bytes);
-      p += pDataInfo->bytes;
-    }
-
-    memcpy(p, MULTI_KEY_DELIM, strlen(MULTI_KEY_DELIM));
-    p += strlen(MULTI_KEY_DELIM);
+    groupbyKeyColumn(p, val, pDataInfo->type, pDataInfo->bytes);
+    p += pDataInfo->bytes;
   }
+
+  memcpy(p, &groupIndex, sizeof(groupIndex));
 }
 
-static bool isGroupbyKeyEqual(void *a, void *b, void *ext) {
-  SGroupbyOperatorInfo *pInfo = (SGroupbyOperatorInfo *)ext;
-  if (memcmp(a, b, pInfo->totalBytes) == 0) {
-    return true;
-  }
-  int32_t offset = 0;
+static bool isGroupbyRowEqual(const SSDataBlock *pSDataBlock, SGroupbyOperatorInfo *pInfo, int32_t r1, int32_t r2) {
   for (int32_t i = 0; i < taosArrayGetSize(pInfo->pGroupbyDataInfo); i++) {
     SGroupbyDataInfo *pDataInfo = taosArrayGet(pInfo->pGroupbyDataInfo, i);
 
-    char *k1 = (char *)a + offset;
-    char *k2 = (char *)b + offset;
-    if (getComparFunc(pDataInfo->type, 0)(k1, k2) != 0) {
-       return false;
+    SColumnInfoData* pColData = taosArrayGet(pSDataBlock->pDataBlock, pDataInfo->index);
+    char *v1 = ((char *)pColData->pData) + pDataInfo->bytes * r1;
+    char *v2 = ((char *)pColData->pData) + pDataInfo->bytes * r2;
+
+    int32_t len = IS_VAR_DATA_TYPE(pDataInfo->type) ? varDataTLen(v1) : pDataInfo->bytes;
+    if ((IS_VAR_DATA_TYPE(pDataInfo->type) && len != varDataTLen(v2)) || memcmp(v1, v2, len) != 0) {
+      return false;
     }
-    offset += pDataInfo->bytes;
-    offset += (int32_t)strlen(MULTI_KEY_DELIM);
   }
   return true;
 }
 
+static SResultRow* getGroupResultRow(SQueryRuntimeEnv *pRuntimeEnv, SGroupbyOperatorInfo *pInfo, uint64_t hash, int32_t groupIndex) {
+  SResultRow *pResultRow = groupbyHashGet(pInfo->pGroupHash, hash, pInfo->prevData);
+  if (pResultRow != NULL) {
+    return pResultRow;
+  }
+
+  // a new group, the result row is created once and kept in the group hash
+  int64_t tid = 0;
+  pResultRow = doSetResultOutBufByKey(pRuntimeEnv, &pInfo->binfo.resultRowInfo, tid, pInfo->prevData, (int16_t)pInfo->totalBytes, true, groupIndex);
+  assert(pResultRow != NULL);
+
+  if (groupbyHashPut(pInfo->pGroupHash, hash, pInfo->prevData, pResultRow) != TSDB_CODE_SUCCESS) {
+    longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_OUT_OF_MEMORY);
+  }
+
+  return pResultRow;
+}
+
 static void doHashGroupbyAgg(SOperatorInfo* pOperator, SGroupbyOperatorInfo *pInfo, SSDataBlock *pSDataBlock) {
   SQueryRuntimeEnv* pRuntimeEnv = pOperator->pRuntimeEnv;
   STableQueryInfo*  item = pRuntimeEnv->current;
@@ -1675,69 +1882,61 @@ static void doHashGroupbyAgg(SOperatorInfo* pOperator, SGroupbyOperatorInfo *pIn
   SQueryAttr* pQueryAttr = pRuntimeEnv->pQueryAttr;
 
   if (!initGroupbyInfo(pSDataBlock, pRuntimeEnv->pQueryAttr->pGroupbyExpr, pInfo)) {
-    qError("QInfo:0x%"PRIx64" group by not supported on double/float columns, abort", GET_QID(pRuntimeEnv));
+    qError("QInfo:0x%"PRIx64" failed to init the group by columns, abort", GET_QID(pRuntimeEnv));
     return;
   }
   //realloc pRuntimeEnv->keyBuf
   pRuntimeEnv->keyBuf = realloc(pRuntimeEnv->keyBuf, pInfo->totalBytes + sizeof(int64_t) + POINTER_BYTES);
 
+  int32_t numOfRows = pSDataBlock->info.rows;
+  if (pInfo->rowHashSize < numOfRows) {
+    uint64_t *p = realloc(pInfo->pRowHash, sizeof(uint64_t) * numOfRows);
+    if (p == NULL) {
+      longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_OUT_OF_MEMORY);
+    }
+
+    pInfo->pRowHash = p;
+    pInfo->rowHashSize = numOfRows;
+  }
+
+  // hash the whole block column by column before the rows are visited
+  uint64_t *hash = pInfo->pRowHash;
+  for (int32_t j = 0; j < numOfRows; ++j) {
+    hash[j] = (uint64_t)item->groupIndex;
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(pInfo->pGroupbyDataInfo); i++) {
+    SGroupbyDataInfo *pDataInfo = taosArrayGet(pInfo->pGroupbyDataInfo, i);
+    SColumnInfoData  *pColData = taosArrayGet(pSDataBlock->pDataBlock, pDataInfo->index);
+    groupbyHashColumn(pColData->pData, pDataInfo->type, pDataInfo->bytes, numOfRows, hash);
+  }
+
   SColumnInfoData* pFirstColData = taosArrayGet(pSDataBlock->pDataBlock, 0);
   int64_t* tsList = (pFirstColData->info.type == TSDB_DATA_TYPE_TIMESTAMP)? (int64_t*) pFirstColData->pData:NULL;
 
   STimeWindow w = TSWINDOW_INITIALIZER;
 
-  char *key = NULL;
-  int16_t num = 0;
-  int32_t type = 0;
-  for (int32_t j = 0; j < pSDataBlock->info.rows; ++j) {
-    buildGroupbyKeyBuf(pSDataBlock, pInfo, j, &key);
-    if (!key)  { continue; }
-
-    if (pInfo->prevData == NULL) {
-      // first row of
-      pInfo->prevData = key;
-      num++;
-      continue;
-    } else if (isGroupbyKeyEqual(pInfo->prevData, key, pInfo)) {
-      num++;
-      tfree(key);
+  // the rows of one key next to each other are aggregated together, and the group is looked up once for them
+  int32_t start = 0;
+  for (int32_t j = 1; j <= numOfRows; ++j) {
+    if (j < numOfRows && hash[j] == hash[start] && isGroupbyRowEqual(pSDataBlock, pInfo, start, j)) {
       continue;
     }
 
+    buildGroupbyKeyBuf(pSDataBlock, pInfo, start, item->groupIndex, pInfo->prevData);
     if (pQueryAttr->stableQuery && pQueryAttr->stabledev && (pRuntimeEnv->prevResult != NULL)) {
       setParamForStableStddevByColData(pRuntimeEnv, pInfo->binfo.pCtx, pOperator->numOfOutput, pOperator->pExpr, pInfo);
     }
 
-    int32_t ret = setGroupResultOutputBuf(pRuntimeEnv, &(pInfo->binfo), pOperator->numOfOutput, pInfo->prevData, type, pInfo->totalBytes, item->groupIndex);
+    SResultRow *pResultRow = getGroupResultRow(pRuntimeEnv, pInfo, hash[start], item->groupIndex);
+    int32_t ret = setGroupResultOutputBuf(pRuntimeEnv, &(pInfo->binfo), pOperator->numOfOutput, pResultRow, item->groupIndex);
     if (ret != TSDB_CODE_SUCCESS) {  // null data, too many state code
       longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_APP_ERROR);
     }
 
-    doApplyFunctions(pRuntimeEnv, pInfo->binfo.pCtx, &w, j - num, num, tsList, pSDataBlock->info.rows, pOperator->numOfOutput);
-
-    num = 1;
-
-    tfree(pInfo->prevData);
-    pInfo->prevData = key;
+    doApplyFunctions(pRuntimeEnv, pInfo->binfo.pCtx, &w, start, j - start, tsList, numOfRows, pOperator->numOfOutput);
+    start = j;
   }
-
-  if (num > 0) {
-    buildGroupbyKeyBuf(pSDataBlock, pInfo, pSDataBlock->info.rows - num, &key);
-    if (key) {
-      tfree(pInfo->prevData);
-      pInfo->prevData = key;
-      if (pQueryAttr->stableQuery && pQueryAttr->stabledev && (pRuntimeEnv->prevResult != NULL)) {
-        setParamForStableStddevByColData(pRuntimeEnv, pInfo->binfo.pCtx, pOperator->numOfOutput, pOperator->pExpr, pInfo);
-      }
-      int32_t ret = setGroupResultOutputBuf(pRuntimeEnv, &(pInfo->binfo), pOperator->numOfOutput, pInfo->prevData, type, pInfo->totalBytes, item->groupIndex);
-      if (ret != TSDB_CODE_SUCCESS) {  // null data, too many state code
-        longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_APP_ERROR);
-      }
-      doApplyFunctions(pRuntimeEnv, pInfo->binfo.pCtx, &w, pSDataBlock->info.rows - num, num, tsList, pSDataBlock->info.rows, pOperator->numOfOutput);
-    }
-  }
-
-  tfree(pInfo->prevData);
 }
 
 static void doSessionWindowAggImpl(SOperatorInfo* pOperator, SSWindowOperatorInfo *pInfo, SSDataBlock *pSDataBlock) {
@@ -1814,21 +2013,12 @@ static void doSessionWindowAggImpl(SOperatorInfo* pOperator, SSWindowOperatorInf
                    pSDataBlock->info.rows, pOperator->numOfOutput);
 }
 
-static int32_t setGroupResultOutputBuf(SQueryRuntimeEnv *pRuntimeEnv, SOptrBasicInfo *binfo, int32_t numOfCols, char *pData, int16_t type, int16_t bytes, int32_t groupIndex) {
+static int32_t setGroupResultOutputBuf(SQueryRuntimeEnv *pRuntimeEnv, SOptrBasicInfo *binfo, int32_t numOfCols, SResultRow *pResultRow, int32_t groupIndex) {
   SDiskbasedResultBuf *pResultBuf = pRuntimeEnv->pResultBuf;
 
   int32_t        *rowCellInfoOffset = binfo->rowCellInfoOffset;
-  SResultRowInfo *pResultRowInfo    = &binfo->resultRowInfo;
   SQLFunctionCtx *pCtx              = binfo->pCtx;
 
-  // not assign result buffer yet, add new result buffer, TODO remove it
-  char* d = pData;
-  int16_t len = bytes;
-
-  int64_t tid = 0;
-  SResultRow *pResultRow = doSetResultOutBufByKey(pRuntimeEnv, pResultRowInfo, tid, d, len, true, groupIndex);
-  assert (pResultRow != NULL);
-
   if (pResultRow->pageId == -1) {
     int32_t ret = addNewWindowResultBuf(pResultRow, pResultBuf, groupIndex, pRuntimeEnv->pQueryAttr->resultRowSize);
     if (ret != 0) {
@@ -2132,6 +2322,17 @@ static int32_t setupQueryRuntimeEnv(SQueryRuntimeEnv *pRuntimeEnv, int32_t numOf
   }
   pRuntimeEnv->cntTableReadOver= 0;
 
+  // late materialization only pays off when the filter leaves some of the columns out
+  if (pQueryAttr->pFilters != NULL) {
+    pRuntimeEnv->pFilterColList = taosArrayInit(4, sizeof(int16_t));
+    if (pRuntimeEnv->pFilterColList != NULL) {
+      filterGetColIdList(pQueryAttr->pFilters, pRuntimeEnv->pFilterColList);
+      if (taosArrayGetSize(pRuntimeEnv->pFilterColList) + 1 >= pQueryAttr->numOfCols) {
+        taosArrayDestroy(&pRuntimeEnv->pFilterColList);
+      }
+    }
+  }
+
   // NOTE: pTableCheckInfo need to update the query time range and the lastKey info
   pRuntimeEnv->pTableRetrieveTsMap = taosHashInit(numOfTables, taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT), false, HASH_NO_LOCK);
 
@@ -2457,6 +2658,8 @@ static void teardownQueryRuntimeEnv(SQueryRuntimeEnv *pRuntimeEnv) {
   taosHashCleanup(pRuntimeEnv->pTablesRead);
   pRuntimeEnv->pTablesRead = NULL;
 
+  taosArrayDestroy(&pRuntimeEnv->pFilterColList);
+
   taosHashCleanup(pRuntimeEnv->pResultRowListSet);
   pRuntimeEnv->pResultRowListSet = NULL;
 
@@ -2477,6 +2680,10 @@ bool isQueryKilled(SQInfo *pQInfo) {
     return true;
   }
 
+  if (pQInfo->pParent != NULL && isQueryKilled(pQInfo->pParent)) {
+    return true;
+  }
+
   // query has been executed more than tsShellActivityTimer, and the retrieve has not arrived
   // abort current query execution.
   if (pQInfo->owner != 0 && ((taosGetTimestampSec() - pQInfo->lastRetrieveTs/1000) > getMaximumIdleDurationSec()) &&
@@ -3176,6 +3383,58 @@ FORCE_INLINE int32_t getColumnDataFromId(void *param, int32_t id, void **data) {
   return TSDB_CODE_SUCCESS;
 }
 
+static int32_t getColumnDictFromId(void *param, int32_t id, const uint8_t **codes) {
+  *codes = tsdbRetrieveDataBlockDictCodes(param, (int16_t)id);
+  return TSDB_CODE_SUCCESS;
+}
+
+/*
+ * Late materialization of a filtered data block: only the filter columns are loaded before the filter is applied, and
+ * the other columns are loaded only if there are qualified rows in the block.
+ */
+static int32_t doLoadFilteredDataBlock(SQueryRuntimeEnv* pRuntimeEnv, STableScanInfo* pTableScanInfo, SSDataBlock* pBlock) {
+  SQueryAttr* pQueryAttr = pRuntimeEnv->pQueryAttr;
+  int32_t     numOfRows = pBlock->info.rows;
+
+  pBlock->pDataBlock = tsdbRetrieveDataBlock(pTableScanInfo->pQueryHandle, pRuntimeEnv->pFilterColList);
+  if (pBlock->pDataBlock == NULL) {
+    return terrno;
+  }
+
+  SColumnDataParam param = {.numOfCols = pBlock->info.numOfCols, .pDataBlock = pBlock->pDataBlock};
+  filterSetColFieldData(pQueryAttr->pFilters, &param, getColumnDataFromId);
+  filterSetColFieldDict(pQueryAttr->pFilters, pTableScanInfo->pQueryHandle, getColumnDictFromId);
+
+  int8_t* p = NULL;
+  bool    all = filterExecute(pQueryAttr->pFilters, numOfRows, &p, pBlock->pBlockStatis, pQueryAttr->numOfCols);
+
+  bool qualified = all;
+  for (int32_t i = 0; !qualified && p != NULL && i < numOfRows; ++i) {
+    qualified = (p[i] != 0);
+  }
+
+  if (!qualified) {
+    qDebug("QInfo:0x%"PRIx64" no qualified rows in data block, brange:%" PRId64 "-%" PRId64 ", rows:%d, remain columns not loaded",
+           GET_QID(pRuntimeEnv), pBlock->info.window.skey, pBlock->info.window.ekey, numOfRows);
+    pBlock->info.rows = 0;
+    pBlock->pBlockStatis = NULL;  // clean the block statistics info
+    tfree(p);
+    return TSDB_CODE_SUCCESS;
+  }
+
+  pBlock->pDataBlock = tsdbRetrieveDataBlock(pTableScanInfo->pQueryHandle, NULL);
+  if (pBlock->pDataBlock == NULL) {
+    tfree(p);
+    return terrno;
+  }
+
+  if (!all) {
+    doCompactSDataBlock(pBlock, numOfRows, p);
+  }
+
+  tfree(p);
+  return TSDB_CODE_SUCCESS;
+}
 
 int32_t loadDataBlockOnDemand(SQueryRuntimeEnv* pRuntimeEnv, STableScanInfo* pTableScanInfo, SSDataBlock* pBlock,
                               uint32_t* status) {
@@ -3316,6 +3575,11 @@ int32_t loadDataBlockOnDemand(SQueryRuntimeEnv* pRuntimeEnv, STableScanInfo* pTa
 
     pCost->totalCheckedRows += pBlockInfo->rows;
     pCost->loadBlocks += 1;
+
+    if (pRuntimeEnv->pFilterColList != NULL && pRuntimeEnv->pTsBuf == NULL) {
+      return doLoadFilteredDataBlock(pRuntimeEnv, pTableScanInfo, pBlock);
+    }
+
     pBlock->pDataBlock = tsdbRetrieveDataBlock(pTableScanInfo->pQueryHandle, NULL);
     if (pBlock->pDataBlock == NULL) {
       return terrno;
@@ -3324,6 +3588,7 @@ int32_t loadDataBlockOnDemand(SQueryRuntimeEnv* pRuntimeEnv, STableScanInfo* pTa
     if (pQueryAttr->pFilters != NULL) {
       SColumnDataParam param = {.numOfCols = pBlock->info.numOfCols, .pDataBlock = pBlock->pDataBlock};
       filterSetColFieldData(pQueryAttr->pFilters, &param, getColumnDataFromId);
+      filterSetColFieldDict(pQueryAttr->pFilters, pTableScanInfo->pQueryHandle, getColumnDictFromId);
     }
 
     if (pQueryAttr->pFilters != NULL || pRuntimeEnv->pTsBuf != NULL) {
@@ -5154,6 +5419,7 @@ STsdbQueryCond createTsdbQueryCond(SQueryAttr* pQueryAttr, STimeWindow* win) {
       .numOfCols = pQueryAttr->numOfCols,
       .type      = BLOCK_LOAD_OFFSET_SEQ_ORDER,
       .loadExternalRows = false,
+      .statisQuery = isBlockStatisQuery(pQueryAttr),
       .twindow = *win,
   };
 
@@ -5284,6 +5550,12 @@ static SSDataBlock* doTableScan(void* param, bool *newgroup) {
   SResultRowInfo* pResultRowInfo = pTableScanInfo->pResultRowInfo;
   *newgroup = false;
 
+  // the previous block has been consumed by the operators above, the query may stop here and be executed again later
+  SQInfo* pQInfo = pRuntimeEnv->qinfo;
+  if (pQInfo->yieldTs != 0 && pRuntimeEnv->scanFlag == MASTER_SCAN && taosGetTimestampMs() >= pQInfo->yieldTs) {
+    longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_YIELDED);
+  }
+
   while (pTableScanInfo->current < pTableScanInfo->times) {
     SSDataBlock* p = doTableScanImpl(pOperator, newgroup);
     if (p != NULL) {
@@ -6402,6 +6674,7 @@ static SSDataBlock* doIntervalAgg(void* param, bool* newgroup) {
   pOperator->status = OP_RES_TO_RETURN;
   if (pIntervalInfo->resultRowInfo.size > 0 && pQueryAttr->needSort) {
     qsort(pIntervalInfo->resultRowInfo.pResult, pIntervalInfo->resultRowInfo.size, POINTER_BYTES, resRowCompare);
+    rebuildWindowIndex(&pIntervalInfo->resultRowInfo);
   }
 
   closeAllResultRows(&pIntervalInfo->resultRowInfo);
@@ -7471,6 +7744,8 @@ static void destroyGroupbyOperatorInfo(void* param, int32_t numOfOutput) {
   SGroupbyOperatorInfo* pInfo = (SGroupbyOperatorInfo*) param;
   doDestroyBasicInfo(&pInfo->binfo, numOfOutput);
   taosArrayDestroy(&pInfo->pGroupbyDataInfo);
+  groupbyHashDestroy(pInfo->pGroupHash);
+  tfree(pInfo->pRowHash);
 
   if (pInfo->prevData) {
     tfree(pInfo->prevData);
@@ -7730,6 +8005,14 @@ SOperatorInfo* createTimeIntervalOperatorInfo(SQueryRuntimeEnv* pRuntimeEnv, SOp
     goto _clean;
   }
 
+  // the windows of a natural month/year do not have the same length, they are kept in the hash tables
+  SInterval* pInterval = &pRuntimeEnv->pQueryAttr->interval;
+  if (pInterval->intervalUnit != 'n' && pInterval->intervalUnit != 'y' && pInterval->sliding > 0) {
+    if (initWindowIndex(&pInfo->resultRowInfo, pInterval->sliding, 0) != TSDB_CODE_SUCCESS) {
+      goto _clean;
+    }
+  }
+
   SOperatorInfo* pOperator = calloc(1, sizeof(SOperatorInfo));
   if (pOperator == NULL) {
     goto _clean;
@@ -8480,6 +8763,226 @@ _clean:
   return NULL;
 }
 
+static void* tsQueryParallelSched = NULL;
+
+int32_t qInitParallelPool() {
+  if (tsQueryParallelThreads <= 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  tsQueryParallelSched =
+      taosInitScheduler(tsQueryParallelThreads * TSDB_MAX_QUERY_PARALLEL_DEGREE, tsQueryParallelThreads, "qParallel");
+  if (tsQueryParallelSched == NULL) {
+    terrno = TSDB_CODE_QRY_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+void qCleanupParallelPool() {
+  if (tsQueryParallelSched != NULL) {
+    taosCleanUpScheduler(tsQueryParallelSched);
+    tsQueryParallelSched = NULL;
+  }
+}
+
+// only the aggregation and interval results of super tables are partial on a vnode, so that the client can merge
+// those of the morsels as it merges those of different vnodes
+int32_t getQueryParallelDegree(SQueryTableMsg *pQueryMsg, SQueryParam *param, uint32_t numOfTables) {
+  if (tsQueryParallelSched == NULL || !pQueryMsg->stableQuery || param->pUdfInfo != NULL) {
+    return 1;
+  }
+
+  // the ts buffer of a join, the previous results of stddev and the block distribution belong to the whole vnode
+  if (pQueryMsg->tsBuf.tsLen > 0 || pQueryMsg->prevResultLen > 0 || param->tableScanOperator == OP_TableBlockInfoScan) {
+    return 1;
+  }
+
+  if (taosArrayGetSize(param->pOperator) != 1) {
+    return 1;
+  }
+
+  int32_t op = *(int32_t*) taosArrayGet(param->pOperator, 0);
+  if (op != OP_MultiTableAggregate && op != OP_MultiTableTimeInterval) {
+    return 1;
+  }
+
+  return (int32_t) MIN((uint32_t) tsQueryParallelDegree, numOfTables);
+}
+
+// a morsel runs on the pool first and then on the query worker thread, so the jump buffer is set on each call
+static SSDataBlock* doExecMorsel(SQInfo* pQInfo) {
+  SQueryRuntimeEnv* pRuntimeEnv = &pQInfo->runtimeEnv;
+  if (pRuntimeEnv->proot == NULL) {
+    return NULL;
+  }
+
+  int32_t ret = setjmp(pRuntimeEnv->env);
+  if (ret != TSDB_CODE_SUCCESS) {
+    pQInfo->code = ret;
+    qDebug("QInfo:0x%"PRIx64" morsel abort due to error/cancel occurs, code:%s", pQInfo->qId, tstrerror(ret));
+    return NULL;
+  }
+
+  bool    newgroup = false;
+  int64_t st = taosGetTimestampUs();
+
+  SSDataBlock* pBlock = pRuntimeEnv->proot->exec(pRuntimeEnv->proot, &newgroup);
+  pQInfo->summary.elapsedTime += (taosGetTimestampUs() - st);
+  return pBlock;
+}
+
+static void doExecMorselFp(SSchedMsg* pMsg) {
+  SQueryMorsel* pMorsel = pMsg->ahandle;
+
+  pMorsel->pBlock = doExecMorsel(pMorsel->pQInfo);
+  tsem_post(pMorsel->finished);
+}
+
+static void waitForMorsels(SParallelMergeOperatorInfo* pInfo) {
+  for (; pInfo->numOfFinished < pInfo->numOfLaunched; ++pInfo->numOfFinished) {
+    tsem_wait(&pInfo->finished);
+  }
+}
+
+static void addMorselCost(SQueryCostInfo* pSummary, const SQueryCostInfo* pMorsel) {
+  pSummary->loadStatisTime    += pMorsel->loadStatisTime;
+  pSummary->loadFileBlockTime += pMorsel->loadFileBlockTime;
+  pSummary->loadStatisSize    += pMorsel->loadStatisSize;
+  pSummary->loadFileBlockSize += pMorsel->loadFileBlockSize;
+  pSummary->totalRows         += pMorsel->totalRows;
+  pSummary->totalCheckedRows  += pMorsel->totalCheckedRows;
+  pSummary->totalBlocks       += pMorsel->totalBlocks;
+  pSummary->loadBlocks        += pMorsel->loadBlocks;
+  pSummary->loadBlockStatis   += pMorsel->loadBlockStatis;
+  pSummary->discardBlocks     += pMorsel->discardBlocks;
+}
+
+static SSDataBlock* doParallelMerge(void* param, bool* newgroup) {
+  SOperatorInfo* pOperator = (SOperatorInfo*) param;
+  if (pOperator->status == OP_EXEC_DONE) {
+    return NULL;
+  }
+
+  SParallelMergeOperatorInfo* pInfo = pOperator->info;
+  SQueryRuntimeEnv* pRuntimeEnv = pOperator->pRuntimeEnv;
+  SQInfo* pQInfo = pRuntimeEnv->qinfo;
+
+  for (; pInfo->numOfLaunched < pInfo->numOfMorsels; ++pInfo->numOfLaunched) {
+    SSchedMsg msg = {0};
+    msg.fp = doExecMorselFp;
+    msg.ahandle = &pInfo->pMorsels[pInfo->numOfLaunched];
+    taosScheduleTask(tsQueryParallelSched, &msg);
+  }
+
+  if (!pInfo->upstreamDone) {
+    SOperatorInfo* upstream = pOperator->upstream[0];
+
+    publishOperatorProfEvent(upstream, QUERY_PROF_BEFORE_OPERATOR_EXEC);
+    SSDataBlock* pBlock = upstream->exec(upstream, newgroup);
+    publishOperatorProfEvent(upstream, QUERY_PROF_AFTER_OPERATOR_EXEC);
+
+    if (pBlock != NULL && pBlock->info.rows > 0) {
+      return pBlock;
+    }
+
+    pInfo->upstreamDone = true;
+    waitForMorsels(pInfo);
+
+    for (int32_t i = 0; i < pInfo->numOfMorsels; ++i) {
+      addMorselCost(&pQInfo->summary, &pInfo->pMorsels[i].pQInfo->summary);
+    }
+
+    qDebug("QInfo:0x%"PRIx64" %d morsels completed", pQInfo->qId, pInfo->numOfMorsels);
+  }
+
+  while (pInfo->current < pInfo->numOfMorsels) {
+    SQueryMorsel* pMorsel = &pInfo->pMorsels[pInfo->current];
+    if (!pMorsel->pending) {
+      pMorsel->pBlock = doExecMorsel(pMorsel->pQInfo);
+    }
+
+    if (pMorsel->pQInfo->code != TSDB_CODE_SUCCESS) {
+      longjmp(pRuntimeEnv->env, pMorsel->pQInfo->code);
+    }
+
+    pMorsel->pending = false;
+    if (pMorsel->pBlock != NULL && pMorsel->pBlock->info.rows > 0) {
+      return pMorsel->pBlock;
+    }
+
+    pInfo->current += 1;
+  }
+
+  doSetOperatorCompleted(pOperator);
+  return NULL;
+}
+
+static void destroyParallelMergeOperatorInfo(void* param, int32_t numOfOutput) {
+  SParallelMergeOperatorInfo* pInfo = (SParallelMergeOperatorInfo*) param;
+
+  // the morsels still running are stopped before they are freed
+  if (pInfo->numOfFinished < pInfo->numOfLaunched) {
+    for (int32_t i = 0; i < pInfo->numOfMorsels; ++i) {
+      setQueryKilled(pInfo->pMorsels[i].pQInfo);
+    }
+
+    waitForMorsels(pInfo);
+  }
+
+  for (int32_t i = 0; i < pInfo->numOfMorsels; ++i) {
+    freeQInfo(pInfo->pMorsels[i].pQInfo);
+  }
+
+  tfree(pInfo->pMorsels);
+  tsem_destroy(&pInfo->finished);
+}
+
+SOperatorInfo* createParallelMergeOperatorInfo(SQueryRuntimeEnv* pRuntimeEnv, SOperatorInfo* upstream, SQInfo** pMorsels,
+                                               int32_t numOfMorsels) {
+  SParallelMergeOperatorInfo* pInfo = calloc(1, sizeof(SParallelMergeOperatorInfo));
+  if (pInfo == NULL) {
+    return NULL;
+  }
+
+  pInfo->pMorsels = calloc(numOfMorsels, sizeof(SQueryMorsel));
+  if (pInfo->pMorsels == NULL) {
+    tfree(pInfo);
+    return NULL;
+  }
+
+  SOperatorInfo* pOperator = calloc(1, sizeof(SOperatorInfo));
+  if (pOperator == NULL) {
+    tfree(pInfo->pMorsels);
+    tfree(pInfo);
+    return NULL;
+  }
+
+  tsem_init(&pInfo->finished, 0, 0);
+  pInfo->numOfMorsels = numOfMorsels;
+  for (int32_t i = 0; i < numOfMorsels; ++i) {
+    pInfo->pMorsels[i].pQInfo   = pMorsels[i];
+    pInfo->pMorsels[i].pending  = true;
+    pInfo->pMorsels[i].finished = &pInfo->finished;
+    pMorsels[i]->pParent = pRuntimeEnv->qinfo;
+  }
+
+  pOperator->name         = "ParallelMerge";
+  pOperator->operatorType = OP_ParallelMerge;
+  pOperator->blockingOptr = false;
+  pOperator->status       = OP_IN_EXECUTING;
+  pOperator->info         = pInfo;
+  pOperator->pExpr        = upstream->pExpr;
+  pOperator->numOfOutput  = upstream->numOfOutput;
+  pOperator->pRuntimeEnv  = pRuntimeEnv;
+  pOperator->exec         = doParallelMerge;
+  pOperator->cleanup      = destroyParallelMergeOperatorInfo;
+
+  appendUpstream(pOperator, upstream);
+  return pOperator;
+}
+
 static int32_t getColumnIndexInSource(SQueriedTableInfo *pTableInfo, SSqlExpr *pExpr, SColumnInfo* pTagCols) {
   int32_t j = 0;
 
@@ -9607,7 +10110,7 @@ FORCE_INLINE bool checkQIdEqual(void *qHandle, uint64_t qId) {
 
 SQInfo* createQInfoImpl(SQueryTableMsg* pQueryMsg, SGroupbyExpr* pGroupbyExpr, SExprInfo* pExprs,
                         SExprInfo* pSecExprs, STableGroupInfo* pTableGroupInfo, SColumnInfo* pTagCols, void* pFilters, int32_t vgId,
-                        char* sql, uint64_t qId, SUdfInfo* pUdfInfo) {
+                        char* sql, uint64_t qId, SUdfInfo* pUdfInfo, int8_t queryClass) {
   int16_t numOfCols = pQueryMsg->numOfCols;
   int16_t numOfOutput = pQueryMsg->numOfOutput;
 
@@ -9616,6 +10119,10 @@ SQInfo* createQInfoImpl(SQueryTableMsg* pQueryMsg, SGroupbyExpr* pGroupbyExpr, S
     goto _cleanup_qinfo;
   }
 
+  // the query buffer is charged by checkForQueryBuf before, freeQInfo gives it back on any of the cleanup paths below
+  pQInfo->queryClass = queryClass;
+  pQInfo->queryBufTables = pTableGroupInfo->numOfTables;
+
   pQInfo->qId = qId;
   pQInfo->startExecTs = 0;
 
@@ -9796,6 +10303,7 @@ SQInfo* createQInfoImpl(SQueryTableMsg* pQueryMsg, SGroupbyExpr* pGroupbyExpr, S
   return pQInfo;
 
 _cleanup_qinfo:
+  releaseQueryBuf(pTableGroupInfo->numOfTables, queryClass);
   tsdbDestroyTableGroup(pTableGroupInfo);
 
   if (pGroupbyExpr != NULL) {
@@ -9989,7 +10497,7 @@ void freeQInfo(SQInfo *pQInfo) {
   qDebug("QInfo:0x%"PRIx64" start to free QInfo", pQInfo->qId);
 
   SQueryRuntimeEnv* pRuntimeEnv = &pQInfo->runtimeEnv;
-  releaseQueryBuf(pRuntimeEnv->tableqinfoGroupInfo.numOfTables);
+  releaseQueryBuf(pQInfo->queryBufTables, pQInfo->queryClass);
 
   doDestroyTableQueryInfo(&pRuntimeEnv->tableqinfoGroupInfo);
   teardownQueryRuntimeEnv(&pQInfo->runtimeEnv);
@@ -10090,6 +10598,38 @@ bool doBuildResCheck(SQInfo* pQInfo) {
   return buildRes;
 }
 
+/*
+ * A query can stop before any data block of its master scan only if the operators above the scan keep everything they
+ * have aggregated in their operator info, so that executing the plan again from its root goes on where it stopped.
+ */
+bool canQueryYield(SQInfo* pQInfo) {
+  SQueryRuntimeEnv* pRuntimeEnv = &pQInfo->runtimeEnv;
+  SOperatorInfo*    proot = pRuntimeEnv->proot;
+
+  if (tsQueryYieldTime == 0 || proot == NULL || pRuntimeEnv->pQueryAttr->timeWindowInterpo) {
+    return false;
+  }
+
+  if (proot->operatorType != OP_Aggregate && proot->operatorType != OP_MultiTableAggregate &&
+      proot->operatorType != OP_MultiTableTimeInterval) {
+    return false;
+  }
+
+  int32_t upstreamType = proot->upstream[0]->operatorType;
+  return upstreamType == OP_TableScan || upstreamType == OP_DataBlocksOptScan;
+}
+
+// the result is not ready yet, the query only gives up its owner until it is executed again
+void setQueryYielded(SQInfo* pQInfo) {
+  pthread_mutex_lock(&pQInfo->lock);
+
+  pQInfo->yielded = true;
+  assert(pQInfo->owner == taosGetSelfPthreadId());
+  pQInfo->owner = 0;
+
+  pthread_mutex_unlock(&pQInfo->lock);
+}
+
 static void doSetTagValueToResultBuf(char* output, const char* val, int16_t type, int16_t bytes) {
   if (val == NULL) {
     setNull(output, type, bytes);
@@ -10123,17 +10663,16 @@ static int64_t getQuerySupportBufSize(size_t numOfTables) {
   return (int64_t)((s1 + s2) * 1.5 * numOfTables);
 }
 
-int32_t checkForQueryBuf(size_t numOfTables) {
-  int64_t t = getQuerySupportBufSize(numOfTables);
-  if (tsQueryBufferSizeBytes < 0) {
+static int32_t doCheckForQueryBuf(int64_t* pBufferSizeBytes, int64_t t) {
+  if (*pBufferSizeBytes < 0) {
     return TSDB_CODE_SUCCESS;
-  } else if (tsQueryBufferSizeBytes > 0) {
+  } else if (*pBufferSizeBytes > 0) {
 
     while(1) {
-      int64_t s = tsQueryBufferSizeBytes;
+      int64_t s = *pBufferSizeBytes;
       int64_t remain = s - t;
       if (remain >= 0) {
-        if (atomic_val_compare_exchange_64(&tsQueryBufferSizeBytes, s, remain) == s) {
+        if (atomic_val_compare_exchange_64(pBufferSizeBytes, s, remain) == s) {
           return TSDB_CODE_SUCCESS;
         }
       } else {
@@ -10146,6 +10685,35 @@ int32_t checkForQueryBuf(size_t numOfTables) {
   return TSDB_CODE_QRY_NOT_ENOUGH_BUFFER;
 }
 
+static void doReleaseQueryBuf(int64_t* pBufferSizeBytes, int64_t t) {
+  if (*pBufferSizeBytes < 0) {
+    return;
+  }
+
+  // restore value is not enough buffer available
+  atomic_add_fetch_64(pBufferSizeBytes, t);
+}
+
+// a query of the batch class takes its buffer from the budget of its class as well as from that of the dnode
+int32_t checkForQueryBuf(size_t numOfTables, int8_t queryClass) {
+  int64_t t = getQuerySupportBufSize(numOfTables);
+  if (queryClass != TSDB_QUERY_CLASS_BATCH) {
+    return doCheckForQueryBuf(&tsQueryBufferSizeBytes, t);
+  }
+
+  int32_t code = doCheckForQueryBuf(&tsBatchQueryBufferSizeBytes, t);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  code = doCheckForQueryBuf(&tsQueryBufferSizeBytes, t);
+  if (code != TSDB_CODE_SUCCESS) {
+    doReleaseQueryBuf(&tsBatchQueryBufferSizeBytes, t);
+  }
+
+  return code;
+}
+
 bool checkNeedToCompressQueryCol(SQInfo *pQInfo) {
   SQueryRuntimeEnv* pRuntimeEnv = &pQInfo->runtimeEnv;
   SQueryAttr *pQueryAttr = pRuntimeEnv->pQueryAttr;
@@ -10170,15 +10738,13 @@ bool checkNeedToCompressQueryCol(SQInfo *pQInfo) {
   return false;
 }
 
-void releaseQueryBuf(size_t numOfTables) {
-  if (tsQueryBufferSizeBytes < 0) {
-    return;
-  }
-
+void releaseQueryBuf(size_t numOfTables, int8_t queryClass) {
   int64_t t = getQuerySupportBufSize(numOfTables);
+  doReleaseQueryBuf(&tsQueryBufferSizeBytes, t);
 
-  // restore value is not enough buffer available
-  atomic_add_fetch_64(&tsQueryBufferSizeBytes, t);
+  if (queryClass == TSDB_QUERY_CLASS_BATCH) {
+    doReleaseQueryBuf(&tsBatchQueryBufferSizeBytes, t);
+  }
 }
 
 void freeQueryAttr(SQueryAttr* pQueryAttr) {
@@ -1774,9 +1774,16 @@ void filterFreePCtx(SFilterPCtx *pctx) {
 void filterFreeInfo(SFilterInfo *info) {
   CHK_RETV(info == NULL);
 
+  if (info->cunits != NULL) {
+    for (uint32_t i = 0; i < info->unitNum; ++i) {
+      freeCompiledPattern(info->cunits[i].pattern);
+    }
+  }
+
   tfree(info->cunits);
   tfree(info->blkUnitRes);
   tfree(info->blkUnits);
+  tfree(info->kernelRes);
   
   for (int32_t i = 0; i < FLD_TYPE_MAX; ++i) {
     for (uint32_t f = 0; f < info->fields[i].num; ++f) {
@@ -2635,6 +2642,268 @@ int32_t filterPostProcessRange(SFilterInfo *info) {
 }
 
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FILTER_KERNEL_AVX2
+#endif
+
+// Integer bounds are folded into an inclusive range that never covers the null value, so the two compares of a row
+// answer both the predicate and the null check
+#define FILTER_INT_KERNEL(_name, _type, _val, _null, _attr)                                   \
+  static _attr void _name(const SFilterComUnit *cunit, int32_t numOfRows, int8_t *res) {      \
+    const _type *data = (const _type *)cunit->colData;                                        \
+    const _type  lo = (_type)cunit->lo._val, hi = (_type)cunit->hi._val, null = (_type)_null; \
+    switch (cunit->kernel) {                                                                  \
+      case FILTER_KERNEL_RANGE:                                                               \
+        for (int32_t i = 0; i < numOfRows; ++i) res[i] = (data[i] >= lo) & (data[i] <= hi);   \
+        break;                                                                                \
+      case FILTER_KERNEL_NOT_EQUAL:                                                           \
+        for (int32_t i = 0; i < numOfRows; ++i) res[i] = (data[i] != lo) & (data[i] != null); \
+        break;                                                                                \
+      case FILTER_KERNEL_ISNULL:                                                              \
+        for (int32_t i = 0; i < numOfRows; ++i) res[i] = (data[i] == null);                   \
+        break;                                                                                \
+      default:                                                                                \
+        for (int32_t i = 0; i < numOfRows; ++i) res[i] = (data[i] != null);                   \
+        break;                                                                                \
+    }                                                                                         \
+  }
+
+// Same result as compareFloatVal/compareDoubleVal: values within the tolerance are equal and a NaN is less than any
+// bound, the null value is a NaN so it is told apart by its bits
+#define FILTER_FLT_KERNEL(_name, _type, _btype, _null, _abs, _attr)                                         \
+  static _attr void _name(const SFilterComUnit *cunit, int32_t numOfRows, int8_t *res) {                    \
+    const _type  *data = (const _type *)cunit->colData;                                                     \
+    const _btype *bits = (const _btype *)cunit->colData;                                                    \
+    const _type   lo = (_type)cunit->lo.d, hi = (_type)cunit->hi.d;                                         \
+    const _type   tol = (_type)(FLT_COMPAR_TOL_FACTOR * FLT_EPSILON);                                       \
+    const int8_t  noLo = FILTER_GET_FLAG(cunit->kflag, KERNEL_FLG_NO_LOW) != 0;                             \
+    const int8_t  loInc = FILTER_GET_FLAG(cunit->kflag, KERNEL_FLG_LOW_INC) != 0;                           \
+    const int8_t  noHi = FILTER_GET_FLAG(cunit->kflag, KERNEL_FLG_NO_HIGH) != 0;                            \
+    const int8_t  hiInc = FILTER_GET_FLAG(cunit->kflag, KERNEL_FLG_HIGH_INC) != 0;                          \
+    switch (cunit->kernel) {                                                                                \
+      case FILTER_KERNEL_RANGE:                                                                             \
+        for (int32_t i = 0; i < numOfRows; ++i) {                                                           \
+          int8_t eqLo = _abs(data[i] - lo) <= tol, eqHi = _abs(data[i] - hi) <= tol;                        \
+          res[i] = (bits[i] != (_btype)_null) & (noLo | (eqLo & loInc) | ((!eqLo) & (data[i] > lo))) &      \
+                   (noHi | (eqHi & hiInc) | ((!eqHi) & !(data[i] > hi)));                                   \
+        }                                                                                                   \
+        break;                                                                                              \
+      case FILTER_KERNEL_NOT_EQUAL:                                                                         \
+        for (int32_t i = 0; i < numOfRows; ++i) {                                                           \
+          res[i] = (bits[i] != (_btype)_null) & !(_abs(data[i] - lo) <= tol);                               \
+        }                                                                                                   \
+        break;                                                                                              \
+      case FILTER_KERNEL_ISNULL:                                                                            \
+        for (int32_t i = 0; i < numOfRows; ++i) res[i] = (bits[i] == (_btype)_null);                        \
+        break;                                                                                              \
+      default:                                                                                              \
+        for (int32_t i = 0; i < numOfRows; ++i) res[i] = (bits[i] != (_btype)_null);                        \
+        break;                                                                                              \
+    }                                                                                                       \
+  }
+
+#define FILTER_KERNELS(_sfx, _attr)                                                                                \
+  FILTER_INT_KERNEL(filterKernelInt8##_sfx, int8_t, i, TSDB_DATA_TINYINT_NULL, _attr)                              \
+  FILTER_INT_KERNEL(filterKernelInt16##_sfx, int16_t, i, TSDB_DATA_SMALLINT_NULL, _attr)                           \
+  FILTER_INT_KERNEL(filterKernelInt32##_sfx, int32_t, i, TSDB_DATA_INT_NULL, _attr)                                \
+  FILTER_INT_KERNEL(filterKernelInt64##_sfx, int64_t, i, TSDB_DATA_BIGINT_NULL, _attr)                             \
+  FILTER_INT_KERNEL(filterKernelUint8##_sfx, uint8_t, u, TSDB_DATA_UTINYINT_NULL, _attr)                           \
+  FILTER_INT_KERNEL(filterKernelUint16##_sfx, uint16_t, u, TSDB_DATA_USMALLINT_NULL, _attr)                        \
+  FILTER_INT_KERNEL(filterKernelUint32##_sfx, uint32_t, u, TSDB_DATA_UINT_NULL, _attr)                             \
+  FILTER_INT_KERNEL(filterKernelUint64##_sfx, uint64_t, u, TSDB_DATA_UBIGINT_NULL, _attr)                          \
+  FILTER_FLT_KERNEL(filterKernelFloat##_sfx, float, uint32_t, TSDB_DATA_FLOAT_NULL, fabsf, _attr)                  \
+  FILTER_FLT_KERNEL(filterKernelDouble##_sfx, double, uint64_t, TSDB_DATA_DOUBLE_NULL, fabs, _attr)                \
+                                                                                                                   \
+  static filter_kernel_func gFilterKernel##_sfx[TSDB_DATA_TYPE_UBIGINT + 1] = {                                    \
+      [TSDB_DATA_TYPE_TINYINT] = filterKernelInt8##_sfx,    [TSDB_DATA_TYPE_SMALLINT] = filterKernelInt16##_sfx,   \
+      [TSDB_DATA_TYPE_INT] = filterKernelInt32##_sfx,       [TSDB_DATA_TYPE_BIGINT] = filterKernelInt64##_sfx,     \
+      [TSDB_DATA_TYPE_TIMESTAMP] = filterKernelInt64##_sfx, [TSDB_DATA_TYPE_UTINYINT] = filterKernelUint8##_sfx,   \
+      [TSDB_DATA_TYPE_USMALLINT] = filterKernelUint16##_sfx, [TSDB_DATA_TYPE_UINT] = filterKernelUint32##_sfx,     \
+      [TSDB_DATA_TYPE_UBIGINT] = filterKernelUint64##_sfx,  [TSDB_DATA_TYPE_FLOAT] = filterKernelFloat##_sfx,      \
+      [TSDB_DATA_TYPE_DOUBLE] = filterKernelDouble##_sfx,                                                          \
+  };
+
+FILTER_KERNELS(Scalar, )
+#ifdef FILTER_KERNEL_AVX2
+FILTER_KERNELS(Avx2, __attribute__((target("avx2"))))
+#endif
+
+static filter_kernel_func *gFilterKernel = gFilterKernelScalar;
+static pthread_once_t      filterKernelInit = PTHREAD_ONCE_INIT;
+
+static void filterInitKernels(void) {
+#ifdef FILTER_KERNEL_AVX2
+  if (__builtin_cpu_supports("avx2")) {
+    gFilterKernel = gFilterKernelAvx2;
+  }
+#endif
+  qDebug("filter kernels use %s", gFilterKernel == gFilterKernelScalar ? "scalar code" : "avx2");
+}
+
+// Indexed by rfunc, see gRangeCompare
+static uint8_t gRangeKernelFlag[] = {0,
+                                     KERNEL_FLG_HIGH_INC,
+                                     KERNEL_FLG_LOW_INC,
+                                     KERNEL_FLG_LOW_INC | KERNEL_FLG_HIGH_INC,
+                                     KERNEL_FLG_NO_HIGH,
+                                     KERNEL_FLG_LOW_INC | KERNEL_FLG_NO_HIGH,
+                                     KERNEL_FLG_NO_LOW,
+                                     KERNEL_FLG_NO_LOW | KERNEL_FLG_HIGH_INC};
+
+static void filterSetIntKernelBounds(SFilterComUnit *cunit) {
+  int64_t vmin = 0, vmax = 0, v = 0;
+
+  // the smallest value of a signed type is its null value
+  switch (cunit->dataType) {
+    case TSDB_DATA_TYPE_TINYINT:  vmin = INT8_MIN + 1;  vmax = INT8_MAX;  break;
+    case TSDB_DATA_TYPE_SMALLINT: vmin = INT16_MIN + 1; vmax = INT16_MAX; break;
+    case TSDB_DATA_TYPE_INT:      vmin = INT32_MIN + 1; vmax = INT32_MAX; break;
+    default:                      vmin = INT64_MIN + 1; vmax = INT64_MAX; break;
+  }
+
+  cunit->lo.i = vmin;
+  cunit->hi.i = vmax;
+
+  if (!FILTER_GET_FLAG(cunit->kflag, KERNEL_FLG_NO_LOW)) {
+    GET_TYPED_DATA(v, int64_t, cunit->dataType, cunit->valData);
+    if (FILTER_GET_FLAG(cunit->kflag, KERNEL_FLG_LOW_INC)) {
+      cunit->lo.i = MAX(vmin, v);
+    } else if (v < vmax) {
+      cunit->lo.i = MAX(vmin, v + 1);
+    } else {
+      cunit->lo.i = vmax;
+      cunit->hi.i = vmin;
+      return;
+    }
+  }
+
+  if (!FILTER_GET_FLAG(cunit->kflag, KERNEL_FLG_NO_HIGH)) {
+    GET_TYPED_DATA(v, int64_t, cunit->dataType, cunit->valData2);
+    if (FILTER_GET_FLAG(cunit->kflag, KERNEL_FLG_HIGH_INC)) {
+      cunit->hi.i = MIN(vmax, v);
+    } else if (v > vmin) {
+      cunit->hi.i = MIN(vmax, v - 1);
+    } else {
+      cunit->lo.i = vmax;
+      cunit->hi.i = vmin;
+    }
+  }
+}
+
+static void filterSetUintKernelBounds(SFilterComUnit *cunit) {
+  uint64_t vmax = 0, v = 0;
+
+  // the largest value of an unsigned type is its null value
+  switch (cunit->dataType) {
+    case TSDB_DATA_TYPE_UTINYINT:  vmax = UINT8_MAX - 1;  break;
+    case TSDB_DATA_TYPE_USMALLINT: vmax = UINT16_MAX - 1; break;
+    case TSDB_DATA_TYPE_UINT:      vmax = UINT32_MAX - 1; break;
+    default:                       vmax = UINT64_MAX - 1; break;
+  }
+
+  cunit->lo.u = 0;
+  cunit->hi.u = vmax;
+
+  if (!FILTER_GET_FLAG(cunit->kflag, KERNEL_FLG_NO_LOW)) {
+    GET_TYPED_DATA(v, uint64_t, cunit->dataType, cunit->valData);
+    if (FILTER_GET_FLAG(cunit->kflag, KERNEL_FLG_LOW_INC)) {
+      cunit->lo.u = v;
+    } else if (v < vmax) {
+      cunit->lo.u = v + 1;
+    } else {
+      cunit->lo.u = vmax;
+      cunit->hi.u = 0;
+      return;
+    }
+  }
+
+  if (!FILTER_GET_FLAG(cunit->kflag, KERNEL_FLG_NO_HIGH)) {
+    GET_TYPED_DATA(v, uint64_t, cunit->dataType, cunit->valData2);
+    if (FILTER_GET_FLAG(cunit->kflag, KERNEL_FLG_HIGH_INC)) {
+      cunit->hi.u = MIN(vmax, v);
+    } else if (v > 0) {
+      cunit->hi.u = MIN(vmax, v - 1);
+    } else {
+      cunit->lo.u = vmax;
+      cunit->hi.u = 0;
+    }
+  }
+}
+
+static void filterSetComUnitKernel(SFilterComUnit *cunit) {
+  uint8_t type = cunit->dataType;
+  uint8_t optr = cunit->optr;
+
+  cunit->kernel = FILTER_KERNEL_NONE;
+  cunit->kflag = 0;
+
+  if (type > TSDB_DATA_TYPE_UBIGINT || gFilterKernelScalar[type] == NULL) {
+    return;
+  }
+
+  if (optr == TSDB_RELATION_ISNULL || optr == TSDB_RELATION_NOTNULL) {
+    cunit->kernel = (optr == TSDB_RELATION_ISNULL) ? FILTER_KERNEL_ISNULL : FILTER_KERNEL_NOTNULL;
+    return;
+  }
+
+  if (cunit->valData == NULL) {
+    return;
+  }
+
+  if (optr == TSDB_RELATION_NOT_EQUAL) {
+    if (IS_FLOAT_TYPE(type)) {
+      GET_TYPED_DATA(cunit->lo.d, double, type, cunit->valData);
+      if (isnan(cunit->lo.d)) {
+        return;
+      }
+    } else if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
+      GET_TYPED_DATA(cunit->lo.u, uint64_t, type, cunit->valData);
+    } else {
+      GET_TYPED_DATA(cunit->lo.i, int64_t, type, cunit->valData);
+    }
+
+    cunit->kernel = FILTER_KERNEL_NOT_EQUAL;
+    return;
+  }
+
+  if (optr == TSDB_RELATION_EQUAL) {
+    cunit->kflag = KERNEL_FLG_LOW_INC | KERNEL_FLG_HIGH_INC;
+  } else if (cunit->rfunc >= 0) {
+    cunit->kflag = gRangeKernelFlag[cunit->rfunc];
+  } else {
+    return;
+  }
+
+  if (IS_FLOAT_TYPE(type)) {
+    GET_TYPED_DATA(cunit->lo.d, double, type, cunit->valData);
+    GET_TYPED_DATA(cunit->hi.d, double, type, cunit->valData2);
+    if (isnan(cunit->lo.d) || isnan(cunit->hi.d)) {
+      return;
+    }
+  } else if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
+    filterSetUintKernelBounds(cunit);
+  } else {
+    filterSetIntKernelBounds(cunit);
+  }
+
+  cunit->kernel = FILTER_KERNEL_RANGE;
+}
+
+// The pattern of a json unit is in its tVariant, json values are compared as nchar
+static SCompiledPattern *filterCompileUnitPattern(SFilterComUnit *cunit) {
+  uint8_t optr = cunit->optr;
+  if (cunit->valData == NULL || (optr != TSDB_RELATION_MATCH && optr != TSDB_RELATION_NMATCH && optr != TSDB_RELATION_LIKE)) {
+    return NULL;
+  }
+
+  if (cunit->dataType == TSDB_DATA_TYPE_JSON) {
+    tVariant *val = cunit->valData;
+    return compilePattern(TSDB_DATA_TYPE_NCHAR, optr, val->pz, val->nLen);
+  }
+
+  return compilePattern(cunit->dataType, optr, varDataVal(cunit->valData), varDataLen(cunit->valData));
+}
+
 int32_t filterGenerateComInfo(SFilterInfo *info) {
   info->cunits = malloc(info->unitNum * sizeof(*info->cunits));
   info->blkUnitRes = malloc(sizeof(*info->blkUnitRes) * info->unitNum);
@@ -2666,6 +2935,18 @@ int32_t filterGenerateComInfo(SFilterInfo *info) {
     
     info->cunits[i].dataSize = FILTER_UNIT_COL_SIZE(info, unit);
     info->cunits[i].dataType = FILTER_UNIT_DATA_TYPE(unit);
+    info->cunits[i].dictCodes = NULL;
+    info->cunits[i].pattern = filterCompileUnitPattern(&info->cunits[i]);
+
+    filterSetComUnitKernel(&info->cunits[i]);
+  }
+
+  info->kernelAll = (info->unitNum > 0);
+  for (uint32_t i = 0; i < info->unitNum; ++i) {
+    if (info->cunits[i].kernel == FILTER_KERNEL_NONE) {
+      info->kernelAll = false;
+      break;
+    }
   }
   
   return TSDB_CODE_SUCCESS;
@@ -2676,8 +2957,11 @@ int32_t filterUpdateComUnits(SFilterInfo *info) {
     SFilterUnit *unit = &info->units[i];
 
     info->cunits[i].colData = FILTER_UNIT_COL_DATA(info, unit, 0);
+    info->cunits[i].dictCodes = NULL;
   }
 
+  info->dictAny = false;
+
   return TSDB_CODE_SUCCESS;
 }
 
@@ -2859,6 +3143,94 @@ _return:
   return TSDB_CODE_SUCCESS;
 }
 
+static int32_t filterPrepareKernelRes(SFilterInfo *info, int32_t numOfRows) {
+  if (info->kernelRows >= numOfRows) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int8_t *res = realloc(info->kernelRes, 2 * (size_t)numOfRows);
+  if (res == NULL) {
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
+
+  info->kernelRes = res;
+  info->kernelRows = numOfRows;
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static void filterExecuteUnitRows(SFilterComUnit *cunit, int32_t numOfRows, int8_t *res);
+static void filterExecuteUnitDict(SFilterComUnit *cunit, int32_t numOfRows, int8_t *res);
+
+// The result of a unit with a compiled pattern, a json value only matches when it is a string
+static FORCE_INLINE int8_t filterDoPatternCompare(SFilterComUnit *cunit, void *colData) {
+  if (cunit->dataType == TSDB_DATA_TYPE_JSON) {
+    if (*(char *)colData != TSDB_DATA_TYPE_NCHAR) {
+      return false;
+    }
+
+    colData = POINTER_SHIFT(colData, CHAR_BYTES);
+  }
+
+  return compareCompiledPattern(cunit->pattern, colData) == 0;
+}
+
+static FORCE_INLINE void filterExecuteKernel(SFilterComUnit *cunit, int32_t numOfRows, int8_t *res) {
+  if (cunit->colData == NULL) {
+    memset(res, (cunit->optr == TSDB_RELATION_ISNULL) ? 1 : 0, numOfRows);
+    return;
+  }
+
+  if (cunit->dictCodes != NULL) {
+    filterExecuteUnitDict(cunit, numOfRows, res);
+  } else if (cunit->kernel == FILTER_KERNEL_NONE) {
+    filterExecuteUnitRows(cunit, numOfRows, res);
+  } else {
+    (*gFilterKernel[cunit->dataType])(cunit, numOfRows, res);
+  }
+}
+
+// Groups are evaluated one unit at a time over all rows, instead of one row at a time over all units, the units of
+// a group are ANDed and the groups are ORed into res. Units without a kernel, which only happens when some column has
+// dictionary codes, are evaluated row by row or once for each distinct value.
+static bool filterExecuteKernelImpl(SFilterInfo *info, int32_t numOfRows, int8_t *res, bool blk) {
+  int8_t   *gres = info->kernelRes;
+  int8_t   *ures = info->kernelRes + numOfRows;
+  uint32_t  groupNum = blk ? info->blkGroupNum : info->groupNum;
+  uint32_t *unitIdx = info->blkUnits;
+
+  for (uint32_t g = 0; g < groupNum; ++g) {
+    uint32_t  unitNum = 0;
+    uint32_t *unitIdxs = NULL;
+    int8_t   *dst = (g == 0) ? res : gres;
+
+    if (blk) {
+      unitNum = *(unitIdx++);
+      unitIdxs = unitIdx;
+      unitIdx += unitNum;
+    } else {
+      unitNum = info->groups[g].unitNum;
+      unitIdxs = info->groups[g].unitIdxs;
+    }
+
+    filterExecuteKernel(&info->cunits[unitIdxs[0]], numOfRows, dst);
+    for (uint32_t u = 1; u < unitNum; ++u) {
+      filterExecuteKernel(&info->cunits[unitIdxs[u]], numOfRows, ures);
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        dst[i] &= ures[i];
+      }
+    }
+
+    if (g > 0) {
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        res[i] |= gres[i];
+      }
+    }
+  }
+
+  return memchr(res, 0, numOfRows) == NULL;
+}
+
 bool filterExecuteBasedOnStatisImpl(void *pinfo, int32_t numOfRows, int8_t** p, SDataStatis *statis, int16_t numOfCols) {
   SFilterInfo *info = (SFilterInfo *)pinfo;
   bool all = true;
@@ -2867,6 +3239,10 @@ bool filterExecuteBasedOnStatisImpl(void *pinfo, int32_t numOfRows, int8_t** p,
   if (*p == NULL) {
     *p = calloc(numOfRows, sizeof(int8_t));
   }
+
+  if (info->kernelAll && filterPrepareKernelRes(info, numOfRows) == TSDB_CODE_SUCCESS) {
+    return filterExecuteKernelImpl(info, numOfRows, *p, true);
+  }
   
   for (int32_t i = 0; i < numOfRows; ++i) {
     //FILTER_UNIT_CLR_F(info);
@@ -2893,6 +3269,8 @@ bool filterExecuteBasedOnStatisImpl(void *pinfo, int32_t numOfRows, int8_t** p,
               (*p)[i] = 0;
             } else if (cunit->rfunc >= 0) {
               (*p)[i] = (*gRangeCompare[cunit->rfunc])(colData, colData, cunit->valData, cunit->valData2, gDataCompare[cunit->func]);
+            } else if (cunit->pattern != NULL) {
+              (*p)[i] = filterDoPatternCompare(cunit, colData);
             } else {
               (*p)[i] = filterDoCompare(gDataCompare[cunit->func], cunit->optr, colData, cunit->valData);
             }
@@ -3033,7 +3411,9 @@ static FORCE_INLINE bool filterExecuteImplNotNull(void *pinfo, int32_t numOfRows
 }
 
 static void doJsonCompare(SFilterComUnit *cunit, int8_t *result, void* colData){
-  if(cunit->optr == TSDB_RELATION_MATCH || cunit->optr == TSDB_RELATION_NMATCH){
+  if (cunit->pattern != NULL) {
+    *result = filterDoPatternCompare(cunit, colData);
+  }else if(cunit->optr == TSDB_RELATION_MATCH || cunit->optr == TSDB_RELATION_NMATCH){
     uint8_t  jsonType = *(char*)colData;
     char* realData = POINTER_SHIFT(colData, CHAR_BYTES);
     if (jsonType != TSDB_DATA_TYPE_NCHAR){
@@ -3073,6 +3453,66 @@ static void doJsonCompare(SFilterComUnit *cunit, int8_t *result, void* colData){
   }
 }
 
+// The result of one unit for the value of one row
+static int8_t filterDoUnitCompare(SFilterComUnit *cunit, void *colData) {
+  uint8_t optr = cunit->optr;
+  int8_t  res = 0;
+
+  if (isNull(colData, cunit->dataType)) {
+    return optr == TSDB_RELATION_ISNULL ? true : false;
+  }
+
+  if (optr == TSDB_RELATION_NOTNULL) {
+    return 1;
+  } else if (optr == TSDB_RELATION_ISNULL) {
+    return 0;
+  } else if (cunit->rfunc >= 0) {
+    return (*gRangeCompare[cunit->rfunc])(colData, colData, cunit->valData, cunit->valData2, gDataCompare[cunit->func]);
+  } else if (cunit->pattern != NULL) {
+    return filterDoPatternCompare(cunit, colData);
+  }
+
+  if (cunit->dataType == TSDB_DATA_TYPE_NCHAR && (optr == TSDB_RELATION_MATCH || optr == TSDB_RELATION_NMATCH)) {
+    char *newColData = calloc(cunit->dataSize * TSDB_NCHAR_SIZE + VARSTR_HEADER_SIZE, 1);
+    int32_t len = taosUcs4ToMbs(varDataVal(colData), varDataLen(colData), varDataVal(newColData));
+    if (len < 0) {
+      qError("castConvert1 taosUcs4ToMbs error");
+    } else {
+      varDataSetLen(newColData, len);
+      res = filterDoCompare(gDataCompare[cunit->func], optr, newColData, cunit->valData);
+    }
+    tfree(newColData);
+  } else if (cunit->dataType == TSDB_DATA_TYPE_JSON) {
+    doJsonCompare(cunit, &res, colData);
+  } else {
+    res = filterDoCompare(gDataCompare[cunit->func], optr, colData, cunit->valData);
+  }
+
+  return res;
+}
+
+static void filterExecuteUnitRows(SFilterComUnit *cunit, int32_t numOfRows, int8_t *res) {
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    res[i] = filterDoUnitCompare(cunit, (char *)cunit->colData + cunit->dataSize * i);
+  }
+}
+
+// Rows of the same code have the same value, so each distinct value is compared once, however long the strings or
+// expensive the LIKE or MATCH pattern
+static void filterExecuteUnitDict(SFilterComUnit *cunit, int32_t numOfRows, int8_t *res) {
+  const uint8_t *codes = cunit->dictCodes;
+  int8_t         codeRes[TSDB_STR_DICT_MAX_VALUES];
+
+  memset(codeRes, -1, sizeof(codeRes));
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int8_t *r = codeRes + codes[i];
+    if (*r < 0) {
+      *r = filterDoUnitCompare(cunit, (char *)cunit->colData + cunit->dataSize * i);
+    }
+    res[i] = *r;
+  }
+}
+
 bool filterExecuteImplRange(void *pinfo, int32_t numOfRows, int8_t** p, SDataStatis *statis, int16_t numOfCols) {
   SFilterInfo *info = (SFilterInfo *)pinfo;
   bool all = true;
@@ -3132,7 +3572,9 @@ bool filterExecuteImplMisc(void *pinfo, int32_t numOfRows, int8_t** p, SDataStat
     }
     // match/nmatch for nchar type need convert from ucs4 to mbs
 
-    if(info->cunits[uidx].dataType == TSDB_DATA_TYPE_NCHAR && (info->cunits[uidx].optr == TSDB_RELATION_MATCH || info->cunits[uidx].optr == TSDB_RELATION_NMATCH)){
+    if (info->cunits[uidx].pattern != NULL) {
+      (*p)[i] = filterDoPatternCompare(&info->cunits[uidx], colData);
+    }else if(info->cunits[uidx].dataType == TSDB_DATA_TYPE_NCHAR && (info->cunits[uidx].optr == TSDB_RELATION_MATCH || info->cunits[uidx].optr == TSDB_RELATION_NMATCH)){
       char *newColData = calloc(info->cunits[uidx].dataSize * TSDB_NCHAR_SIZE + VARSTR_HEADER_SIZE, 1);
       int32_t len = taosUcs4ToMbs(varDataVal(colData), varDataLen(colData), varDataVal(newColData));
       if (len < 0){
@@ -3177,42 +3619,12 @@ bool filterExecuteImpl(void *pinfo, int32_t numOfRows, int8_t** p, SDataStatis *
         uint32_t uidx = group->unitIdxs[u];
         SFilterComUnit *cunit = &info->cunits[uidx];
         void *colData = (char *)cunit->colData + cunit->dataSize * i;
-      
-        //if (FILTER_UNIT_GET_F(info, uidx)) {
-        //  p[i] = FILTER_UNIT_GET_R(info, uidx);
-        //} else {
-          uint8_t optr = cunit->optr;
 
-          if (colData == NULL || isNull(colData, cunit->dataType)) {
-            (*p)[i] = optr == TSDB_RELATION_ISNULL ? true : false;
-          } else {
-            if (optr == TSDB_RELATION_NOTNULL) {
-              (*p)[i] = 1;
-            } else if (optr == TSDB_RELATION_ISNULL) {
-              (*p)[i] = 0;
-            } else if (cunit->rfunc >= 0) {
-              (*p)[i] = (*gRangeCompare[cunit->rfunc])(colData, colData, cunit->valData, cunit->valData2, gDataCompare[cunit->func]);
-            } else {
-              if(cunit->dataType == TSDB_DATA_TYPE_NCHAR && (cunit->optr == TSDB_RELATION_MATCH || cunit->optr == TSDB_RELATION_NMATCH)){
-                char *newColData = calloc(cunit->dataSize * TSDB_NCHAR_SIZE + VARSTR_HEADER_SIZE, 1);
-                int32_t len = taosUcs4ToMbs(varDataVal(colData), varDataLen(colData), varDataVal(newColData));
-                if (len < 0){
-                  qError("castConvert1 taosUcs4ToMbs error");
-                }else{
-                  varDataSetLen(newColData, len);
-                  (*p)[i] = filterDoCompare(gDataCompare[cunit->func], cunit->optr, newColData, cunit->valData);
-                }
-                tfree(newColData);
-              }else if(cunit->dataType == TSDB_DATA_TYPE_JSON){
-                doJsonCompare(cunit, &(*p)[i], colData);
-              }else{
-                (*p)[i] = filterDoCompare(gDataCompare[cunit->func], cunit->optr, colData, cunit->valData);
-              }
-            }
-          
-          //FILTER_UNIT_SET_R(info, uidx, p[i]);
-          //FILTER_UNIT_SET_F(info, uidx);
-          }
+        if (colData == NULL) {
+          (*p)[i] = cunit->optr == TSDB_RELATION_ISNULL ? true : false;
+        } else {
+          (*p)[i] = filterDoUnitCompare(cunit, colData);
+        }
 
         if ((*p)[i] == 0) {
           break;
@@ -3233,7 +3645,31 @@ bool filterExecuteImpl(void *pinfo, int32_t numOfRows, int8_t** p, SDataStatis *
 }
 
 
+bool filterExecuteImplKernel(void *pinfo, int32_t numOfRows, int8_t** p, SDataStatis *statis, int16_t numOfCols) {
+  SFilterInfo *info = (SFilterInfo *)pinfo;
+  bool all = true;
+
+  if (filterExecuteBasedOnStatis(info, numOfRows, p, statis, numOfCols, &all) == 0) {
+    return all;
+  }
+
+  if (info->unitNum > 1 && filterPrepareKernelRes(info, numOfRows) != TSDB_CODE_SUCCESS) {
+    return filterExecuteImpl(pinfo, numOfRows, p, NULL, numOfCols);
+  }
+
+  if (*p == NULL) {
+    *p = calloc(numOfRows, sizeof(int8_t));
+  }
+
+  return filterExecuteKernelImpl(info, numOfRows, *p, false);
+}
+
 FORCE_INLINE bool filterExecute(SFilterInfo *info, int32_t numOfRows, int8_t** p, SDataStatis *statis, int16_t numOfCols) {
+  // the codes are set for one block, the units are then evaluated one at a time like the kernels
+  if (info->dictAny) {
+    return filterExecuteImplKernel(info, numOfRows, p, statis, numOfCols);
+  }
+
   return (*info->func)(info, numOfRows, p, statis, numOfCols);
 }
 
@@ -3248,6 +3684,13 @@ int32_t filterSetExecFunc(SFilterInfo *info) {
     return TSDB_CODE_SUCCESS;
   }
 
+  pthread_once(&filterKernelInit, filterInitKernels);
+
+  if (info->kernelAll) {
+    info->func = filterExecuteImplKernel;
+    return TSDB_CODE_SUCCESS;
+  }
+
   if (info->unitNum > 1) {
     info->func = filterExecuteImpl;
     return TSDB_CODE_SUCCESS;
@@ -3336,6 +3779,39 @@ int32_t filterSetColFieldData(SFilterInfo *info, void *param, filer_get_col_from
   return TSDB_CODE_SUCCESS;
 }
 
+// Called after filterSetColFieldData for each block, whose binary and nchar columns may have dictionary codes
+int32_t filterSetColFieldDict(SFilterInfo *info, void *param, filer_get_col_dict_from_id fp) {
+  CHK_LRET(info == NULL, TSDB_CODE_QRY_APP_ERROR, "info NULL");
+
+  if (FILTER_ALL_RES(info) || FILTER_EMPTY_RES(info)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  info->dictAny = false;
+  for (uint32_t i = 0; i < info->unitNum; ++i) {
+    SFilterComUnit *cunit = &info->cunits[i];
+
+    cunit->dictCodes = NULL;
+    if (cunit->dataType == TSDB_DATA_TYPE_BINARY || cunit->dataType == TSDB_DATA_TYPE_NCHAR) {
+      (*fp)(param, cunit->colId, &cunit->dictCodes);
+      info->dictAny = info->dictAny || (cunit->dictCodes != NULL);
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+int32_t filterGetColIdList(SFilterInfo *info, SArray *colIdList) {
+  CHK_LRET(info == NULL || colIdList == NULL, TSDB_CODE_QRY_APP_ERROR, "null parameter");
+
+  for (uint32_t i = 0; i < info->fields[FLD_TYPE_COLUMN].num; ++i) {
+    int16_t colId = FILTER_GET_COL_FIELD_ID(FILTER_GET_COL_FIELD(info, i));
+    taosArrayPush(colIdList, &colId);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t filterSetJsonColFieldData(SFilterInfo *info, void *param, filer_get_col_from_name fp) {
   CHK_LRET(info == NULL, TSDB_CODE_QRY_APP_ERROR, "info NULL");
   CHK_LRET(info->fields[FLD_TYPE_COLUMN].num <= 0, TSDB_CODE_QRY_APP_ERROR, "no column fileds");
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+#include "hashfunc.h"
+#include "qGroupbyHash.h"
+#include "taosdef.h"
+#include "taoserror.h"
+#include "ttype.h"
+
+#define GROUPBY_HASH_INIT_GROUPS 64
+#define GROUPBY_HASH_EMPTY_SLOT  (-1)
+
+#define GROUPBY_HASH_MIX(_h, _v) (((_h) ^ (uint64_t)(_v)) * 0x9E3779B97F4A7C15ULL)
+
+struct SGroupbyHash {
+  int32_t   keyLen;
+  int32_t   size;      // number of groups
+  int32_t   capacity;  // number of groups the arrays below can take
+  int32_t   mask;      // number of slots - 1, there are twice as many slots as groups at most
+  int32_t  *pSlot;     // group number, or GROUPBY_HASH_EMPTY_SLOT
+  uint64_t *pHash;     // hash of each group
+  char     *pKey;      // key of each group, keyLen bytes apart
+  void    **pData;     // value of each group
+};
+
+// the hashes of a block are plain multiply-xor mixes, the bits are spread once here when a slot is chosen
+static FORCE_INLINE int32_t groupbyHashSlot(const SGroupbyHash *pHash, uint64_t hash) {
+  hash ^= hash >> 33;
+  hash *= 0xFF51AFD7ED558CCDULL;
+  hash ^= hash >> 33;
+  return (int32_t)(hash & (uint64_t)pHash->mask);
+}
+
+SGroupbyHash *groupbyHashCreate(int32_t keyLen) {
+  SGroupbyHash *pHash = calloc(1, sizeof(SGroupbyHash));
+  if (pHash == NULL) {
+    return NULL;
+  }
+
+  pHash->keyLen = keyLen;
+  pHash->capacity = GROUPBY_HASH_INIT_GROUPS;
+  pHash->mask = GROUPBY_HASH_INIT_GROUPS * 2 - 1;
+  pHash->pSlot = malloc(sizeof(int32_t) * (pHash->mask + 1));
+  pHash->pHash = malloc(sizeof(uint64_t) * pHash->capacity);
+  pHash->pKey = malloc((size_t)keyLen * pHash->capacity);
+  pHash->pData = malloc(POINTER_BYTES * pHash->capacity);
+
+  if (pHash->pSlot == NULL || pHash->pHash == NULL || pHash->pKey == NULL || pHash->pData == NULL) {
+    groupbyHashDestroy(pHash);
+    return NULL;
+  }
+
+  memset(pHash->pSlot, 0xFF, sizeof(int32_t) * (pHash->mask + 1));
+  return pHash;
+}
+
+void groupbyHashDestroy(SGroupbyHash *pHash) {
+  if (pHash == NULL) {
+    return;
+  }
+
+  tfree(pHash->pSlot);
+  tfree(pHash->pHash);
+  tfree(pHash->pKey);
+  tfree(pHash->pData);
+  free(pHash);
+}
+
+int32_t groupbyHashGetSize(const SGroupbyHash *pHash) { return pHash->size; }
+
+void *groupbyHashGet(const SGroupbyHash *pHash, uint64_t hash, const char *key) {
+  for (int32_t i = groupbyHashSlot(pHash, hash);; i = (i + 1) & pHash->mask) {
+    int32_t group = pHash->pSlot[i];
+    if (group == GROUPBY_HASH_EMPTY_SLOT) {
+      return NULL;
+    }
+
+    if (pHash->pHash[group] == hash && memcmp(pHash->pKey + (size_t)group * pHash->keyLen, key, pHash->keyLen) == 0) {
+      return pHash->pData[group];
+    }
+  }
+}
+
+// the groups keep their number, only the slots are laid out again from the stored hashes
+static int32_t groupbyHashGrow(SGroupbyHash *pHash) {
+  int32_t capacity = pHash->capacity * 2;
+
+  uint64_t *pNewHash = realloc(pHash->pHash, sizeof(uint64_t) * capacity);
+  if (pNewHash == NULL) {
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
+  pHash->pHash = pNewHash;
+
+  char *pNewKey = realloc(pHash->pKey, (size_t)pHash->keyLen * capacity);
+  if (pNewKey == NULL) {
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
+  pHash->pKey = pNewKey;
+
+  void **pNewData = realloc(pHash->pData, POINTER_BYTES * capacity);
+  if (pNewData == NULL) {
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
+  pHash->pData = pNewData;
+
+  int32_t *pNewSlot = malloc(sizeof(int32_t) * capacity * 2);
+  if (pNewSlot == NULL) {
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
+
+  free(pHash->pSlot);
+  pHash->pSlot = pNewSlot;
+  pHash->capacity = capacity;
+  pHash->mask = capacity * 2 - 1;
+  memset(pHash->pSlot, 0xFF, sizeof(int32_t) * capacity * 2);
+
+  for (int32_t group = 0; group < pHash->size; ++group) {
+    int32_t i = groupbyHashSlot(pHash, pHash->pHash[group]);
+    while (pHash->pSlot[i] != GROUPBY_HASH_EMPTY_SLOT) {
+      i = (i + 1) & pHash->mask;
+    }
+    pHash->pSlot[i] = group;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+int32_t groupbyHashPut(SGroupbyHash *pHash, uint64_t hash, const char *key, void *pData) {
+  if (pHash->size == pHash->capacity) {
+    int32_t code = groupbyHashGrow(pHash);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  int32_t i = groupbyHashSlot(pHash, hash);
+  while (pHash->pSlot[i] != GROUPBY_HASH_EMPTY_SLOT) {
+    i = (i + 1) & pHash->mask;
+  }
+
+  int32_t group = pHash->size++;
+  pHash->pSlot[i] = group;
+  pHash->pHash[group] = hash;
+  pHash->pData[group] = pData;
+  memcpy(pHash->pKey + (size_t)group * pHash->keyLen, key, pHash->keyLen);
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// -0.0 and 0.0 are one group, and nulls are kept as their sentinel value
+#define GROUPBY_HASH_FLT_COLUMN(_type, _btype)                        \
+  do {                                                                \
+    const _type *data = (const _type *)pData;                         \
+    for (int32_t i = 0; i < numOfRows; ++i) {                         \
+      _type  v = (data[i] == 0) ? 0 : data[i];                        \
+      _btype b;                                                       \
+      memcpy(&b, &v, sizeof(b));                                      \
+      hash[i] = GROUPBY_HASH_MIX(hash[i], b);                         \
+    }                                                                 \
+  } while (0)
+
+#define GROUPBY_HASH_INT_COLUMN(_type)                                \
+  do {                                                                \
+    const _type *data = (const _type *)pData;                         \
+    for (int32_t i = 0; i < numOfRows; ++i) {                         \
+      hash[i] = GROUPBY_HASH_MIX(hash[i], data[i]);                   \
+    }                                                                 \
+  } while (0)
+
+void groupbyHashColumn(const char *pData, int32_t type, int32_t bytes, int32_t numOfRows, uint64_t *hash) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_UTINYINT:
+      GROUPBY_HASH_INT_COLUMN(uint8_t);
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_USMALLINT:
+      GROUPBY_HASH_INT_COLUMN(uint16_t);
+      break;
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_UINT:
+      GROUPBY_HASH_INT_COLUMN(uint32_t);
+      break;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_UBIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      GROUPBY_HASH_INT_COLUMN(uint64_t);
+      break;
+    case TSDB_DATA_TYPE_FLOAT:
+      GROUPBY_HASH_FLT_COLUMN(float, uint32_t);
+      break;
+    case TSDB_DATA_TYPE_DOUBLE:
+      GROUPBY_HASH_FLT_COLUMN(double, uint64_t);
+      break;
+    default:
+      assert(IS_VAR_DATA_TYPE(type));
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        const char *val = pData + (size_t)i * bytes;
+        hash[i] = GROUPBY_HASH_MIX(hash[i], MurmurHash3_32(val, varDataTLen(val)));
+      }
+      break;
+  }
+}
+
+void groupbyKeyColumn(char *pSlot, const char *val, int32_t type, int32_t bytes) {
+  if (IS_VAR_DATA_TYPE(type)) {
+    int32_t len = varDataTLen(val);
+    memcpy(pSlot, val, len);
+    memset(pSlot + len, 0, bytes - len);
+  } else if (type == TSDB_DATA_TYPE_FLOAT && GET_FLOAT_VAL(val) == 0) {
+    memset(pSlot, 0, sizeof(float));
+  } else if (type == TSDB_DATA_TYPE_DOUBLE && GET_DOUBLE_VAL(val) == 0) {
+    memset(pSlot, 0, sizeof(double));
+  } else {
+    memcpy(pSlot, val, bytes);
+  }
+}
@@ -65,6 +65,7 @@ int32_t initResultRowInfo(SResultRowInfo *pResultRowInfo, int32_t size, int16_t
   pResultRowInfo->size     = 0;
   pResultRowInfo->curPos  = -1;
   pResultRowInfo->capacity = size;
+  pResultRowInfo->pWindowIndex = NULL;
 
   pResultRowInfo->pResult = calloc(pResultRowInfo->capacity, POINTER_BYTES);
   if (pResultRowInfo->pResult == NULL) {
@@ -79,6 +80,8 @@ void cleanupResultRowInfo(SResultRowInfo *pResultRowInfo) {
     return;
   }
 
+  destroyWindowIndex(pResultRowInfo);
+
   if (pResultRowInfo->capacity == 0) {
     assert(pResultRowInfo->pResult == NULL);
     return;
@@ -119,6 +122,183 @@ void resetResultRowInfo(SQueryRuntimeEnv *pRuntimeEnv, SResultRowInfo *pResultRo
 
   pResultRowInfo->size     = 0;
   pResultRowInfo->curPos  = -1;
+
+  if (pResultRowInfo->pWindowIndex != NULL) {
+    tfree(pResultRowInfo->pWindowIndex->pos);
+    pResultRowInfo->pWindowIndex->numOfSlots = 0;
+  }
+}
+
+int32_t initWindowIndex(SResultRowInfo *pResultRowInfo, int64_t sliding, uint64_t groupId) {
+  assert(pResultRowInfo->pWindowIndex == NULL && sliding > 0);
+
+  SWindowIndex *pIndex = calloc(1, sizeof(SWindowIndex));
+  if (pIndex == NULL) {
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
+
+  pIndex->sliding = sliding;
+  pIndex->groupId = groupId;
+  pResultRowInfo->pWindowIndex = pIndex;
+  return TSDB_CODE_SUCCESS;
+}
+
+void destroyWindowIndex(SResultRowInfo *pResultRowInfo) {
+  if (pResultRowInfo->pWindowIndex == NULL) {
+    return;
+  }
+
+  tfree(pResultRowInfo->pWindowIndex->pos);
+  tfree(pResultRowInfo->pWindowIndex);
+}
+
+static FORCE_INLINE bool getWindowIndexSlot(const SWindowIndex *pIndex, TSKEY skey, int64_t *slot) {
+  int64_t offset = skey - pIndex->skey;
+  if (offset % pIndex->sliding != 0) {
+    return false;
+  }
+
+  *slot = offset / pIndex->sliding;
+  return true;
+}
+
+int32_t getWindowIndexPos(SResultRowInfo *pResultRowInfo, TSKEY skey) {
+  SWindowIndex *pIndex = pResultRowInfo->pWindowIndex;
+
+  int64_t slot = 0;
+  if (pIndex->numOfSlots == 0 || !getWindowIndexSlot(pIndex, skey, &slot) || slot < 0 || slot >= pIndex->numOfSlots) {
+    return -1;
+  }
+
+  return pIndex->pos[slot];
+}
+
+/*
+ * The slots grow towards the new window, both ascending and descending scans are covered. A window that is not
+ * aligned with the first one, or too far away from it, is not taken and the caller falls back to the hash tables.
+ */
+int32_t putWindowIndexPos(SResultRowInfo *pResultRowInfo, TSKEY skey, int32_t pos) {
+  SWindowIndex *pIndex = pResultRowInfo->pWindowIndex;
+  if (pIndex->numOfSlots == 0) {
+    pIndex->skey = skey;
+  }
+
+  int64_t slot = 0;
+  if (!getWindowIndexSlot(pIndex, skey, &slot)) {
+    return TSDB_CODE_QRY_TOO_MANY_TIMEWINDOW;
+  }
+
+  if (slot < 0 || slot >= pIndex->numOfSlots) {
+    int64_t num = MAX(slot, pIndex->numOfSlots - 1) - MIN(slot, 0) + 1;
+    if (num > MAX_INTERVAL_TIME_WINDOW) {
+      return TSDB_CODE_QRY_TOO_MANY_TIMEWINDOW;
+    }
+
+    int64_t numOfSlots = MAX(num, pIndex->numOfSlots * 2L);
+    numOfSlots = MIN(numOfSlots, MAX_INTERVAL_TIME_WINDOW);
+    numOfSlots = MAX(numOfSlots, 64);
+
+    int32_t *p = malloc(sizeof(int32_t) * numOfSlots);
+    if (p == NULL) {
+      return TSDB_CODE_QRY_OUT_OF_MEMORY;
+    }
+
+    // the existing slots move to the end when the index grows towards the earlier windows
+    int64_t shift = (slot < 0) ? numOfSlots - pIndex->numOfSlots : 0;
+    memset(p, 0xFF, sizeof(int32_t) * numOfSlots);
+    if (pIndex->numOfSlots > 0) {
+      memcpy(p + shift, pIndex->pos, sizeof(int32_t) * pIndex->numOfSlots);
+    }
+
+    free(pIndex->pos);
+    pIndex->pos = p;
+    pIndex->skey -= shift * pIndex->sliding;
+    pIndex->numOfSlots = (int32_t)numOfSlots;
+    slot += shift;
+  }
+
+  pIndex->pos[slot] = pos;
+  return TSDB_CODE_SUCCESS;
+}
+
+// the positions change once the result rows are sorted
+void rebuildWindowIndex(SResultRowInfo *pResultRowInfo) {
+  SWindowIndex *pIndex = pResultRowInfo->pWindowIndex;
+  if (pIndex == NULL || pIndex->numOfSlots == 0) {
+    return;
+  }
+
+  memset(pIndex->pos, 0xFF, sizeof(int32_t) * pIndex->numOfSlots);
+  for (int32_t i = 0; i < pResultRowInfo->size; ++i) {
+    int64_t slot = 0;
+    bool    ret = getWindowIndexSlot(pIndex, pResultRowInfo->pResult[i]->win.skey, &slot);
+    assert(ret && slot >= 0 && slot < pIndex->numOfSlots);
+    pIndex->pos[slot] = i;
+  }
+}
+
+static void destroyMorsels(STableGroupInfo *pMorsels, int32_t numOfMorsels) {
+  for (int32_t k = 0; k < numOfMorsels; ++k) {
+    size_t numOfGroups = taosArrayGetSize(pMorsels[k].pGroupList);
+    for (int32_t i = 0; i < numOfGroups; ++i) {
+      SArray *p = taosArrayGetP(pMorsels[k].pGroupList, i);
+      taosArrayDestroy(&p);
+    }
+
+    taosArrayDestroy(&pMorsels[k].pGroupList);
+  }
+}
+
+int32_t splitTableGroupInfo(STableGroupInfo *pGroupInfo, int32_t numOfMorsels, STableGroupInfo *pMorsels) {
+  assert(numOfMorsels > 0 && numOfMorsels <= (int32_t)pGroupInfo->numOfTables);
+  memset(pMorsels, 0, sizeof(STableGroupInfo) * numOfMorsels);
+
+  for (int32_t k = 0; k < numOfMorsels; ++k) {
+    pMorsels[k].sVersion = pGroupInfo->sVersion;
+    pMorsels[k].tVersion = pGroupInfo->tVersion;
+    pMorsels[k].pGroupList = taosArrayInit(4, POINTER_BYTES);
+    if (pMorsels[k].pGroupList == NULL) {
+      destroyMorsels(pMorsels, numOfMorsels);
+      return TSDB_CODE_QRY_OUT_OF_MEMORY;
+    }
+  }
+
+  int64_t index = 0;
+  size_t  numOfGroups = taosArrayGetSize(pGroupInfo->pGroupList);
+  for (int32_t i = 0; i < numOfGroups; ++i) {
+    SArray *pa = taosArrayGetP(pGroupInfo->pGroupList, i);
+    SArray *p1 = NULL;
+    int32_t cur = -1;
+
+    size_t numOfTables = taosArrayGetSize(pa);
+    for (int32_t j = 0; j < numOfTables; ++j, ++index) {
+      int32_t k = (int32_t)(index * numOfMorsels / pGroupInfo->numOfTables);
+      if (k != cur) {
+        p1 = taosArrayInit(MIN(numOfTables - j, pGroupInfo->numOfTables / numOfMorsels + 1), sizeof(STableKeyInfo));
+        if (p1 == NULL || taosArrayPush(pMorsels[k].pGroupList, &p1) == NULL) {
+          taosArrayDestroy(&p1);
+          destroyMorsels(pMorsels, numOfMorsels);
+          return TSDB_CODE_QRY_OUT_OF_MEMORY;
+        }
+        cur = k;
+      }
+
+      taosArrayPush(p1, taosArrayGet(pa, j));
+      pMorsels[k].numOfTables += 1;
+    }
+  }
+
+  // the tables are referred to by the morsels from now on
+  for (int32_t i = 0; i < numOfGroups; ++i) {
+    SArray *p = taosArrayGetP(pGroupInfo->pGroupList, i);
+    taosArrayDestroy(&p);
+  }
+
+  taosArrayDestroy(&pGroupInfo->pGroupList);
+  taosHashCleanup(pGroupInfo->map);
+  pGroupInfo->map = NULL;
+  pGroupInfo->numOfTables = 0;
+  return TSDB_CODE_SUCCESS;
 }
 
 int32_t numOfClosedResultRows(SResultRowInfo *pResultRowInfo) {
@@ -67,7 +67,132 @@ void freeParam(SQueryParam *param) {
   tfree(param->prevResult);
 }
 
-int32_t qCreateQueryInfo(void* tsdb, int32_t vgId, SQueryTableMsg* pQueryMsg, qinfo_t* pQInfo, uint64_t qId) {
+static void destroyTableGroups(STableGroupInfo* pGroupInfo, int32_t numOfGroupInfo) {
+  for (int32_t i = 0; i < numOfGroupInfo; ++i) {
+    tsdbDestroyTableGroup(&pGroupInfo[i]);
+  }
+}
+
+// a morsel is queried by a QInfo of its own, which is built from the same message as the QInfo of the first morsel
+static int32_t createMorselQInfo(void* tsdb, int32_t vgId, SQueryTableMsg* pQueryMsg, SQueryParam* param, SQInfo* pFirst,
+                                 STableGroupInfo* pGroupInfo, SQInfo** pMorsel) {
+  SExprInfo*    pExprs = NULL;
+  SExprInfo*    pSecExprs = NULL;
+  void*         pFilters = NULL;
+  SGroupbyExpr* pGroupbyExpr = NULL;
+  SColumnInfo*  pTagCols = NULL;
+  int32_t       code = TSDB_CODE_SUCCESS;
+
+  *pMorsel = NULL;
+
+  if (pQueryMsg->numOfTags > 0) {
+    pTagCols = malloc(sizeof(SColumnInfo) * pQueryMsg->numOfTags);
+    if (pTagCols == NULL) {
+      code = TSDB_CODE_QRY_OUT_OF_MEMORY;
+      goto _error;
+    }
+
+    memcpy(pTagCols, pFirst->query.tagColList, sizeof(SColumnInfo) * pQueryMsg->numOfTags);
+  }
+
+  SQueriedTableInfo info = { .numOfTags = pQueryMsg->numOfTags, .numOfCols = pQueryMsg->numOfCols, .colList = pQueryMsg->tableCols};
+  if ((code = createQueryFunc(&info, pQueryMsg->numOfOutput, &pExprs, param->pExpr, pTagCols, pQueryMsg->queryType,
+                              pQueryMsg, NULL)) != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  if (param->pSecExpr != NULL) {
+    if ((code = createIndirectQueryFuncExprFromMsg(pQueryMsg, pQueryMsg->secondStageOutput, &pSecExprs, param->pSecExpr,
+                                                   pExprs, NULL)) != TSDB_CODE_SUCCESS) {
+      goto _error;
+    }
+  }
+
+  if (param->colCond != NULL) {
+    if ((code = createQueryFilter(param->colCond, pQueryMsg->colCondLen, &pFilters)) != TSDB_CODE_SUCCESS) {
+      goto _error;
+    }
+  }
+
+  pGroupbyExpr = createGroupbyExprFromMsg(pQueryMsg, param->pGroupColIndex, &code);
+  if ((pGroupbyExpr == NULL && pQueryMsg->numOfGroupCols != 0) || code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  if ((code = checkForQueryBuf(pGroupInfo->numOfTables, pFirst->queryClass)) != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  // the expressions, filters and the tables are owned by the QInfo from now on, even if it fails
+  *pMorsel = createQInfoImpl(pQueryMsg, pGroupbyExpr, pExprs, pSecExprs, pGroupInfo, pTagCols, pFilters, vgId, NULL,
+                             pFirst->qId, NULL, pFirst->queryClass);
+  if (*pMorsel == NULL) {
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
+
+  code = initQInfo(&pQueryMsg->tsBuf, tsdb, NULL, *pMorsel, param, (char*)pQueryMsg, 0, NULL);
+  if (code != TSDB_CODE_SUCCESS) {
+    *pMorsel = NULL;
+  }
+
+  return code;
+
+_error:
+  tsdbDestroyTableGroup(pGroupInfo);
+  destroyQueryFuncExpr(pExprs, (pExprs == NULL) ? 0 : pQueryMsg->numOfOutput);
+  destroyQueryFuncExpr(pSecExprs, (pSecExprs == NULL) ? 0 : pQueryMsg->secondStageOutput);
+  filterFreeInfo(pFilters);
+  if (pGroupbyExpr != NULL) {
+    taosArrayDestroy(&pGroupbyExpr->columnInfo);
+    free(pGroupbyExpr);
+  }
+
+  tfree(pTagCols);
+  return code;
+}
+
+// the other morsels are queried on the parallel pool, and their results are returned after those of the first one
+static int32_t setupParallelQuery(void* tsdb, int32_t vgId, SQueryTableMsg* pQueryMsg, SQueryParam* param, SQInfo* pFirst,
+                                  STableGroupInfo* pGroupInfo, int32_t numOfMorsels) {
+  SQueryRuntimeEnv* pRuntimeEnv = &pFirst->runtimeEnv;
+  if (pRuntimeEnv->proot == NULL) {  // no data in the query time range
+    destroyTableGroups(pGroupInfo, numOfMorsels);
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SQInfo* pMorsels[TSDB_MAX_QUERY_PARALLEL_DEGREE] = {0};
+  int32_t code = TSDB_CODE_SUCCESS;
+
+  int32_t i = 0;
+  for (; i < numOfMorsels; ++i) {
+    code = createMorselQInfo(tsdb, vgId, pQueryMsg, param, pFirst, &pGroupInfo[i], &pMorsels[i]);
+    if (code != TSDB_CODE_SUCCESS) {
+      break;
+    }
+  }
+
+  if (code == TSDB_CODE_SUCCESS) {
+    SOperatorInfo* pOperator = createParallelMergeOperatorInfo(pRuntimeEnv, pRuntimeEnv->proot, pMorsels, numOfMorsels);
+    if (pOperator != NULL) {
+      pRuntimeEnv->proot = pOperator;
+      qDebug("QInfo:0x%"PRIx64" query split into %d morsels", pFirst->qId, numOfMorsels + 1);
+      return TSDB_CODE_SUCCESS;
+    }
+
+    code = TSDB_CODE_QRY_OUT_OF_MEMORY;
+  } else {
+    destroyTableGroups(&pGroupInfo[i + 1], numOfMorsels - i - 1);
+  }
+
+  for (int32_t j = 0; j < i; ++j) {
+    freeQInfo(pMorsels[j]);
+  }
+
+  return code;
+}
+
+int32_t qCreateQueryInfo(void* tsdb, int32_t vgId, SQueryTableMsg* pQueryMsg, qinfo_t* pQInfo, uint64_t qId,
+                         int8_t queryClass) {
   assert(pQueryMsg != NULL && tsdb != NULL);
 
   int32_t code = TSDB_CODE_SUCCESS;
@@ -172,14 +297,26 @@ int32_t qCreateQueryInfo(void* tsdb, int32_t vgId, SQueryTableMsg* pQueryMsg, qi
     goto _over;
   }
 
-  code = checkForQueryBuf(tableGroupInfo.numOfTables);
+  // the first morsel is queried by the QInfo returned, see setupParallelQuery
+  STableGroupInfo morsels[TSDB_MAX_QUERY_PARALLEL_DEGREE];
+  int32_t numOfMorsels = getQueryParallelDegree(pQueryMsg, &param, tableGroupInfo.numOfTables);
+  if (numOfMorsels > 1) {
+    if (splitTableGroupInfo(&tableGroupInfo, numOfMorsels, morsels) == TSDB_CODE_SUCCESS) {
+      tableGroupInfo = morsels[0];
+    } else {
+      numOfMorsels = 1;
+    }
+  }
+
+  code = checkForQueryBuf(tableGroupInfo.numOfTables, queryClass);
   if (code != TSDB_CODE_SUCCESS) {  // not enough query buffer, abort
+    destroyTableGroups(&morsels[1], numOfMorsels - 1);
     goto _over;
   }
 
   assert(pQueryMsg->stableQuery == isSTableQuery);
   (*pQInfo) = createQInfoImpl(pQueryMsg, param.pGroupbyExpr, param.pExprs, param.pSecExprs, &tableGroupInfo,
-                              param.pTagColumnInfo, param.pFilters, vgId, param.sql, qId, param.pUdfInfo);
+                              param.pTagColumnInfo, param.pFilters, vgId, param.sql, qId, param.pUdfInfo, queryClass);
 
   param.sql    = NULL;
   param.pExprs = NULL;
@@ -189,12 +326,21 @@ int32_t qCreateQueryInfo(void* tsdb, int32_t vgId, SQueryTableMsg* pQueryMsg, qi
   param.pFilters = NULL;
 
   if ((*pQInfo) == NULL) {
+    destroyTableGroups(&morsels[1], numOfMorsels - 1);
     code = TSDB_CODE_QRY_OUT_OF_MEMORY;
     goto _over;
   }
   param.pUdfInfo = NULL;
 
   code = initQInfo(&pQueryMsg->tsBuf, tsdb, NULL, *pQInfo, &param, (char*)pQueryMsg, pQueryMsg->prevResultLen, NULL);
+  if (numOfMorsels > 1) {
+    if (code != TSDB_CODE_SUCCESS) {
+      destroyTableGroups(&morsels[1], numOfMorsels - 1);
+    } else if ((code = setupParallelQuery(tsdb, vgId, pQueryMsg, &param, *pQInfo, &morsels[1], numOfMorsels - 1)) !=
+               TSDB_CODE_SUCCESS) {
+      freeQInfo(*pQInfo);
+    }
+  }
 
   _over:
   if (param.pGroupbyExpr != NULL) {
@@ -238,6 +384,7 @@ bool qTableQuery(qinfo_t qinfo, uint64_t *qId) {
   }
 
   *qId = pQInfo->qId;
+  pQInfo->yielded = false;
   if(pQInfo->startExecTs == 0) {
     pQInfo->startExecTs = taosGetTimestampMs();
     pQInfo->lastRetrieveTs = pQInfo->startExecTs;
@@ -257,9 +404,20 @@ bool qTableQuery(qinfo_t qinfo, uint64_t *qId) {
     return doBuildResCheck(pQInfo);
   }
 
+  pQInfo->yieldTs = canQueryYield(pQInfo) ? taosGetTimestampMs() + tsQueryYieldTime : 0;
+
+  int64_t st = taosGetTimestampUs();
+
   // error occurs, record the error code and return to client
   int32_t ret = setjmp(pQInfo->runtimeEnv.env);
-  if (ret != TSDB_CODE_SUCCESS) {
+  if (ret == TSDB_CODE_QRY_YIELDED) {
+    // close the operator executions left open by the jump, the plan is executed from its root next time
+    publishQueryAbortEvent(pQInfo, ret);
+    pQInfo->summary.elapsedTime += (taosGetTimestampUs() - st);
+    qDebug("QInfo:0x%"PRIx64" query yields after %d ms", pQInfo->qId, tsQueryYieldTime);
+    setQueryYielded(pQInfo);
+    return false;
+  } else if (ret != TSDB_CODE_SUCCESS) {
     publishQueryAbortEvent(pQInfo, ret);
     pQInfo->code = ret;
     qDebug("QInfo:0x%"PRIx64" query abort due to error/cancel occurs, code:%s", pQInfo->qId, tstrerror(pQInfo->code));
@@ -271,7 +429,6 @@ bool qTableQuery(qinfo_t qinfo, uint64_t *qId) {
   bool newgroup = false;
   publishOperatorProfEvent(pRuntimeEnv->proot, QUERY_PROF_BEFORE_OPERATOR_EXEC);
 
-  int64_t st = taosGetTimestampUs();
   pRuntimeEnv->outputBuf = pRuntimeEnv->proot->exec(pRuntimeEnv->proot, &newgroup);
   pQInfo->summary.elapsedTime += (taosGetTimestampUs() - st);
 #ifdef TEST_IMPL
@@ -454,6 +611,16 @@ int32_t qQueryCompleted(qinfo_t qinfo) {
   return isQueryKilled(pQInfo) || Q_STATUS_EQUAL(pQInfo->runtimeEnv.status, QUERY_OVER);
 }
 
+int8_t qGetQueryClass(qinfo_t qinfo) {
+  SQInfo *pQInfo = (SQInfo *)qinfo;
+  return isValidQInfo(pQInfo) ? pQInfo->queryClass : TSDB_QUERY_CLASS_INTERACTIVE;
+}
+
+bool qQueryYielded(qinfo_t qinfo) {
+  SQInfo *pQInfo = (SQInfo *)qinfo;
+  return isValidQInfo(pQInfo) && pQInfo->yielded;
+}
+
 void qDestroyQueryInfo(qinfo_t qHandle) {
   SQInfo* pQInfo = (SQInfo*) qHandle;
   if (!isValidQInfo(pQInfo)) {
@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "os.h"
+#include "taos.h"
+#include "taosdef.h"
+#include "ttype.h"
+
+#include "qAggKernel.h"
+
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+
+namespace {
+
+const int32_t numOfRows = 4099;  // not a multiple of any vector width
+
+int32_t kernelTypes[] = {TSDB_DATA_TYPE_TINYINT,  TSDB_DATA_TYPE_SMALLINT,  TSDB_DATA_TYPE_INT,  TSDB_DATA_TYPE_BIGINT,
+                         TSDB_DATA_TYPE_UTINYINT, TSDB_DATA_TYPE_USMALLINT, TSDB_DATA_TYPE_UINT, TSDB_DATA_TYPE_UBIGINT,
+                         TSDB_DATA_TYPE_FLOAT,    TSDB_DATA_TYPE_DOUBLE};
+
+// Small values keep every sum exact whatever the order of the additions, one row in ten is null if asked
+char *fillAggCol(int32_t type, bool withNull) {
+  int32_t bytes = tDataTypes[type].bytes;
+  char   *data = (char *)calloc(numOfRows, bytes);
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    char *p = data + i * bytes;
+    if (withNull && rand() % 10 == 0) {
+      setNull(p, type, bytes);
+      continue;
+    }
+
+    int64_t v = rand() % 201 - 100;
+    if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
+      v += 100;
+    }
+
+    switch (type) {
+      case TSDB_DATA_TYPE_TINYINT:   *(int8_t *)p = (int8_t)v; break;
+      case TSDB_DATA_TYPE_SMALLINT:  *(int16_t *)p = (int16_t)v; break;
+      case TSDB_DATA_TYPE_INT:       *(int32_t *)p = (int32_t)v; break;
+      case TSDB_DATA_TYPE_BIGINT:    *(int64_t *)p = v; break;
+      case TSDB_DATA_TYPE_UTINYINT:  *(uint8_t *)p = (uint8_t)v; break;
+      case TSDB_DATA_TYPE_USMALLINT: *(uint16_t *)p = (uint16_t)v; break;
+      case TSDB_DATA_TYPE_UINT:      *(uint32_t *)p = (uint32_t)v; break;
+      case TSDB_DATA_TYPE_UBIGINT:   *(uint64_t *)p = (uint64_t)v; break;
+      case TSDB_DATA_TYPE_FLOAT:     *(float *)p = (float)v / 4; break;
+      case TSDB_DATA_TYPE_DOUBLE:    *(double *)p = (double)v / 4; break;
+      default: break;
+    }
+  }
+
+  return data;
+}
+
+double getAggVal(const char *p, int32_t type) {
+  double v = 0;
+  GET_TYPED_DATA(v, double, type, p);
+  return v;
+}
+
+void setAggVal(char *p, int32_t type, double v) {
+  SET_TYPED_DATA(p, type, v);
+}
+
+// min_function and max_function before the kernels: every row that improves the output replaces it
+int32_t refMinMax(const char *data, int32_t type, bool isMin, char *pOutput) {
+  int32_t bytes = tDataTypes[type].bytes;
+  int32_t index = -1;
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    const char *p = data + i * bytes;
+    if (isNull(p, type)) {
+      continue;
+    }
+
+    if ((getAggVal(pOutput, type) < getAggVal(p, type)) ^ isMin) {
+      memcpy(pOutput, p, bytes);
+      index = i;
+    }
+  }
+
+  return index;
+}
+
+void checkAggKernel(int32_t type, bool withNull) {
+  const SAggKernel *pKernel = aggGetKernel(type);
+  ASSERT_NE(pKernel, nullptr);
+
+  char   *data = fillAggCol(type, withNull);
+  int32_t bytes = tDataTypes[type].bytes;
+
+  int32_t num = 0;
+  double  sum = 0;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    const char *p = data + i * bytes;
+    if (!isNull(p, type)) {
+      num += 1;
+      sum += getAggVal(p, type);
+    }
+  }
+
+  EXPECT_EQ((*pKernel->count)(data, numOfRows), num);
+
+  // the sum starts from a previous block
+  if (IS_SIGNED_NUMERIC_TYPE(type)) {
+    int64_t s = 7;
+    EXPECT_EQ((*pKernel->sum)(data, numOfRows, withNull, &s), num);
+    EXPECT_EQ(s, (int64_t)sum + 7);
+  } else if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
+    uint64_t s = 7;
+    EXPECT_EQ((*pKernel->sum)(data, numOfRows, withNull, &s), num);
+    EXPECT_EQ(s, (uint64_t)sum + 7);
+  } else {
+    double s = 7;
+    EXPECT_EQ((*pKernel->sum)(data, numOfRows, withNull, &s), num);
+    EXPECT_EQ(s, sum + 7);
+  }
+
+  double avg = 7;
+  EXPECT_EQ((*pKernel->avg)(data, numOfRows, withNull, &avg), num);
+  EXPECT_EQ(avg, sum + 7);
+
+  // from the setup value, then from values on both sides of the result
+  double starts[] = {0, 10, 90};
+  for (int32_t isMin = 0; isMin <= 1; ++isMin) {
+    for (size_t s = 0; s < sizeof(starts) / sizeof(starts[0]); ++s) {
+      char expected[8] = {0}, output[8] = {0};
+      setAggVal(expected, type, starts[s]);
+      setAggVal(output, type, starts[s]);
+
+      int32_t index = -1;
+      int32_t expectedIndex = refMinMax(data, type, isMin, expected);
+      EXPECT_EQ((*pKernel->minMax)(data, numOfRows, withNull, isMin, output, &index), num);
+      EXPECT_EQ(index, expectedIndex) << "type " << type << " isMin " << isMin << " start " << starts[s];
+      EXPECT_EQ(memcmp(output, expected, bytes), 0);
+    }
+  }
+
+  free(data);
+}
+
+}  // namespace
+
+TEST(testCase, aggKernelTest) {
+  srand(0);
+  for (size_t t = 0; t < sizeof(kernelTypes) / sizeof(kernelTypes[0]); ++t) {
+    checkAggKernel(kernelTypes[t], false);
+    checkAggKernel(kernelTypes[t], true);
+  }
+
+  // an all null block has no result
+  char    data[64];
+  int32_t index = 0;
+  int32_t output = 5;
+  for (int32_t i = 0; i < 16; ++i) {
+    setNull(data + i * sizeof(int32_t), TSDB_DATA_TYPE_INT, sizeof(int32_t));
+  }
+
+  const SAggKernel *pKernel = aggGetKernel(TSDB_DATA_TYPE_INT);
+  EXPECT_EQ((*pKernel->minMax)(data, 16, true, true, &output, &index), 0);
+  EXPECT_EQ(index, -1);
+  EXPECT_EQ(output, 5);
+
+  // an empty block has no result either, even when the output is still at the value the search starts from
+  int32_t ints[] = {INT32_MIN, INT32_MAX};
+  for (int32_t isMin = 0; isMin <= 1; ++isMin) {
+    output = ints[isMin];
+    index = 0;
+    EXPECT_EQ((*pKernel->minMax)(data, 0, false, isMin, &output, &index), 0);
+    EXPECT_EQ(index, -1);
+    EXPECT_EQ(output, ints[isMin]);
+  }
+
+  uint64_t uints[] = {0, UINT64_MAX};
+  for (int32_t isMin = 0; isMin <= 1; ++isMin) {
+    uint64_t u = uints[isMin];
+    index = 0;
+    EXPECT_EQ((*aggGetKernel(TSDB_DATA_TYPE_UBIGINT)->minMax)(data, 0, false, isMin, &u, &index), 0);
+    EXPECT_EQ(index, -1);
+    EXPECT_EQ(u, uints[isMin]);
+  }
+
+  EXPECT_EQ(aggGetKernel(TSDB_DATA_TYPE_BINARY), nullptr);
+  EXPECT_EQ(aggGetKernel(TSDB_DATA_TYPE_BOOL)->sum, nullptr);
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <iostream>
+
+#include "os.h"
+#include "taos.h"
+#include "taosdef.h"
+#include "tarithoperator.h"
+#include "tcompare.h"
+#include "ttype.h"
+
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+
+namespace {
+
+const int32_t numOfRows = 1031;  // more than one block, and not a multiple of any vector width
+
+int32_t arithTypes[] = {TSDB_DATA_TYPE_TINYINT,  TSDB_DATA_TYPE_SMALLINT,  TSDB_DATA_TYPE_INT,  TSDB_DATA_TYPE_BIGINT,
+                        TSDB_DATA_TYPE_UTINYINT, TSDB_DATA_TYPE_USMALLINT, TSDB_DATA_TYPE_UINT, TSDB_DATA_TYPE_UBIGINT,
+                        TSDB_DATA_TYPE_FLOAT,    TSDB_DATA_TYPE_DOUBLE};
+
+int32_t arithOptrs[] = {TSDB_BINARY_OP_ADD, TSDB_BINARY_OP_SUBTRACT, TSDB_BINARY_OP_MULTIPLY, TSDB_BINARY_OP_DIVIDE,
+                        TSDB_BINARY_OP_REMAINDER};
+
+// one row in eight is null and one in eight is zero, so that divisions by zero are covered
+char *fillArithCol(int32_t type, int32_t rows) {
+  int32_t bytes = tDataTypes[type].bytes;
+  char   *data = (char *)calloc(rows, bytes);
+
+  for (int32_t i = 0; i < rows; ++i) {
+    char *p = data + i * bytes;
+    if (rand() % 8 == 0) {
+      setNull(p, type, bytes);
+      continue;
+    }
+
+    double v = (rand() % 8 == 0) ? 0 : rand() % 100 + 1;
+    if (IS_SIGNED_NUMERIC_TYPE(type) && rand() % 2 == 0) {
+      v = -v;
+    } else if (IS_FLOAT_TYPE(type)) {
+      v /= 3;
+    }
+    SET_TYPED_DATA(p, type, v);
+  }
+
+  return data;
+}
+
+// the row by row evaluation the kernels replace
+uint64_t refArith(int32_t optr, const char *pLeft, int32_t leftType, const char *pRight, int32_t rightType) {
+  double out = 0;
+  if (isNull(pLeft, leftType) || isNull(pRight, rightType)) {
+    SET_DOUBLE_NULL(&out);
+  } else {
+    double l = 0, r = 0;
+    GET_TYPED_DATA(l, double, leftType, pLeft);
+    GET_TYPED_DATA(r, double, rightType, pRight);
+
+    if ((optr == TSDB_BINARY_OP_DIVIDE || optr == TSDB_BINARY_OP_REMAINDER) && FLT_EQUAL(r, 0.0)) {
+      SET_DOUBLE_NULL(&out);
+    } else if (optr == TSDB_BINARY_OP_ADD) {
+      out = l + r;
+    } else if (optr == TSDB_BINARY_OP_SUBTRACT) {
+      out = l - r;
+    } else if (optr == TSDB_BINARY_OP_MULTIPLY) {
+      out = l * r;
+    } else if (optr == TSDB_BINARY_OP_DIVIDE) {
+      out = l / r;
+    } else {
+      out = l - ((int64_t)(l / r)) * r;
+    }
+  }
+
+  uint64_t bits;
+  memcpy(&bits, &out, sizeof(bits));
+  return bits;
+}
+
+void checkArith(int32_t optr, int32_t leftType, int32_t rightType, int32_t leftRows, int32_t rightRows, int32_t order) {
+  char   *left = fillArithCol(leftType, leftRows);
+  char   *right = fillArithCol(rightType, rightRows);
+  int32_t rows = MAX(leftRows, rightRows);
+
+  uint64_t *output = (uint64_t *)calloc(rows, sizeof(uint64_t));
+  getArithmeticOperatorFn(optr)(left, leftRows, leftType, right, rightRows, rightType, output, order);
+
+  for (int32_t k = 0; k < rows; ++k) {
+    int32_t i = (order == TSDB_ORDER_ASC) ? k : rows - 1 - k;
+    const char *pLeft = left + ((leftRows == 1) ? 0 : i) * tDataTypes[leftType].bytes;
+    const char *pRight = right + ((rightRows == 1) ? 0 : i) * tDataTypes[rightType].bytes;
+
+    ASSERT_EQ(output[k], refArith(optr, pLeft, leftType, pRight, rightType))
+        << "optr " << optr << " types " << leftType << "," << rightType << " rows " << leftRows << "," << rightRows
+        << " order " << order << " row " << k;
+  }
+
+  free(output);
+  free(left);
+  free(right);
+}
+
+}  // namespace
+
+TEST(testCase, arithmeticKernelTest) {
+  srand(0);
+  for (size_t o = 0; o < sizeof(arithOptrs) / sizeof(arithOptrs[0]); ++o) {
+    for (size_t l = 0; l < sizeof(arithTypes) / sizeof(arithTypes[0]); ++l) {
+      for (size_t r = 0; r < sizeof(arithTypes) / sizeof(arithTypes[0]); ++r) {
+        checkArith(arithOptrs[o], arithTypes[l], arithTypes[r], numOfRows, numOfRows, TSDB_ORDER_ASC);
+        checkArith(arithOptrs[o], arithTypes[l], arithTypes[r], numOfRows, numOfRows, TSDB_ORDER_DESC);
+        checkArith(arithOptrs[o], arithTypes[l], arithTypes[r], 1, numOfRows, TSDB_ORDER_ASC);
+        checkArith(arithOptrs[o], arithTypes[l], arithTypes[r], numOfRows, 1, TSDB_ORDER_DESC);
+      }
+    }
+  }
+
+  // a null constant makes every row null
+  int32_t  nullInt = TSDB_DATA_INT_NULL;
+  double   col[4] = {1, 2, 3, 4};
+  uint64_t output[4] = {0};
+  getArithmeticOperatorFn(TSDB_BINARY_OP_ADD)(&nullInt, 1, TSDB_DATA_TYPE_INT, col, 4, TSDB_DATA_TYPE_DOUBLE, output,
+                                              TSDB_ORDER_ASC);
+  for (int32_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(output[i], (uint64_t)TSDB_DATA_DOUBLE_NULL);
+  }
+}
+
+TEST(testCase, arithmeticRemainderTest) {
+  // zero divisors, null and infinite operands, and quotients out of the range of int64_t
+  double   left[6] = {7, 7, 0, 1e300, -1e30, 5.5};
+  double   right[6] = {0, 0, 0, 7, 3, 2};
+  uint64_t output[6] = {0};
+  SET_DOUBLE_NULL(&left[1]);
+  right[5] = INFINITY;
+  getArithmeticOperatorFn(TSDB_BINARY_OP_REMAINDER)(left, 6, TSDB_DATA_TYPE_DOUBLE, right, 6, TSDB_DATA_TYPE_DOUBLE,
+                                                    output, TSDB_ORDER_ASC);
+  for (int32_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(output[i], (uint64_t)TSDB_DATA_DOUBLE_NULL) << "row " << i;
+  }
+
+  double out[6];
+  memcpy(out, output, sizeof(out));
+  EXPECT_DOUBLE_EQ(out[3], 1e300 - trunc(1e300 / 7) * 7);
+  EXPECT_DOUBLE_EQ(out[4], -1e30 - trunc(-1e30 / 3) * 3);
+  EXPECT_TRUE(std::isnan(out[5]));
+}
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "taos.h"
+#include "taosdef.h"
+#include "tcompare.h"
+
+#include "qFilter.h"
+
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+
+namespace {
+
+const int32_t numOfRows = 4099;
+const int32_t colBytes = VARSTR_HEADER_SIZE + 16;
+
+const char *dictValues[] = {"running", "stopped", "error", "starting", "maintenance", NULL};
+
+// A binary column block as the query sees it, values in fixed size slots, and the dictionary codes of its rows
+typedef struct SDictCol {
+  char    *data;
+  uint8_t *codes;
+} SDictCol;
+
+tExprNode *createColNode() {
+  tExprNode *pNode = (tExprNode *)calloc(1, sizeof(tExprNode));
+  pNode->nodeType = TSQL_NODE_COL;
+  pNode->pSchema = (SSchema *)calloc(1, sizeof(SSchema));
+  pNode->pSchema->type = TSDB_DATA_TYPE_BINARY;
+  pNode->pSchema->bytes = colBytes;
+  pNode->pSchema->colId = 1;
+  return pNode;
+}
+
+tExprNode *createValNode(const char *v) {
+  tExprNode *pNode = (tExprNode *)calloc(1, sizeof(tExprNode));
+  pNode->nodeType = TSQL_NODE_VALUE;
+  pNode->pVal = (tVariant *)calloc(1, sizeof(tVariant));
+  pNode->pVal->nType = TSDB_DATA_TYPE_BINARY;
+  pNode->pVal->nLen = (int32_t)strlen(v);
+  pNode->pVal->pz = strdup(v);
+  return pNode;
+}
+
+tExprNode *createExprNode(uint8_t optr, tExprNode *pLeft, tExprNode *pRight) {
+  tExprNode *pNode = (tExprNode *)calloc(1, sizeof(tExprNode));
+  pNode->nodeType = TSQL_NODE_EXPR;
+  pNode->_node.optr = optr;
+  pNode->_node.pLeft = pLeft;
+  pNode->_node.pRight = pRight;
+  return pNode;
+}
+
+tExprNode *createCompNode(uint8_t optr, const char *v) {
+  bool nullOptr = (optr == TSDB_RELATION_ISNULL || optr == TSDB_RELATION_NOTNULL);
+  return createExprNode(optr, createColNode(), nullOptr ? NULL : createValNode(v));
+}
+
+int32_t getDictColData(void *param, int32_t colId, void **data) {
+  *data = ((SDictCol *)param)->data;
+  return TSDB_CODE_SUCCESS;
+}
+
+int32_t getDictColCodes(void *param, int32_t colId, const uint8_t **codes) {
+  *codes = ((SDictCol *)param)->codes;
+  return TSDB_CODE_SUCCESS;
+}
+
+void fillDictCol(SDictCol *pCol) {
+  pCol->data = (char *)calloc(numOfRows, colBytes);
+  pCol->codes = (uint8_t *)calloc(numOfRows, sizeof(uint8_t));
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    char       *p = pCol->data + i * colBytes;
+    int32_t     code = rand() % tListLen(dictValues);
+    const char *v = dictValues[code];
+
+    pCol->codes[i] = (uint8_t)code;
+    if (v == NULL) {
+      setVardataNull(p, TSDB_DATA_TYPE_BINARY);
+    } else {
+      STR_TO_VARSTR(p, v);
+    }
+  }
+}
+
+// Executes the filter with and without the codes of the column, both must give the same rows
+void checkDictFilter(tExprNode *pExpr, SDictCol *pCol) {
+  SFilterInfo *pInfo = NULL;
+  ASSERT_EQ(filterInitFromTree(pExpr, (void **)&pInfo, 0), TSDB_CODE_SUCCESS);
+  tExprTreeDestroy(pExpr, NULL);
+  ASSERT_NE(pInfo, (SFilterInfo *)NULL);
+
+  int8_t res[2][numOfRows];
+  for (int32_t d = 0; d < 2; ++d) {
+    filterSetColFieldData(pInfo, pCol, getDictColData);
+    if (d == 1) {
+      filterSetColFieldDict(pInfo, pCol, getDictColCodes);
+    }
+
+    int8_t *p = NULL;
+    bool    all = filterExecute(pInfo, numOfRows, &p, NULL, 0);
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      res[d][i] = all ? 1 : (p ? p[i] : 0);
+    }
+    tfree(p);
+  }
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    ASSERT_EQ(res[0][i], res[1][i]) << "row:" << i;
+  }
+
+  filterFreeInfo(pInfo);
+}
+
+}  // namespace
+
+TEST(testCase, filterDictTest) {
+  SDictCol col = {0};
+
+  srand(0);
+  fillDictCol(&col);
+
+  checkDictFilter(createCompNode(TSDB_RELATION_EQUAL, "error"), &col);
+  checkDictFilter(createCompNode(TSDB_RELATION_EQUAL, "unknown"), &col);
+  checkDictFilter(createCompNode(TSDB_RELATION_NOT_EQUAL, "running"), &col);
+  checkDictFilter(createCompNode(TSDB_RELATION_LIKE, "st%"), &col);
+  checkDictFilter(createCompNode(TSDB_RELATION_ISNULL, NULL), &col);
+  checkDictFilter(createCompNode(TSDB_RELATION_NOTNULL, NULL), &col);
+
+  // the shape IN takes, one group for each value
+  checkDictFilter(createExprNode(TSDB_RELATION_OR, createCompNode(TSDB_RELATION_EQUAL, "running"),
+                                 createExprNode(TSDB_RELATION_OR, createCompNode(TSDB_RELATION_EQUAL, "stopped"),
+                                                createCompNode(TSDB_RELATION_ISNULL, NULL))),
+                  &col);
+
+  checkDictFilter(createExprNode(TSDB_RELATION_AND, createCompNode(TSDB_RELATION_LIKE, "%ing"),
+                                 createCompNode(TSDB_RELATION_NOT_EQUAL, "starting")),
+                  &col);
+
+  free(col.data);
+  free(col.codes);
+}
@@ -0,0 +1,250 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "taos.h"
+#include "taosdef.h"
+#include "tcompare.h"
+
+#include "qFilter.h"
+
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+
+namespace {
+
+const int32_t numOfRows = 4099;  // not a multiple of any vector width
+
+typedef struct SKernelCol {
+  int16_t colId;
+  int8_t  type;
+  char   *data;
+} SKernelCol;
+
+tExprNode *createColNode(SKernelCol *pCol) {
+  tExprNode *pNode = (tExprNode *)calloc(1, sizeof(tExprNode));
+  pNode->nodeType = TSQL_NODE_COL;
+  pNode->pSchema = (SSchema *)calloc(1, sizeof(SSchema));
+  pNode->pSchema->type = pCol->type;
+  pNode->pSchema->bytes = tDataTypes[pCol->type].bytes;
+  pNode->pSchema->colId = pCol->colId;
+  return pNode;
+}
+
+tExprNode *createValNode(double v) {
+  tExprNode *pNode = (tExprNode *)calloc(1, sizeof(tExprNode));
+  pNode->nodeType = TSQL_NODE_VALUE;
+  pNode->pVal = (tVariant *)calloc(1, sizeof(tVariant));
+  if (v == (int64_t)v) {
+    pNode->pVal->nType = TSDB_DATA_TYPE_BIGINT;
+    pNode->pVal->i64 = (int64_t)v;
+  } else {
+    pNode->pVal->nType = TSDB_DATA_TYPE_DOUBLE;
+    pNode->pVal->dKey = v;
+  }
+  pNode->pVal->nLen = tDataTypes[pNode->pVal->nType].bytes;
+  return pNode;
+}
+
+tExprNode *createExprNode(uint8_t optr, tExprNode *pLeft, tExprNode *pRight) {
+  tExprNode *pNode = (tExprNode *)calloc(1, sizeof(tExprNode));
+  pNode->nodeType = TSQL_NODE_EXPR;
+  pNode->_node.optr = optr;
+  pNode->_node.pLeft = pLeft;
+  pNode->_node.pRight = pRight;
+  return pNode;
+}
+
+tExprNode *createCompNode(SKernelCol *pCol, uint8_t optr, double v) {
+  bool nullOptr = (optr == TSDB_RELATION_ISNULL || optr == TSDB_RELATION_NOTNULL);
+  return createExprNode(optr, createColNode(pCol), nullOptr ? NULL : createValNode(v));
+}
+
+int32_t getKernelColData(void *param, int32_t colId, void **data) {
+  SKernelCol *pCols = (SKernelCol *)param;
+  for (SKernelCol *pCol = pCols; pCol->data != NULL; ++pCol) {
+    if (pCol->colId == colId) {
+      *data = pCol->data;
+      return TSDB_CODE_SUCCESS;
+    }
+  }
+  return TSDB_CODE_QRY_APP_ERROR;
+}
+
+// Values are kept small so that the bounds below cut through the data, one row in ten is null
+void fillKernelCol(SKernelCol *pCol) {
+  int32_t bytes = tDataTypes[pCol->type].bytes;
+  pCol->data = (char *)calloc(numOfRows, bytes);
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    char *p = pCol->data + i * bytes;
+    if (rand() % 10 == 0) {
+      setNull(p, pCol->type, bytes);
+      continue;
+    }
+
+    int64_t v = rand() % 41 - 20;
+    if (IS_UNSIGNED_NUMERIC_TYPE(pCol->type)) {
+      v += 20;
+    }
+
+    switch (pCol->type) {
+      case TSDB_DATA_TYPE_TINYINT:   *(int8_t *)p = (int8_t)v; break;
+      case TSDB_DATA_TYPE_SMALLINT:  *(int16_t *)p = (int16_t)v; break;
+      case TSDB_DATA_TYPE_INT:       *(int32_t *)p = (int32_t)v; break;
+      case TSDB_DATA_TYPE_BIGINT:    *(int64_t *)p = v; break;
+      case TSDB_DATA_TYPE_UTINYINT:  *(uint8_t *)p = (uint8_t)v; break;
+      case TSDB_DATA_TYPE_USMALLINT: *(uint16_t *)p = (uint16_t)v; break;
+      case TSDB_DATA_TYPE_UINT:      *(uint32_t *)p = (uint32_t)v; break;
+      case TSDB_DATA_TYPE_UBIGINT:   *(uint64_t *)p = (uint64_t)v; break;
+      case TSDB_DATA_TYPE_FLOAT:     *(float *)p = (float)v / 4; break;
+      case TSDB_DATA_TYPE_DOUBLE:    *(double *)p = (double)v / 4; break;
+      default: break;
+    }
+  }
+}
+
+// What the row by row evaluation gives for one comparison
+bool compareKernelRow(SKernelCol *pCol, int32_t row, uint8_t optr, double v) {
+  char *p = pCol->data + row * tDataTypes[pCol->type].bytes;
+  if (isNull(p, pCol->type)) {
+    return optr == TSDB_RELATION_ISNULL;
+  }
+
+  int32_t cmp = 0;
+  if (pCol->type == TSDB_DATA_TYPE_FLOAT) {
+    float fv = (float)v;
+    cmp = compareFloatVal(p, &fv);
+  } else if (pCol->type == TSDB_DATA_TYPE_DOUBLE) {
+    cmp = compareDoubleVal(p, &v);
+  } else {
+    double dv = 0;
+    GET_TYPED_DATA(dv, double, pCol->type, p);
+    cmp = (dv > v) ? 1 : ((dv < v) ? -1 : 0);
+  }
+
+  switch (optr) {
+    case TSDB_RELATION_GREATER:       return cmp > 0;
+    case TSDB_RELATION_GREATER_EQUAL: return cmp >= 0;
+    case TSDB_RELATION_LESS:          return cmp < 0;
+    case TSDB_RELATION_LESS_EQUAL:    return cmp <= 0;
+    case TSDB_RELATION_EQUAL:         return cmp == 0;
+    case TSDB_RELATION_NOT_EQUAL:     return cmp != 0;
+    case TSDB_RELATION_NOTNULL:       return true;
+    default:                          return false;
+  }
+}
+
+void executeKernelFilter(tExprNode *pExpr, SKernelCol *pCols, int8_t *res) {
+  SFilterInfo *pInfo = NULL;
+  ASSERT_EQ(filterInitFromTree(pExpr, (void **)&pInfo, 0), TSDB_CODE_SUCCESS);
+  tExprTreeDestroy(pExpr, NULL);
+
+  if (pInfo == NULL) {  // the condition is always true
+    memset(res, 1, numOfRows);
+    return;
+  }
+
+  filterSetColFieldData(pInfo, pCols, getKernelColData);
+
+  int8_t *p = NULL;
+  bool    all = filterExecute(pInfo, numOfRows, &p, NULL, 0);
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    res[i] = all ? 1 : (p ? p[i] : 0);
+  }
+
+  tfree(p);
+  filterFreeInfo(pInfo);
+}
+
+// the parser turns <> on a numeric column into < or >
+uint8_t kernelOptrs[] = {TSDB_RELATION_GREATER,    TSDB_RELATION_GREATER_EQUAL, TSDB_RELATION_LESS,
+                         TSDB_RELATION_LESS_EQUAL, TSDB_RELATION_EQUAL,         TSDB_RELATION_ISNULL,
+                         TSDB_RELATION_NOTNULL};
+
+double kernelVals[] = {-25, -20, -2.5, -1, 0, 0.25, 1, 3, 20, 40, 60};
+
+void singleUnitTest(SKernelCol *pCols) {
+  int8_t res[numOfRows];
+
+  for (SKernelCol *pCol = pCols; pCol->data != NULL; ++pCol) {
+    for (int32_t o = 0; o < (int32_t)tListLen(kernelOptrs); ++o) {
+      for (int32_t v = 0; v < (int32_t)tListLen(kernelVals); ++v) {
+        uint8_t optr = kernelOptrs[o];
+        double  val = kernelVals[v];
+
+        // the parser never builds a value that does not fit the column
+        if (IS_UNSIGNED_NUMERIC_TYPE(pCol->type) && val < 0) continue;
+        if (!IS_FLOAT_TYPE(pCol->type) && val != (int64_t)val) continue;
+
+        executeKernelFilter(createCompNode(pCol, optr, val), pCols, res);
+        for (int32_t i = 0; i < numOfRows; ++i) {
+          ASSERT_EQ(res[i], compareKernelRow(pCol, i, optr, val))
+              << "type:" << (int)pCol->type << " optr:" << (int)optr << " val:" << val << " row:" << i;
+        }
+      }
+    }
+  }
+}
+
+void multiUnitTest(SKernelCol *pCols) {
+  int8_t res[numOfRows];
+
+  for (SKernelCol *pCol = pCols; pCol->data != NULL; ++pCol) {
+    SKernelCol *pNext = (pCol + 1)->data ? pCol + 1 : pCols;
+
+    // range on one column, merged into one unit
+    executeKernelFilter(createExprNode(TSDB_RELATION_AND, createCompNode(pCol, TSDB_RELATION_GREATER, 1),
+                                       createCompNode(pCol, TSDB_RELATION_LESS_EQUAL, 10)),
+                        pCols, res);
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      ASSERT_EQ(res[i], compareKernelRow(pCol, i, TSDB_RELATION_GREATER, 1) &&
+                            compareKernelRow(pCol, i, TSDB_RELATION_LESS_EQUAL, 10));
+    }
+
+    // the shape IN takes, one group for each value
+    executeKernelFilter(
+        createExprNode(TSDB_RELATION_OR, createCompNode(pCol, TSDB_RELATION_EQUAL, 2),
+                       createExprNode(TSDB_RELATION_OR, createCompNode(pCol, TSDB_RELATION_EQUAL, 5),
+                                      createCompNode(pCol, TSDB_RELATION_ISNULL, 0))),
+        pCols, res);
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      ASSERT_EQ(res[i], compareKernelRow(pCol, i, TSDB_RELATION_EQUAL, 2) ||
+                            compareKernelRow(pCol, i, TSDB_RELATION_EQUAL, 5) ||
+                            compareKernelRow(pCol, i, TSDB_RELATION_ISNULL, 0));
+    }
+
+    // two columns in one group, or'ed with a third unit
+    executeKernelFilter(
+        createExprNode(TSDB_RELATION_OR,
+                       createExprNode(TSDB_RELATION_AND, createCompNode(pCol, TSDB_RELATION_GREATER_EQUAL, 3),
+                                      createCompNode(pNext, TSDB_RELATION_GREATER, 4)),
+                       createCompNode(pCol, TSDB_RELATION_LESS, 1)),
+        pCols, res);
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      ASSERT_EQ(res[i], (compareKernelRow(pCol, i, TSDB_RELATION_GREATER_EQUAL, 3) &&
+                         compareKernelRow(pNext, i, TSDB_RELATION_GREATER, 4)) ||
+                            compareKernelRow(pCol, i, TSDB_RELATION_LESS, 1));
+    }
+  }
+}
+
+}  // namespace
+
+TEST(testCase, filterKernelTest) {
+  SKernelCol cols[] = {{1, TSDB_DATA_TYPE_TINYINT},  {2, TSDB_DATA_TYPE_SMALLINT}, {3, TSDB_DATA_TYPE_INT},
+                       {4, TSDB_DATA_TYPE_BIGINT},   {5, TSDB_DATA_TYPE_UTINYINT}, {6, TSDB_DATA_TYPE_USMALLINT},
+                       {7, TSDB_DATA_TYPE_UINT},     {8, TSDB_DATA_TYPE_UBIGINT},  {9, TSDB_DATA_TYPE_FLOAT},
+                       {10, TSDB_DATA_TYPE_DOUBLE},  {0, 0, NULL}};
+
+  srand(0);
+  for (SKernelCol *pCol = cols; pCol->type != 0; ++pCol) {
+    fillKernelCol(pCol);
+  }
+
+  singleUnitTest(cols);
+  multiUnitTest(cols);
+
+  for (SKernelCol *pCol = cols; pCol->data != NULL; ++pCol) {
+    free(pCol->data);
+  }
+}
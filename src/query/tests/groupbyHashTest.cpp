@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "os.h"
+#include "taos.h"
+#include "taosdef.h"
+#include "taoserror.h"
+#include "tdataformat.h"
+#include "ttype.h"
+
+#include "qGroupbyHash.h"
+
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+
+namespace {
+
+// a key of an int column and a binary(8) column
+const int32_t keyLen = sizeof(int32_t) + VARSTR_HEADER_SIZE + 8;
+
+void buildKey(char *key, uint64_t *hash, int32_t v, const char *str) {
+  char val[VARSTR_HEADER_SIZE + 8] = {0};
+  STR_TO_VARSTR(val, str);
+
+  *hash = 0;
+  groupbyHashColumn((char *)&v, TSDB_DATA_TYPE_INT, sizeof(int32_t), 1, hash);
+  groupbyHashColumn(val, TSDB_DATA_TYPE_BINARY, sizeof(val), 1, hash);
+
+  memset(key, 0x7F, keyLen);
+  groupbyKeyColumn(key, (char *)&v, TSDB_DATA_TYPE_INT, sizeof(int32_t));
+  groupbyKeyColumn(key + sizeof(int32_t), val, TSDB_DATA_TYPE_BINARY, sizeof(val));
+}
+
+}  // namespace
+
+TEST(testCase, groupbyHashTest) {
+  SGroupbyHash *pHash = groupbyHashCreate(keyLen);
+  ASSERT_NE(pHash, nullptr);
+
+  char     key[keyLen];
+  char     str[8];
+  uint64_t hash = 0;
+
+  // enough groups to grow the table several times
+  const int32_t numOfGroups = 10000;
+  for (int32_t i = 0; i < numOfGroups; ++i) {
+    snprintf(str, sizeof(str), "s%d", i % 7);
+    buildKey(key, &hash, i, str);
+    EXPECT_EQ(groupbyHashGet(pHash, hash, key), nullptr);
+    EXPECT_EQ(groupbyHashPut(pHash, hash, key, (void *)(intptr_t)(i + 1)), TSDB_CODE_SUCCESS);
+  }
+  EXPECT_EQ(groupbyHashGetSize(pHash), numOfGroups);
+
+  for (int32_t i = 0; i < numOfGroups; ++i) {
+    snprintf(str, sizeof(str), "s%d", i % 7);
+    buildKey(key, &hash, i, str);
+    EXPECT_EQ(groupbyHashGet(pHash, hash, key), (void *)(intptr_t)(i + 1));
+
+    // the padding of the binary slot is not part of the value
+    snprintf(str, sizeof(str), "s%d_", i % 7);
+    buildKey(key, &hash, i, str);
+    EXPECT_EQ(groupbyHashGet(pHash, hash, key), nullptr);
+  }
+
+  groupbyHashDestroy(pHash);
+
+  // one block: -0.0 and 0.0 are one key, null is a key of its own
+  double   d[4] = {0.0, -0.0, 1.5, 0};
+  uint64_t h[4] = {0};
+  SET_DOUBLE_NULL(&d[3]);
+  groupbyHashColumn((char *)d, TSDB_DATA_TYPE_DOUBLE, sizeof(double), 4, h);
+  EXPECT_EQ(h[0], h[1]);
+  EXPECT_NE(h[0], h[2]);
+  EXPECT_NE(h[0], h[3]);
+
+  char k0[sizeof(double)], k1[sizeof(double)], k3[sizeof(double)];
+  groupbyKeyColumn(k0, (char *)&d[0], TSDB_DATA_TYPE_DOUBLE, sizeof(double));
+  groupbyKeyColumn(k1, (char *)&d[1], TSDB_DATA_TYPE_DOUBLE, sizeof(double));
+  groupbyKeyColumn(k3, (char *)&d[3], TSDB_DATA_TYPE_DOUBLE, sizeof(double));
+  EXPECT_EQ(memcmp(k0, k1, sizeof(double)), 0);
+  EXPECT_TRUE(isNull(k3, TSDB_DATA_TYPE_DOUBLE));
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "os.h"
+#include "taos.h"
+#include "taosdef.h"
+#include "taoserror.h"
+#include "tsdb.h"
+
+extern "C" {
+#include "qExecutor.h"
+#include "qUtil.h"
+}
+
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+
+namespace {
+
+// the tables are fake, their pointer is their number
+STableGroupInfo createGroups(const int32_t *numOfTables, int32_t numOfGroups) {
+  STableGroupInfo info = {0};
+  info.pGroupList = (SArray *)taosArrayInit(numOfGroups, POINTER_BYTES);
+
+  intptr_t id = 1;
+  for (int32_t i = 0; i < numOfGroups; ++i) {
+    SArray *p = (SArray *)taosArrayInit(numOfTables[i], sizeof(STableKeyInfo));
+    for (int32_t j = 0; j < numOfTables[i]; ++j) {
+      STableKeyInfo k = {(void *)id++, 0};
+      taosArrayPush(p, &k);
+    }
+
+    taosArrayPush(info.pGroupList, &p);
+    info.numOfTables += numOfTables[i];
+  }
+
+  return info;
+}
+
+void destroyGroups(STableGroupInfo *pInfo) {
+  for (int32_t i = 0; i < taosArrayGetSize(pInfo->pGroupList); ++i) {
+    SArray *p = (SArray *)taosArrayGetP(pInfo->pGroupList, i);
+    taosArrayDestroy(&p);
+  }
+
+  taosArrayDestroy(&pInfo->pGroupList);
+}
+
+void checkSplit(const int32_t *numOfTables, int32_t numOfGroups, int32_t numOfMorsels) {
+  STableGroupInfo info = createGroups(numOfTables, numOfGroups);
+  int32_t         total = info.numOfTables;
+
+  STableGroupInfo morsels[TSDB_MAX_QUERY_PARALLEL_DEGREE];
+  ASSERT_EQ(splitTableGroupInfo(&info, numOfMorsels, morsels), TSDB_CODE_SUCCESS);
+  EXPECT_EQ(info.numOfTables, 0);
+  EXPECT_EQ(info.pGroupList, nullptr);
+
+  int32_t groupOf[1024] = {0};
+  for (int32_t i = 0, t = 1; i < numOfGroups; ++i) {
+    for (int32_t j = 0; j < numOfTables[i]; ++j) {
+      groupOf[t++] = i;
+    }
+  }
+
+  // every table is in one morsel, in the order and the group it had
+  intptr_t id = 1;
+  for (int32_t k = 0; k < numOfMorsels; ++k) {
+    EXPECT_GE(morsels[k].numOfTables, total / numOfMorsels);
+    EXPECT_LE(morsels[k].numOfTables, total / numOfMorsels + 1);
+
+    uint32_t n = 0;
+    int32_t  prev = -1;
+    for (int32_t i = 0; i < taosArrayGetSize(morsels[k].pGroupList); ++i) {
+      SArray *p = (SArray *)taosArrayGetP(morsels[k].pGroupList, i);
+      ASSERT_GT(taosArrayGetSize(p), 0);
+
+      int32_t group = groupOf[id];
+      EXPECT_GT(group, prev);
+      prev = group;
+
+      for (int32_t j = 0; j < taosArrayGetSize(p); ++j) {
+        STableKeyInfo *pKey = (STableKeyInfo *)taosArrayGet(p, j);
+        EXPECT_EQ((intptr_t)pKey->pTable, id);
+        EXPECT_EQ(groupOf[id], group);
+        id += 1;
+      }
+
+      n += taosArrayGetSize(p);
+    }
+
+    EXPECT_EQ(n, morsels[k].numOfTables);
+    destroyGroups(&morsels[k]);
+  }
+
+  EXPECT_EQ(id, total + 1);
+}
+
+}  // namespace
+
+TEST(testCase, morselSplitTest) {
+  int32_t oneGroup[] = {1000};
+  checkSplit(oneGroup, 1, 1);
+  checkSplit(oneGroup, 1, 7);
+  checkSplit(oneGroup, 1, 64);
+
+  int32_t groups[] = {3, 1, 17, 2, 2, 40, 1};
+  checkSplit(groups, 7, 2);
+  checkSplit(groups, 7, 5);
+  checkSplit(groups, 7, 33);  // two tables each
+  checkSplit(groups, 7, 64);
+
+  // as many morsels as tables
+  int32_t few[] = {2, 1};
+  checkSplit(few, 2, 3);
+}
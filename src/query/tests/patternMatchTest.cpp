@@ -84,3 +84,68 @@ TEST(testCase, patternMatchTest) {
   ret = patternMatch("%9", str, 2, &info);
   EXPECT_EQ(ret, TSDB_PATTERN_MATCH);
 }
+
+namespace {
+// varstr of the string, converted to ucs4 for nchar
+void setPatternVar(char* buf, const char* str, int32_t type) {
+  if (type == TSDB_DATA_TYPE_NCHAR) {
+    int32_t len = 0;
+    taosMbsToUcs4((char*)str, strlen(str), (char*)varDataVal(buf), 256, &len);
+    varDataSetLen(buf, len);
+  } else {
+    memcpy((char*)varDataVal(buf), str, strlen(str));
+    varDataSetLen(buf, strlen(str));
+  }
+}
+}  // namespace
+
+// the compiled pattern, literal or not, gives the result of the comparison function of the operator
+TEST(testCase, compiledPatternTest) {
+  const char* likes[] = {"abc", "abc%", "%abc", "%abc%", "%%ab%%", "%", "", "a_c", "a%c", "ab\\%", "%b_", "ABC%"};
+  const char* regexes[] = {"abc", "^abc", "abc$", "^abc$", "b", "^a.c", "a|x", "[0-9]+", "^$", "c\\$"};
+  const char* values[] = {"abc", "ABC", "abcd", "xabc", "xabcx", "ab", "", "a%", "ab%", "a1c", "bcd", "12c$"};
+
+  char pattern[300] = {0};
+  char value[300] = {0};
+
+  int32_t types[] = {TSDB_DATA_TYPE_BINARY, TSDB_DATA_TYPE_NCHAR};
+  for (int32_t t = 0; t < 2; ++t) {
+    int32_t type = types[t];
+    for (size_t p = 0; p < sizeof(likes) / sizeof(likes[0]); ++p) {
+      setPatternVar(pattern, likes[p], type);
+      SCompiledPattern* pPattern = compilePattern(type, TSDB_RELATION_LIKE, (char*)varDataVal(pattern), varDataLen(pattern));
+      ASSERT_NE(pPattern, nullptr);
+
+      for (size_t v = 0; v < sizeof(values) / sizeof(values[0]); ++v) {
+        setPatternVar(value, values[v], type);
+        int32_t expected = (type == TSDB_DATA_TYPE_NCHAR) ? compareWStrPatternComp(value, pattern) : compareStrPatternComp(value, pattern);
+        EXPECT_EQ(compareCompiledPattern(pPattern, value), expected) << likes[p] << " like " << values[v];
+      }
+
+      freeCompiledPattern(pPattern);
+    }
+
+    for (size_t p = 0; p < sizeof(regexes) / sizeof(regexes[0]); ++p) {
+      setPatternVar(pattern, regexes[p], TSDB_DATA_TYPE_BINARY);
+      SCompiledPattern* pMatch = compilePattern(type, TSDB_RELATION_MATCH, (char*)varDataVal(pattern), varDataLen(pattern));
+      SCompiledPattern* pNMatch = compilePattern(type, TSDB_RELATION_NMATCH, (char*)varDataVal(pattern), varDataLen(pattern));
+      ASSERT_NE(pMatch, nullptr);
+      ASSERT_NE(pNMatch, nullptr);
+
+      for (size_t v = 0; v < sizeof(values) / sizeof(values[0]); ++v) {
+        setPatternVar(value, values[v], TSDB_DATA_TYPE_BINARY);
+        int32_t expected = compareStrRegexCompMatch(value, pattern);
+
+        setPatternVar(value, values[v], type);
+        EXPECT_EQ(compareCompiledPattern(pMatch, value), expected) << values[v] << " match " << regexes[p];
+        EXPECT_EQ(compareCompiledPattern(pNMatch, value), expected ? 0 : 1) << values[v] << " nmatch " << regexes[p];
+      }
+
+      freeCompiledPattern(pMatch);
+      freeCompiledPattern(pNMatch);
+    }
+  }
+
+  EXPECT_EQ(compilePattern(TSDB_DATA_TYPE_BINARY, TSDB_RELATION_MATCH, "a(", 2), nullptr);
+  EXPECT_EQ(compilePattern(TSDB_DATA_TYPE_INT, TSDB_RELATION_LIKE, "1", 1), nullptr);
+}
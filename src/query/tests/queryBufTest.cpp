@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "os.h"
+#include "taos.h"
+#include "taosdef.h"
+#include "taoserror.h"
+#include "tglobal.h"
+#include "tsdb.h"
+
+extern "C" {
+#include "qExecutor.h"
+}
+
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+
+namespace {
+
+// the budgets of the dnode and of the batch class are restored whatever a test does with them
+class QueryBufTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    oldQueryBuf = tsQueryBufferSizeBytes;
+    oldBatchBuf = tsBatchQueryBufferSizeBytes;
+  }
+
+  void TearDown() override {
+    tsQueryBufferSizeBytes = oldQueryBuf;
+    tsBatchQueryBufferSizeBytes = oldBatchBuf;
+  }
+
+  int64_t oldQueryBuf;
+  int64_t oldBatchBuf;
+};
+
+// a QInfo of one output and no table, which fails no allocation of createQInfoImpl
+SQInfo* createQInfo(size_t numOfTables, int8_t queryClass) {
+  SQueryTableMsg* pMsg = (SQueryTableMsg*)calloc(1, sizeof(SQueryTableMsg) + sizeof(SColumnInfo));
+  pMsg->numOfCols = 1;
+  pMsg->numOfOutput = 1;
+  pMsg->order = TSDB_ORDER_ASC;
+  pMsg->fillType = TSDB_FILL_NONE;
+  pMsg->tableCols[0].colId = PRIMARYKEY_TIMESTAMP_COL_INDEX;
+  pMsg->tableCols[0].type = TSDB_DATA_TYPE_TIMESTAMP;
+  pMsg->tableCols[0].bytes = TSDB_KEYSIZE;
+
+  SExprInfo* pExprs = (SExprInfo*)calloc(1, sizeof(SExprInfo));
+  pExprs->base.functionId = TSDB_FUNC_COUNT;
+  pExprs->base.colInfo.colId = PRIMARYKEY_TIMESTAMP_COL_INDEX;
+  pExprs->base.resType = TSDB_DATA_TYPE_BIGINT;
+  pExprs->base.resBytes = sizeof(int64_t);
+
+  STableGroupInfo groupInfo = {0};
+  groupInfo.numOfTables = numOfTables;
+  groupInfo.pGroupList = (SArray*)taosArrayInit(1, POINTER_BYTES);
+
+  SQInfo* pQInfo = createQInfoImpl(pMsg, NULL, pExprs, NULL, &groupInfo, NULL, NULL, 1, NULL, 1, NULL, queryClass);
+  free(pMsg);
+  return pQInfo;
+}
+
+}  // namespace
+
+TEST_F(QueryBufTest, interactiveBuf) {
+  tsQueryBufferSizeBytes = 1048576;
+  tsBatchQueryBufferSizeBytes = 65536;
+
+  ASSERT_EQ(checkForQueryBuf(100, TSDB_QUERY_CLASS_INTERACTIVE), TSDB_CODE_SUCCESS);
+  EXPECT_LT(tsQueryBufferSizeBytes, 1048576);
+  EXPECT_EQ(tsBatchQueryBufferSizeBytes, 65536);
+
+  releaseQueryBuf(100, TSDB_QUERY_CLASS_INTERACTIVE);
+  EXPECT_EQ(tsQueryBufferSizeBytes, 1048576);
+  EXPECT_EQ(tsBatchQueryBufferSizeBytes, 65536);
+}
+
+TEST_F(QueryBufTest, batchBuf) {
+  tsQueryBufferSizeBytes = 1048576;
+  tsBatchQueryBufferSizeBytes = 65536;
+
+  // a batch query takes the same bytes from both budgets
+  ASSERT_EQ(checkForQueryBuf(100, TSDB_QUERY_CLASS_BATCH), TSDB_CODE_SUCCESS);
+  EXPECT_EQ(1048576 - tsQueryBufferSizeBytes, 65536 - tsBatchQueryBufferSizeBytes);
+  EXPECT_GT(65536 - tsBatchQueryBufferSizeBytes, 0);
+
+  releaseQueryBuf(100, TSDB_QUERY_CLASS_BATCH);
+  EXPECT_EQ(tsQueryBufferSizeBytes, 1048576);
+  EXPECT_EQ(tsBatchQueryBufferSizeBytes, 65536);
+
+  // more than the budget of the class, the dnode budget is not touched
+  EXPECT_EQ(checkForQueryBuf(100000, TSDB_QUERY_CLASS_BATCH), TSDB_CODE_QRY_NOT_ENOUGH_BUFFER);
+  EXPECT_EQ(tsQueryBufferSizeBytes, 1048576);
+  EXPECT_EQ(tsBatchQueryBufferSizeBytes, 65536);
+
+  // no budget of the class, only that of the dnode
+  tsBatchQueryBufferSizeBytes = -1;
+  ASSERT_EQ(checkForQueryBuf(100, TSDB_QUERY_CLASS_BATCH), TSDB_CODE_SUCCESS);
+  EXPECT_LT(tsQueryBufferSizeBytes, 1048576);
+  releaseQueryBuf(100, TSDB_QUERY_CLASS_BATCH);
+  EXPECT_EQ(tsQueryBufferSizeBytes, 1048576);
+  EXPECT_EQ(tsBatchQueryBufferSizeBytes, -1);
+}
+
+TEST_F(QueryBufTest, batchBufRollback) {
+  tsQueryBufferSizeBytes = 1024;
+  tsBatchQueryBufferSizeBytes = 1048576;
+
+  // the share taken from the class is given back when the dnode has not enough
+  EXPECT_EQ(checkForQueryBuf(1000, TSDB_QUERY_CLASS_BATCH), TSDB_CODE_QRY_NOT_ENOUGH_BUFFER);
+  EXPECT_EQ(tsQueryBufferSizeBytes, 1024);
+  EXPECT_EQ(tsBatchQueryBufferSizeBytes, 1048576);
+
+  // a dnode budget of 0 disables the queries
+  tsQueryBufferSizeBytes = 0;
+  EXPECT_EQ(checkForQueryBuf(1, TSDB_QUERY_CLASS_BATCH), TSDB_CODE_QRY_NOT_ENOUGH_BUFFER);
+  EXPECT_EQ(tsBatchQueryBufferSizeBytes, 1048576);
+}
+
+TEST_F(QueryBufTest, freeQInfoReleasesBuf) {
+  for (int8_t queryClass = 0; queryClass < TSDB_QUERY_CLASS_NUM; ++queryClass) {
+    tsQueryBufferSizeBytes = 1048576;
+    tsBatchQueryBufferSizeBytes = 65536;
+
+    ASSERT_EQ(checkForQueryBuf(100, queryClass), TSDB_CODE_SUCCESS);
+    SQInfo* pQInfo = createQInfo(100, queryClass);
+    ASSERT_NE(pQInfo, nullptr);
+    EXPECT_EQ(pQInfo->queryClass, queryClass);
+
+    // the tables charged are released with the class of the query, even after the runtime env has dropped them as
+    // it does when the time range of the query is empty
+    pQInfo->runtimeEnv.tableqinfoGroupInfo.numOfTables = 0;
+
+    freeQInfo(pQInfo);
+    EXPECT_EQ(tsQueryBufferSizeBytes, 1048576) << "class " << (int)queryClass;
+    EXPECT_EQ(tsBatchQueryBufferSizeBytes, 65536) << "class " << (int)queryClass;
+  }
+}
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "os.h"
+#include "taos.h"
+#include "taosdef.h"
+#include "taoserror.h"
+
+extern "C" {
+#include "qExecutor.h"
+#include "qUtil.h"
+}
+
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+
+TEST(testCase, windowIndexTest) {
+  const int64_t sliding = 1000;
+  const TSKEY   skey = 1600000000000L;
+
+  SResultRowInfo info = {0};
+  ASSERT_EQ(initResultRowInfo(&info, 8, TSDB_DATA_TYPE_INT), TSDB_CODE_SUCCESS);
+  ASSERT_EQ(initWindowIndex(&info, sliding, 0), TSDB_CODE_SUCCESS);
+  EXPECT_EQ(getWindowIndexPos(&info, skey), -1);
+
+  // an ascending scan, with gaps between the windows
+  for (int32_t i = 0; i < 1000; ++i) {
+    ASSERT_EQ(putWindowIndexPos(&info, skey + i * 3 * sliding, i), TSDB_CODE_SUCCESS);
+  }
+
+  // then windows before the first one, as a descending scan adds them
+  for (int32_t i = 1; i <= 500; ++i) {
+    ASSERT_EQ(putWindowIndexPos(&info, skey - i * sliding, 1000 + i), TSDB_CODE_SUCCESS);
+  }
+
+  for (int32_t i = 0; i < 1000; ++i) {
+    EXPECT_EQ(getWindowIndexPos(&info, skey + i * 3 * sliding), i);
+    EXPECT_EQ(getWindowIndexPos(&info, skey + i * 3 * sliding + sliding), -1);
+  }
+
+  for (int32_t i = 1; i <= 500; ++i) {
+    EXPECT_EQ(getWindowIndexPos(&info, skey - i * sliding), 1000 + i);
+  }
+
+  // not aligned with the windows, or too far away
+  EXPECT_EQ(getWindowIndexPos(&info, skey + 1), -1);
+  EXPECT_NE(putWindowIndexPos(&info, skey + 1, 0), TSDB_CODE_SUCCESS);
+  EXPECT_NE(putWindowIndexPos(&info, skey + (int64_t)MAX_INTERVAL_TIME_WINDOW * 2 * sliding, 0), TSDB_CODE_SUCCESS);
+  EXPECT_EQ(getWindowIndexPos(&info, skey + 999 * 3 * sliding), 999);
+
+  // the positions follow the result rows once they are moved
+  SResultRow rows[3];
+  memset(rows, 0, sizeof(rows));
+  for (int32_t i = 0; i < 3; ++i) {
+    rows[i].win.skey = skey + (2 - i) * 3 * sliding;
+    info.pResult[i] = &rows[i];
+  }
+  info.size = 3;
+
+  rebuildWindowIndex(&info);
+  EXPECT_EQ(getWindowIndexPos(&info, skey), 2);
+  EXPECT_EQ(getWindowIndexPos(&info, skey + 6 * sliding), 0);
+  EXPECT_EQ(getWindowIndexPos(&info, skey + 9 * sliding), -1);
+  EXPECT_EQ(getWindowIndexPos(&info, skey - sliding), -1);
+
+  info.size = 0;
+  cleanupResultRowInfo(&info);
+  EXPECT_EQ(info.pWindowIndex, nullptr);
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_TSDB_BLK_CACHE_H_
+#define _TD_TSDB_BLK_CACHE_H_
+
+/**
+ * Cache of decompressed column chunks shared by all readers of one repository.
+ *
+ * Entries are keyed by (generation, fid, .data/.last, block offset, colId). The generation is bumped whenever a
+ * FS transaction ends (commit/compact/delete/sync), so a reader only ever sees chunks of the file sets it opened.
+ * Eviction is a segmented LRU: new chunks enter the probation segment and are promoted to the protected segment on
+ * the second hit, so one large scan cannot flush the blocks that dashboards hit repeatedly.
+ *
+ * A second instance with its own budget keeps the decoded SBlockIdx array and SBlockInfo parts of .head files, keyed
+ * by their offset in the .head file (last and colId are 0).
+ */
+
+#define TSDB_BLK_CACHE_PROTECTED_RATIO 0.8
+
+typedef struct {
+  uint32_t gen;
+  int32_t  fid;
+  int64_t  offset;
+  int16_t  colId;
+  uint8_t  last;
+  uint8_t  reserved[5];
+} SBlkCacheKey;
+
+typedef struct {
+  pthread_mutex_t lock;
+  uint32_t        gen;
+  int64_t         capacity;   // in bytes
+  int64_t         size;       // bytes of all entries
+  int64_t         protSize;   // bytes of entries in protected segment
+  SHashObj*       pHash;      // SBlkCacheKey -> SListNode*
+  SList*          probList;   // probation segment, MRU at head
+  SList*          protList;   // protected segment, MRU at head
+} STsdbBlkCache;
+
+STsdbBlkCache* tsdbNewBlkCache(int64_t capacity);
+void*          tsdbFreeBlkCache(STsdbBlkCache* pCache);
+void           tsdbInvalidateBlkCache(STsdbBlkCache* pCache);
+uint32_t       tsdbGetBlkCacheGen(STsdbBlkCache* pCache);
+bool           tsdbGetBlkCacheCol(STsdbBlkCache* pCache, SBlkCacheKey* pKey, SDataCol* pDataCol, int numOfRows,
+                                  int maxPoints);
+void           tsdbPutBlkCacheCol(STsdbBlkCache* pCache, SBlkCacheKey* pKey, SDataCol* pDataCol, int numOfRows);
+bool           tsdbGetBlkCacheBuf(STsdbBlkCache* pCache, SBlkCacheKey* pKey, void** ppBuf, int32_t* len);
+void           tsdbPutBlkCacheBuf(STsdbBlkCache* pCache, SBlkCacheKey* pKey, const void* pBuf, int32_t len);
+
+static FORCE_INLINE void tsdbInitBlkCacheKey(SBlkCacheKey* pKey, uint32_t gen, int32_t fid, bool last, int64_t offset,
+                                             int16_t colId) {
+  memset(pKey, 0, sizeof(*pKey));
+  pKey->gen = gen;
+  pKey->fid = fid;
+  pKey->last = last ? 1 : 0;
+  pKey->offset = offset;
+  pKey->colId = colId;
+}
+
+#endif /* _TD_TSDB_BLK_CACHE_H_ */
@@ -35,6 +35,7 @@ void  tsdbGetRtnSnap(STsdbRepo *pRepo, SRtn *pRtn);
 int   tsdbEncodeKVRecord(void **buf, SKVRecord *pRecord);
 void *tsdbDecodeKVRecord(void *buf, SKVRecord *pRecord);
 void *tsdbCommitData(STsdbRepo *pRepo, bool end);
+void  tsdbHelpCommitFSets(void *param);
 int   tsdbApplyRtnOnFSet(STsdbRepo *pRepo, SDFileSet *pSet, SRtn *pRtn);
 int tsdbWriteBlockInfoImpl(SDFile *pHeadf, STable *pTable, SArray *pSupA, SArray *pSubA, void **ppBuf, SBlockIdx *pIdx);
 int tsdbWriteBlockIdx(SDFile *pHeadf, SArray *pIdxA, void **ppBuf);
@@ -45,6 +46,16 @@ int   tsdbApplyRtn(STsdbRepo *pRepo);
 // commit control command 
 int tsdbCommitControl(STsdbRepo* pRepo, SControlDataInfo* pCtlDataInfo);
 
+// The compression of the blocks written to a file set on a level, the second stage is zstd on the tiers from zstdTier
+// when zstd is built in, LZ4 on any tier otherwise
+static FORCE_INLINE int8_t tsdbGetLevelCompression(STsdbCfg *pCfg, int level) {
+#ifdef TD_TSZ
+  return (pCfg->compression == TWO_STAGE_COMP && level >= tsZstdTier) ? TWO_STAGE_COMP_ZSTD : pCfg->compression;
+#else
+  return pCfg->compression;
+#endif
+}
+
 static FORCE_INLINE int tsdbGetFidLevel(int fid, SRtn *pRtn) {
   if (fid >= pRtn->maxFid) {
     return 0;
@@ -22,6 +22,7 @@ typedef enum {
   COMPACT_REQ,
   CONTROL_REQ,
   COMMIT_CONFIG_REQ,
+  COMMIT_FSET_REQ,
 } TSDB_REQ_T;
 
 int tsdbScheduleCommit(STsdbRepo *pRepo, void* param, TSDB_REQ_T req);
@@ -20,6 +20,7 @@ extern "C" {
 #endif
 
 void *tsdbCompactImpl(STsdbRepo *pRepo);
+int   tsdbRecompressFSet(STsdbRepo *pRepo, SDFileSet *pSet, SDiskID did);
 
 #ifdef __cplusplus
 }
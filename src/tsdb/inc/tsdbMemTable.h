@@ -27,20 +27,69 @@ typedef struct {
   TSKEY keyLast;
 } SMergeInfo;
 
+/**
+ * Column buffer of a table in the memtable (memColumnBuffer 1).
+ *
+ * Data rows written in key order are appended column by column to chunks allocated from the buffer pool, only the
+ * other rows (out-of-order, deleted, KV rows or rows of another schema version) go to the skiplist. A key may be in
+ * both when an appended row is updated later, then the skiplist row wins. The write thread fills a row and then
+ * publishes it by bumping numOfRows, readers only look at the rows published when they create their iterator.
+ */
+#define TSDB_MEM_COL_CHUNK_MIN_ROWS 16
+#define TSDB_MEM_COL_CHUNK_MAX_ROWS 4096
+#define TSDB_MEM_COL_CHUNK_MAX_SIZE 65536
+
+typedef struct SMemColChunk {
+  struct SMemColChunk *next;
+  struct SMemColChunk *prev;
+  int64_t              offset;    // index of the first row of the chunk in the column buffer
+  int32_t              capacity;  // in rows
+  void *               cols[];    // fixed length values, or pointers to the values of var data columns
+} SMemColChunk;
+
 typedef struct {
-  STable *           pTable;
-  SSkipListIterator *pIter;
-} SCommitIter;
+  STSchema *    pSchema;    // schema of the appended rows, allocated from the buffer pool
+  SMemColChunk *head;
+  SMemColChunk *tail;
+  int64_t       numOfRows;  // published rows
+  TSKEY         keyLast;
+} SMemColBuf;
 
 struct STableData {
-  uint64_t   uid;
-  TSKEY      keyFirst;
-  TSKEY      keyLast;
-  int64_t    numOfRows;
-  SSkipList* pData;
+  uint64_t    uid;
+  TSKEY       keyFirst;
+  TSKEY       keyLast;
+  int64_t     numOfRows;
+  SSkipList*  pData;
+  SMemColBuf* pColBuf;
   T_REF_DECLARE()
 };
 
+/**
+ * Iterator merging the skiplist and the column buffer of a table. It can be copied by value to save a position, a
+ * row got from the column buffer is only valid until the next call on the iterator.
+ */
+typedef struct {
+  SSkipListIterator slIter;   // pSkipList is NULL if the skiplist is not iterated
+  SMemColBuf*       pColBuf;  // NULL if the column buffer is not iterated
+  SMemColChunk*     pChunk;   // chunk of cpos
+  int64_t           nRows;    // column buffer rows visible to the iterator
+  int64_t           cpos;     // next column buffer row, out of [0, nRows) if there is none
+  int32_t           order;
+  bool              started;
+  int8_t            src;      // sources of the current row, TSDB_MEM_ITER_SRC_*
+  TSKEY             key;      // key of the current row
+  SMemRow           rowBuf;   // column buffer row materialized for tsdbTableDataIterGet
+} STableDataIter;
+
+#define TSDB_MEM_ITER_SRC_SL 0x1
+#define TSDB_MEM_ITER_SRC_COL 0x2
+
+typedef struct {
+  STable *        pTable;
+  STableDataIter *pIter;
+} SCommitIter;
+
 enum { TSDB_UPDATE_META, TSDB_DROP_META };
 
 #ifdef WINDOWS
@@ -69,27 +118,48 @@ void* tsdbAllocBytes(STsdbRepo* pRepo, int bytes);
 // if pCtrlData is NULL, force must be true
 int   tsdbAsyncCommit(STsdbRepo* pRepo, SControlDataInfo* pCtlDataInfo);
 int   tsdbSyncCommitConfig(STsdbRepo* pRepo);
-int   tsdbLoadDataFromCache(STable* pTable, SSkipListIterator* pIter, TSKEY maxKey, int maxRowsToRead, SDataCols* pCols,
+int   tsdbLoadDataFromCache(STable* pTable, STableDataIter* pIter, TSKEY maxKey, int maxRowsToRead, SDataCols* pCols,
                             TKEY* filterKeys, int nFilterKeys, bool keepDup, SMergeInfo* pMergeInfo);
 void* tsdbCommitData(STsdbRepo* pRepo, bool end);
 
-static FORCE_INLINE SMemRow tsdbNextIterRow(SSkipListIterator* pIter) {
-  if (pIter == NULL) return NULL;
+STableDataIter* tsdbCreateTableDataIter(STableData* pTableData, const TSKEY* pKey, int32_t order);
+void*           tsdbDestroyTableDataIter(STableDataIter* pIter);
+bool            tsdbTableDataIterNext(STableDataIter* pIter);
+SMemRow         tsdbTableDataIterGet(STableDataIter* pIter);
+int32_t         tsdbTableDataIterColRun(STableDataIter* pIter, TSKEY boundKey, int32_t maxRows);
+void            tsdbTableDataIterSkip(STableDataIter* pIter, int32_t nRows);
 
-  SSkipListNode* node = tSkipListIterGet(pIter);
-  if (node == NULL) return NULL;
+static FORCE_INLINE int32_t tsdbMemColElemBytes(STColumn* pCol) {
+  return IS_VAR_DATA_TYPE(colType(pCol)) ? (int32_t)sizeof(void*) : colBytes(pCol);
+}
 
-  return (SMemRow)SL_GET_NODE_DATA(node);
+// Value of column i at row ridx of the chunk
+static FORCE_INLINE void* tsdbMemColChunkVal(SMemColChunk* pChunk, STSchema* pSchema, int i, int32_t ridx) {
+  STColumn* pCol = schemaColAt(pSchema, i);
+  if (IS_VAR_DATA_TYPE(colType(pCol))) {
+    return ((void**)pChunk->cols[i])[ridx];
+  } else {
+    return POINTER_SHIFT(pChunk->cols[i], colBytes(pCol) * ridx);
+  }
 }
 
-static FORCE_INLINE TSKEY tsdbNextIterKey(SSkipListIterator* pIter) {
-  SMemRow row = tsdbNextIterRow(pIter);
-  if (row == NULL) return TSDB_DATA_TIMESTAMP_NULL;
+static FORCE_INLINE bool tsdbTableDataIterHasRow(STableDataIter* pIter) {
+  return pIter != NULL && pIter->started && pIter->src != 0;
+}
+
+static FORCE_INLINE SMemRow tsdbNextIterRow(STableDataIter* pIter) {
+  if (pIter == NULL) return NULL;
+
+  return tsdbTableDataIterGet(pIter);
+}
+
+static FORCE_INLINE TSKEY tsdbNextIterKey(STableDataIter* pIter) {
+  if (!tsdbTableDataIterHasRow(pIter)) return TSDB_DATA_TIMESTAMP_NULL;
 
-  return memRowKey(row);
+  return pIter->key;
 }
 
-static FORCE_INLINE TKEY tsdbNextIterTKey(SSkipListIterator* pIter) {
+static FORCE_INLINE TKEY tsdbNextIterTKey(STableDataIter* pIter) {
   SMemRow row = tsdbNextIterRow(pIter);
   if (row == NULL) return TKEY_NULL;
 
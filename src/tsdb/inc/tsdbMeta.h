@@ -37,6 +37,7 @@ typedef struct STable {
   SKVRow         tagVal;
   SSkipList*     pIndex;         // For TSDB_SUPER_TABLE, it is the skiplist index
   SHashObj*      jsonKeyMap;     // For json tag key  {"key":[t1, t2, t3]}
+  SArray*        pTagIdx;        // For TSDB_SUPER_TABLE, STagIdxCol of the indexed tag columns
   void*          eventHandler;   // TODO
   void*          streamHandler;  // TODO
   TSKEY          lastKey;
@@ -161,6 +161,10 @@ typedef struct {
 
 typedef void SAggrBlkData;  // SBlockCol cols[];
 
+#define TSDB_BLK_DECODE_MAX_TASKS 8       // max tasks the columns of one block are split into
+#define TSDB_BLK_DECODE_MIN_COLS 4        // min columns decoded by one task
+#define TSDB_BLK_DECODE_MIN_BYTES 16384   // min compressed bytes decoded by one task
+
 struct SReadH {
   STsdbRepo * pRepo;
   SDFileSet   rSet;     // FSET to read
@@ -175,6 +179,10 @@ struct SReadH {
   void *      pBuf;   // buffer
   void *      pCBuf;  // compression buffer
   void *      pExBuf;  // extra buffer
+  void *      pDecItems;  // columns of the block being decoded
+  void *      pDecCBuf[TSDB_BLK_DECODE_MAX_TASKS - 1];  // compression buffers of the helper decode tasks
+  uint32_t    blkCacheGen;     // block cache generation of rSet
+  uint32_t    blkIdxCacheGen;  // block index cache generation of rSet
 };
 
 #define TSDB_READ_REPO(rh) ((rh)->pRepo)
@@ -227,6 +235,7 @@ int   tsdbLoadBlockData(SReadH *pReadh, SBlock *pBlock, SBlockInfo *pBlockInfo);
 int   tsdbLoadBlockDataCols(SReadH *pReadh, SBlock *pBlock, SBlockInfo *pBlkInfo, int16_t *colIds, int numOfColsIds);
 int   tsdbLoadBlockStatis(SReadH *pReadh, SBlock *pBlock);
 int   tsdbLoadBlockOffset(SReadH *pReadh, SBlock *pBlock);
+int   tsdbLoadBlockStatisRange(SReadH *pReadh, SBlock *pBlock, SDataStatis *pStatis, int numOfCols, int start, int end);
 int   tsdbEncodeSBlockIdx(void **buf, SBlockIdx *pIdx);
 void *tsdbDecodeSBlockIdx(void *buf, SBlockIdx *pIdx);
 void  tsdbGetBlockStatis(SReadH *pReadh, SDataStatis *pStatis, int numOfCols, SBlock *pBlock);
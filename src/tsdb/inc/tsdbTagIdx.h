@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_TSDB_TAG_IDX_H_
+#define _TD_TSDB_TAG_IDX_H_
+
+/**
+ * Inverted indexes on the tag columns of a super table, enabled by tagInvertedIndex.
+ *
+ * Each tag column maps a tag value to the tids of the child tables holding it, kept in ascending order so that the
+ * lists of several conditions can be intersected and merged in one pass. A null or missing tag is indexed under the
+ * null value of the column. Float and double tags are not indexed since their equality has a tolerance.
+ *
+ * The index of a column is built the first time a child table is added after the column appears in the tag schema,
+ * from the tables already in the skiplist index of the super table. All changes are made under the meta write lock
+ * and lookups are done under the meta read lock.
+ */
+
+typedef struct {
+  int16_t   colId;
+  int8_t    type;
+  SHashObj* pHash;  // tag value -> SArray* of tids in ascending order
+} STagIdxCol;
+
+void    tsdbFreeTagIdx(STable* pSTable);
+int     tsdbAddTableIntoTagIdx(STable* pSTable, STable* pTable);
+void    tsdbRemoveTableFromTagIdx(STable* pSTable, STable* pTable);
+SArray* tsdbGetTagIdxTids(STable* pSTable, int16_t colId, int8_t type, const void* key, int32_t len, bool* indexed);
+// Lists out of order or with duplicates are sorted first. The intersection is left in pTids, the union is returned and
+// pTids is freed. Both fail only if they run out of memory.
+int     tsdbIntersectTids(SArray* pTids, const SArray* pOther);
+SArray* tsdbMergeTids(SArray* pTids, const SArray* pOther);
+
+static FORCE_INLINE bool tsdbIsTagIdxType(int8_t type) {
+  return type != TSDB_DATA_TYPE_FLOAT && type != TSDB_DATA_TYPE_DOUBLE && type != TSDB_DATA_TYPE_JSON;
+}
+
+// The key of a tag value in the index, var data types are keyed by their content without the length header
+static FORCE_INLINE const void* tsdbGetTagIdxKey(int8_t type, const void* val, int32_t* len) {
+  if (val == NULL || isNull(val, type)) val = getNullValue(type);
+
+  if (IS_VAR_DATA_TYPE(type)) {
+    *len = varDataLen(val);
+    return varDataVal(val);
+  }
+
+  *len = tDataTypes[type].bytes;
+  return val;
+}
+
+#endif /* _TD_TSDB_TAG_IDX_H_ */
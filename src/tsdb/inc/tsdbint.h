@@ -52,6 +52,8 @@ extern "C" {
 #include "tsdbLog.h"
 // Meta
 #include "tsdbMeta.h"
+// Tag Index
+#include "tsdbTagIdx.h"
 // Buffer
 #include "tsdbBuffer.h"
 // MemTable
@@ -60,6 +62,8 @@ extern "C" {
 #include "tsdbFile.h"
 // FS
 #include "tsdbFS.h"
+// Block Cache
+#include "tsdbBlkCache.h"
 // ReadImpl
 #include "tsdbReadImpl.h"
 // Commit
@@ -91,6 +95,8 @@ struct STsdbRepo {
   SMemTable*      mem;
   SMemTable*      imem;
   STsdbFS*        fs;
+  STsdbBlkCache*  pBlkCache;     // decompressed block columns, NULL if disabled
+  STsdbBlkCache*  pBlkIdxCache;  // decoded .head file index parts, NULL if disabled
   SRtn            rtn;
   tsem_t          readyToCommit;
   pthread_mutex_t mutex;
@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tsdbint.h"
+
+typedef struct {
+  SBlkCacheKey key;
+  bool         prot;     // in protected segment
+  int16_t      dictNum;  // dictionary codes of a column chunk, one for each row, follow its data
+  int32_t      len;
+  char         data[];
+} SBlkCacheEntry;
+
+#define TSDB_BLK_CACHE_ENTRY(n) ((SBlkCacheEntry *)((n)->data))
+#define TSDB_BLK_CACHE_ENTRY_SIZE(len) ((int64_t)(sizeof(SListNode) + sizeof(SBlkCacheEntry) + (len)))
+
+// dnode-wide counters reported through the monitor module
+static int64_t tsBlkCacheHit = 0;
+static int64_t tsBlkCacheMiss = 0;
+
+static SListNode *tsdbLookupBlkCacheNode(STsdbBlkCache *pCache, SBlkCacheKey *pKey);
+static SListNode *tsdbNewBlkCacheNode(STsdbBlkCache *pCache, SBlkCacheKey *pKey, int32_t len);
+static void       tsdbInsertBlkCacheNode(STsdbBlkCache *pCache, SListNode *pNode);
+static void       tsdbRemoveBlkCacheNode(STsdbBlkCache *pCache, SListNode *pNode);
+static void       tsdbDemoteBlkCacheNodes(STsdbBlkCache *pCache);
+static void       tsdbEvictBlkCacheNodes(STsdbBlkCache *pCache);
+
+STsdbBlkCache *tsdbNewBlkCache(int64_t capacity) {
+  if (capacity <= 0) return NULL;
+
+  STsdbBlkCache *pCache = (STsdbBlkCache *)calloc(1, sizeof(*pCache));
+  if (pCache == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pCache->capacity = capacity;
+
+  int code = pthread_mutex_init(&(pCache->lock), NULL);
+  if (code != 0) {
+    terrno = TAOS_SYSTEM_ERROR(code);
+    free(pCache);
+    return NULL;
+  }
+
+  pCache->pHash = taosHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+  pCache->probList = tdListNew(0);
+  pCache->protList = tdListNew(0);
+  if (pCache->pHash == NULL || pCache->probList == NULL || pCache->protList == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    tsdbFreeBlkCache(pCache);
+    return NULL;
+  }
+
+  return pCache;
+}
+
+void *tsdbFreeBlkCache(STsdbBlkCache *pCache) {
+  if (pCache) {
+    taosHashCleanup(pCache->pHash);
+    tdListFree(pCache->probList);
+    tdListFree(pCache->protList);
+    pthread_mutex_destroy(&(pCache->lock));
+    free(pCache);
+  }
+
+  return NULL;
+}
+
+void tsdbInvalidateBlkCache(STsdbBlkCache *pCache) {
+  if (pCache == NULL) return;
+
+  pthread_mutex_lock(&(pCache->lock));
+  pCache->gen++;
+  taosHashClear(pCache->pHash);
+  tdListEmpty(pCache->probList);
+  tdListEmpty(pCache->protList);
+  pCache->size = 0;
+  pCache->protSize = 0;
+  pthread_mutex_unlock(&(pCache->lock));
+}
+
+uint32_t tsdbGetBlkCacheGen(STsdbBlkCache *pCache) {
+  if (pCache == NULL) return 0;
+
+  pthread_mutex_lock(&(pCache->lock));
+  uint32_t gen = pCache->gen;
+  pthread_mutex_unlock(&(pCache->lock));
+
+  return gen;
+}
+
+bool tsdbGetBlkCacheCol(STsdbBlkCache *pCache, SBlkCacheKey *pKey, SDataCol *pDataCol, int numOfRows, int maxPoints) {
+  if (pCache == NULL) return false;
+
+  pthread_mutex_lock(&(pCache->lock));
+
+  SListNode *pNode = tsdbLookupBlkCacheNode(pCache, pKey);
+  if (pNode == NULL) {
+    pthread_mutex_unlock(&(pCache->lock));
+    atomic_add_fetch_64(&tsBlkCacheMiss, 1);
+    return false;
+  }
+
+  SBlkCacheEntry *pEntry = TSDB_BLK_CACHE_ENTRY(pNode);
+
+  // The caller reads the column from the file instead
+  if (tdAllocMemForCol(pDataCol, maxPoints) < 0) {
+    pthread_mutex_unlock(&(pCache->lock));
+    atomic_add_fetch_64(&tsBlkCacheMiss, 1);
+    return false;
+  }
+
+  pDataCol->dictNum = pEntry->dictNum;
+  pDataCol->len = pEntry->len - ((pEntry->dictNum > 0) ? numOfRows : 0);
+  memcpy(pDataCol->pData, pEntry->data, pDataCol->len);
+  if (pEntry->dictNum > 0) {
+    memcpy(pDataCol->dictCodes, pEntry->data + pDataCol->len, numOfRows);
+  }
+
+  pthread_mutex_unlock(&(pCache->lock));
+  atomic_add_fetch_64(&tsBlkCacheHit, 1);
+
+  if (IS_VAR_DATA_TYPE(pDataCol->type)) {
+    dataColSetOffset(pDataCol, numOfRows);
+  }
+
+  return true;
+}
+
+void tsdbPutBlkCacheCol(STsdbBlkCache *pCache, SBlkCacheKey *pKey, SDataCol *pDataCol, int numOfRows) {
+  if (pCache == NULL) return;
+
+  int32_t    ncodes = (pDataCol->dictNum > 0) ? numOfRows : 0;
+  SListNode *pNode = tsdbNewBlkCacheNode(pCache, pKey, pDataCol->len + ncodes);
+  if (pNode == NULL) return;
+
+  SBlkCacheEntry *pEntry = TSDB_BLK_CACHE_ENTRY(pNode);
+  pEntry->dictNum = pDataCol->dictNum;
+  memcpy(pEntry->data, pDataCol->pData, pDataCol->len);
+  if (ncodes > 0) {
+    memcpy(pEntry->data + pDataCol->len, pDataCol->dictCodes, ncodes);
+  }
+
+  tsdbInsertBlkCacheNode(pCache, pNode);
+}
+
+bool tsdbGetBlkCacheBuf(STsdbBlkCache *pCache, SBlkCacheKey *pKey, void **ppBuf, int32_t *len) {
+  if (pCache == NULL) return false;
+
+  pthread_mutex_lock(&(pCache->lock));
+
+  SListNode *pNode = tsdbLookupBlkCacheNode(pCache, pKey);
+  if (pNode == NULL) {
+    pthread_mutex_unlock(&(pCache->lock));
+    return false;
+  }
+
+  SBlkCacheEntry *pEntry = TSDB_BLK_CACHE_ENTRY(pNode);
+  if (tsdbMakeRoom(ppBuf, pEntry->len) < 0) {
+    pthread_mutex_unlock(&(pCache->lock));
+    return false;
+  }
+
+  memcpy(*ppBuf, pEntry->data, pEntry->len);
+  *len = pEntry->len;
+
+  pthread_mutex_unlock(&(pCache->lock));
+  return true;
+}
+
+void tsdbPutBlkCacheBuf(STsdbBlkCache *pCache, SBlkCacheKey *pKey, const void *pBuf, int32_t len) {
+  if (pCache == NULL) return;
+
+  SListNode *pNode = tsdbNewBlkCacheNode(pCache, pKey, len);
+  if (pNode == NULL) return;
+
+  memcpy(TSDB_BLK_CACHE_ENTRY(pNode)->data, pBuf, len);
+  tsdbInsertBlkCacheNode(pCache, pNode);
+}
+
+void tsdbGetBlkCacheStatis(int64_t *hit, int64_t *miss) {
+  *hit = atomic_exchange_64(&tsBlkCacheHit, 0);
+  *miss = atomic_exchange_64(&tsBlkCacheMiss, 0);
+}
+
+// Find the entry and move it to the head of the protected segment, the cache lock must be held
+static SListNode *tsdbLookupBlkCacheNode(STsdbBlkCache *pCache, SBlkCacheKey *pKey) {
+  SListNode **ppNode = taosHashGet(pCache->pHash, pKey, sizeof(*pKey));
+  if (ppNode == NULL) return NULL;
+
+  SListNode *     pNode = *ppNode;
+  SBlkCacheEntry *pEntry = TSDB_BLK_CACHE_ENTRY(pNode);
+
+  // Second reference promotes the entry, any later one just refreshes it
+  if (pEntry->prot) {
+    tdListPopNode(pCache->protList, pNode);
+  } else {
+    tdListPopNode(pCache->probList, pNode);
+    pEntry->prot = true;
+    pCache->protSize += TSDB_BLK_CACHE_ENTRY_SIZE(pEntry->len);
+  }
+  tdListPrependNode(pCache->protList, pNode);
+  tsdbDemoteBlkCacheNodes(pCache);
+
+  return pNode;
+}
+
+// The entry of the node is filled by the caller before it is inserted
+static SListNode *tsdbNewBlkCacheNode(STsdbBlkCache *pCache, SBlkCacheKey *pKey, int32_t len) {
+  // A single entry should never wipe out a large part of the cache
+  int64_t esize = TSDB_BLK_CACHE_ENTRY_SIZE(len);
+  if (esize > pCache->capacity / 4) return NULL;
+
+  SListNode *pNode = (SListNode *)malloc(esize);
+  if (pNode == NULL) return NULL;
+
+  pNode->next = pNode->prev = NULL;
+
+  SBlkCacheEntry *pEntry = TSDB_BLK_CACHE_ENTRY(pNode);
+  pEntry->key = *pKey;
+  pEntry->prot = false;
+  pEntry->dictNum = 0;
+  pEntry->len = len;
+
+  return pNode;
+}
+
+static void tsdbInsertBlkCacheNode(STsdbBlkCache *pCache, SListNode *pNode) {
+  SBlkCacheKey *pKey = &(TSDB_BLK_CACHE_ENTRY(pNode)->key);
+  int64_t       esize = TSDB_BLK_CACHE_ENTRY_SIZE(TSDB_BLK_CACHE_ENTRY(pNode)->len);
+
+  pthread_mutex_lock(&(pCache->lock));
+
+  // The reader opened its file set before the last FS transaction ended, its chunk is stale for everyone else
+  if (pKey->gen != pCache->gen || taosHashGet(pCache->pHash, pKey, sizeof(*pKey)) != NULL) {
+    pthread_mutex_unlock(&(pCache->lock));
+    free(pNode);
+    return;
+  }
+
+  if (taosHashPut(pCache->pHash, pKey, sizeof(*pKey), &pNode, POINTER_BYTES) != 0) {
+    pthread_mutex_unlock(&(pCache->lock));
+    free(pNode);
+    return;
+  }
+
+  tdListPrependNode(pCache->probList, pNode);
+  pCache->size += esize;
+  tsdbEvictBlkCacheNodes(pCache);
+
+  pthread_mutex_unlock(&(pCache->lock));
+}
+
+static void tsdbRemoveBlkCacheNode(STsdbBlkCache *pCache, SListNode *pNode) {
+  SBlkCacheEntry *pEntry = TSDB_BLK_CACHE_ENTRY(pNode);
+  int64_t         esize = TSDB_BLK_CACHE_ENTRY_SIZE(pEntry->len);
+
+  if (pEntry->prot) {
+    tdListPopNode(pCache->protList, pNode);
+    pCache->protSize -= esize;
+  } else {
+    tdListPopNode(pCache->probList, pNode);
+  }
+
+  taosHashRemove(pCache->pHash, &(pEntry->key), sizeof(pEntry->key));
+  pCache->size -= esize;
+  listNodeFree(pNode);
+}
+
+static void tsdbDemoteBlkCacheNodes(STsdbBlkCache *pCache) {
+  int64_t protCap = (int64_t)(pCache->capacity * TSDB_BLK_CACHE_PROTECTED_RATIO);
+
+  while (pCache->protSize > protCap) {
+    SListNode *     pNode = tdListPopNode(pCache->protList, listTail(pCache->protList));
+    SBlkCacheEntry *pEntry = TSDB_BLK_CACHE_ENTRY(pNode);
+
+    pEntry->prot = false;
+    pCache->protSize -= TSDB_BLK_CACHE_ENTRY_SIZE(pEntry->len);
+    tdListPrependNode(pCache->probList, pNode);
+  }
+}
+
+static void tsdbEvictBlkCacheNodes(STsdbBlkCache *pCache) {
+  while (pCache->size > pCache->capacity) {
+    SListNode *pNode = listTail(pCache->probList);
+    if (pNode == NULL) pNode = listTail(pCache->protList);
+    if (pNode == NULL) break;
+
+    tsdbRemoveBlkCacheNode(pCache, pNode);
+  }
+}
@@ -37,6 +37,28 @@ typedef struct {
   SDataCols *  pDataCols;
 } SCommitH;
 
+typedef struct {
+  SDFileSet *pSet;    // existing FSET, NULL if the memory data goes to a new one
+  int        fid;
+  bool       commit;  // has memory data to commit, otherwise only the retention is applied
+  bool       done;    // wSet is written
+  SDFileSet  wSet;
+} SCommitFSet;
+
+// File sets of one commit, taken one by one by the committing thread and the helpers on the commit queue
+typedef struct {
+  STsdbRepo *     pRepo;
+  SRtn            rtn;
+  SArray *        aFSet;     // SCommitFSet array in fid order
+  int32_t         nextFSet;  // index of the next FSET to take
+  int32_t         code;      // first error met
+  int32_t         ref;
+  int             nHelpers;  // helpers running
+  bool            closed;    // helpers coming later do nothing
+  pthread_mutex_t lock;
+  pthread_cond_t  helpersDone;
+} SCommitJob;
+
 /*
  * millisecond by default
  * for TSDB_TIME_PRECISION_MILLI: 3600000L
@@ -70,7 +92,13 @@ static void tsdbEndCommit(STsdbRepo *pRepo, int eno, bool end);
 static int  tsdbCommitToFile(SCommitH *pCommith, SDFileSet *pSet, int fid);
 static int  tsdbCreateCommitIters(SCommitH *pCommith);
 static void tsdbDestroyCommitIters(SCommitH *pCommith);
-static void tsdbSeekCommitIter(SCommitH *pCommith, TSKEY key);
+static int  tsdbSeekCommitIter(SCommitH *pCommith, TSKEY key);
+static SCommitJob *tsdbNewCommitJob(STsdbRepo *pRepo, SRtn *pRtn);
+static void        tsdbUnRefCommitJob(SCommitJob *pJob);
+static int         tsdbPlanCommitJob(SCommitH *pCommith, SCommitJob *pJob);
+static void        tsdbRunCommitJob(SCommitJob *pJob, SCommitH *pCommith);
+static void        tsdbCloseCommitJob(SCommitJob *pJob);
+static int         tsdbEndCommitJob(SCommitJob *pJob);
 static int  tsdbInitCommitH(SCommitH *pCommith, STsdbRepo *pRepo);
 static void tsdbDestroyCommitH(SCommitH *pCommith);
 static int  tsdbGetFidLevel(int fid, SRtn *pRtn);
@@ -143,7 +171,12 @@ int tsdbApplyRtnOnFSet(STsdbRepo *pRepo, SDFileSet *pSet, SRtn *pRtn) {
     return -1;
   }
 
-  if (did.level > TSDB_FSET_LEVEL(pSet)) {
+  if (did.level > TSDB_FSET_LEVEL(pSet) &&
+      tsdbGetLevelCompression(REPO_CFG(pRepo), did.level) !=
+          tsdbGetLevelCompression(REPO_CFG(pRepo), TSDB_FSET_LEVEL(pSet))) {
+    // The blocks are compressed again with the second stage of the higher level instead of being copied
+    return tsdbRecompressFSet(pRepo, pSet, did);
+  } else if (did.level > TSDB_FSET_LEVEL(pSet)) {
     // Need to move the FSET to higher level
     tsdbInitDFileSet(&nSet, did, REPO_ID(pRepo), pSet->fid, FS_TXN_VERSION(pfs), pSet->ver);
 
@@ -610,10 +643,9 @@ _err:
 
 // =================== Commit Time-Series Data
 static int tsdbCommitTSData(STsdbRepo *pRepo) {
-  SMemTable *pMem = pRepo->imem;
-  SCommitH   commith;
-  SDFileSet *pSet = NULL;
-  int        fid;
+  SMemTable * pMem = pRepo->imem;
+  SCommitH    commith;
+  SCommitJob *pJob = NULL;
 
   memset(&commith, 0, sizeof(commith));
 
@@ -630,10 +662,122 @@ static int tsdbCommitTSData(STsdbRepo *pRepo) {
     return -1;
   }
 
+  pJob = tsdbNewCommitJob(pRepo, &(commith.rtn));
+  if (pJob == NULL) {
+    tsdbDestroyCommitH(&commith);
+    return -1;
+  }
+
+  if (tsdbPlanCommitJob(&commith, pJob) < 0) {
+    tsdbUnRefCommitJob(pJob);
+    tsdbDestroyCommitH(&commith);
+    return -1;
+  }
+
+  // Ask idle commit threads to take some of the file sets, the thread committing the vnode takes the others
+  int nCommit = 0;
+  for (size_t i = 0; i < taosArrayGetSize(pJob->aFSet); i++) {
+    if (((SCommitFSet *)taosArrayGet(pJob->aFSet, i))->commit) nCommit++;
+  }
+
+  int nHelpers = MIN(tsdbCommitFSetThreads, tsNumOfCommitThreads) - 1;
+  nHelpers = MIN(nHelpers, nCommit - 1);
+  for (int i = 0; i < nHelpers; i++) {
+    atomic_add_fetch_32(&(pJob->ref), 1);
+    if (tsdbScheduleCommit(pRepo, pJob, COMMIT_FSET_REQ) < 0) {
+      atomic_sub_fetch_32(&(pJob->ref), 1);
+      break;
+    }
+  }
+
+  if (nHelpers > 0) {
+    tsdbDebug("vgId:%d commit %d FSETs with up to %d helpers", REPO_ID(pRepo), nCommit, nHelpers);
+  }
+
+  tsdbRunCommitJob(pJob, &commith);
+  tsdbCloseCommitJob(pJob);
+  tsdbDestroyCommitH(&commith);
+
+  int code = tsdbEndCommitJob(pJob);
+  tsdbUnRefCommitJob(pJob);
+
+  return code;
+}
+
+void tsdbHelpCommitFSets(void *param) {
+  SCommitJob *pJob = (SCommitJob *)param;
+  SCommitH    commith;
+
+  pthread_mutex_lock(&(pJob->lock));
+  if (pJob->closed) {
+    pthread_mutex_unlock(&(pJob->lock));
+    tsdbUnRefCommitJob(pJob);
+    return;
+  }
+  pJob->nHelpers++;
+  pthread_mutex_unlock(&(pJob->lock));
+
+  // A helper failing to start leaves its share to the others
+  if (tsdbInitCommitH(&commith, pJob->pRepo) == 0) {
+    commith.rtn = pJob->rtn;
+    tsdbRunCommitJob(pJob, &commith);
+    tsdbDestroyCommitH(&commith);
+  }
+
+  pthread_mutex_lock(&(pJob->lock));
+  if (--pJob->nHelpers == 0) {
+    pthread_cond_signal(&(pJob->helpersDone));
+  }
+  pthread_mutex_unlock(&(pJob->lock));
+
+  tsdbUnRefCommitJob(pJob);
+}
+
+static SCommitJob *tsdbNewCommitJob(STsdbRepo *pRepo, SRtn *pRtn) {
+  SCommitJob *pJob = (SCommitJob *)calloc(1, sizeof(*pJob));
+  if (pJob == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pJob->aFSet = taosArrayInit(16, sizeof(SCommitFSet));
+  if (pJob->aFSet == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    free(pJob);
+    return NULL;
+  }
+
+  pJob->pRepo = pRepo;
+  pJob->rtn = *pRtn;
+  pJob->ref = 1;
+  pthread_mutex_init(&(pJob->lock), NULL);
+  pthread_cond_init(&(pJob->helpersDone), NULL);
+
+  return pJob;
+}
+
+static void tsdbUnRefCommitJob(SCommitJob *pJob) {
+  if (atomic_sub_fetch_32(&(pJob->ref), 1) > 0) return;
+
+  taosArrayDestroy(&(pJob->aFSet));
+  pthread_cond_destroy(&(pJob->helpersDone));
+  pthread_mutex_destroy(&(pJob->lock));
+  free(pJob);
+}
+
+// List the FSETs to commit and those only to apply the retention on, in fid order, as they are added to the FS
+static int tsdbPlanCommitJob(SCommitH *pCommith, SCommitJob *pJob) {
+  STsdbRepo * pRepo = TSDB_COMMIT_REPO(pCommith);
+  STsdbCfg *  pCfg = REPO_CFG(pRepo);
+  SDFileSet * pSet = NULL;
+  SCommitFSet fSet;
+  TSKEY       minKey, maxKey;
+  int         fid;
+
   // Skip expired memory data and expired FSET
-  tsdbSeekCommitIter(&commith, commith.rtn.minKey);
-  while ((pSet = tsdbFSIterNext(&(commith.fsIter)))) {
-    if (pSet->fid < commith.rtn.minFid) {
+  if (tsdbSeekCommitIter(pCommith, pCommith->rtn.minKey) < 0) return -1;
+  while ((pSet = tsdbFSIterNext(&(pCommith->fsIter)))) {
+    if (pSet->fid < pCommith->rtn.minFid) {
       tsdbInfo("vgId:%d FSET %d on level %d disk id %d expires, remove it", REPO_ID(pRepo), pSet->fid,
                TSDB_FSET_LEVEL(pSet), TSDB_FSET_ID(pSet));
     } else {
@@ -641,47 +785,112 @@ static int tsdbCommitTSData(STsdbRepo *pRepo) {
     }
   }
 
-  // Loop to commit to each file
-  fid = tsdbNextCommitFid(&(commith));
+  // Loop over both on disk and memory
+  fid = tsdbNextCommitFid(pCommith);
   while (true) {
-    // Loop over both on disk and memory
     if (pSet == NULL && fid == TSDB_IVLD_FID) break;
 
+    memset(&fSet, 0, sizeof(fSet));
     if (pSet && (fid == TSDB_IVLD_FID || pSet->fid < fid)) {
       // Only has existing FSET but no memory data to commit in this
       // existing FSET, only check if file in correct retention
-      if (tsdbApplyRtnOnFSet(pRepo, pSet, &(commith.rtn)) < 0) {
-        tsdbDestroyCommitH(&commith);
-        return -1;
-      }
+      fSet.pSet = pSet;
+      fSet.fid = pSet->fid;
+      fSet.commit = false;
 
-      pSet = tsdbFSIterNext(&(commith.fsIter));
+      pSet = tsdbFSIterNext(&(pCommith->fsIter));
     } else {
-      // Has memory data to commit
-      SDFileSet *pCSet;
-      int        cfid;
-
       if (pSet == NULL || pSet->fid > fid) {
         // Commit to a new FSET with fid: fid
-        pCSet = NULL;
-        cfid = fid;
+        fSet.pSet = NULL;
+        fSet.fid = fid;
       } else {
         // Commit to an existing FSET
-        pCSet = pSet;
-        cfid = pSet->fid;
-        pSet = tsdbFSIterNext(&(commith.fsIter));
+        fSet.pSet = pSet;
+        fSet.fid = pSet->fid;
+        pSet = tsdbFSIterNext(&(pCommith->fsIter));
       }
+      fSet.commit = true;
 
-      if (tsdbCommitToFile(&commith, pCSet, cfid) < 0) {
-        tsdbDestroyCommitH(&commith);
-        return -1;
+      tsdbGetFidKeyRange(pCfg->daysPerFile, pCfg->precision, fSet.fid, &minKey, &maxKey);
+      if (tsdbSeekCommitIter(pCommith, maxKey + 1) < 0) return -1;
+      fid = tsdbNextCommitFid(pCommith);
+    }
+
+    if (taosArrayPush(pJob->aFSet, &fSet) == NULL) {
+      terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+      return -1;
+    }
+  }
+
+  // Each FSET commit seeks the iterators forward from the first row again
+  tsdbDestroyCommitIters(pCommith);
+  return tsdbCreateCommitIters(pCommith);
+}
+
+static void tsdbRunCommitJob(SCommitJob *pJob, SCommitH *pCommith) {
+  STsdbCfg *pCfg = REPO_CFG(pJob->pRepo);
+  TSKEY     minKey, maxKey;
+
+  while (atomic_load_32(&(pJob->code)) == TSDB_CODE_SUCCESS) {
+    int idx = atomic_fetch_add_32(&(pJob->nextFSet), 1);
+    if (idx >= (int)taosArrayGetSize(pJob->aFSet)) break;
+
+    SCommitFSet *pFSet = (SCommitFSet *)taosArrayGet(pJob->aFSet, idx);
+    if (!pFSet->commit) continue;
+
+    // FSETs are taken in fid order, the iterators of a thread only move forward
+    tsdbGetFidKeyRange(pCfg->daysPerFile, pCfg->precision, pFSet->fid, &minKey, &maxKey);
+    if (tsdbSeekCommitIter(pCommith, MAX(minKey, pJob->rtn.minKey)) < 0 ||
+        tsdbCommitToFile(pCommith, pFSet->pSet, pFSet->fid) < 0) {
+      atomic_val_compare_exchange_32(&(pJob->code), TSDB_CODE_SUCCESS, terrno);
+      break;
+    }
+
+    pFSet->wSet = pCommith->wSet;
+    pFSet->done = true;
+    tsdbDebug("vgId:%d FSET %d is written", REPO_ID(pJob->pRepo), pFSet->fid);
+  }
+}
+
+// No helper joins the job after it is closed, wait for the running ones
+static void tsdbCloseCommitJob(SCommitJob *pJob) {
+  pthread_mutex_lock(&(pJob->lock));
+  pJob->closed = true;
+  while (pJob->nHelpers > 0) {
+    pthread_cond_wait(&(pJob->helpersDone), &(pJob->lock));
+  }
+  pthread_mutex_unlock(&(pJob->lock));
+}
+
+// Add the FSETs to the FS transaction in fid order, or remove the files written if any FSET failed
+static int tsdbEndCommitJob(SCommitJob *pJob) {
+  STsdbRepo *pRepo = pJob->pRepo;
+  size_t     nFSet = taosArrayGetSize(pJob->aFSet);
+
+  if (pJob->code != TSDB_CODE_SUCCESS) {
+    for (size_t i = 0; i < nFSet; i++) {
+      SCommitFSet *pFSet = (SCommitFSet *)taosArrayGet(pJob->aFSet, i);
+      if (pFSet->done) {
+        tsdbApplyDFileSetChange(&(pFSet->wSet), pFSet->pSet);
       }
+    }
 
-      fid = tsdbNextCommitFid(&commith);
+    terrno = pJob->code;
+    return -1;
+  }
+
+  for (size_t i = 0; i < nFSet; i++) {
+    SCommitFSet *pFSet = (SCommitFSet *)taosArrayGet(pJob->aFSet, i);
+
+    if (pFSet->commit) {
+      ASSERT(pFSet->done);
+      if (tsdbUpdateDFileSet(REPO_FS(pRepo), &(pFSet->wSet)) < 0) return -1;
+    } else {
+      if (tsdbApplyRtnOnFSet(pRepo, pFSet->pSet, &(pJob->rtn)) < 0) return -1;
     }
   }
 
-  tsdbDestroyCommitH(&commith);
   return 0;
 }
 
@@ -779,13 +988,9 @@ static int tsdbCommitToFile(SCommitH *pCommith, SDFileSet *pSet, int fid) {
     return -1;
   }
 
-  // Close commit file
+  // Close commit file, the FSET is added to the FS transaction once all of them are written
   tsdbCloseCommitFile(pCommith, false);
 
-  if (tsdbUpdateDFileSet(REPO_FS(pRepo), &(pCommith->wSet)) < 0) {
-    return -1;
-  }
-
   return 0;
 }
 
@@ -816,12 +1021,11 @@ static int tsdbCreateCommitIters(SCommitH *pCommith) {
   for (int i = 0; i < pMem->maxTables; i++) {
     if ((pCommith->iters[i].pTable != NULL) && (pMem->tData[i] != NULL) &&
         (TABLE_UID(pCommith->iters[i].pTable) == pMem->tData[i]->uid)) {
-      if ((pCommith->iters[i].pIter = tSkipListCreateIter(pMem->tData[i]->pData)) == NULL) {
-        terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+      if ((pCommith->iters[i].pIter = tsdbCreateTableDataIter(pMem->tData[i], NULL, TSDB_ORDER_ASC)) == NULL) {
         return -1;
       }
 
-      tSkipListIterNext(pCommith->iters[i].pIter);
+      tsdbTableDataIterNext(pCommith->iters[i].pIter);
     }
   }
 
@@ -834,7 +1038,7 @@ static void tsdbDestroyCommitIters(SCommitH *pCommith) {
   for (int i = 1; i < pCommith->niters; i++) {
     if (pCommith->iters[i].pTable != NULL) {
       tsdbUnRefTable(pCommith->iters[i].pTable);
-      tSkipListDestroyIter(pCommith->iters[i].pIter);
+      tsdbDestroyTableDataIter(pCommith->iters[i].pIter);
     }
   }
 
@@ -843,14 +1047,26 @@ static void tsdbDestroyCommitIters(SCommitH *pCommith) {
   pCommith->niters = 0;
 }
 
-// Skip all keys until key (not included)
-static void tsdbSeekCommitIter(SCommitH *pCommith, TSKEY key) {
+// Move the iterators forward to the first key not less than key
+static int tsdbSeekCommitIter(SCommitH *pCommith, TSKEY key) {
+  SMemTable *pMem = TSDB_COMMIT_REPO(pCommith)->imem;
+
   for (int i = 0; i < pCommith->niters; i++) {
     SCommitIter *pIter = pCommith->iters + i;
     if (pIter->pTable == NULL || pIter->pIter == NULL) continue;
 
-    tsdbLoadDataFromCache(pIter->pTable, pIter->pIter, key - 1, INT32_MAX, NULL, NULL, 0, true, NULL);
+    TSKEY nextKey = tsdbNextIterKey(pIter->pIter);
+    if (nextKey == TSDB_DATA_TIMESTAMP_NULL || nextKey >= key) continue;
+
+    pIter->pIter = tsdbDestroyTableDataIter(pIter->pIter);
+    if ((pIter->pIter = tsdbCreateTableDataIter(pMem->tData[i], &key, TSDB_ORDER_ASC)) == NULL) {
+      return -1;
+    }
+
+    tsdbTableDataIterNext(pIter->pIter);
   }
+
+  return 0;
 }
 
 static int tsdbInitCommitH(SCommitH *pCommith, STsdbRepo *pRepo) {
@@ -1078,6 +1294,7 @@ int tsdbWriteBlockImpl(STsdbRepo *pRepo, STable *pTable, SDFile *pDFile, SDFile
   SAggrBlkData *pAggrBlkData = NULL;
   int64_t     offset = 0, offsetAggr = 0;
   int         rowsToWrite = pDataCols->numOfRows;
+  int8_t      comp = tsdbGetLevelCompression(pCfg, TSDB_FILE_LEVEL(pDFile));
 
   ASSERT(rowsToWrite > 0 && rowsToWrite <= pCfg->maxRowsPerFileBlock);
   ASSERT((!isLast) || rowsToWrite < pCfg->minRowsPerFileBlock);
@@ -1156,7 +1373,8 @@ int tsdbWriteBlockImpl(STsdbRepo *pRepo, STable *pTable, SDFile *pDFile, SDFile
     pBlockCol = pBlockData->cols + tcol;
     tptr = POINTER_SHIFT(pBlockData, lsize);
 
-    if (pCfg->compression == TWO_STAGE_COMP &&
+    // The dictionary encoding of binary and nchar columns is compared with LZ4 in the buffer
+    if ((pCfg->compression == TWO_STAGE_COMP || (pCfg->compression && IS_VAR_DATA_TYPE(pDataCol->type))) &&
         tsdbMakeRoom(ppCBuf, tlen + COMP_OVERFLOW_BYTES) < 0) {
       return -1;
     }
@@ -1164,7 +1382,7 @@ int tsdbWriteBlockImpl(STsdbRepo *pRepo, STable *pTable, SDFile *pDFile, SDFile
     // Compress or just copy
     if (pCfg->compression) {
       flen = (*(tDataTypes[pDataCol->type].compFunc))((char *)pDataCol->pData, tlen, rowsToWrite, tptr,
-                                                      tlen + COMP_OVERFLOW_BYTES, pCfg->compression, *ppCBuf,
+                                                      tlen + COMP_OVERFLOW_BYTES, comp, *ppCBuf,
                                                       tlen + COMP_OVERFLOW_BYTES);
     } else {
       flen = tlen;
@@ -1216,7 +1434,7 @@ int tsdbWriteBlockImpl(STsdbRepo *pRepo, STable *pTable, SDFile *pDFile, SDFile
   // Update pBlock membership variables
   pBlock->last = isLast;
   pBlock->offset = offset;
-  pBlock->algorithm = pCfg->compression;
+  pBlock->algorithm = comp;
   pBlock->numOfRows = rowsToWrite;
   pBlock->len = lsize;
   pBlock->keyLen = keyLen;
@@ -1318,7 +1536,7 @@ static int tsdbMergeMemData(SCommitH *pCommith, SCommitIter *pIter, int bidx) {
     keyLimit = pBlock[1].keyFirst - 1;
   }
 
-  SSkipListIterator titer = *(pIter->pIter);
+  STableDataIter titer = *(pIter->pIter);
   if (tsdbLoadBlockDataCols(&(pCommith->readh), pBlock, NULL, &colId, 1) < 0) return -1;
 
   tsdbLoadDataFromCache(pIter->pTable, &titer, keyLimit, INT32_MAX, NULL, pCommith->readh.pDCols[0]->cols[0].pData,
@@ -1470,11 +1688,12 @@ static void tsdbLoadAndMergeFromCache(SDataCols *pDataCols, int *iter, SCommitIt
 
   while (true) {
     key1 = (*iter >= pDataCols->numOfRows) ? INT64_MAX : dataColsKeyAt(pDataCols, *iter);
-    SMemRow row = tsdbNextIterRow(pCommitIter->pIter);
-    if (row == NULL || memRowKey(row) > maxKey) {
+    SMemRow row = NULL;
+    key2 = tsdbNextIterKey(pCommitIter->pIter);
+    if (key2 == TSDB_DATA_TIMESTAMP_NULL || key2 > maxKey) {
       key2 = INT64_MAX;
-    } else {
-      key2 = memRowKey(row);
+    } else if (key1 >= key2) {
+      row = tsdbNextIterRow(pCommitIter->pIter);
     }
 
     if (key1 == INT64_MAX && key2 == INT64_MAX) break;
@@ -1497,7 +1716,7 @@ static void tsdbLoadAndMergeFromCache(SDataCols *pDataCols, int *iter, SCommitIt
 
       tdAppendMemRowToDataCol(row, pSchema, pTarget, true, 0);
 
-      tSkipListIterNext(pCommitIter->pIter);
+      tsdbTableDataIterNext(pCommitIter->pIter);
     } else {
       if (update != TD_ROW_OVERWRITE_UPDATE) {
         //copy disk data
@@ -1521,7 +1740,7 @@ static void tsdbLoadAndMergeFromCache(SDataCols *pDataCols, int *iter, SCommitIt
                                 update != TD_ROW_PARTIAL_UPDATE ? 0 : -1);
       }
       (*iter)++;
-      tSkipListIterNext(pCommitIter->pIter);
+      tsdbTableDataIterNext(pCommitIter->pIter);
     }
 
     if (pTarget->numOfRows >= maxRows) break;
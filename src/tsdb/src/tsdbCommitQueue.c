@@ -109,7 +109,12 @@ int tsdbScheduleCommit(STsdbRepo *pRepo, void *param, TSDB_REQ_T req) {
 
   // ASSERT(pQueue->stop);
 
-  tdListAppendNode(pQueue->queue, pNode);
+  // Helpers of a running commit go first, the commit ends sooner and the helpers find file sets left to take
+  if (req == COMMIT_FSET_REQ) {
+    tdListPrependNode(pQueue->queue, pNode);
+  } else {
+    tdListAppendNode(pQueue->queue, pNode);
+  }
   pthread_cond_signal(&(pQueue->queueNotEmpty));
 
   pthread_mutex_unlock(&(pQueue->lock));
@@ -203,6 +208,10 @@ static void *tsdbLoopCommit(void *arg) {
       ASSERT(pRepo->config_changed);
       tsdbApplyRepoConfig(pRepo);
       tsem_post(&(pRepo->readyToCommit));
+    } else if (req == COMMIT_FSET_REQ) {
+      // the job is shared with the committing thread and released by the helper
+      tsdbHelpCommitFSets(param);
+      param = NULL;
     } else {
       ASSERT(0);
     }
@@ -58,6 +58,7 @@ static int  tsdbCacheFSetIndex(SCompactH *pComph);
 static int  tsdbCompactFSetInit(SCompactH *pComph, SDFileSet *pSet);
 static void tsdbCompactFSetEnd(SCompactH *pComph);
 static int  tsdbCompactFSetImpl(SCompactH *pComph);
+static int  tsdbRewriteFSet(SCompactH *pComph, SDFileSet *pSet, SDiskID did);
 static int  tsdbWriteBlockToRightFile(SCompactH *pComph, STable *pTable, SDataCols *pDataCols, void **ppBuf,
                                       void **ppCBuf, void **ppExBuf);
 
@@ -94,6 +95,29 @@ _err:
   return NULL;
 }
 
+int tsdbRecompressFSet(STsdbRepo *pRepo, SDFileSet *pSet, SDiskID did) {
+  SCompactH compactH;
+
+  if (tsdbInitCompactH(&compactH, pRepo) < 0) {
+    return -1;
+  }
+
+  if (tsdbCompactFSetInit(&compactH, pSet) < 0 || tsdbRewriteFSet(&compactH, pSet, did) < 0) {
+    tsdbError("vgId:%d failed to recompress FSET %d from level %d to level %d since %s", REPO_ID(pRepo), pSet->fid,
+              TSDB_FSET_LEVEL(pSet), did.level, tstrerror(terrno));
+    tsdbCompactFSetEnd(&compactH);
+    tsdbDestroyCompactH(&compactH);
+    return -1;
+  }
+
+  tsdbInfo("vgId:%d FSET %d is recompressed from level %d disk id %d to level %d disk id %d", REPO_ID(pRepo),
+           pSet->fid, TSDB_FSET_LEVEL(pSet), TSDB_FSET_ID(pSet), did.level, did.id);
+
+  tsdbCompactFSetEnd(&compactH);
+  tsdbDestroyCompactH(&compactH);
+  return 0;
+}
+
 static int tsdbAsyncCompact(STsdbRepo *pRepo) {
   if (pRepo->compactState != TSDB_NO_COMPACT) {
     tsdbInfo("vgId:%d not compact tsdb again ", REPO_ID(pRepo));
@@ -202,23 +226,12 @@ static int tsdbCompactMeta(STsdbRepo *pRepo) {
         return -1;
       }
 
-      tsdbInitDFileSet(TSDB_COMPACT_WSET(pComph), did, REPO_ID(pRepo), TSDB_FSET_FID(pSet),
-                      FS_TXN_VERSION(REPO_FS(pRepo)), TSDB_LATEST_FSET_VER);
-      if (tsdbCreateDFileSet(TSDB_COMPACT_WSET(pComph), true) < 0) {
+      if (tsdbRewriteFSet(pComph, pSet, did) < 0) {
         tsdbError("vgId:%d failed to compact FSET %d since %s", REPO_ID(pRepo), pSet->fid, tstrerror(terrno));
         tsdbCompactFSetEnd(pComph);
         return -1;
       }
 
-      if (tsdbCompactFSetImpl(pComph) < 0) {
-        tsdbCloseDFileSet(TSDB_COMPACT_WSET(pComph));
-        tsdbRemoveDFileSet(TSDB_COMPACT_WSET(pComph));
-        tsdbCompactFSetEnd(pComph);
-        return -1;
-      }
-
-      tsdbCloseDFileSet(TSDB_COMPACT_WSET(pComph));
-      tsdbUpdateDFileSet(REPO_FS(pRepo), TSDB_COMPACT_WSET(pComph));
       tsdbDebug("vgId:%d FSET %d compact over", REPO_ID(pRepo), pSet->fid);
     }
 
@@ -226,6 +239,25 @@ static int tsdbCompactMeta(STsdbRepo *pRepo) {
     return 0;
   }
 
+  static int tsdbRewriteFSet(SCompactH *pComph, SDFileSet *pSet, SDiskID did) {
+    STsdbRepo *pRepo = TSDB_COMPACT_REPO(pComph);
+
+    tsdbInitDFileSet(TSDB_COMPACT_WSET(pComph), did, REPO_ID(pRepo), TSDB_FSET_FID(pSet),
+                     FS_TXN_VERSION(REPO_FS(pRepo)), TSDB_LATEST_FSET_VER);
+    if (tsdbCreateDFileSet(TSDB_COMPACT_WSET(pComph), true) < 0) {
+      return -1;
+    }
+
+    if (tsdbCompactFSetImpl(pComph) < 0) {
+      tsdbCloseDFileSet(TSDB_COMPACT_WSET(pComph));
+      tsdbRemoveDFileSet(TSDB_COMPACT_WSET(pComph));
+      return -1;
+    }
+
+    tsdbCloseDFileSet(TSDB_COMPACT_WSET(pComph));
+    return tsdbUpdateDFileSet(REPO_FS(pRepo), TSDB_COMPACT_WSET(pComph));
+  }
+
   static bool tsdbShouldCompact(SCompactH *pComph) {
     if (tsdbForceCompactFile) {
       return true;
@@ -244,6 +276,10 @@ static int tsdbCompactMeta(STsdbRepo *pRepo) {
     int     nSmallBlocks = 0;  // # of blocks with rows < defaultRows
     int64_t tsize = 0;
 
+    // Blocks whose second stage is not that of the tier the file set is written to, because the file set moves to
+    // another tier or zstdTier changed, are compressed again
+    int8_t comp = tsdbGetLevelCompression(pCfg, tsdbGetFidLevel(TSDB_READ_FSET(pReadh)->fid, &(pComph->rtn)));
+
     for (size_t i = 0; i < taosArrayGetSize(pComph->tbArray); i++) {
       pTh = (STableCompactH *)taosArrayGet(pComph->tbArray, i);
 
@@ -253,6 +289,10 @@ static int tsdbCompactMeta(STsdbRepo *pRepo) {
         tblocks++;
         pBlock = pTh->pInfo->blocks + bidx;
 
+        if (IS_TWO_STAGE_COMP(comp) && IS_TWO_STAGE_COMP(pBlock->algorithm) && pBlock->algorithm != comp) {
+          return true;
+        }
+
         if (pBlock->numOfRows < defaultRows) {
           nSmallBlocks++;
         }
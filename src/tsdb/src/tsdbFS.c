@@ -389,6 +389,8 @@ int tsdbEndFSTxn(STsdbRepo *pRepo) {
   pStatus = pfs->cstatus;
   pfs->cstatus = pfs->nstatus;
   pfs->nstatus = pStatus;
+  tsdbInvalidateBlkCache(pRepo->pBlkCache);
+  tsdbInvalidateBlkCache(pRepo->pBlkIdxCache);
   tsdbUnLockFS(pfs);
 
   // Apply actual change to each file and SDFileSet
@@ -628,11 +628,31 @@ static STsdbRepo *tsdbNewRepo(STsdbCfg *pCfg, STsdbAppH *pAppH) {
     return NULL;
   }
 
+  if (tsdbBlkDataCacheSize > 0) {
+    pRepo->pBlkCache = tsdbNewBlkCache((int64_t)tsdbBlkDataCacheSize * 1024 * 1024);
+    if (pRepo->pBlkCache == NULL) {
+      tsdbError("vgId:%d failed to create block cache since %s", REPO_ID(pRepo), tstrerror(terrno));
+      tsdbFreeRepo(pRepo);
+      return NULL;
+    }
+  }
+
+  if (tsdbBlkIdxCacheSize > 0) {
+    pRepo->pBlkIdxCache = tsdbNewBlkCache((int64_t)tsdbBlkIdxCacheSize * 1024 * 1024);
+    if (pRepo->pBlkIdxCache == NULL) {
+      tsdbError("vgId:%d failed to create block index cache since %s", REPO_ID(pRepo), tstrerror(terrno));
+      tsdbFreeRepo(pRepo);
+      return NULL;
+    }
+  }
+
   return pRepo;
 }
 
 static void tsdbFreeRepo(STsdbRepo *pRepo) {
   if (pRepo) {
+    tsdbFreeBlkCache(pRepo->pBlkCache);
+    tsdbFreeBlkCache(pRepo->pBlkIdxCache);
     tsdbFreeFS(pRepo->fs);
     tsdbFreeBufPool(pRepo->pPool);
     tsdbFreeMeta(pRepo->tsdbMeta);
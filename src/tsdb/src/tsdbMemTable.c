@@ -50,6 +50,21 @@ static int          tsdbGetSubmitMsgNext(SSubmitMsgIter *pIter, SSubmitBlk **pPB
 static int          tsdbCheckTableSchema(STsdbRepo *pRepo, SSubmitBlk *pBlock, STable *pTable);
 static int          tsdbUpdateTableLatestInfo(STsdbRepo *pRepo, STable *pTable, SMemRow row);
 static int32_t      tsdbInsertControlData(STsdbRepo* pRepo, SSubmitBlk* pBlock, SShellSubmitRspMsg *pRsp, tsem_t** pSem);
+static int          tsdbInsertRowsToColBuf(STsdbRepo *pRepo, STable *pTable, STableData *pTableData,
+                                           SSubmitBlkIter *pIter, int32_t *pPoints, SMemRow *pLastRow, int64_t *pRows);
+static int          tsdbPutRowToSkipList(STsdbRepo *pRepo, STableData *pTableData, SMemRow row, int32_t *pPoints,
+                                         SMemRow *pLastRow, int64_t *pRows);
+static void *       tsdbAllocAlignedBytes(STsdbRepo *pRepo, int bytes);
+static SMemColBuf * tsdbNewMemColBuf(STsdbRepo *pRepo, STable *pTable, int16_t sversion);
+static int          tsdbAppendMemColRow(STsdbRepo *pRepo, SMemColBuf *pColBuf, SMemRow row);
+static bool         tsdbFindMemColRow(SMemColBuf *pColBuf, TSKEY key, SMemColChunk **ppChunk, int32_t *pRidx);
+static int64_t      tsdbSeekMemColBuf(SMemColBuf *pColBuf, int64_t nRows, TSKEY key, int32_t order,
+                                      SMemColChunk **ppChunk);
+static void         tsdbGetMemColRow(SMemColBuf *pColBuf, SMemColChunk *pChunk, int32_t ridx, SMemRow row);
+static void         tsdbMoveMemColPos(STableDataIter *pIter, int32_t nRows);
+static bool         tsdbSetTableDataIterCur(STableDataIter *pIter);
+static TSKEY        tsdbGetIterKeyBefore(STableDataIter *pIter, TSKEY maxKey, bool *isRowDel);
+static void         tsdbAppendColRunToCols(STableDataIter *pIter, int32_t nRun, SDataCols *pCols);
 
 static FORCE_INLINE int tsdbCheckRowRange(STsdbRepo *pRepo, STable *pTable, SMemRow row, TSKEY minKey, TSKEY maxKey,
                                           TSKEY now);
@@ -392,7 +407,7 @@ int tsdbSyncCommit(STsdbRepo *repo) {
  * 
  * The function tries to procceed AS MUCH AS POSSIBLE.
  */
-int tsdbLoadDataFromCache(STable *pTable, SSkipListIterator *pIter, TSKEY maxKey, int maxRowsToRead, SDataCols *pCols,
+int tsdbLoadDataFromCache(STable *pTable, STableDataIter *pIter, TSKEY maxKey, int maxRowsToRead, SDataCols *pCols,
                           TKEY *filterKeys, int nFilterKeys, bool keepDup, SMergeInfo *pMergeInfo) {
   ASSERT(maxRowsToRead > 0 && nFilterKeys >= 0);
   if (pIter == NULL) return 0;
@@ -401,7 +416,6 @@ int tsdbLoadDataFromCache(STable *pTable, SSkipListIterator *pIter, TSKEY maxKey
   TSKEY      fKey = 0;
   bool       isRowDel = false;
   int        filterIter = 0;
-  SMemRow    row = NULL;
   SMergeInfo mInfo;
 
   if (pMergeInfo == NULL) pMergeInfo = &mInfo;
@@ -411,14 +425,7 @@ int tsdbLoadDataFromCache(STable *pTable, SSkipListIterator *pIter, TSKEY maxKey
   pMergeInfo->keyLast = INT64_MIN;
   if (pCols) tdResetDataCols(pCols);
 
-  row = tsdbNextIterRow(pIter);
-  if (row == NULL || memRowKey(row) > maxKey) {
-    rowKey = INT64_MAX;
-    isRowDel = false;
-  } else {
-    rowKey = memRowKey(row);
-    isRowDel = memRowDeleted(row);
-  }
+  rowKey = tsdbGetIterKeyBefore(pIter, maxKey, &isRowDel);
 
   if (filterIter >= nFilterKeys) {
     fKey = INT64_MAX;
@@ -445,29 +452,36 @@ int tsdbLoadDataFromCache(STable *pTable, SSkipListIterator *pIter, TSKEY maxKey
       } else {
         if (pMergeInfo->rowsInserted - pMergeInfo->rowsDeleteSucceed >= maxRowsToRead) break;
         if (pCols && pMergeInfo->nOperations >= pCols->maxPoints) break;
-        pMergeInfo->rowsInserted++;
-        pMergeInfo->nOperations++;
-        pMergeInfo->keyFirst = MIN(pMergeInfo->keyFirst, rowKey);
-        pMergeInfo->keyLast = MAX(pMergeInfo->keyLast, rowKey);
-        tsdbAppendTableRowToCols(pTable, pCols, &pSchema, row);
-      }
 
-      tSkipListIterNext(pIter);
-      row = tsdbNextIterRow(pIter);
-      if (row == NULL || memRowKey(row) > maxKey) {
-        rowKey = INT64_MAX;
-        isRowDel = false;
-      } else {
-        rowKey = memRowKey(row);
-        isRowDel = memRowDeleted(row);
+        // Rows of the column buffer before the next filter key are copied column by column
+        int32_t maxRows = maxRowsToRead - (pMergeInfo->rowsInserted - pMergeInfo->rowsDeleteSucceed);
+        if (pCols) maxRows = MIN(maxRows, pCols->maxPoints - pMergeInfo->nOperations);
+        int32_t nRun = tsdbTableDataIterColRun(pIter, (maxKey < fKey) ? maxKey + 1 : fKey, maxRows);
+        if (nRun > 1) {
+          if (pCols) tsdbAppendColRunToCols(pIter, nRun, pCols);
+          pMergeInfo->rowsInserted += nRun;
+          pMergeInfo->nOperations += nRun;
+          pMergeInfo->keyFirst = MIN(pMergeInfo->keyFirst, rowKey);
+          tsdbTableDataIterSkip(pIter, nRun - 1);
+          pMergeInfo->keyLast = MAX(pMergeInfo->keyLast, pIter->key);
+        } else {
+          pMergeInfo->rowsInserted++;
+          pMergeInfo->nOperations++;
+          pMergeInfo->keyFirst = MIN(pMergeInfo->keyFirst, rowKey);
+          pMergeInfo->keyLast = MAX(pMergeInfo->keyLast, rowKey);
+          if (pCols) tsdbAppendTableRowToCols(pTable, pCols, &pSchema, tsdbNextIterRow(pIter));
+        }
       }
+
+      tsdbTableDataIterNext(pIter);
+      rowKey = tsdbGetIterKeyBefore(pIter, maxKey, &isRowDel);
     } else {
       if (isRowDel) {
         ASSERT(!keepDup);
         if (pCols && pMergeInfo->nOperations >= pCols->maxPoints) break;
         pMergeInfo->rowsDeleteSucceed++;
         pMergeInfo->nOperations++;
-        tsdbAppendTableRowToCols(pTable, pCols, &pSchema, row);
+        if (pCols) tsdbAppendTableRowToCols(pTable, pCols, &pSchema, tsdbNextIterRow(pIter));
       } else {
         if (keepDup) {
           if (pCols && pMergeInfo->nOperations >= pCols->maxPoints) break;
@@ -475,22 +489,15 @@ int tsdbLoadDataFromCache(STable *pTable, SSkipListIterator *pIter, TSKEY maxKey
           pMergeInfo->nOperations++;
           pMergeInfo->keyFirst = MIN(pMergeInfo->keyFirst, rowKey);
           pMergeInfo->keyLast = MAX(pMergeInfo->keyLast, rowKey);
-          tsdbAppendTableRowToCols(pTable, pCols, &pSchema, row);
+          if (pCols) tsdbAppendTableRowToCols(pTable, pCols, &pSchema, tsdbNextIterRow(pIter));
         } else {
           pMergeInfo->keyFirst = MIN(pMergeInfo->keyFirst, fKey);
           pMergeInfo->keyLast = MAX(pMergeInfo->keyLast, fKey);
         }
       }
 
-      tSkipListIterNext(pIter);
-      row = tsdbNextIterRow(pIter);
-      if (row == NULL || memRowKey(row) > maxKey) {
-        rowKey = INT64_MAX;
-        isRowDel = false;
-      } else {
-        rowKey = memRowKey(row);
-        isRowDel = memRowDeleted(row);
-      }
+      tsdbTableDataIterNext(pIter);
+      rowKey = tsdbGetIterKeyBefore(pIter, maxKey, &isRowDel);
 
       filterIter++;
       if (filterIter >= nFilterKeys) {
@@ -504,6 +511,151 @@ int tsdbLoadDataFromCache(STable *pTable, SSkipListIterator *pIter, TSKEY maxKey
   return 0;
 }
 
+STableDataIter *tsdbCreateTableDataIter(STableData *pTableData, const TSKEY *pKey, int32_t order) {
+  ASSERT(order == TSDB_ORDER_ASC || order == TSDB_ORDER_DESC);
+
+  STableDataIter *pIter = (STableDataIter *)calloc(1, sizeof(*pIter));
+  if (pIter == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pIter->order = order;
+  pIter->cpos = -1;
+
+  SSkipListIterator *pSlIter = NULL;
+  if (pKey == NULL) {
+    ASSERT(order == TSDB_ORDER_ASC);
+    pSlIter = tSkipListCreateIter(pTableData->pData);
+  } else {
+    TKEY tkey = keyToTkey(*pKey);
+    pSlIter = tSkipListCreateIterFromVal(pTableData->pData, (const char *)&tkey, TSDB_DATA_TYPE_TIMESTAMP, order);
+  }
+  if (pSlIter == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    free(pIter);
+    return NULL;
+  }
+  pIter->slIter = *pSlIter;
+  tSkipListDestroyIter(pSlIter);
+
+  // Rows appended after this point are not visible to the iterator
+  SMemColBuf *pColBuf = (SMemColBuf *)atomic_load_ptr(&(pTableData->pColBuf));
+  int64_t     nRows = (pColBuf == NULL) ? 0 : atomic_load_64(&(pColBuf->numOfRows));
+  if (nRows > 0) {
+    pIter->rowBuf = malloc(memRowMaxBytesFromSchema(pColBuf->pSchema));
+    if (pIter->rowBuf == NULL) {
+      terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+      free(pIter);
+      return NULL;
+    }
+
+    pIter->pColBuf = pColBuf;
+    pIter->nRows = nRows;
+    if (pKey == NULL) {
+      pIter->pChunk = pColBuf->head;
+      pIter->cpos = 0;
+    } else {
+      pIter->cpos = tsdbSeekMemColBuf(pColBuf, nRows, *pKey, order, &(pIter->pChunk));
+    }
+  }
+
+  return pIter;
+}
+
+void *tsdbDestroyTableDataIter(STableDataIter *pIter) {
+  if (pIter) {
+    tfree(pIter->rowBuf);
+    free(pIter);
+  }
+
+  return NULL;
+}
+
+bool tsdbTableDataIterNext(STableDataIter *pIter) {
+  if (!pIter->started) {
+    pIter->started = true;
+    tSkipListIterNext(&(pIter->slIter));
+  } else {
+    if (pIter->src & TSDB_MEM_ITER_SRC_SL) tSkipListIterNext(&(pIter->slIter));
+    if (pIter->src & TSDB_MEM_ITER_SRC_COL) tsdbMoveMemColPos(pIter, 1);
+  }
+
+  return tsdbSetTableDataIterCur(pIter);
+}
+
+SMemRow tsdbTableDataIterGet(STableDataIter *pIter) {
+  if (!pIter->started || pIter->src == 0) return NULL;
+
+  if (pIter->src & TSDB_MEM_ITER_SRC_SL) {
+    return (SMemRow)SL_GET_NODE_DATA(tSkipListIterGet(&(pIter->slIter)));
+  }
+
+  tsdbGetMemColRow(pIter->pColBuf, pIter->pChunk, (int32_t)(pIter->cpos - pIter->pChunk->offset), pIter->rowBuf);
+  return pIter->rowBuf;
+}
+
+/**
+ * Return the number of rows, at most maxRows, that can be taken from the current chunk of the column buffer starting
+ * at the current row: their keys are before boundKey in the iterating order and no skiplist row is between them.
+ */
+int32_t tsdbTableDataIterColRun(STableDataIter *pIter, TSKEY boundKey, int32_t maxRows) {
+  if (!pIter->started || pIter->src != TSDB_MEM_ITER_SRC_COL || maxRows <= 0) return 0;
+
+  bool           asc = (pIter->order == TSDB_ORDER_ASC);
+  SSkipListNode *node = tSkipListIterGet(&(pIter->slIter));
+  if (node != NULL) {
+    TSKEY slKey = memRowKey((SMemRow)SL_GET_NODE_DATA(node));
+    boundKey = asc ? MIN(boundKey, slKey) : MAX(boundKey, slKey);
+  }
+
+  SMemColChunk *pChunk = pIter->pChunk;
+  TKEY *        keys = (TKEY *)pChunk->cols[0];
+  int32_t       ridx = (int32_t)(pIter->cpos - pChunk->offset);
+  int32_t       lo, hi;
+
+  // The first row not before boundKey is searched in [lo, hi)
+  if (asc) {
+    int32_t nRows = (int32_t)MIN(pChunk->capacity, pIter->nRows - pChunk->offset);
+    lo = ridx;
+    hi = ridx + MIN(nRows - ridx, maxRows);
+    int32_t end = hi;
+    while (lo < hi) {
+      int32_t mid = (lo + hi) / 2;
+      if (tdGetKey(keys[mid]) < boundKey) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    ASSERT(lo <= end);
+    return lo - ridx;
+  } else {
+    lo = MAX(0, ridx - maxRows + 1);
+    hi = ridx + 1;
+    int32_t start = lo;
+    while (lo < hi) {
+      int32_t mid = (lo + hi) / 2;
+      if (tdGetKey(keys[mid]) > boundKey) {
+        hi = mid;
+      } else {
+        lo = mid + 1;
+      }
+    }
+    ASSERT(lo >= start);
+    return ridx + 1 - lo;
+  }
+}
+
+// Move forward nRows rows of the column buffer, which must all be in the current run of the iterator
+void tsdbTableDataIterSkip(STableDataIter *pIter, int32_t nRows) {
+  if (nRows <= 0) return;
+
+  ASSERT(pIter->src == TSDB_MEM_ITER_SRC_COL);
+  tsdbMoveMemColPos(pIter, nRows);
+  tsdbSetTableDataIterCur(pIter);
+}
+
 // ---------------- LOCAL FUNCTIONS ----------------
 static SMemTable* tsdbNewMemTable(STsdbRepo *pRepo) {
   STsdbMeta *pMeta = pRepo->tsdbMeta;
@@ -883,10 +1035,17 @@ static int tsdbInsertDataToTable(STsdbRepo* pRepo, SSubmitBlk* pBlock, int32_t *
   ASSERT((pTableData != NULL) && pTableData->uid == TABLE_UID(pTable));
 
   SMemRow lastRow = NULL;
+  int64_t nrows = 0;
   int64_t osize = SL_SIZE(pTableData->pData);
   tsdbSetupSkipListHookFns(pTableData->pData, pRepo, pTable, &points, &lastRow);
-  tSkipListPutBatchByIter(pTableData->pData, &blkIter, (iter_next_fn_t)tsdbGetSubmitBlkNext);
-  int64_t dsize = SL_SIZE(pTableData->pData) - osize;
+  if (tsdbMemColBuffer) {
+    if (tsdbInsertRowsToColBuf(pRepo, pTable, pTableData, &blkIter, &points, &lastRow, &nrows) < 0) {
+      return -1;
+    }
+  } else {
+    tSkipListPutBatchByIter(pTableData->pData, &blkIter, (iter_next_fn_t)tsdbGetSubmitBlkNext);
+  }
+  int64_t dsize = SL_SIZE(pTableData->pData) - osize + nrows;
   (*pAffectedRows) += points;
 
   if(lastRow != NULL) {
@@ -1230,4 +1389,401 @@ int32_t tsdbInsertControlData(STsdbRepo* pRepo, SSubmitBlk* pBlock, SShellSubmit
     tsdbDestroyTableGroup(&tableGroupInfo);
 
   return ret;
-}
\ No newline at end of file
+}
+// Append the rows in key order to the column buffer of the table and put the others to the skiplist
+static int tsdbInsertRowsToColBuf(STsdbRepo *pRepo, STable *pTable, STableData *pTableData, SSubmitBlkIter *pIter,
+                                  int32_t *pPoints, SMemRow *pLastRow, int64_t *pRows) {
+  SSkipList * pSkipList = pTableData->pData;
+  SMemColBuf *pColBuf = pTableData->pColBuf;
+  SMemRow     lastAppended = NULL;
+  SMemRow     row = NULL;
+
+  while ((row = tsdbGetSubmitBlkNext(pIter)) != NULL) {
+    TSKEY key = memRowKey(row);
+
+    if (isDataRow(row) && !memRowDeleted(row) && (pColBuf == NULL || key > pColBuf->keyLast) &&
+        (SL_SIZE(pSkipList) == 0 || key > tdGetKey(*(TKEY *)SL_GET_MAX_KEY(pSkipList)))) {
+      if (pColBuf == NULL) {
+        pColBuf = tsdbNewMemColBuf(pRepo, pTable, memRowVersion(row));
+        if (pColBuf == NULL) return -1;
+        atomic_store_ptr(&(pTableData->pColBuf), pColBuf);
+      }
+
+      // Rows of another schema version go to the skiplist until the memtable is committed
+      if (memRowVersion(row) == schemaVersion(pColBuf->pSchema)) {
+        if (tsdbAppendMemColRow(pRepo, pColBuf, row) < 0) return -1;
+        (*pPoints)++;
+        (*pRows)++;
+        lastAppended = row;
+        continue;
+      }
+    }
+
+    if (tsdbPutRowToSkipList(pRepo, pTableData, row, pPoints, pLastRow, pRows) < 0) return -1;
+  }
+
+  // Appended rows have larger keys than any row in the skiplist
+  if (lastAppended != NULL) *pLastRow = lastAppended;
+
+  return 0;
+}
+
+static int tsdbPutRowToSkipList(STsdbRepo *pRepo, STableData *pTableData, SMemRow row, int32_t *pPoints,
+                                SMemRow *pLastRow, int64_t *pRows) {
+  SSkipList *   pSkipList = pTableData->pData;
+  SMemColBuf *  pColBuf = pTableData->pColBuf;
+  TSKEY         key = memRowKey(row);
+  SMemColChunk *pChunk = NULL;
+  int32_t       ridx = 0;
+
+  if (pColBuf == NULL || key > pColBuf->keyLast || !tsdbFindMemColRow(pColBuf, key, &pChunk, &ridx)) {
+    tSkipListPut(pSkipList, row);
+    return 0;
+  }
+
+  if (pRepo->config.update == TD_ROW_DISCARD_UPDATE) {
+    // for compatiblity, duplicate key inserted when update=0 should be also calculated as affected rows!
+    (*pPoints)++;
+    return 0;
+  }
+
+  // The row updates an appended one, the new version is kept in the skiplist which wins over the column buffer
+  int64_t osize = SL_SIZE(pSkipList);
+
+  if (pRepo->config.update == TD_ROW_PARTIAL_UPDATE) {
+    TKEY               tkey = keyToTkey(key);
+    SSkipListIterator *pSlIter =
+        tSkipListCreateIterFromVal(pSkipList, (const char *)&tkey, TSDB_DATA_TYPE_TIMESTAMP, TSDB_ORDER_ASC);
+    if (pSlIter == NULL) {
+      terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+      return -1;
+    }
+    SSkipListNode *node = tSkipListIterNext(pSlIter) ? tSkipListIterGet(pSlIter) : NULL;
+    bool           inSkipList = (node != NULL) && (memRowKey((SMemRow)SL_GET_NODE_DATA(node)) == key);
+    tSkipListDestroyIter(pSlIter);
+
+    // Columns not in the new row keep the values of the appended one
+    if (!inSkipList) {
+      SMemRow orow = malloc(memRowMaxBytesFromSchema(pColBuf->pSchema));
+      if (orow == NULL) {
+        terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+        return -1;
+      }
+
+      int32_t points = *pPoints;
+      SMemRow lastRow = *pLastRow;
+      tsdbGetMemColRow(pColBuf, pChunk, ridx, orow);
+      tSkipListPut(pSkipList, orow);
+      free(orow);
+      *pPoints = points;
+      *pLastRow = lastRow;
+    }
+  }
+
+  tSkipListPut(pSkipList, row);
+  (*pRows) -= SL_SIZE(pSkipList) - osize;
+
+  return 0;
+}
+
+// Memory from the buffer pool aligned to 8 bytes
+static void *tsdbAllocAlignedBytes(STsdbRepo *pRepo, int bytes) {
+  void *ptr = tsdbAllocBytes(pRepo, bytes + 7);
+  if (ptr == NULL) return NULL;
+
+  return (void *)(((uintptr_t)ptr + 7) & ~((uintptr_t)7));
+}
+
+static SMemColBuf *tsdbNewMemColBuf(STsdbRepo *pRepo, STable *pTable, int16_t sversion) {
+  STSchema *pSchema = tsdbGetTableSchemaImpl(pTable, false, false, sversion, -1);
+  if (pSchema == NULL) {
+    terrno = TSDB_CODE_TDB_IVD_TB_SCHEMA_VERSION;
+    return NULL;
+  }
+
+  int         slen = (int)(sizeof(STSchema) + sizeof(STColumn) * schemaNCols(pSchema));
+  SMemColBuf *pColBuf = tsdbAllocAlignedBytes(pRepo, (int)sizeof(SMemColBuf) + slen);
+  if (pColBuf == NULL) return NULL;
+
+  memset(pColBuf, 0, sizeof(*pColBuf));
+  pColBuf->pSchema = (STSchema *)POINTER_SHIFT(pColBuf, sizeof(SMemColBuf));
+  memcpy(pColBuf->pSchema, pSchema, slen);
+  pColBuf->keyLast = INT64_MIN;
+
+  return pColBuf;
+}
+
+static SMemColChunk *tsdbNewMemColChunk(STsdbRepo *pRepo, SMemColBuf *pColBuf) {
+  STSchema *    pSchema = pColBuf->pSchema;
+  SMemColChunk *pTail = pColBuf->tail;
+  int           ncols = schemaNCols(pSchema);
+  int32_t       rowBytes = 0;
+
+  for (int i = 0; i < ncols; i++) {
+    rowBytes += tsdbMemColElemBytes(schemaColAt(pSchema, i));
+  }
+
+  // Chunks double from a small size so that tables with few rows do not waste the buffer pool
+  int32_t capacity = (pTail == NULL) ? TSDB_MEM_COL_CHUNK_MIN_ROWS : pTail->capacity * 2;
+  capacity = MIN(capacity, TSDB_MEM_COL_CHUNK_MAX_ROWS);
+  int32_t maxRowsBySize = MAX(TSDB_MEM_COL_CHUNK_MAX_SIZE / rowBytes, TSDB_MEM_COL_CHUNK_MIN_ROWS);
+  capacity = MIN(capacity, maxRowsBySize);
+
+  int size = (int)(sizeof(SMemColChunk) + sizeof(void *) * ncols);
+  for (int i = 0; i < ncols; i++) {
+    size += ALIGN8(tsdbMemColElemBytes(schemaColAt(pSchema, i)) * capacity);
+  }
+
+  SMemColChunk *pChunk = tsdbAllocAlignedBytes(pRepo, size);
+  if (pChunk == NULL) return NULL;
+
+  pChunk->next = NULL;
+  pChunk->prev = pTail;
+  pChunk->offset = (pTail == NULL) ? 0 : pTail->offset + pTail->capacity;
+  pChunk->capacity = capacity;
+
+  void *ptr = POINTER_SHIFT(pChunk, ALIGN8(sizeof(SMemColChunk) + sizeof(void *) * ncols));
+  for (int i = 0; i < ncols; i++) {
+    pChunk->cols[i] = ptr;
+    ptr = POINTER_SHIFT(ptr, ALIGN8(tsdbMemColElemBytes(schemaColAt(pSchema, i)) * capacity));
+  }
+
+  return pChunk;
+}
+
+static int tsdbAppendMemColRow(STsdbRepo *pRepo, SMemColBuf *pColBuf, SMemRow row) {
+  STSchema *    pSchema = pColBuf->pSchema;
+  SMemColChunk *pChunk = pColBuf->tail;
+  int64_t       nRows = pColBuf->numOfRows;
+  bool          newChunk = false;
+
+  if (pChunk == NULL || nRows >= pChunk->offset + pChunk->capacity) {
+    pChunk = tsdbNewMemColChunk(pRepo, pColBuf);
+    if (pChunk == NULL) return -1;
+    newChunk = true;
+  }
+
+  SDataRow dataRow = memRowDataBody(row);
+  int32_t  ridx = (int32_t)(nRows - pChunk->offset);
+
+  for (int i = 0; i < schemaNCols(pSchema); i++) {
+    STColumn *pCol = schemaColAt(pSchema, i);
+    void *    value = tdGetRowDataOfCol(dataRow, colType(pCol), colOffset(pCol) + TD_DATA_ROW_HEAD_SIZE);
+
+    if (IS_VAR_DATA_TYPE(colType(pCol))) {
+      void *pVal = NULL;
+      if (isNull(value, colType(pCol))) {
+        pVal = (void *)getNullValue(colType(pCol));
+      } else {
+        pVal = tsdbAllocBytes(pRepo, varDataTLen(value));
+        if (pVal == NULL) return -1;
+        memcpy(pVal, value, varDataTLen(value));
+      }
+      ((void **)pChunk->cols[i])[ridx] = pVal;
+    } else {
+      memcpy(POINTER_SHIFT(pChunk->cols[i], colBytes(pCol) * ridx), value, colBytes(pCol));
+    }
+  }
+
+  // A new chunk is linked only once its first row is written, as tsdbFindMemColRow reads the first key of every chunk
+  if (newChunk) {
+    if (pColBuf->tail == NULL) {
+      atomic_store_ptr(&(pColBuf->head), pChunk);
+    } else {
+      atomic_store_ptr(&(pColBuf->tail->next), pChunk);
+    }
+    pColBuf->tail = pChunk;
+  }
+
+  pColBuf->keyLast = memRowKey(row);
+  atomic_store_64(&(pColBuf->numOfRows), nRows + 1);
+
+  return 0;
+}
+
+// Look for an appended row by key from the last chunk backwards, as updated rows are usually recent ones
+static bool tsdbFindMemColRow(SMemColBuf *pColBuf, TSKEY key, SMemColChunk **ppChunk, int32_t *pRidx) {
+  SMemColChunk *pChunk = pColBuf->tail;
+
+  while (pChunk != NULL && tdGetKey(((TKEY *)pChunk->cols[0])[0]) > key) {
+    pChunk = pChunk->prev;
+  }
+  if (pChunk == NULL) return false;
+
+  TKEY *  keys = (TKEY *)pChunk->cols[0];
+  int32_t lo = 0;
+  int32_t hi = (int32_t)MIN(pChunk->capacity, pColBuf->numOfRows - pChunk->offset) - 1;
+  while (lo <= hi) {
+    int32_t mid = (lo + hi) / 2;
+    TSKEY   mkey = tdGetKey(keys[mid]);
+    if (mkey == key) {
+      *ppChunk = pChunk;
+      *pRidx = mid;
+      return true;
+    } else if (mkey < key) {
+      lo = mid + 1;
+    } else {
+      hi = mid - 1;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Return the position of the first row with a key not less than key for ascending order, or of the last row with a key
+ * not greater than key for descending order, among the first nRows rows. The position is out of [0, nRows) if there
+ * is no such row.
+ */
+static int64_t tsdbSeekMemColBuf(SMemColBuf *pColBuf, int64_t nRows, TSKEY key, int32_t order, SMemColChunk **ppChunk) {
+  SMemColChunk *pChunk = (SMemColChunk *)atomic_load_ptr(&(pColBuf->head));
+  SMemColChunk *pFound = NULL;
+
+  *ppChunk = NULL;
+  while (pChunk != NULL && pChunk->offset < nRows) {
+    TKEY *  keys = (TKEY *)pChunk->cols[0];
+    int32_t cRows = (int32_t)MIN(pChunk->capacity, nRows - pChunk->offset);
+
+    if (order == TSDB_ORDER_ASC) {
+      if (tdGetKey(keys[cRows - 1]) >= key) {
+        pFound = pChunk;
+        break;
+      }
+    } else {
+      if (tdGetKey(keys[0]) > key) break;
+      pFound = pChunk;
+    }
+
+    pChunk = (SMemColChunk *)atomic_load_ptr(&(pChunk->next));
+  }
+
+  if (pFound == NULL) return (order == TSDB_ORDER_ASC) ? nRows : -1;
+
+  TKEY *  keys = (TKEY *)pFound->cols[0];
+  int32_t lo = 0;
+  int32_t hi = (int32_t)MIN(pFound->capacity, nRows - pFound->offset);
+
+  // First row with a key greater than (desc) or not less than (asc) key
+  while (lo < hi) {
+    int32_t mid = (lo + hi) / 2;
+    TSKEY   mkey = tdGetKey(keys[mid]);
+    if ((order == TSDB_ORDER_ASC) ? (mkey < key) : (mkey <= key)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  *ppChunk = pFound;
+  return pFound->offset + ((order == TSDB_ORDER_ASC) ? lo : lo - 1);
+}
+
+// Materialize an appended row as a data row
+static void tsdbGetMemColRow(SMemColBuf *pColBuf, SMemColChunk *pChunk, int32_t ridx, SMemRow row) {
+  STSchema *pSchema = pColBuf->pSchema;
+
+  memRowSetType(row, SMEM_ROW_DATA);
+  SDataRow dataRow = memRowDataBody(row);
+  tdInitDataRow(dataRow, pSchema);
+  for (int i = 0; i < schemaNCols(pSchema); i++) {
+    STColumn *pCol = schemaColAt(pSchema, i);
+    tdAppendColVal(dataRow, tsdbMemColChunkVal(pChunk, pSchema, i, ridx), colType(pCol), colOffset(pCol));
+  }
+}
+
+static void tsdbMoveMemColPos(STableDataIter *pIter, int32_t nRows) {
+  SMemColChunk *pChunk = pIter->pChunk;
+
+  if (pIter->order == TSDB_ORDER_ASC) {
+    pIter->cpos += nRows;
+    if (pIter->cpos >= pChunk->offset + pChunk->capacity) {
+      ASSERT(pIter->cpos == pChunk->offset + pChunk->capacity);
+      pIter->pChunk = (pIter->cpos < pIter->nRows) ? (SMemColChunk *)atomic_load_ptr(&(pChunk->next)) : NULL;
+    }
+  } else {
+    pIter->cpos -= nRows;
+    if (pIter->cpos < pChunk->offset) {
+      ASSERT(pIter->cpos == pChunk->offset - 1);
+      pIter->pChunk = pChunk->prev;
+    }
+  }
+}
+
+// Choose the next row from the skiplist and the column buffer, the skiplist row wins if both have the key
+static bool tsdbSetTableDataIterCur(STableDataIter *pIter) {
+  SSkipListNode *node = tSkipListIterGet(&(pIter->slIter));
+  bool           hasCol = (pIter->pChunk != NULL) && (pIter->cpos >= 0) && (pIter->cpos < pIter->nRows);
+  TSKEY          slKey = (node == NULL) ? 0 : memRowKey((SMemRow)SL_GET_NODE_DATA(node));
+  TSKEY          colKey = hasCol ? tdGetKey(((TKEY *)pIter->pChunk->cols[0])[pIter->cpos - pIter->pChunk->offset]) : 0;
+
+  if (node != NULL && hasCol) {
+    if (slKey == colKey) {
+      pIter->src = TSDB_MEM_ITER_SRC_SL | TSDB_MEM_ITER_SRC_COL;
+      pIter->key = slKey;
+    } else if ((slKey < colKey) == (pIter->order == TSDB_ORDER_ASC)) {
+      pIter->src = TSDB_MEM_ITER_SRC_SL;
+      pIter->key = slKey;
+    } else {
+      pIter->src = TSDB_MEM_ITER_SRC_COL;
+      pIter->key = colKey;
+    }
+  } else if (node != NULL) {
+    pIter->src = TSDB_MEM_ITER_SRC_SL;
+    pIter->key = slKey;
+  } else if (hasCol) {
+    pIter->src = TSDB_MEM_ITER_SRC_COL;
+    pIter->key = colKey;
+  } else {
+    pIter->src = 0;
+  }
+
+  return pIter->src != 0;
+}
+
+// Key of the current row, INT64_MAX if there is none or it is beyond maxKey
+static TSKEY tsdbGetIterKeyBefore(STableDataIter *pIter, TSKEY maxKey, bool *isRowDel) {
+  *isRowDel = false;
+  if (!pIter->started || pIter->src == 0 || pIter->key > maxKey) return INT64_MAX;
+
+  if (pIter->src & TSDB_MEM_ITER_SRC_SL) {
+    *isRowDel = memRowDeleted(tsdbTableDataIterGet(pIter));
+  }
+
+  return pIter->key;
+}
+
+// Copy a run of the column buffer to pCols, columns not in the appended rows are set to NULL
+static void tsdbAppendColRunToCols(STableDataIter *pIter, int32_t nRun, SDataCols *pCols) {
+  STSchema *    pSchema = pIter->pColBuf->pSchema;
+  SMemColChunk *pChunk = pIter->pChunk;
+  int32_t       ridx = (int32_t)(pIter->cpos - pChunk->offset);
+  int           rcol = 0;
+
+  ASSERT(pIter->order == TSDB_ORDER_ASC);
+  ASSERT(pCols->numOfRows + nRun <= pCols->maxPoints);
+
+  for (int dcol = 0; dcol < pCols->numOfCols; dcol++) {
+    SDataCol *pDataCol = pCols->cols + dcol;
+
+    while (rcol < schemaNCols(pSchema) && colColId(schemaColAt(pSchema, rcol)) < pDataCol->colId) rcol++;
+
+    if (rcol < schemaNCols(pSchema) && colColId(schemaColAt(pSchema, rcol)) == pDataCol->colId) {
+      if (IS_VAR_DATA_TYPE(pDataCol->type)) {
+        for (int32_t i = 0; i < nRun; i++) {
+          dataColAppendVal(pDataCol, ((void **)pChunk->cols[rcol])[ridx + i], pCols->numOfRows + i, pCols->maxPoints,
+                           0);
+        }
+      } else {
+        dataColAppendNVal(pDataCol, POINTER_SHIFT(pChunk->cols[rcol], pDataCol->bytes * ridx), nRun,
+                          pCols->numOfRows, pCols->maxPoints);
+      }
+    } else {
+      const void *nullVal = getNullValue(pDataCol->type);
+      for (int32_t i = 0; i < nRun; i++) {
+        dataColAppendVal(pDataCol, nullVal, pCols->numOfRows + i, pCols->maxPoints, 0);
+      }
+    }
+  }
+
+  pCols->numOfRows += nRun;
+}
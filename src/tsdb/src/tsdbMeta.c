@@ -395,12 +395,16 @@ int tsdbUpdateTableTagValue(STsdbRepo *repo, SUpdateTableTagValMsg *pMsg) {
 
   bool      isChangeIndexCol = (pMsg->colId == colColId(schemaColAt(pTable->pSuper->tagSchema, 0)))
       || pMsg->type == TSDB_DATA_TYPE_JSON;
+  bool      isChangeTagIdx = !isChangeIndexCol && pTable->pSuper->pTagIdx != NULL;
   // STColumn *pCol = bsearch(&(pMsg->colId), pMsg->data, pMsg->numOfTags, sizeof(STColumn), colIdCompar);
   // ASSERT(pCol != NULL);
 
   if (isChangeIndexCol) {
     tsdbWLockRepoMeta(pRepo);
     tsdbRemoveTableFromIndex(pMeta, pTable);
+  } else if (isChangeTagIdx) {
+    tsdbWLockRepoMeta(pRepo);
+    tsdbRemoveTableFromTagIdx(pTable->pSuper, pTable);
   }
   TSDB_WLOCK_TABLE(pTable);
   if (pMsg->type == TSDB_DATA_TYPE_JSON){
@@ -413,6 +417,12 @@ int tsdbUpdateTableTagValue(STsdbRepo *repo, SUpdateTableTagValMsg *pMsg) {
   if (isChangeIndexCol) {
     tsdbAddTableIntoIndex(pMeta, pTable, false);
     tsdbUnlockRepoMeta(pRepo);
+  } else if (isChangeTagIdx) {
+    if (tsdbAddTableIntoTagIdx(pTable->pSuper, pTable) < 0) {
+      tsdbWarn("vgId:%d failed to add table %s into tag inverted index since %s", REPO_ID(pRepo),
+               TABLE_CHAR_NAME(pTable), tstrerror(terrno));
+    }
+    tsdbUnlockRepoMeta(pRepo);
   }
 
   // Update on file
@@ -947,6 +957,7 @@ static void tsdbFreeTable(STable *pTable) {
 
     tSkipListDestroy(pTable->pIndex);
     taosHashCleanup(pTable->jsonKeyMap);
+    tsdbFreeTagIdx(pTable);
     taosTZfree(pTable->lastRow);    
     tfree(pTable->sql);
 
@@ -1155,6 +1166,9 @@ static int tsdbAddTableIntoIndex(STsdbMeta *pMeta, STable *pTable, bool refSuper
     }
   }else{
     tSkipListPut(pSTable->pIndex, (void *)pTable);
+    if (tsdbAddTableIntoTagIdx(pSTable, pTable) < 0) {
+      tsdbWarn("failed to add table %s into tag inverted index since %s", TABLE_CHAR_NAME(pTable), tstrerror(terrno));
+    }
   }
 
   return 0;
@@ -1217,6 +1231,7 @@ static int tsdbRemoveTableFromIndex(STsdbMeta *pMeta, STable *pTable) {
     }
 
     taosArrayDestroy(&res);
+    tsdbRemoveTableFromTagIdx(pSTable, pTable);
   }
   return 0;
 }
@@ -71,7 +71,10 @@ typedef struct SDataBlockLoadInfo {
   SDFileSet*  fileGroup;
   int32_t     slot;
   int32_t     tid;
-  SArray*     pLoadedCols;
+  SArray*     pLoadedCols;  // columns of the block currently held in rhelper.pDCols[0]
+  bool        partial;      // only part of the required columns have been copied into pColumns
+  int32_t     rangeStart;   // rows of the cut block whose non-key columns are left encoded, -1 if none
+  int32_t     rangeEnd;
 } SDataBlockLoadInfo;
 
 typedef struct SLoadCompBlockInfo {
@@ -95,8 +98,8 @@ typedef struct STableCheckInfo {
   int32_t       numOfBlocks:29; // number of qualified data blocks not the original blocks
   uint8_t        chosen:2;       // indicate which iterator should move forward
   bool          initBuf;        // whether to initialize the in-memory skip list iterator or not
-  SSkipListIterator* iter;      // mem buffer skip list iterator
-  SSkipListIterator* iiter;     // imem buffer skip list iterator
+  STableDataIter* iter;         // mem buffer iterator
+  STableDataIter* iiter;        // imem buffer iterator
 } STableCheckInfo;
 
 typedef struct STableBlockInfo {
@@ -138,6 +141,7 @@ typedef struct STsdbQueryHandle {
   bool           checkFiles;       // check file stage
   int8_t         cachelastrow;     // check if last row cached
   bool           loadExternalRow;  // load time window external data rows
+  bool           statisQuery;      // see STsdbQueryCond
   bool           currentLoadExternalRows; // current load external rows
   int32_t        loadType;         // block load type
   uint64_t       qId;              // query info handle, for debug purpose
@@ -146,6 +150,7 @@ typedef struct STsdbQueryHandle {
   SFSIter        fileIter;
   SReadH         rhelper;
   STableBlockInfo* pDataBlockInfo;
+  int32_t        readAheadSlot;    // next slot in pDataBlockInfo to issue read ahead for
   SDataCols     *pDataCols;        // in order to hold current file data block
   int32_t        allocSize;        // allocated data block size
   SMemRef       *pMemRef;
@@ -183,11 +188,13 @@ static void    changeQueryHandleForInterpQuery(TsdbQueryHandleT pHandle);
 static void    doMergeTwoLevelData(STsdbQueryHandle* pQueryHandle, STableCheckInfo* pCheckInfo, SBlock* pBlock);
 static int32_t binarySearchForKey(char* pValue, int num, TSKEY key, int order);
 static int32_t tsdbReadRowsFromCache(STableCheckInfo* pCheckInfo, TSKEY maxKey, int maxRowsToRead, STimeWindow* win, STsdbQueryHandle* pQueryHandle);
+static int32_t copyColRunFromMem(STsdbQueryHandle* pQueryHandle, STableCheckInfo* pCheckInfo, TSKEY maxKey,
+                                 int32_t capacity, int32_t numOfRows, STimeWindow* win);
 static int32_t doGetExternalRow(STsdbQueryHandle* pQueryHandle, int16_t type, SMemRef* pMemRef);
 static void*   doFreeColumnInfoData(SArray* pColumnInfoData);
 static void*   destroyTableCheckInfo(SArray* pTableCheckInfo);
 static bool    tsdbGetExternalRow(TsdbQueryHandleT pHandle);
-static int32_t tsdbQueryTableList(STable* pTable, SArray* pRes, void* filterInfo);
+static int32_t tsdbQueryTableList(STsdbMeta* pMeta, STable* pTable, SArray* pRes, void* filterInfo);
 static STableBlockInfo* moveToNextDataBlockInCurrentFile(STsdbQueryHandle* pQueryHandle);
 static bool initTableMemIterator(STsdbQueryHandle* pHandle, STableCheckInfo* pCheckInfo);
 static SMemRow getSMemRowInTableMem(STableCheckInfo* pCheckInfo, int32_t order, int32_t update, SMemRow* extraRow);
@@ -196,6 +203,13 @@ static void tsdbInitDataBlockLoadInfo(SDataBlockLoadInfo* pBlockLoadInfo) {
   pBlockLoadInfo->slot = -1;
   pBlockLoadInfo->tid = -1;
   pBlockLoadInfo->fileGroup = NULL;
+  pBlockLoadInfo->partial = false;
+  pBlockLoadInfo->rangeStart = -1;
+  pBlockLoadInfo->rangeEnd = -1;
+}
+
+static bool isLoadedColumn(SDataBlockLoadInfo* pBlockLoadInfo, int16_t colId) {
+  return taosArraySearch(pBlockLoadInfo->pLoadedCols, &colId, compareInt16Val, TD_EQ) != NULL;
 }
 
 static void tsdbInitCompBlockLoadInfo(SLoadCompBlockInfo* pCompBlockLoadInfo) {
@@ -231,6 +245,33 @@ static SArray* getDefaultLoadColumns(STsdbQueryHandle* pQueryHandle, bool loadTS
   return pLocalIdList;
 }
 
+// the primary timestamp column and the default load columns that are (included) or are not (!included) in pIdList
+static SArray* getLoadColumns(STsdbQueryHandle* pQueryHandle, SArray* pIdList, bool included) {
+  size_t  numOfCols = taosArrayGetSize(pQueryHandle->defaultLoadColumn);
+  SArray* pLoadList = taosArrayInit(numOfCols, sizeof(int16_t));
+  if (pLoadList == NULL) {
+    return NULL;
+  }
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    int16_t colId = *(int16_t*)taosArrayGet(pQueryHandle->defaultLoadColumn, i);
+
+    bool found = false;
+    for (int32_t j = 0; j < taosArrayGetSize(pIdList); ++j) {
+      if (*(int16_t*)taosArrayGet(pIdList, j) == colId) {
+        found = true;
+        break;
+      }
+    }
+
+    if (colId == PRIMARYKEY_TIMESTAMP_COL_INDEX || found == included) {
+      taosArrayPush(pLoadList, &colId);
+    }
+  }
+
+  return pLoadList;
+}
+
 static void tsdbMayTakeMemSnapshot(STsdbQueryHandle* pQueryHandle, SArray* psTable) {
   assert(pQueryHandle != NULL && pQueryHandle->pMemRef != NULL);
 
@@ -353,8 +394,8 @@ static void resetCheckInfo(STsdbQueryHandle* pQueryHandle) {
   for (int32_t i = 0; i < numOfTables; ++i) {
     STableCheckInfo* pCheckInfo = (STableCheckInfo*) taosArrayGet(pQueryHandle->pTableCheckInfo, i);
     pCheckInfo->lastKey = pQueryHandle->window.skey;
-    pCheckInfo->iter    = tSkipListDestroyIter(pCheckInfo->iter);
-    pCheckInfo->iiter   = tSkipListDestroyIter(pCheckInfo->iiter);
+    pCheckInfo->iter    = tsdbDestroyTableDataIter(pCheckInfo->iter);
+    pCheckInfo->iiter   = tsdbDestroyTableDataIter(pCheckInfo->iiter);
     pCheckInfo->initBuf = false;
 
     if (ASCENDING_TRAVERSE(pQueryHandle->order)) {
@@ -449,6 +490,7 @@ static STsdbQueryHandle* tsdbQueryTablesImpl(STsdbRepo* tsdb, STsdbQueryCond* pC
   pQueryHandle->outputCapacity  = ((STsdbRepo*)tsdb)->config.maxRowsPerFileBlock;
   pQueryHandle->loadExternalRow = pCond->loadExternalRows;
   pQueryHandle->currentLoadExternalRows = pCond->loadExternalRows;
+  pQueryHandle->statisQuery     = pCond->statisQuery;
 
   if (tsdbInitReadH(&pQueryHandle->rhelper, (STsdbRepo*)tsdb) != 0) {
     goto _end;
@@ -561,6 +603,7 @@ void tsdbResetQueryHandle(TsdbQueryHandleT queryHandle, STsdbQueryCond *pCond) {
   pQueryHandle->activeIndex = 0;   // current active table index
   pQueryHandle->locateStart = false;
   pQueryHandle->loadExternalRow = pCond->loadExternalRows;
+  pQueryHandle->statisQuery = pCond->statisQuery;
 
   if (ASCENDING_TRAVERSE(pCond->order)) {
     assert(pQueryHandle->window.skey <= pQueryHandle->window.ekey);
@@ -589,6 +632,7 @@ void tsdbResetQueryHandleForNewTable(TsdbQueryHandleT queryHandle, STsdbQueryCon
   pQueryHandle->activeIndex = 0;   // current active table index
   pQueryHandle->locateStart = false;
   pQueryHandle->loadExternalRow = pCond->loadExternalRows;
+  pQueryHandle->statisQuery = pCond->statisQuery;
 
   if (ASCENDING_TRAVERSE(pCond->order)) {
     assert(pQueryHandle->window.skey <= pQueryHandle->window.ekey);
@@ -792,18 +836,14 @@ static bool initTableMemIterator(STsdbQueryHandle* pHandle, STableCheckInfo* pCh
   if (pMemT && pCheckInfo->tableId.tid < pMemT->maxTables) {
     pMem = pMemT->tData[pCheckInfo->tableId.tid];
     if (pMem != NULL && pMem->uid == pCheckInfo->tableId.uid) { // check uid
-      TKEY tLastKey = keyToTkey(pCheckInfo->lastKey);
-      pCheckInfo->iter =
-          tSkipListCreateIterFromVal(pMem->pData, (const char*)&tLastKey, TSDB_DATA_TYPE_TIMESTAMP, order);
+      pCheckInfo->iter = tsdbCreateTableDataIter(pMem, &pCheckInfo->lastKey, order);
     }
   }
 
   if (pIMemT && pCheckInfo->tableId.tid < pIMemT->maxTables) {
     pIMem = pIMemT->tData[pCheckInfo->tableId.tid];
     if (pIMem != NULL && pIMem->uid == pCheckInfo->tableId.uid) { // check uid
-      TKEY tLastKey = keyToTkey(pCheckInfo->lastKey);
-      pCheckInfo->iiter =
-          tSkipListCreateIterFromVal(pIMem->pData, (const char*)&tLastKey, TSDB_DATA_TYPE_TIMESTAMP, order);
+      pCheckInfo->iiter = tsdbCreateTableDataIter(pIMem, &pCheckInfo->lastKey, order);
     }
   }
 
@@ -812,18 +852,14 @@ static bool initTableMemIterator(STsdbQueryHandle* pHandle, STableCheckInfo* pCh
     return false;
   }
 
-  bool memEmpty  = (pCheckInfo->iter == NULL) || (pCheckInfo->iter != NULL && !tSkipListIterNext(pCheckInfo->iter));
-  bool imemEmpty = (pCheckInfo->iiter == NULL) || (pCheckInfo->iiter != NULL && !tSkipListIterNext(pCheckInfo->iiter));
+  bool memEmpty  = (pCheckInfo->iter == NULL) || (pCheckInfo->iter != NULL && !tsdbTableDataIterNext(pCheckInfo->iter));
+  bool imemEmpty = (pCheckInfo->iiter == NULL) || (pCheckInfo->iiter != NULL && !tsdbTableDataIterNext(pCheckInfo->iiter));
   if (memEmpty && imemEmpty) { // buffer is empty
     return false;
   }
 
   if (!memEmpty) {
-    SSkipListNode* node = tSkipListIterGet(pCheckInfo->iter);
-    assert(node != NULL);
-
-    SMemRow row = (SMemRow)SL_GET_NODE_DATA(node);
-    TSKEY   key = memRowKey(row);  // first timestamp in buffer
+    TSKEY key = tsdbNextIterKey(pCheckInfo->iter);  // first timestamp in buffer
     tsdbDebug("%p uid:%" PRId64 ", tid:%d check data in mem from skey:%" PRId64 ", order:%d, ts range in buf:%" PRId64
               "-%" PRId64 ", lastKey:%" PRId64 ", numOfRows:%"PRId64", 0x%"PRIx64,
               pHandle, pCheckInfo->tableId.uid, pCheckInfo->tableId.tid, key, order, pMem->keyFirst, pMem->keyLast,
@@ -841,11 +877,7 @@ static bool initTableMemIterator(STsdbQueryHandle* pHandle, STableCheckInfo* pCh
   }
 
   if (!imemEmpty) {
-    SSkipListNode* node = tSkipListIterGet(pCheckInfo->iiter);
-    assert(node != NULL);
-
-    SMemRow row = (SMemRow)SL_GET_NODE_DATA(node);
-    TSKEY   key = memRowKey(row);  // first timestamp in buffer
+    TSKEY key = tsdbNextIterKey(pCheckInfo->iiter);  // first timestamp in buffer
     tsdbDebug("%p uid:%" PRId64 ", tid:%d check data in imem from skey:%" PRId64 ", order:%d, ts range in buf:%" PRId64
               "-%" PRId64 ", lastKey:%" PRId64 ", numOfRows:%"PRId64", 0x%"PRIx64,
               pHandle, pCheckInfo->tableId.uid, pCheckInfo->tableId.tid, key, order, pIMem->keyFirst, pIMem->keyLast,
@@ -865,52 +897,40 @@ static bool initTableMemIterator(STsdbQueryHandle* pHandle, STableCheckInfo* pCh
 }
 
 static void destroyTableMemIterator(STableCheckInfo* pCheckInfo) {
-  tSkipListDestroyIter(pCheckInfo->iter);
-  tSkipListDestroyIter(pCheckInfo->iiter);
+  tsdbDestroyTableDataIter(pCheckInfo->iter);
+  tsdbDestroyTableDataIter(pCheckInfo->iiter);
 }
 
 static TSKEY extractFirstTraverseKey(STableCheckInfo* pCheckInfo, int32_t order, int32_t update) {
-  SMemRow rmem = NULL, rimem = NULL;
-  if (pCheckInfo->iter) {
-    SSkipListNode* node = tSkipListIterGet(pCheckInfo->iter);
-    if (node != NULL) {
-      rmem = (SMemRow)SL_GET_NODE_DATA(node);
-    }
-  }
-
-  if (pCheckInfo->iiter) {
-    SSkipListNode* node = tSkipListIterGet(pCheckInfo->iiter);
-    if (node != NULL) {
-      rimem = (SMemRow)SL_GET_NODE_DATA(node);
-    }
-  }
+  bool hasMem = tsdbTableDataIterHasRow(pCheckInfo->iter);
+  bool hasIMem = tsdbTableDataIterHasRow(pCheckInfo->iiter);
 
-  if (rmem == NULL && rimem == NULL) {
+  if (!hasMem && !hasIMem) {
     return TSKEY_INITIAL_VAL;
   }
 
-  if (rmem != NULL && rimem == NULL) {
+  if (hasMem && !hasIMem) {
     pCheckInfo->chosen = CHECKINFO_CHOSEN_MEM;
-    return memRowKey(rmem);
+    return tsdbNextIterKey(pCheckInfo->iter);
   }
 
-  if (rmem == NULL && rimem != NULL) {
+  if (!hasMem && hasIMem) {
     pCheckInfo->chosen = CHECKINFO_CHOSEN_IMEM;
-    return memRowKey(rimem);
+    return tsdbNextIterKey(pCheckInfo->iiter);
   }
 
-  TSKEY r1 = memRowKey(rmem);
-  TSKEY r2 = memRowKey(rimem);
+  TSKEY r1 = tsdbNextIterKey(pCheckInfo->iter);
+  TSKEY r2 = tsdbNextIterKey(pCheckInfo->iiter);
 
   if (r1 == r2) {
     if(update == TD_ROW_DISCARD_UPDATE){
       pCheckInfo->chosen = CHECKINFO_CHOSEN_IMEM;
-      tSkipListIterNext(pCheckInfo->iter);
+      tsdbTableDataIterNext(pCheckInfo->iter);
       return r2;
     }
     else if(update == TD_ROW_OVERWRITE_UPDATE) {
       pCheckInfo->chosen = CHECKINFO_CHOSEN_MEM;
-      tSkipListIterNext(pCheckInfo->iiter);
+      tsdbTableDataIterNext(pCheckInfo->iiter);
       return r1;
     } else {
       pCheckInfo->chosen = CHECKINFO_CHOSEN_BOTH;
@@ -938,20 +958,8 @@ static TSKEY extractFirstTraverseKey(STableCheckInfo* pCheckInfo, int32_t order,
 }
 
 static SMemRow getSMemRowInTableMem(STableCheckInfo* pCheckInfo, int32_t order, int32_t update, SMemRow* extraRow) {
-  SMemRow rmem = NULL, rimem = NULL;
-  if (pCheckInfo->iter) {
-    SSkipListNode* node = tSkipListIterGet(pCheckInfo->iter);
-    if (node != NULL) {
-      rmem = (SMemRow)SL_GET_NODE_DATA(node);
-    }
-  }
-
-  if (pCheckInfo->iiter) {
-    SSkipListNode* node = tSkipListIterGet(pCheckInfo->iiter);
-    if (node != NULL) {
-      rimem = (SMemRow)SL_GET_NODE_DATA(node);
-    }
-  }
+  SMemRow rmem = tsdbNextIterRow(pCheckInfo->iter);
+  SMemRow rimem = tsdbNextIterRow(pCheckInfo->iiter);
 
   if (rmem == NULL && rimem == NULL) {
     return NULL;
@@ -972,11 +980,11 @@ static SMemRow getSMemRowInTableMem(STableCheckInfo* pCheckInfo, int32_t order,
 
   if (r1 == r2) {
     if (update == TD_ROW_DISCARD_UPDATE) {
-      tSkipListIterNext(pCheckInfo->iter);
+      tsdbTableDataIterNext(pCheckInfo->iter);
       pCheckInfo->chosen = CHECKINFO_CHOSEN_IMEM;
       return rimem;
     } else if(update == TD_ROW_OVERWRITE_UPDATE){
-      tSkipListIterNext(pCheckInfo->iiter);
+      tsdbTableDataIterNext(pCheckInfo->iiter);
       pCheckInfo->chosen = CHECKINFO_CHOSEN_MEM;
       return rmem;
     } else {
@@ -1009,7 +1017,7 @@ static bool moveToNextRowInMem(STableCheckInfo* pCheckInfo) {
   bool hasNext = false;
   if (pCheckInfo->chosen == CHECKINFO_CHOSEN_MEM) {
     if (pCheckInfo->iter != NULL) {
-      hasNext = tSkipListIterNext(pCheckInfo->iter);
+      hasNext = tsdbTableDataIterNext(pCheckInfo->iter);
     }
 
     if (hasNext) {
@@ -1017,11 +1025,11 @@ static bool moveToNextRowInMem(STableCheckInfo* pCheckInfo) {
     }
 
     if (pCheckInfo->iiter != NULL) {
-      return tSkipListIterGet(pCheckInfo->iiter) != NULL;
+      return tsdbTableDataIterHasRow(pCheckInfo->iiter);
     }
   } else if (pCheckInfo->chosen == CHECKINFO_CHOSEN_IMEM){
     if (pCheckInfo->iiter != NULL) {
-      hasNext = tSkipListIterNext(pCheckInfo->iiter);
+      hasNext = tsdbTableDataIterNext(pCheckInfo->iiter);
     }
 
     if (hasNext) {
@@ -1029,14 +1037,14 @@ static bool moveToNextRowInMem(STableCheckInfo* pCheckInfo) {
     }
 
     if (pCheckInfo->iter != NULL) {
-      return tSkipListIterGet(pCheckInfo->iter) != NULL;
+      return tsdbTableDataIterHasRow(pCheckInfo->iter);
     }
   } else {
     if (pCheckInfo->iter != NULL) {
-      hasNext = tSkipListIterNext(pCheckInfo->iter);
+      hasNext = tsdbTableDataIterNext(pCheckInfo->iter);
     }
     if (pCheckInfo->iiter != NULL) {
-      hasNext = tSkipListIterNext(pCheckInfo->iiter) || hasNext;
+      hasNext = tsdbTableDataIterNext(pCheckInfo->iiter) || hasNext;
     }
   }
 
@@ -1473,7 +1481,8 @@ static int32_t getFileCompInfo(STsdbQueryHandle* pQueryHandle, int32_t* numOfBlo
   return code;
 }
 
-static int32_t doLoadFileDataBlock(STsdbQueryHandle* pQueryHandle, SBlock* pBlock, STableCheckInfo* pCheckInfo, int32_t slotIndex) {
+static int32_t doLoadFileDataBlockCols(STsdbQueryHandle* pQueryHandle, SBlock* pBlock, STableCheckInfo* pCheckInfo,
+                                       int32_t slotIndex, SArray* pColIdList) {
   int64_t st = taosGetTimestampUs();
 
   STSchema *pSchema = tsdbGetTableSchema(pCheckInfo->pTableObj);
@@ -1498,20 +1507,33 @@ static int32_t doLoadFileDataBlock(STsdbQueryHandle* pQueryHandle, SBlock* pBloc
     goto _error;
   }
 
-  int16_t* colIds = pQueryHandle->defaultLoadColumn->pData;
+  SDataBlockLoadInfo* pBlockLoadInfo = &pQueryHandle->dataBlockLoadInfo;
+  if (pBlockLoadInfo->pLoadedCols == NULL) {
+    pBlockLoadInfo->pLoadedCols = taosArrayInit(QH_GET_NUM_OF_COLS(pQueryHandle), sizeof(int16_t));
+    if (pBlockLoadInfo->pLoadedCols == NULL) {
+      terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+      goto _error;
+    }
+  }
+
+  int16_t* colIds = pColIdList->pData;
 
-  int32_t ret = tsdbLoadBlockDataCols(&(pQueryHandle->rhelper), pBlock, pCheckInfo->pCompInfo, colIds, (int)(QH_GET_NUM_OF_COLS(pQueryHandle)));
+  int32_t ret = tsdbLoadBlockDataCols(&(pQueryHandle->rhelper), pBlock, pCheckInfo->pCompInfo, colIds, (int)taosArrayGetSize(pColIdList));
   if (ret != TSDB_CODE_SUCCESS) {
     int32_t c = terrno;
     assert(c != TSDB_CODE_SUCCESS);
     goto _error;
   }
 
-  SDataBlockLoadInfo* pBlockLoadInfo = &pQueryHandle->dataBlockLoadInfo;
-
   pBlockLoadInfo->fileGroup = pQueryHandle->pFileGroup;
   pBlockLoadInfo->slot = pQueryHandle->cur.slot;
   pBlockLoadInfo->tid = pCheckInfo->pTableObj->tableId.tid;
+  pBlockLoadInfo->partial = false;
+  pBlockLoadInfo->rangeStart = -1;
+  pBlockLoadInfo->rangeEnd = -1;
+
+  taosArrayClear(pBlockLoadInfo->pLoadedCols);
+  taosArrayAddAll(pBlockLoadInfo->pLoadedCols, pColIdList);
 
   SDataCols* pCols = pQueryHandle->rhelper.pDCols[0];
   assert(pCols->numOfRows != 0 && pCols->numOfRows <= pBlock->numOfRows);
@@ -1541,6 +1563,10 @@ _error:
   return terrno;
 }
 
+static int32_t doLoadFileDataBlock(STsdbQueryHandle* pQueryHandle, SBlock* pBlock, STableCheckInfo* pCheckInfo, int32_t slotIndex) {
+  return doLoadFileDataBlockCols(pQueryHandle, pBlock, pCheckInfo, slotIndex, pQueryHandle->defaultLoadColumn);
+}
+
 static int32_t getEndPosInDataBlock(STsdbQueryHandle* pQueryHandle, SDataBlockInfo* pBlockInfo);
 static int32_t doCopyRowsFromFileBlock(STsdbQueryHandle* pQueryHandle, int32_t capacity, int32_t numOfRows, int32_t start, int32_t end);
 static void moveDataToFront(STsdbQueryHandle* pQueryHandle, int32_t numOfRows, int32_t numOfCols);
@@ -1641,6 +1667,75 @@ static int32_t handleDataMergeIfNeeded(STsdbQueryHandle* pQueryHandle, SBlock* p
   return code;
 }
 
+// A block cut by the query window and not overlapping rows in memory is counted and aggregated on its encoded columns,
+// only its keys are loaded here and the other columns when its rows are retrieved. Queries that need the rows, like
+// projections and filters, would load the columns twice, so they take the whole block.
+static bool isKeyOnlyCutBlock(STsdbQueryHandle* pQueryHandle, SBlock* pBlock, STableCheckInfo* pCheckInfo) {
+  if (!tsdbEncodedAggr || !pQueryHandle->statisQuery || pBlock->numOfSubBlocks > 1 ||
+      taosArrayGetSize(pQueryHandle->defaultLoadColumn) <= 1) {
+    return false;
+  }
+
+  initTableMemIterator(pQueryHandle, pCheckInfo);
+
+  SDataBlockInfo  binfo = GET_FILE_DATA_BLOCK_INFO(pCheckInfo, pBlock);
+  STableDataIter* iters[] = {pCheckInfo->iter, pCheckInfo->iiter};
+  for (int32_t i = 0; i < tListLen(iters); ++i) {
+    if (!tsdbTableDataIterHasRow(iters[i])) {
+      continue;
+    }
+
+    TSKEY key = tsdbNextIterKey(iters[i]);
+    if ((ASCENDING_TRAVERSE(pQueryHandle->order) && key <= binfo.window.ekey) ||
+        (!ASCENDING_TRAVERSE(pQueryHandle->order) && key >= binfo.window.skey)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static int32_t loadKeyOnlyCutBlock(STsdbQueryHandle* pQueryHandle, SBlock* pBlock, STableCheckInfo* pCheckInfo) {
+  SQueryFilePos* cur = &pQueryHandle->cur;
+  SDataBlockInfo binfo = GET_FILE_DATA_BLOCK_INFO(pCheckInfo, pBlock);
+  int16_t        colId = PRIMARYKEY_TIMESTAMP_COL_INDEX;
+
+  SArray* pKeyList = taosArrayInit(1, sizeof(int16_t));
+  if (pKeyList == NULL) {
+    return TSDB_CODE_TDB_OUT_OF_MEMORY;
+  }
+
+  taosArrayPush(pKeyList, &colId);
+  int32_t code = doLoadFileDataBlockCols(pQueryHandle, pBlock, pCheckInfo, cur->slot, pKeyList);
+  taosArrayDestroy(&pKeyList);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  char* keyFile = pQueryHandle->rhelper.pDCols[0]->cols[0].pData;
+  if (ASCENDING_TRAVERSE(pQueryHandle->order)) {
+    cur->pos = (pCheckInfo->lastKey > pBlock->keyFirst)
+                   ? binarySearchForKey(keyFile, pBlock->numOfRows, pCheckInfo->lastKey, pQueryHandle->order)
+                   : 0;
+  } else {
+    cur->pos = (pCheckInfo->lastKey < pBlock->keyLast)
+                   ? binarySearchForKey(keyFile, pBlock->numOfRows, pCheckInfo->lastKey, pQueryHandle->order)
+                   : pBlock->numOfRows - 1;
+  }
+
+  SDataBlockLoadInfo* pBlockLoadInfo = &pQueryHandle->dataBlockLoadInfo;
+  int32_t             endPos = getEndPosInDataBlock(pQueryHandle, &binfo);
+  int32_t             start = MIN(cur->pos, endPos);
+  int32_t             end = MAX(cur->pos, endPos);
+
+  copyAllRemainRowsFromFileBlock(pQueryHandle, pCheckInfo, &binfo, endPos);
+
+  pBlockLoadInfo->partial = true;
+  pBlockLoadInfo->rangeStart = start;
+  pBlockLoadInfo->rangeEnd = end;
+  return TSDB_CODE_SUCCESS;
+}
+
 static int32_t loadFileDataBlock(STsdbQueryHandle* pQueryHandle, SBlock* pBlock, STableCheckInfo* pCheckInfo, bool* exists) {
   SQueryFilePos* cur = &pQueryHandle->cur;
   int32_t code = TSDB_CODE_SUCCESS;
@@ -1649,6 +1744,12 @@ static int32_t loadFileDataBlock(STsdbQueryHandle* pQueryHandle, SBlock* pBlock,
   if (asc) {
     // query ended in/started from current block
     if (pQueryHandle->window.ekey < pBlock->keyLast || pCheckInfo->lastKey > pBlock->keyFirst) {
+      if (isKeyOnlyCutBlock(pQueryHandle, pBlock, pCheckInfo)) {
+        code = loadKeyOnlyCutBlock(pQueryHandle, pBlock, pCheckInfo);
+        *exists = (code == TSDB_CODE_SUCCESS && pQueryHandle->realNumOfRows > 0);
+        return code;
+      }
+
       if ((code = doLoadFileDataBlock(pQueryHandle, pBlock, pCheckInfo, cur->slot)) != TSDB_CODE_SUCCESS) {
         *exists = false;
         return code;
@@ -1672,6 +1773,12 @@ static int32_t loadFileDataBlock(STsdbQueryHandle* pQueryHandle, SBlock* pBlock,
     }
   } else {  //desc order, query ended in current block
     if (pQueryHandle->window.ekey > pBlock->keyFirst || pCheckInfo->lastKey < pBlock->keyLast) {
+      if (isKeyOnlyCutBlock(pQueryHandle, pBlock, pCheckInfo)) {
+        code = loadKeyOnlyCutBlock(pQueryHandle, pBlock, pCheckInfo);
+        *exists = (code == TSDB_CODE_SUCCESS && pQueryHandle->realNumOfRows > 0);
+        return code;
+      }
+
       if ((code = doLoadFileDataBlock(pQueryHandle, pBlock, pCheckInfo, cur->slot)) != TSDB_CODE_SUCCESS) {
         *exists = false;
         return code;
@@ -1770,12 +1877,19 @@ static int32_t doCopyRowsFromFileBlock(STsdbQueryHandle* pQueryHandle, int32_t c
   }
 
   int32_t requiredNumOfCols = (int32_t)taosArrayGetSize(pQueryHandle->pColumns);
+  SDataBlockLoadInfo* pBlockLoadInfo = &pQueryHandle->dataBlockLoadInfo;
 
   //data in buffer has greater timestamp, copy data in file block
   int32_t i = 0, j = 0;
   while(i < requiredNumOfCols && j < pCols->numOfCols) {
     SColumnInfoData* pColInfo = taosArrayGet(pQueryHandle->pColumns, i);
 
+    // not loaded from the file block this time, keep the content of the column
+    if (!isLoadedColumn(pBlockLoadInfo, pColInfo->info.colId)) {
+      i++;
+      continue;
+    }
+
     SDataCol* src = &pCols->cols[j];
     if (src->colId < pColInfo->info.colId) {
       j++;
@@ -1823,6 +1937,11 @@ static int32_t doCopyRowsFromFileBlock(STsdbQueryHandle* pQueryHandle, int32_t c
 
   while (i < requiredNumOfCols) { // the remain columns are all null data
     SColumnInfoData* pColInfo = taosArrayGet(pQueryHandle->pColumns, i);
+    if (!isLoadedColumn(pBlockLoadInfo, pColInfo->info.colId)) {
+      i++;
+      continue;
+    }
+
     if (ASCENDING_TRAVERSE(pQueryHandle->order)) {
       pData = (char*)pColInfo->pData + numOfRows * pColInfo->info.bytes;
     } else {
@@ -2609,6 +2728,53 @@ static int32_t createDataBlocksInfo(STsdbQueryHandle* pQueryHandle, int32_t numO
   return TSDB_CODE_SUCCESS;
 }
 
+static void readAheadBlock(STsdbQueryHandle* pQueryHandle, SBlock* pBlock) {
+  SDFile* pDFile = (pBlock->last) ? TSDB_READ_LAST_FILE(&pQueryHandle->rhelper) : TSDB_READ_DATA_FILE(&pQueryHandle->rhelper);
+  if (!TSDB_FILE_OPENED(pDFile)) {
+    return;
+  }
+
+  if (taosReadAhead(TSDB_FILE_FD(pDFile), pBlock->offset, pBlock->len) < 0) {
+    tsdbDebug("%p failed to read ahead block at offset %" PRId64 " of file %s since %s, 0x%" PRIx64, pQueryHandle,
+              (int64_t)pBlock->offset, TSDB_FILE_FULL_NAME(pDFile), strerror(errno), pQueryHandle->qId);
+  }
+}
+
+/*
+ * Ask the kernel to fetch the next blocks, in the order they will be loaded, into the page cache while the current
+ * one is being processed. A long range scan on a slow disk then waits for at most one block at a time.
+ */
+static void readAheadDataBlocks(STsdbQueryHandle* pQueryHandle) {
+  if (tsdbBlkReadAhead <= 0) {
+    return;
+  }
+
+  int32_t step = ASCENDING_TRAVERSE(pQueryHandle->order)? 1 : -1;
+  int32_t end = pQueryHandle->cur.slot + step * (tsdbBlkReadAhead + 1);
+
+  // blocks skipped by the caller never need to be read ahead
+  if ((pQueryHandle->readAheadSlot - pQueryHandle->cur.slot) * step <= 0) {
+    pQueryHandle->readAheadSlot = pQueryHandle->cur.slot + step;
+  }
+
+  while (pQueryHandle->readAheadSlot >= 0 && pQueryHandle->readAheadSlot < pQueryHandle->numOfBlocks &&
+         pQueryHandle->readAheadSlot != end) {
+    STableBlockInfo* pBlockInfo = &pQueryHandle->pDataBlockInfo[pQueryHandle->readAheadSlot];
+    SBlock*          pBlock = pBlockInfo->compBlock;
+
+    if (pBlock->numOfSubBlocks > 1) {
+      SBlock* pSubBlocks = POINTER_SHIFT(pBlockInfo->pTableCheckInfo->pCompInfo, pBlock->offset);
+      for (int32_t i = 0; i < pBlock->numOfSubBlocks; ++i) {
+        readAheadBlock(pQueryHandle, &pSubBlocks[i]);
+      }
+    } else {
+      readAheadBlock(pQueryHandle, pBlock);
+    }
+
+    pQueryHandle->readAheadSlot += step;
+  }
+}
+
 static int32_t getFirstFileDataBlock(STsdbQueryHandle* pQueryHandle, bool* exists);
 
 static int32_t getDataBlockRv(STsdbQueryHandle* pQueryHandle, STableBlockInfo* pNext, bool *exists) {
@@ -2726,6 +2892,9 @@ static int32_t getFirstFileDataBlock(STsdbQueryHandle* pQueryHandle, bool* exist
   cur->slot = ASCENDING_TRAVERSE(pQueryHandle->order)? 0:pQueryHandle->numOfBlocks-1;
   cur->fid = pQueryHandle->pFileGroup->fid;
 
+  pQueryHandle->readAheadSlot = cur->slot + (ASCENDING_TRAVERSE(pQueryHandle->order)? 1:-1);
+  readAheadDataBlocks(pQueryHandle);
+
   STableBlockInfo* pBlockInfo = &pQueryHandle->pDataBlockInfo[cur->slot];
   return getDataBlockRv(pQueryHandle, pBlockInfo, exists);
 }
@@ -2743,6 +2912,8 @@ static STableBlockInfo* moveToNextDataBlockInCurrentFile(STsdbQueryHandle* pQuer
   cur->mixBlock       = false;
   cur->blockCompleted = false;
 
+  readAheadDataBlocks(pQueryHandle);
+
   // no callback check
   STableBlockInfo* pBlockInfo = &pQueryHandle->pDataBlockInfo[cur->slot];
   if(pQueryHandle->readover_cb == NULL) {
@@ -2971,6 +3142,83 @@ static UNUSED_FUNC void changeQueryHandleForInterpQuery(TsdbQueryHandleT pHandle
   taosArrayPush(pQueryHandle->pTableCheckInfo, &info);
 }
 
+/**
+ * Copy the rows of a column buffer chunk column by column, as long as no row of the skiplists or of the other memtable
+ * comes between them. The iterator is left at the last row copied and chosen for moveToNextRowInMem. Return 0 if the
+ * next rows have to be merged row by row.
+ */
+static int32_t copyColRunFromMem(STsdbQueryHandle* pQueryHandle, STableCheckInfo* pCheckInfo, TSKEY maxKey,
+                                 int32_t capacity, int32_t numOfRows, STimeWindow* win) {
+  bool            asc = ASCENDING_TRAVERSE(pQueryHandle->order);
+  bool            hasMem = tsdbTableDataIterHasRow(pCheckInfo->iter);
+  bool            hasIMem = tsdbTableDataIterHasRow(pCheckInfo->iiter);
+  STableDataIter* pIter = NULL;
+  STableDataIter* pOther = NULL;
+
+  if (hasMem && hasIMem) {
+    TSKEY r1 = tsdbNextIterKey(pCheckInfo->iter);
+    TSKEY r2 = tsdbNextIterKey(pCheckInfo->iiter);
+    if (r1 == r2) return 0;
+
+    bool memFirst = ((r1 < r2) == asc);
+    pCheckInfo->chosen = memFirst ? CHECKINFO_CHOSEN_MEM : CHECKINFO_CHOSEN_IMEM;
+    pIter = memFirst ? pCheckInfo->iter : pCheckInfo->iiter;
+    pOther = memFirst ? pCheckInfo->iiter : pCheckInfo->iter;
+  } else if (hasMem || hasIMem) {
+    pCheckInfo->chosen = hasMem ? CHECKINFO_CHOSEN_MEM : CHECKINFO_CHOSEN_IMEM;
+    pIter = hasMem ? pCheckInfo->iter : pCheckInfo->iiter;
+  } else {
+    return 0;
+  }
+
+  // rows after maxKey in the traverse order are out of the query range
+  TSKEY boundKey = asc ? ((maxKey == INT64_MAX) ? INT64_MAX : maxKey + 1) : ((maxKey == INT64_MIN) ? INT64_MIN : maxKey - 1);
+  if (pOther != NULL) {
+    TSKEY otherKey = tsdbNextIterKey(pOther);
+    boundKey = asc ? MIN(boundKey, otherKey) : MAX(boundKey, otherKey);
+  }
+
+  int32_t nRun = tsdbTableDataIterColRun(pIter, boundKey, capacity - numOfRows);
+  if (nRun < 2) return 0;
+
+  SMemColChunk* pChunk = pIter->pChunk;
+  STSchema*     pSchema = pIter->pColBuf->pSchema;
+  int32_t       ridx = (int32_t)(pIter->cpos - pChunk->offset);
+
+  // rows in the chunk and in the result are in the same order, only the start positions depend on the traverse order
+  int32_t sstart = asc ? ridx : ridx - nRun + 1;
+  int32_t dstart = asc ? numOfRows : capacity - numOfRows - nRun;
+
+  int32_t numOfCols = (int32_t)taosArrayGetSize(pQueryHandle->pColumns);
+  int32_t j = 0;
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pColInfo = taosArrayGet(pQueryHandle->pColumns, i);
+    char*            pData = (char*)pColInfo->pData + dstart * pColInfo->info.bytes;
+
+    while (j < schemaNCols(pSchema) && schemaColAt(pSchema, j)->colId < pColInfo->info.colId) j++;
+
+    if (j >= schemaNCols(pSchema) || schemaColAt(pSchema, j)->colId != pColInfo->info.colId) {
+      setNullN(pData, pColInfo->info.type, pColInfo->info.bytes, nRun);
+    } else if (IS_VAR_DATA_TYPE(pColInfo->info.type)) {
+      for (int32_t k = 0; k < nRun; ++k) {
+        void* value = ((void**)pChunk->cols[j])[sstart + k];
+        memcpy(pData + k * pColInfo->info.bytes, value, varDataTLen(value));
+      }
+    } else {
+      memcpy(pData, POINTER_SHIFT(pChunk->cols[j], sstart * pColInfo->info.bytes), nRun * pColInfo->info.bytes);
+    }
+  }
+
+  if (win->skey == TSKEY_INITIAL_VAL) {
+    win->skey = pIter->key;
+  }
+
+  tsdbTableDataIterSkip(pIter, nRun - 1);
+  win->ekey = pIter->key;
+
+  return nRun;
+}
+
 static int tsdbReadRowsFromCache(STableCheckInfo* pCheckInfo, TSKEY maxKey, int maxRowsToRead, STimeWindow* win,
                                  STsdbQueryHandle* pQueryHandle) {
   int     numOfRows = 0;
@@ -2984,6 +3232,16 @@ static int tsdbReadRowsFromCache(STableCheckInfo* pCheckInfo, TSKEY maxKey, int
   STSchema* pSchema = NULL;
 
   do {
+    int32_t nRun = copyColRunFromMem(pQueryHandle, pCheckInfo, maxKey, maxRowsToRead, numOfRows, win);
+    if (nRun > 0) {
+      numOfRows += nRun;
+      if (numOfRows >= maxRowsToRead) {
+        moveToNextRowInMem(pCheckInfo);
+        break;
+      }
+      continue;
+    }
+
     SMemRow row = getSMemRowInTableMem(pCheckInfo, pQueryHandle->order, pCfg->update, NULL);
     if (row == NULL) {
       break;
@@ -3732,11 +3990,62 @@ void tsdbRetrieveDataBlockInfo(TsdbQueryHandleT* pQueryHandle, SDataBlockInfo* p
 /*
  * return null for mixed data block, if not a complete file data block, the statistics value will always return NULL
  */
+// The rows of the current block are a range of a cut file block whose non-key columns are not loaded yet
+static bool isEncodedRangeBlock(STsdbQueryHandle* pHandle) {
+  SDataBlockLoadInfo* pBlockLoadInfo = &pHandle->dataBlockLoadInfo;
+  if (pHandle->cur.fid == INT32_MIN || !pHandle->cur.mixBlock || pBlockLoadInfo->rangeStart < 0) {
+    return false;
+  }
+
+  STableBlockInfo* pBlockInfo = &pHandle->pDataBlockInfo[pHandle->cur.slot];
+  return pBlockLoadInfo->slot == pHandle->cur.slot && pBlockLoadInfo->fileGroup->fid == pHandle->cur.fid &&
+         pBlockLoadInfo->tid == pBlockInfo->pTableCheckInfo->pTableObj->tableId.tid;
+}
+
+static int32_t retrieveEncodedRangeStatis(STsdbQueryHandle* pHandle, SDataStatis** pBlockStatis) {
+  SDataBlockLoadInfo* pBlockLoadInfo = &pHandle->dataBlockLoadInfo;
+  STableBlockInfo*    pBlockInfo = &pHandle->pDataBlockInfo[pHandle->cur.slot];
+  int16_t*            colIds = pHandle->defaultLoadColumn->pData;
+  size_t              numOfCols = QH_GET_NUM_OF_COLS(pHandle);
+  int64_t             stime = taosGetTimestampUs();
+
+  memset(pHandle->statis, 0, numOfCols * sizeof(SDataStatis));
+  for(int32_t i = 0; i < numOfCols; ++i) {
+    pHandle->statis[i].colId = colIds[i];
+  }
+
+  int statisStatus = tsdbLoadBlockStatisRange(&pHandle->rhelper, pBlockInfo->compBlock, &pHandle->statis[1],
+                                              (int)numOfCols - 1, pBlockLoadInfo->rangeStart, pBlockLoadInfo->rangeEnd);
+  if (statisStatus < TSDB_STATIS_OK) {
+    return terrno;
+  } else if (statisStatus > TSDB_STATIS_OK) {
+    *pBlockStatis = NULL;
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SDataStatis* pPrimaryColStatis = &pHandle->statis[0];
+  assert(pPrimaryColStatis->colId == PRIMARYKEY_TIMESTAMP_COL_INDEX);
+
+  pPrimaryColStatis->numOfNull = 0;
+  pPrimaryColStatis->min = pHandle->cur.win.skey;
+  pPrimaryColStatis->max = pHandle->cur.win.ekey;
+
+  int64_t elapsed = taosGetTimestampUs() - stime;
+  pHandle->cost.statisInfoLoadTime += elapsed;
+
+  *pBlockStatis = pHandle->statis;
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t tsdbRetrieveDataBlockStatisInfo(TsdbQueryHandleT* pQueryHandle, SDataStatis** pBlockStatis) {
   STsdbQueryHandle* pHandle = (STsdbQueryHandle*) pQueryHandle;
 
   SQueryFilePos* c = &pHandle->cur;
   if (c->mixBlock) {
+    if (isEncodedRangeBlock(pHandle)) {
+      return retrieveEncodedRangeStatis(pHandle, pBlockStatis);
+    }
+
     *pBlockStatis = NULL;
     return TSDB_CODE_SUCCESS;
   }
@@ -3791,6 +4100,50 @@ int32_t tsdbRetrieveDataBlockStatisInfo(TsdbQueryHandleT* pQueryHandle, SDataSta
   return TSDB_CODE_SUCCESS;
 }
 
+// if the buffer is not full in case of descending order query, move the data in the front of the buffer
+static void moveLoadedDataToFront(STsdbQueryHandle* pHandle, int32_t numOfRows) {
+  if (ASCENDING_TRAVERSE(pHandle->order) || numOfRows >= pHandle->outputCapacity) {
+    return;
+  }
+
+  int32_t emptySize = pHandle->outputCapacity - numOfRows;
+  int32_t reqNumOfCols = (int32_t)taosArrayGetSize(pHandle->pColumns);
+
+  for(int32_t i = 0; i < reqNumOfCols; ++i) {
+    SColumnInfoData* pColInfo = taosArrayGet(pHandle->pColumns, i);
+    if (!isLoadedColumn(&pHandle->dataBlockLoadInfo, pColInfo->info.colId)) {
+      continue;
+    }
+
+    memmove((char*)pColInfo->pData, (char*)pColInfo->pData + emptySize * pColInfo->info.bytes, numOfRows * pColInfo->info.bytes);
+  }
+}
+
+// The non-key columns of the rows of a cut block are loaded only when the query cannot do with their statistics
+static int32_t loadEncodedRangeBlock(STsdbQueryHandle* pHandle) {
+  SDataBlockLoadInfo* pBlockLoadInfo = &pHandle->dataBlockLoadInfo;
+  STableBlockInfo*    pBlockInfo = &pHandle->pDataBlockInfo[pHandle->cur.slot];
+  int32_t             start = pBlockLoadInfo->rangeStart;
+  int32_t             end = pBlockLoadInfo->rangeEnd;
+
+  SArray* pLoadList = getLoadColumns(pHandle, pBlockLoadInfo->pLoadedCols, false);
+  if (pLoadList == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return terrno;
+  }
+
+  int32_t code = doLoadFileDataBlockCols(pHandle, pBlockInfo->compBlock, pBlockInfo->pTableCheckInfo, pHandle->cur.slot,
+                                         pLoadList);
+  taosArrayDestroy(&pLoadList);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  int32_t numOfRows = doCopyRowsFromFileBlock(pHandle, pHandle->outputCapacity, 0, start, end);
+  moveLoadedDataToFront(pHandle, numOfRows);
+  return TSDB_CODE_SUCCESS;
+}
+
 SArray* tsdbRetrieveDataBlock(TsdbQueryHandleT* pQueryHandle, SArray* pIdList) {
   /**
    * In the following two cases, the data has been loaded to SColumnInfoData.
@@ -3805,6 +4158,10 @@ SArray* tsdbRetrieveDataBlock(TsdbQueryHandleT* pQueryHandle, SArray* pIdList) {
     STableCheckInfo* pCheckInfo = pBlockInfo->pTableCheckInfo;
 
     if (pHandle->cur.mixBlock) {
+      if (isEncodedRangeBlock(pHandle) && loadEncodedRangeBlock(pHandle) != TSDB_CODE_SUCCESS) {
+        return NULL;
+      }
+
       return pHandle->pColumns;
     } else {
       SDataBlockInfo binfo = GET_FILE_DATA_BLOCK_INFO(pCheckInfo, pBlockInfo->compBlock);
@@ -3813,33 +4170,73 @@ SArray* tsdbRetrieveDataBlock(TsdbQueryHandleT* pQueryHandle, SArray* pIdList) {
       // data block has been loaded, todo extract method
       SDataBlockLoadInfo* pBlockLoadInfo = &pHandle->dataBlockLoadInfo;
 
-      if (pBlockLoadInfo->slot == pHandle->cur.slot && pBlockLoadInfo->fileGroup->fid == pHandle->cur.fid &&
-          pBlockLoadInfo->tid == pCheckInfo->pTableObj->tableId.tid) {
+      bool loaded = (pBlockLoadInfo->slot == pHandle->cur.slot && pBlockLoadInfo->fileGroup->fid == pHandle->cur.fid &&
+                     pBlockLoadInfo->tid == pCheckInfo->pTableObj->tableId.tid);
+      if (loaded && (!pBlockLoadInfo->partial || pIdList != NULL)) {
         return pHandle->pColumns;
-      } else {  // only load the file block
-        SBlock* pBlock = pBlockInfo->compBlock;
-        if (doLoadFileDataBlock(pHandle, pBlock, pCheckInfo, pHandle->cur.slot) != TSDB_CODE_SUCCESS) {
-          return NULL;
-        }
+      }
 
-        // todo refactor
-        int32_t numOfRows = doCopyRowsFromFileBlock(pHandle, pHandle->outputCapacity, 0, 0, pBlock->numOfRows - 1);
+      // Only the required columns are loaded first, the other ones when called again without column list
+      SArray* pLoadList = pHandle->defaultLoadColumn;
+      if (loaded) {
+        pLoadList = getLoadColumns(pHandle, pBlockLoadInfo->pLoadedCols, false);
+      } else if (pIdList != NULL) {
+        pLoadList = getLoadColumns(pHandle, pIdList, true);
+      }
 
-        // if the buffer is not full in case of descending order query, move the data in the front of the buffer
-        if (!ASCENDING_TRAVERSE(pHandle->order) && numOfRows < pHandle->outputCapacity) {
-          int32_t emptySize = pHandle->outputCapacity - numOfRows;
-          int32_t reqNumOfCols = (int32_t)taosArrayGetSize(pHandle->pColumns);
+      if (pLoadList == NULL) {
+        terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+        return NULL;
+      }
 
-          for(int32_t i = 0; i < reqNumOfCols; ++i) {
-            SColumnInfoData* pColInfo = taosArrayGet(pHandle->pColumns, i);
-            memmove((char*)pColInfo->pData, (char*)pColInfo->pData + emptySize * pColInfo->info.bytes, numOfRows * pColInfo->info.bytes);
-          }
-        }
+      SBlock* pBlock = pBlockInfo->compBlock;
+      bool    partial = (!loaded && taosArrayGetSize(pLoadList) < taosArrayGetSize(pHandle->defaultLoadColumn));
 
-        return pHandle->pColumns;
+      int32_t code = doLoadFileDataBlockCols(pHandle, pBlock, pCheckInfo, pHandle->cur.slot, pLoadList);
+      if (pLoadList != pHandle->defaultLoadColumn) {
+        taosArrayDestroy(&pLoadList);
+      }
+
+      if (code != TSDB_CODE_SUCCESS) {
+        return NULL;
       }
+
+      // todo refactor
+      int32_t numOfRows = doCopyRowsFromFileBlock(pHandle, pHandle->outputCapacity, 0, 0, pBlock->numOfRows - 1);
+      moveLoadedDataToFront(pHandle, numOfRows);
+
+      pBlockLoadInfo->partial = partial;
+      return pHandle->pColumns;
+    }
+  }
+}
+
+const uint8_t* tsdbRetrieveDataBlockDictCodes(TsdbQueryHandleT* pQueryHandle, int16_t colId) {
+  STsdbQueryHandle* pHandle = (STsdbQueryHandle*)pQueryHandle;
+  if (pHandle->cur.fid == INT32_MIN || pHandle->cur.mixBlock) {
+    return NULL;
+  }
+
+  STableBlockInfo*    pBlockInfo = &pHandle->pDataBlockInfo[pHandle->cur.slot];
+  SDataBlockLoadInfo* pBlockLoadInfo = &pHandle->dataBlockLoadInfo;
+
+  bool loaded = (pBlockLoadInfo->slot == pHandle->cur.slot && pBlockLoadInfo->fileGroup->fid == pHandle->cur.fid &&
+                 pBlockLoadInfo->tid == pBlockInfo->pTableCheckInfo->pTableObj->tableId.tid);
+
+  // The rows of a block with sub blocks are merged, their codes are gone
+  if (!loaded || pBlockInfo->compBlock->numOfSubBlocks > 1) {
+    return NULL;
+  }
+
+  SDataCols* pCols = pHandle->rhelper.pDCols[0];
+  for (int32_t i = 0; i < pCols->numOfCols; ++i) {
+    SDataCol* pCol = &pCols->cols[i];
+    if (pCol->colId == colId) {
+      return (pCol->dictNum > 0 && !isAllRowsNull(pCol)) ? pCol->dictCodes : NULL;
     }
   }
+
+  return NULL;
 }
 
 void filterPrepare(void* expr, void* param) {
@@ -4101,7 +4498,7 @@ int32_t tsdbQuerySTableByTagCond(STsdbRepo* tsdb, uint64_t uid, TSKEY skey, cons
     goto _error;
   }
 
-  ret = tsdbQueryTableList(pTable, res, filterInfo);
+  ret = tsdbQueryTableList(tsdbGetMeta(tsdb), pTable, res, filterInfo);
   if (ret != TSDB_CODE_SUCCESS) {
     terrno = ret;
     tsdbUnlockRepoMeta(tsdb);
@@ -4265,6 +4662,7 @@ void tsdbCleanupQueryHandle(TsdbQueryHandleT queryHandle) {
   pQueryHandle->pColumns = doFreeColumnInfoData(pQueryHandle->pColumns);
 
   taosArrayDestroy(&pQueryHandle->defaultLoadColumn);
+  taosArrayDestroy(&pQueryHandle->dataBlockLoadInfo.pLoadedCols);
   tfree(pQueryHandle->pDataBlockInfo);
   tfree(pQueryHandle->statis);
 
@@ -4413,6 +4811,129 @@ static void queryIndexlessColumn(SSkipList* pSkipList, void* filterInfo, SArray*
   tSkipListDestroyIter(iter);
 }
 
+static FORCE_INLINE int32_t tsdbGetTagDataFromTable(void *param, int32_t id, void **data) {
+  STable* pTable = (STable*)param;
+
+  if (id == TSDB_TBNAME_COLUMN_INDEX) {
+    *data = TABLE_NAME(pTable);
+  } else {
+    *data = tdGetKVRowValOfCol(pTable->tagVal, id);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// The tids of the tables a unit may hold for, false if it can not be answered by the tag inverted index
+static bool getTagIdxUnitTids(STable* pSTable, SFilterInfo* info, SFilterUnit* unit, SArray** pTids) {
+  uint8_t optr = FILTER_UNIT_OPTR(unit);
+  int8_t  type = FILTER_UNIT_DATA_TYPE(unit);
+  int16_t colId = FILTER_UNIT_COL_ID(info, unit);
+  bool    indexed = false;
+  int32_t len = 0;
+
+  *pTids = NULL;
+
+  if (optr == TSDB_RELATION_EQUAL || optr == TSDB_RELATION_ISNULL) {
+    void* val = (optr == TSDB_RELATION_EQUAL) ? FILTER_UNIT_VAL_DATA(info, unit) : NULL;
+    if (optr == TSDB_RELATION_EQUAL && val == NULL) return false;
+
+    const void* key = tsdbGetTagIdxKey(type, val, &len);
+    SArray*     pList = tsdbGetTagIdxTids(pSTable, colId, type, key, len, &indexed);
+    if (indexed) *pTids = (pList == NULL) ? taosArrayInit(0, sizeof(int32_t)) : taosArrayDup(pList);
+  } else if (optr == TSDB_RELATION_IN && IS_VAR_DATA_TYPE(type)) {
+    // the set of an in condition on binary and nchar tags is keyed the same way as the index
+    SHashObj* pSet = (SHashObj*)FILTER_UNIT_VAL_DATA(info, unit);
+    void*     p = taosHashIterate(pSet, NULL);
+
+    *pTids = taosArrayInit(0, sizeof(int32_t));
+    while (p != NULL && *pTids != NULL) {
+      char*   key = taosHashGetDataKey(pSet, p);
+      SArray* pList = tsdbGetTagIdxTids(pSTable, colId, type, key, taosHashGetDataKeyLen(pSet, p), &indexed);
+      if (!indexed) break;
+
+      *pTids = tsdbMergeTids(*pTids, pList);
+      p = taosHashIterate(pSet, p);
+    }
+    if (p != NULL) taosHashCancelIterate(pSet, p);
+  } else {
+    return false;
+  }
+
+  if (!indexed) taosArrayDestroy(pTids);
+
+  return indexed && *pTids != NULL;
+}
+
+// Candidates of each group are the intersection of the tids of its equal, in and is null conditions on indexed tags,
+// the candidates of all groups are merged and then checked against the whole condition. Returns false if some group
+// has no such condition, in which case all child tables have to be checked.
+static bool queryTagIdxColumn(STsdbMeta* pMeta, STable* pSTable, void* filterInfo, SArray* res) {
+  SFilterInfo* info = (SFilterInfo*)filterInfo;
+  SArray*      pTids = NULL;
+  bool         indexed = true;
+
+  if (pSTable->pTagIdx == NULL || info->groupNum == 0) return false;
+
+  pTids = taosArrayInit(0, sizeof(int32_t));
+  for (uint32_t g = 0; g < info->groupNum && pTids != NULL && indexed; ++g) {
+    SFilterGroup* group = &info->groups[g];
+    SArray*       pGroupTids = NULL;
+
+    for (uint32_t u = 0; u < group->unitNum; ++u) {
+      SArray* pUnitTids = NULL;
+      if (!getTagIdxUnitTids(pSTable, info, FILTER_GROUP_UNIT(info, group, u), &pUnitTids)) continue;
+
+      if (pGroupTids == NULL) {
+        pGroupTids = pUnitTids;
+      } else {
+        int code = tsdbIntersectTids(pGroupTids, pUnitTids);
+        taosArrayDestroy(&pUnitTids);
+        if (code < 0) {
+          taosArrayDestroy(&pGroupTids);
+          break;
+        }
+      }
+
+      if (taosArrayGetSize(pGroupTids) == 0) break;
+    }
+
+    if (pGroupTids == NULL) {
+      indexed = false;
+    } else {
+      pTids = tsdbMergeTids(pTids, pGroupTids);
+      taosArrayDestroy(&pGroupTids);
+    }
+  }
+
+  if (pTids == NULL || !indexed) {
+    taosArrayDestroy(&pTids);
+    return false;
+  }
+
+  size_t  size = taosArrayGetSize(pTids);
+  int8_t *addToResult = NULL;
+
+  tsdbDebug("filter tag inverted index, super table:%s, candidates:%" PRIzu, TABLE_CHAR_NAME(pSTable), size);
+
+  for (size_t i = 0; i < size; ++i) {
+    int32_t tid = *(int32_t*)taosArrayGet(pTids, i);
+    STable* pTable = (tid < pMeta->maxTables) ? pMeta->tables[tid] : NULL;
+    if (pTable == NULL || pTable->pSuper != pSTable) continue;
+
+    filterSetColFieldData(filterInfo, pTable, tsdbGetTagDataFromTable);
+
+    bool all = filterExecute(filterInfo, 1, &addToResult, NULL, 0);
+    if (all || (addToResult && *addToResult)) {
+      STableKeyInfo kInfo = {.pTable = (void*)pTable, .lastKey = TSKEY_INITIAL_VAL};
+      taosArrayPush(res, &kInfo);
+    }
+  }
+
+  tfree(addToResult);
+  taosArrayDestroy(&pTids);
+  return true;
+}
+
 static FORCE_INLINE int32_t tsdbGetJsonTagDataFromId(void *param, int32_t id, char* name, void **data) {
   JsonMapValue* jsonMapV = (JsonMapValue*)(param);
   STable* pTable = (STable*)(jsonMapV->table);
@@ -4500,7 +5021,7 @@ static int32_t queryByJsonTag(STable* pTable, void* filterInfo, SArray* res){
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t tsdbQueryTableList(STable* pTable, SArray* pRes, void* filterInfo) {
+static int32_t tsdbQueryTableList(STsdbMeta* pMeta, STable* pTable, SArray* pRes, void* filterInfo) {
   STSchema*   pTSSchema = pTable->tagSchema;
 
   if(pTSSchema->columns->type == TSDB_DATA_TYPE_JSON){
@@ -4513,7 +5034,7 @@ static int32_t tsdbQueryTableList(STable* pTable, SArray* pRes, void* filterInfo
 
     if (indexQuery) {
       queryIndexedColumn(pSkipList, filterInfo, pRes);
-    } else {
+    } else if (!queryTagIdxColumn(pMeta, pTable, filterInfo, pRes)) {
       queryIndexlessColumn(pSkipList, filterInfo, pRes);
     }
   }
@@ -14,9 +14,31 @@
  */
 
 #include "tsdbint.h"
+#include "tsched.h"
 
 #define TSDB_KEY_COL_OFFSET 0
 
+typedef struct {
+  SDataCol *pDataCol;
+  void *    content;
+  int32_t   len;
+  uint32_t  offset;  // column offset in the block, for error report
+} SColDecodeItem;
+
+typedef struct {
+  SColDecodeItem *items;
+  int             nitems;
+  int8_t          comp;
+  int             numOfRows;
+  int             maxPoints;
+  void **         ppCBuf;   // compression buffer owned by the task
+  int             failed;   // index of the column failed to decode, -1 if none
+  int32_t         code;
+} SColDecodeTask;
+
+// dnode-wide pool helping readers decode the columns of a block, NULL if disabled
+static void *tsDecodeSched = NULL;
+
 static void tsdbResetReadTable(SReadH *pReadh);
 static void tsdbResetReadFile(SReadH *pReadh);
 static int  tsdbLoadBlockDataImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *pDataCols);
@@ -25,8 +47,16 @@ static int  tsdbCheckAndDecodeColumnData(SDataCol *pDataCol, void *content, int3
 static int  tsdbLoadBlockDataColsImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *pDataCols, int16_t *colIds,
                                       int numOfColIds);
 static int  tsdbLoadColData(SReadH *pReadh, SDFile *pDFile, SBlock *pBlock, SBlockCol *pBlockCol, SDataCol *pDataCol);
+static int  tsdbReadColData(SReadH *pReadh, SDFile *pDFile, SBlock *pBlock, SBlockCol *pBlockCol, int bytes,
+                            int64_t offset);
+static int64_t tsdbGetColDataOffset(SBlock *pBlock, SBlockCol *pBlockCol);
 static int  tsdbLoadBlockStatisFromDFile(SReadH *pReadh, SBlock *pBlock);
+static void tsdbGetDataColStatis(SDataCol *pDataCol, int start, int rows, SDataStatis *pStatis);
 static int  tsdbLoadBlockStatisFromAggr(SReadH *pReadh, SBlock *pBlock);
+static int  tsdbDecodeBlockCols(SReadH *pReadh, SBlock *pBlock, SDFile *pDFile, SColDecodeItem *items, int nitems,
+                                int maxPoints);
+static int  tsdbDecodeColumns(SColDecodeTask *pTask);
+static void tsdbDecodeColumnsFp(SSchedMsg *pMsg);
 
 int tsdbInitReadH(SReadH *pReadh, STsdbRepo *pRepo) {
   ASSERT(pReadh != NULL && pRepo != NULL);
@@ -65,6 +95,10 @@ void tsdbDestroyReadH(SReadH *pReadh) {
   if (pReadh == NULL) return;
   pReadh->pExBuf = taosTZfree(pReadh->pExBuf);
   pReadh->pCBuf = taosTZfree(pReadh->pCBuf);
+  pReadh->pDecItems = taosTZfree(pReadh->pDecItems);
+  for (int i = 0; i < TSDB_BLK_DECODE_MAX_TASKS - 1; i++) {
+    pReadh->pDecCBuf[i] = taosTZfree(pReadh->pDecCBuf[i]);
+  }
   pReadh->pBuf = taosTZfree(pReadh->pBuf);
   pReadh->pDCols[0] = tdFreeDataCols(pReadh->pDCols[0]);
   pReadh->pDCols[1] = tdFreeDataCols(pReadh->pDCols[1]);
@@ -91,20 +125,38 @@ int tsdbSetAndOpenReadFSet(SReadH *pReadh, SDFileSet *pSet) {
     return -1;
   }
 
+  pReadh->blkCacheGen = tsdbGetBlkCacheGen(TSDB_READ_REPO(pReadh)->pBlkCache);
+  pReadh->blkIdxCacheGen = tsdbGetBlkCacheGen(TSDB_READ_REPO(pReadh)->pBlkIdxCache);
+
   return 0;
 }
 
 void tsdbCloseAndUnsetFSet(SReadH *pReadh) { tsdbResetReadFile(pReadh); }
 
 int tsdbLoadBlockIdx(SReadH *pReadh) {
-  SDFile *  pHeadf = TSDB_READ_HEAD_FILE(pReadh);
-  SBlockIdx blkIdx;
+  SDFile *       pHeadf = TSDB_READ_HEAD_FILE(pReadh);
+  STsdbBlkCache *pIdxCache = TSDB_READ_REPO(pReadh)->pBlkIdxCache;
+  SBlockIdx      blkIdx;
+  SBlkCacheKey   cacheKey;
+  int32_t        len = 0;
 
   ASSERT(taosArrayGetSize(pReadh->aBlkIdx) == 0);
 
   // No data at all, just return
   if (pHeadf->info.offset <= 0) return 0;
 
+  if (pIdxCache) {
+    tsdbInitBlkCacheKey(&cacheKey, pReadh->blkIdxCacheGen, TSDB_FSET_FID(TSDB_READ_FSET(pReadh)), false,
+                        pHeadf->info.offset, 0);
+    if (tsdbGetBlkCacheBuf(pIdxCache, &cacheKey, &TSDB_READ_BUF(pReadh), &len)) {
+      if (len > 0 && taosArrayAddBatch(pReadh->aBlkIdx, TSDB_READ_BUF(pReadh), len / sizeof(SBlockIdx)) == NULL) {
+        terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+        return -1;
+      }
+      return 0;
+    }
+  }
+
   if (tsdbSeekDFile(pHeadf, pHeadf->info.offset, SEEK_SET) < 0) {
     tsdbError("vgId:%d failed to load SBlockIdx part while seek file %s since %s, offset:%u len :%u",
               TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pHeadf), tstrerror(terrno), pHeadf->info.offset,
@@ -152,6 +204,10 @@ int tsdbLoadBlockIdx(SReadH *pReadh) {
                              ((SBlockIdx *)taosArrayGet(pReadh->aBlkIdx, tsize - 1))->tid);
   }
 
+  if (pIdxCache) {
+    tsdbPutBlkCacheBuf(pIdxCache, &cacheKey, TARRAY_GET_START(pReadh->aBlkIdx), tsize * (int32_t)sizeof(SBlockIdx));
+  }
+
   return 0;
 }
 
@@ -309,11 +365,42 @@ static int tsdbSBlkInfoRefactor(SDFile *pHeadf, SBlockInfo **pDstBlkInfo, SBlock
   return TSDB_CODE_SUCCESS;
 }
 
+static int tsdbCopyBlockInfo(SReadH *pReadh, void **pTarget, uint32_t *extendedLen, uint32_t dstBlkInfoLen) {
+  if (extendedLen != NULL) {
+    if (pTarget != NULL) {
+      if (*extendedLen < dstBlkInfoLen) {
+        char *t = realloc(*pTarget, dstBlkInfoLen);
+        if (t == NULL) {
+          terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+          return -1;
+        }
+        *pTarget = t;
+      }
+      memcpy(*pTarget, (void *)(pReadh->pBlkInfo), dstBlkInfoLen);
+    }
+    *extendedLen = dstBlkInfoLen;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
 int tsdbLoadBlockInfo(SReadH *pReadh, void **pTarget, uint32_t *extendedLen) {
   ASSERT(pReadh->pBlkIdx != NULL);
 
-  SDFile *    pHeadf = TSDB_READ_HEAD_FILE(pReadh);
-  SBlockIdx * pBlkIdx = pReadh->pBlkIdx;
+  SDFile *       pHeadf = TSDB_READ_HEAD_FILE(pReadh);
+  SBlockIdx *    pBlkIdx = pReadh->pBlkIdx;
+  STsdbBlkCache *pIdxCache = TSDB_READ_REPO(pReadh)->pBlkIdxCache;
+  SBlkCacheKey   cacheKey;
+  int32_t        len = 0;
+
+  if (pIdxCache) {
+    tsdbInitBlkCacheKey(&cacheKey, pReadh->blkIdxCacheGen, TSDB_FSET_FID(TSDB_READ_FSET(pReadh)), false,
+                        pBlkIdx->offset, 0);
+    if (tsdbGetBlkCacheBuf(pIdxCache, &cacheKey, (void **)(&(pReadh->pBlkInfo)), &len)) {
+      ASSERT(pBlkIdx->tid == pReadh->pBlkInfo->tid && pBlkIdx->uid == pReadh->pBlkInfo->uid);
+      return tsdbCopyBlockInfo(pReadh, pTarget, extendedLen, (uint32_t)len);
+    }
+  }
 
   if (tsdbSeekDFile(pHeadf, pBlkIdx->offset, SEEK_SET) < 0) {
     tsdbError("vgId:%d failed to load SBlockInfo part while seek file %s since %s, offset:%u len:%u",
@@ -351,22 +438,11 @@ int tsdbLoadBlockInfo(SReadH *pReadh, void **pTarget, uint32_t *extendedLen) {
     return -1;
   }
 
-  if (extendedLen != NULL) {
-    if (pTarget != NULL) {
-      if (*extendedLen < dstBlkInfoLen) {
-        char *t = realloc(*pTarget, dstBlkInfoLen);
-        if (t == NULL) {
-          terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
-          return -1;
-        }
-        *pTarget = t;
-      }
-      memcpy(*pTarget, (void *)(pReadh->pBlkInfo), dstBlkInfoLen);
-    }
-    *extendedLen = dstBlkInfoLen;
+  if (pIdxCache) {
+    tsdbPutBlkCacheBuf(pIdxCache, &cacheKey, pReadh->pBlkInfo, (int32_t)dstBlkInfoLen);
   }
 
-  return TSDB_CODE_SUCCESS;
+  return tsdbCopyBlockInfo(pReadh, pTarget, extendedLen, dstBlkInfoLen);
 }
 
 int tsdbLoadBlockData(SReadH *pReadh, SBlock *pBlock, SBlockInfo *pBlkInfo) {
@@ -515,6 +591,98 @@ int tsdbLoadBlockOffset(SReadH *pReadh, SBlock *pBlock) {
   return tsdbLoadBlockStatisFromDFile(pReadh, pBlock);
 }
 
+/**
+ * Computes the statistics of rows [start, end] of the non-key columns of a block into pStatis, whose colIds are set
+ * and ascending. A column is first looked up in the block cache, then its statistics are computed from its encoded
+ * form if the codec allows it, and otherwise it is decoded into the column of pReadh->pDCols[1] and cached, since
+ * the query may load it next. Returns TSDB_STATIS_NONE if a column is of a var data type.
+ */
+int tsdbLoadBlockStatisRange(SReadH *pReadh, SBlock *pBlock, SDataStatis *pStatis, int numOfCols, int start, int end) {
+  ASSERT(pBlock->numOfSubBlocks <= 1 && start >= 0 && start <= end && end < pBlock->numOfRows);
+
+  STsdbRepo *    pRepo = TSDB_READ_REPO(pReadh);
+  STsdbCfg *     pCfg = REPO_CFG(pRepo);
+  STsdbBlkCache *pBlkCache = pRepo->pBlkCache;
+  SDFile *       pDFile = (pBlock->last) ? TSDB_READ_LAST_FILE(pReadh) : TSDB_READ_DATA_FILE(pReadh);
+  SDataCols *    pDataCols = pReadh->pDCols[1];
+  SBlockCol      blockCol = {0};
+  SBlkCacheKey   cacheKey;
+  SCompStatis    compStatis;
+  int            rows = end - start + 1;
+
+  if (tsdbLoadBlockOffset(pReadh, pBlock) < 0) return -1;
+
+  int dcol = 0;
+  int ccol = 0;
+  for (int i = 0; i < numOfCols; i++) {
+    SDataStatis *pColStatis = pStatis + i;
+    SDataCol *   pDataCol = NULL;
+    SBlockCol *  pBlockCol = NULL;
+
+    while (dcol < pDataCols->numOfCols && pDataCols->cols[dcol].colId < pColStatis->colId) dcol++;
+    if (dcol >= pDataCols->numOfCols || pDataCols->cols[dcol].colId != pColStatis->colId) return TSDB_STATIS_NONE;
+
+    pDataCol = &pDataCols->cols[dcol];
+    if (IS_VAR_DATA_TYPE(pDataCol->type)) return TSDB_STATIS_NONE;
+
+    while (ccol < pBlock->numOfCols) {
+      SBlockCol *p = &blockCol;
+      tsdbGetSBlockCol(pBlock, &p, pReadh->pBlkData->cols, ccol);
+      if (p->colId > pColStatis->colId) break;
+
+      ccol++;
+      if (p->colId == pColStatis->colId) {
+        pBlockCol = p;
+        break;
+      }
+    }
+
+    if (pBlockCol == NULL) {  // added to the table after the block was written
+      pColStatis->numOfNull = rows;
+      continue;
+    }
+
+    if (pBlkCache) {
+      tsdbInitBlkCacheKey(&cacheKey, pReadh->blkCacheGen, TSDB_FSET_FID(TSDB_READ_FSET(pReadh)), pBlock->last,
+                          pBlock->offset, pDataCol->colId);
+      if (tsdbGetBlkCacheCol(pBlkCache, &cacheKey, pDataCol, pBlock->numOfRows, pDataCols->maxPoints)) {
+        tsdbGetDataColStatis(pDataCol, start, rows, pColStatis);
+        continue;
+      }
+    }
+
+    int64_t offset = tsdbGetColDataOffset(pBlock, pBlockCol);
+    if (tsdbReadColData(pReadh, pDFile, pBlock, pBlockCol, pDataCol->bytes, offset) < 0) return -1;
+
+    if (pBlock->algorithm != NO_COMPRESSION && taosCheckChecksumWhole((uint8_t *)pReadh->pBuf, pBlockCol->len) &&
+        tsCompressedStatis(pReadh->pBuf, pBlockCol->len - sizeof(TSCKSUM), pBlock->numOfRows, start, end,
+                           pDataCol->type, pBlock->algorithm, pReadh->pCBuf, (int)taosTSizeof(pReadh->pCBuf),
+                           &compStatis) == 0) {
+      pColStatis->sum = compStatis.sum;
+      pColStatis->min = compStatis.min;
+      pColStatis->max = compStatis.max;
+      pColStatis->minIndex = (int16_t)compStatis.minIndex;
+      pColStatis->maxIndex = (int16_t)compStatis.maxIndex;
+      pColStatis->numOfNull = (int16_t)compStatis.numOfNull;
+      continue;
+    }
+
+    if (tsdbCheckAndDecodeColumnData(pDataCol, pReadh->pBuf, pBlockCol->len, pBlock->algorithm, pBlock->numOfRows,
+                                     pCfg->maxRowsPerFileBlock, pReadh->pCBuf, (int32_t)taosTSizeof(pReadh->pCBuf)) < 0) {
+      tsdbError("vgId:%d file %s is broken at column %d offset %" PRId64, REPO_ID(pRepo), TSDB_FILE_FULL_NAME(pDFile),
+                pBlockCol->colId, offset);
+      return -1;
+    }
+
+    if (pBlkCache) {
+      tsdbPutBlkCacheCol(pBlkCache, &cacheKey, pDataCol, pBlock->numOfRows);
+    }
+    tsdbGetDataColStatis(pDataCol, start, rows, pColStatis);
+  }
+
+  return TSDB_STATIS_OK;
+}
+
 int tsdbEncodeSBlockIdx(void **buf, SBlockIdx *pIdx) {
   int tlen = 0;
 
@@ -664,7 +832,11 @@ static int tsdbLoadBlockDataImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *pDat
 
   pDataCols->numOfRows = pBlock->numOfRows;
 
-  // Recover the data
+  if (tsdbMakeRoom(&(pReadh->pDecItems), sizeof(SColDecodeItem) * pDataCols->numOfCols) < 0) return -1;
+  SColDecodeItem *items = (SColDecodeItem *)pReadh->pDecItems;
+  int             nitems = 0;
+
+  // Recover the data, columns found in the block are decoded after the walk
   int ccol = 0;  // loop iter for SBlockCol object
   int dcol = 0;  // loop iter for SDataCols object
   SBlockCol blockCol = {0};
@@ -692,18 +864,12 @@ static int tsdbLoadBlockDataImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *pDat
     }
 
     if (tcolId == pDataCol->colId) {
-      if (pBlock->algorithm == TWO_STAGE_COMP) {
-        int zsize = pDataCol->bytes * pBlock->numOfRows + COMP_OVERFLOW_BYTES;
-        if (tsdbMakeRoom((void **)(&TSDB_READ_COMP_BUF(pReadh)), zsize) < 0) return -1;
-      }
-
-      if (tsdbCheckAndDecodeColumnData(pDataCol, POINTER_SHIFT(pBlockData, tsize + toffset), tlen, pBlock->algorithm,
-                                       pBlock->numOfRows, pDataCols->maxPoints, TSDB_READ_COMP_BUF(pReadh),
-                                       (int)taosTSizeof(TSDB_READ_COMP_BUF(pReadh))) < 0) {
-        tsdbError("vgId:%d file %s is broken at column %d block offset %" PRId64 " column offset %u",
-                  TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFile), tcolId, (int64_t)pBlock->offset, toffset);
-        return -1;
-      }
+      SColDecodeItem *pItem = items + nitems;
+      pItem->pDataCol = pDataCol;
+      pItem->content = POINTER_SHIFT(pBlockData, tsize + toffset);
+      pItem->len = tlen;
+      pItem->offset = toffset;
+      nitems++;
 
       if (dcol != 0) {
         ccol++;
@@ -718,9 +884,146 @@ static int tsdbLoadBlockDataImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *pDat
     }
   }
 
+  return tsdbDecodeBlockCols(pReadh, pBlock, pDFile, items, nitems, pDataCols->maxPoints);
+}
+
+int tsdbInitDecodePool() {
+  if (tsdbBlkDecodeThreads <= 0) return 0;
+
+  tsDecodeSched = taosInitScheduler(tsdbBlkDecodeThreads * TSDB_BLK_DECODE_MAX_TASKS, tsdbBlkDecodeThreads, "tsdbDec");
+  if (tsDecodeSched == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  return 0;
+}
+
+void tsdbDestroyDecodePool() {
+  if (tsDecodeSched) {
+    taosCleanUpScheduler(tsDecodeSched);
+    tsDecodeSched = NULL;
+  }
+}
+
+// Decode the columns of a block. With the decode pool the columns are split into contiguous ranges of about the same
+// compressed size, the loading thread decodes the first range itself and waits for the pool to finish the others.
+// Each column is decoded into its own SDataCol, so the result never depends on the split.
+static int tsdbDecodeBlockCols(SReadH *pReadh, SBlock *pBlock, SDFile *pDFile, SColDecodeItem *items, int nitems,
+                               int maxPoints) {
+  SColDecodeTask tasks[TSDB_BLK_DECODE_MAX_TASKS];
+  tsem_t         done;  // posted by each helper task when it finishes
+  int            ntasks = 1;
+  int64_t        tlen = 0;
+
+  if (tsDecodeSched != NULL) {
+    for (int i = 0; i < nitems; i++) {
+      tlen += items[i].len;
+    }
+
+    ntasks = MIN(tsdbBlkDecodeThreads + 1, TSDB_BLK_DECODE_MAX_TASKS);
+    ntasks = MIN(ntasks, nitems / TSDB_BLK_DECODE_MIN_COLS);
+    ntasks = (int)MIN(ntasks, tlen / TSDB_BLK_DECODE_MIN_BYTES);
+    if (ntasks < 1) ntasks = 1;
+  }
+
+  int     start = 0;
+  int64_t acc = 0;
+  for (int t = 0; t < ntasks; t++) {
+    SColDecodeTask *pTask = tasks + t;
+
+    int end = start;
+    if (t == ntasks - 1) {
+      end = nitems;
+    } else {
+      // Leave at least one column for each of the remaining tasks
+      int64_t target = tlen * (t + 1) / ntasks;
+      while (end < nitems - (ntasks - t - 1) && (end == start || acc < target)) {
+        acc += items[end].len;
+        end++;
+      }
+    }
+
+    pTask->items = items + start;
+    pTask->nitems = end - start;
+    pTask->comp = pBlock->algorithm;
+    pTask->numOfRows = pBlock->numOfRows;
+    pTask->maxPoints = maxPoints;
+    pTask->ppCBuf = (t == 0) ? &TSDB_READ_COMP_BUF(pReadh) : &(pReadh->pDecCBuf[t - 1]);
+    pTask->failed = -1;
+    pTask->code = 0;
+    start = end;
+  }
+
+  if (ntasks > 1) {
+    tsem_init(&done, 0, 0);
+
+    for (int t = 1; t < ntasks; t++) {
+      SSchedMsg msg = {0};
+      msg.fp = tsdbDecodeColumnsFp;
+      msg.ahandle = tasks + t;
+      msg.thandle = &done;
+      taosScheduleTask(tsDecodeSched, &msg);
+    }
+  }
+
+  tsdbDecodeColumns(tasks);
+
+  if (ntasks > 1) {
+    for (int t = 1; t < ntasks; t++) {
+      tsem_wait(&done);
+    }
+    tsem_destroy(&done);
+  }
+
+  // Report the first broken column in the block order, whichever task met it
+  for (int t = 0; t < ntasks; t++) {
+    SColDecodeTask *pTask = tasks + t;
+    if (pTask->failed < 0) continue;
+
+    SColDecodeItem *pItem = pTask->items + pTask->failed;
+    terrno = pTask->code;
+    tsdbError("vgId:%d file %s is broken at column %d block offset %" PRId64 " column offset %u",
+              TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFile), pItem->pDataCol->colId,
+              (int64_t)pBlock->offset, pItem->offset);
+    return -1;
+  }
+
   return 0;
 }
 
+static int tsdbDecodeColumns(SColDecodeTask *pTask) {
+  for (int i = 0; i < pTask->nitems; i++) {
+    SColDecodeItem *pItem = pTask->items + i;
+    SDataCol *      pDataCol = pItem->pDataCol;
+
+    if (IS_TWO_STAGE_COMP(pTask->comp)) {
+      int zsize = pDataCol->bytes * pTask->numOfRows + COMP_OVERFLOW_BYTES;
+      if (tsdbMakeRoom(pTask->ppCBuf, zsize) < 0) {
+        pTask->failed = i;
+        pTask->code = terrno;
+        return -1;
+      }
+    }
+
+    if (tsdbCheckAndDecodeColumnData(pDataCol, pItem->content, pItem->len, pTask->comp, pTask->numOfRows,
+                                     pTask->maxPoints, *(pTask->ppCBuf), (int)taosTSizeof(*(pTask->ppCBuf))) < 0) {
+      pTask->failed = i;
+      pTask->code = terrno;
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+static void tsdbDecodeColumnsFp(SSchedMsg *pMsg) {
+  SColDecodeTask *pTask = (SColDecodeTask *)pMsg->ahandle;
+
+  tsdbDecodeColumns(pTask);
+  tsem_post((tsem_t *)pMsg->thandle);
+}
+
 static int tsdbCheckAndDecodeColumnData(SDataCol *pDataCol, void *content, int32_t len, int8_t comp, int numOfRows,
                                         int maxPoints, char *buffer, int bufferSize) {
   if (!taosCheckChecksumWhole((uint8_t *)content, len)) {
@@ -729,12 +1032,21 @@ static int tsdbCheckAndDecodeColumnData(SDataCol *pDataCol, void *content, int32
   }
 
   tdAllocMemForCol(pDataCol, maxPoints);
+  pDataCol->dictNum = 0;
 
   // Decode the data
   if (comp) {
     // Need to decompress
-    int tlen = (*(tDataTypes[pDataCol->type].decompFunc))(content, len - sizeof(TSCKSUM), numOfRows, pDataCol->pData,
-                                                             pDataCol->spaceSize, comp, buffer, bufferSize);
+    int tlen = 0;
+    if (IS_VAR_DATA_TYPE(pDataCol->type) && tsGetStringDictSize(content) > 0) {
+      // Keep the codes, the filters of a query compare each distinct value once
+      tlen = tsDecompressStringDictImp(content, len - sizeof(TSCKSUM), numOfRows, pDataCol->pData,
+                                       pDataCol->spaceSize, pDataCol->dictCodes);
+      pDataCol->dictNum = (int16_t)tsGetStringDictSize(content);
+    } else {
+      tlen = (*(tDataTypes[pDataCol->type].decompFunc))(content, len - sizeof(TSCKSUM), numOfRows, pDataCol->pData,
+                                                        pDataCol->spaceSize, comp, buffer, bufferSize);
+    }
     if (tlen <= 0) {
       tsdbError("Failed to decompress column, file corrupted, len:%d comp:%d numOfRows:%d maxPoints:%d bufferSize:%d",
                 len, comp, numOfRows, maxPoints, bufferSize);
@@ -759,13 +1071,21 @@ static int tsdbLoadBlockDataColsImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *
   ASSERT(pBlock->numOfSubBlocks == 0 || pBlock->numOfSubBlocks == 1);
   ASSERT(colIds[0] == 0);
 
-  SDFile *  pDFile = (pBlock->last) ? TSDB_READ_LAST_FILE(pReadh) : TSDB_READ_DATA_FILE(pReadh);
-  SBlockCol blockCol = {0};
+  STsdbRepo *    pRepo = TSDB_READ_REPO(pReadh);
+  STsdbBlkCache *pBlkCache = pRepo->pBlkCache;
+  SDFile *       pDFile = (pBlock->last) ? TSDB_READ_LAST_FILE(pReadh) : TSDB_READ_DATA_FILE(pReadh);
+  SBlockCol      blockCol = {0};
+  SBlkCacheKey   cacheKey;
+  bool           blkDataLoaded = false;
 
   tdResetDataCols(pDataCols);
 
-  // If only load timestamp column, no need to load SBlockData part
-  if (numOfColIds > 1 && tsdbLoadBlockOffset(pReadh, pBlock) < 0) return -1;
+  // If only load timestamp column, no need to load SBlockData part. With the block cache it is loaded lazily on the
+  // first non-key column miss.
+  if (pBlkCache == NULL) {
+    if (numOfColIds > 1 && tsdbLoadBlockOffset(pReadh, pBlock) < 0) return -1;
+    blkDataLoaded = true;
+  }
 
   pDataCols->numOfRows = pBlock->numOfRows;
 
@@ -794,6 +1114,17 @@ static int tsdbLoadBlockDataColsImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *
     if (pDataCol == NULL) continue;
     ASSERT(pDataCol->colId == colId);
 
+    if (pBlkCache) {
+      tsdbInitBlkCacheKey(&cacheKey, pReadh->blkCacheGen, TSDB_FSET_FID(TSDB_READ_FSET(pReadh)), pBlock->last,
+                          pBlock->offset, colId);
+      if (tsdbGetBlkCacheCol(pBlkCache, &cacheKey, pDataCol, pBlock->numOfRows, pDataCols->maxPoints)) continue;
+
+      if (colId != 0 && !blkDataLoaded) {
+        if (tsdbLoadBlockOffset(pReadh, pBlock) < 0) return -1;
+        blkDataLoaded = true;
+      }
+    }
+
     if (colId == 0) {  // load the key row
       blockCol.colId = colId;
       blockCol.len = pBlock->keyLen;
@@ -828,6 +1159,10 @@ static int tsdbLoadBlockDataColsImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *
     }
 
     if (tsdbLoadColData(pReadh, pDFile, pBlock, pBlockCol, pDataCol) < 0) return -1;
+
+    if (pBlkCache) {
+      tsdbPutBlkCacheCol(pBlkCache, &cacheKey, pDataCol, pBlock->numOfRows);
+    }
   }
 
   return 0;
@@ -838,13 +1173,39 @@ static int tsdbLoadColData(SReadH *pReadh, SDFile *pDFile, SBlock *pBlock, SBloc
 
   STsdbRepo *pRepo = TSDB_READ_REPO(pReadh);
   STsdbCfg * pCfg = REPO_CFG(pRepo);
-  int        tsize = pDataCol->bytes * pBlock->numOfRows + COMP_OVERFLOW_BYTES;
+  int64_t    offset = tsdbGetColDataOffset(pBlock, pBlockCol);
+
+  if (tsdbReadColData(pReadh, pDFile, pBlock, pBlockCol, pDataCol->bytes, offset) < 0) return -1;
+
+  if (tsdbCheckAndDecodeColumnData(pDataCol, pReadh->pBuf, pBlockCol->len, pBlock->algorithm, pBlock->numOfRows,
+                                   pCfg->maxRowsPerFileBlock, pReadh->pCBuf, (int32_t)taosTSizeof(pReadh->pCBuf)) < 0) {
+    tsdbError("vgId:%d file %s is broken at column %d offset %" PRId64, REPO_ID(pRepo), TSDB_FILE_FULL_NAME(pDFile),
+              pBlockCol->colId, offset);
+    return -1;
+  }
+
+  return 0;
+}
+
+static int64_t tsdbGetColDataOffset(SBlock *pBlock, SBlockCol *pBlockCol) {
+  return pBlock->offset + tsdbBlockStatisSize(pBlock->numOfCols, (uint32_t)pBlock->blkVer) +
+         tsdbGetBlockColOffset(pBlockCol);
+}
+
+static void tsdbGetDataColStatis(SDataCol *pDataCol, int start, int rows, SDataStatis *pStatis) {
+  (*tDataTypes[pDataCol->type].statisFunc)(POINTER_SHIFT(pDataCol->pData, start * pDataCol->bytes), rows,
+                                           &pStatis->min, &pStatis->max, &pStatis->sum, &pStatis->minIndex,
+                                           &pStatis->maxIndex, &pStatis->numOfNull);
+}
+
+// Reads the encoded column into TSDB_READ_BUF and makes room in TSDB_READ_COMP_BUF to decode it
+static int tsdbReadColData(SReadH *pReadh, SDFile *pDFile, SBlock *pBlock, SBlockCol *pBlockCol, int bytes,
+                           int64_t offset) {
+  int tsize = bytes * pBlock->numOfRows + COMP_OVERFLOW_BYTES;
 
   if (tsdbMakeRoom((void **)(&TSDB_READ_BUF(pReadh)), pBlockCol->len) < 0) return -1;
   if (tsdbMakeRoom((void **)(&TSDB_READ_COMP_BUF(pReadh)), tsize) < 0) return -1;
 
-  int64_t offset = pBlock->offset + tsdbBlockStatisSize(pBlock->numOfCols, (uint32_t)pBlock->blkVer) +
-                   tsdbGetBlockColOffset(pBlockCol);
   if (tsdbSeekDFile(pDFile, offset, SEEK_SET) < 0) {
     tsdbError("vgId:%d failed to load block column data while seek file %s to offset %" PRId64 " since %s",
               TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFile), offset, tstrerror(terrno));
@@ -866,12 +1227,5 @@ static int tsdbLoadColData(SReadH *pReadh, SDFile *pDFile, SBlock *pBlock, SBloc
     return -1;
   }
 
-  if (tsdbCheckAndDecodeColumnData(pDataCol, pReadh->pBuf, pBlockCol->len, pBlock->algorithm, pBlock->numOfRows,
-                                   pCfg->maxRowsPerFileBlock, pReadh->pCBuf, (int32_t)taosTSizeof(pReadh->pCBuf)) < 0) {
-    tsdbError("vgId:%d file %s is broken at column %d offset %" PRId64, REPO_ID(pRepo), TSDB_FILE_FULL_NAME(pDFile),
-              pBlockCol->colId, offset);
-    return -1;
-  }
-
   return 0;
 }
@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tsdbint.h"
+
+static STagIdxCol *tsdbGetTagIdxCol(STable *pSTable, int16_t colId);
+static STagIdxCol *tsdbNewTagIdxCol(STable *pSTable, STColumn *pTCol);
+static void        tsdbDropTagIdxCol(STable *pSTable, STagIdxCol *pCol);
+static void        tsdbFreeTagIdxColHash(SHashObj *pHash);
+static int         tsdbPutTagIdxTid(STagIdxCol *pCol, const void *val, int32_t tid);
+static void        tsdbDelTagIdxTid(STagIdxCol *pCol, const void *val, int32_t tid);
+static int         tsdbCompareTid(const void *a, const void *b);
+static bool        tsdbIsTidsSorted(const SArray *pTids);
+static void        tsdbSortTids(SArray *pTids);
+static SArray *    tsdbSortTidsCopy(const SArray *pTids);
+
+void tsdbFreeTagIdx(STable *pSTable) {
+  if (pSTable->pTagIdx == NULL) return;
+
+  for (size_t i = 0; i < taosArrayGetSize(pSTable->pTagIdx); i++) {
+    STagIdxCol *pCol = (STagIdxCol *)taosArrayGet(pSTable->pTagIdx, i);
+    tsdbFreeTagIdxColHash(pCol->pHash);
+  }
+  taosArrayDestroy(&pSTable->pTagIdx);
+}
+
+int tsdbAddTableIntoTagIdx(STable *pSTable, STable *pTable) {
+  if (!tsdbTagInvertedIdx) return 0;
+
+  if (pSTable->pTagIdx == NULL) {
+    pSTable->pTagIdx = taosArrayInit(pSTable->tagSchema->numOfCols, sizeof(STagIdxCol));
+    if (pSTable->pTagIdx == NULL) {
+      terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+      return -1;
+    }
+  }
+
+  STSchema *pTagSchema = pSTable->tagSchema;
+  for (int i = 0; i < schemaNCols(pTagSchema); i++) {
+    STColumn *pTCol = schemaColAt(pTagSchema, i);
+    if (!tsdbIsTagIdxType(colType(pTCol))) continue;
+
+    STagIdxCol *pCol = tsdbGetTagIdxCol(pSTable, colColId(pTCol));
+    if (pCol == NULL && (pCol = tsdbNewTagIdxCol(pSTable, pTCol)) == NULL) {
+      return -1;
+    }
+
+    if (tsdbPutTagIdxTid(pCol, tdGetKVRowValOfCol(pTable->tagVal, pCol->colId), TABLE_TID(pTable)) < 0) {
+      // An index missing a table would lose query results, drop it and let the next table rebuild it
+      tsdbDropTagIdxCol(pSTable, pCol);
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+void tsdbRemoveTableFromTagIdx(STable *pSTable, STable *pTable) {
+  if (pSTable->pTagIdx == NULL) return;
+
+  // Columns dropped from the tag schema keep their index, the values of the table are still in its tag row
+  for (size_t i = 0; i < taosArrayGetSize(pSTable->pTagIdx); i++) {
+    STagIdxCol *pCol = (STagIdxCol *)taosArrayGet(pSTable->pTagIdx, i);
+    tsdbDelTagIdxTid(pCol, tdGetKVRowValOfCol(pTable->tagVal, pCol->colId), TABLE_TID(pTable));
+  }
+}
+
+SArray *tsdbGetTagIdxTids(STable *pSTable, int16_t colId, int8_t type, const void *key, int32_t len, bool *indexed) {
+  STagIdxCol *pCol = tsdbGetTagIdxCol(pSTable, colId);
+
+  *indexed = (pCol != NULL && pCol->type == type);
+  if (!(*indexed)) return NULL;
+
+  SArray **ppTids = (SArray **)taosHashGet(pCol->pHash, key, len);
+  return (ppTids == NULL) ? NULL : *ppTids;
+}
+
+int tsdbIntersectTids(SArray *pTids, const SArray *pOther) {
+  SArray *pCopy = NULL;
+  if (pOther != NULL && !tsdbIsTidsSorted(pOther)) {
+    if ((pCopy = tsdbSortTidsCopy(pOther)) == NULL) return -1;
+    pOther = pCopy;
+  }
+  tsdbSortTids(pTids);
+
+  size_t n = taosArrayGetSize(pTids);
+  size_t m = (pOther == NULL) ? 0 : taosArrayGetSize(pOther);
+  size_t i = 0, j = 0, k = 0;
+
+  while (i < n && j < m) {
+    int32_t a = *(int32_t *)taosArrayGet(pTids, i);
+    int32_t b = *(int32_t *)taosArrayGet(pOther, j);
+    if (a < b) {
+      i++;
+    } else if (a > b) {
+      j++;
+    } else {
+      *(int32_t *)taosArrayGet(pTids, k++) = a;
+      i++;
+      j++;
+    }
+  }
+
+  taosArraySetSize(pTids, k);
+  taosArrayDestroy(&pCopy);
+  return 0;
+}
+
+SArray *tsdbMergeTids(SArray *pTids, const SArray *pOther) {
+  SArray *pCopy = NULL;
+  if (pOther != NULL && !tsdbIsTidsSorted(pOther)) {
+    if ((pCopy = tsdbSortTidsCopy(pOther)) == NULL) {
+      taosArrayDestroy(&pTids);
+      return NULL;
+    }
+    pOther = pCopy;
+  }
+  tsdbSortTids(pTids);
+
+  size_t n = taosArrayGetSize(pTids);
+  size_t m = (pOther == NULL) ? 0 : taosArrayGetSize(pOther);
+  if (m == 0) return pTids;
+
+  SArray *pRes = taosArrayInit(n + m, sizeof(int32_t));
+  if (pRes == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    taosArrayDestroy(&pTids);
+    taosArrayDestroy(&pCopy);
+    return NULL;
+  }
+
+  size_t i = 0, j = 0;
+  while (i < n || j < m) {
+    int32_t a = (i < n) ? *(int32_t *)taosArrayGet(pTids, i) : INT32_MAX;
+    int32_t b = (j < m) ? *(int32_t *)taosArrayGet(pOther, j) : INT32_MAX;
+    int32_t v = MIN(a, b);
+
+    if (a == v) i++;
+    if (b == v) j++;
+    taosArrayPush(pRes, &v);
+  }
+
+  taosArrayDestroy(&pTids);
+  taosArrayDestroy(&pCopy);
+  return pRes;
+}
+
+static STagIdxCol *tsdbGetTagIdxCol(STable *pSTable, int16_t colId) {
+  if (pSTable->pTagIdx == NULL) return NULL;
+
+  // A super table has at most TSDB_MAX_TAGS tags, a linear search is fine
+  for (size_t i = 0; i < taosArrayGetSize(pSTable->pTagIdx); i++) {
+    STagIdxCol *pCol = (STagIdxCol *)taosArrayGet(pSTable->pTagIdx, i);
+    if (pCol->colId == colId) return pCol;
+  }
+
+  return NULL;
+}
+
+static STagIdxCol *tsdbNewTagIdxCol(STable *pSTable, STColumn *pTCol) {
+  STagIdxCol col = {.colId = colColId(pTCol), .type = colType(pTCol)};
+
+  col.pHash = taosHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_NO_LOCK);
+  if (col.pHash == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  STagIdxCol *pCol = (STagIdxCol *)taosArrayPush(pSTable->pTagIdx, &col);
+  if (pCol == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    taosHashCleanup(col.pHash);
+    return NULL;
+  }
+
+  // The column is new to the tag schema or the index is being rebuilt, pick up the tables already there
+  SSkipListIterator *pIter = tSkipListCreateIter(pSTable->pIndex);
+  if (pIter == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    tsdbDropTagIdxCol(pSTable, pCol);
+    return NULL;
+  }
+
+  while (tSkipListIterNext(pIter)) {
+    STable *pTable = (STable *)SL_GET_NODE_DATA(tSkipListIterGet(pIter));
+    if (tsdbPutTagIdxTid(pCol, tdGetKVRowValOfCol(pTable->tagVal, pCol->colId), TABLE_TID(pTable)) < 0) {
+      tSkipListDestroyIter(pIter);
+      tsdbDropTagIdxCol(pSTable, pCol);
+      return NULL;
+    }
+  }
+  tSkipListDestroyIter(pIter);
+
+  tsdbDebug("tag inverted index of column %d of super table %s is built, %d values", pCol->colId,
+            TABLE_CHAR_NAME(pSTable), taosHashGetSize(pCol->pHash));
+
+  return pCol;
+}
+
+static void tsdbDropTagIdxCol(STable *pSTable, STagIdxCol *pCol) {
+  tsdbWarn("tag inverted index of column %d of super table %s is dropped since %s", pCol->colId,
+           TABLE_CHAR_NAME(pSTable), tstrerror(terrno));
+
+  tsdbFreeTagIdxColHash(pCol->pHash);
+  taosArrayRemove(pSTable->pTagIdx, TARRAY_ELEM_IDX(pSTable->pTagIdx, pCol));
+}
+
+static void tsdbFreeTagIdxColHash(SHashObj *pHash) {
+  // The hash never calls its free function, release the tid lists here
+  SArray **ppTids = (SArray **)taosHashIterate(pHash, NULL);
+  while (ppTids) {
+    taosArrayDestroy(ppTids);
+    ppTids = (SArray **)taosHashIterate(pHash, ppTids);
+  }
+  taosHashCleanup(pHash);
+}
+
+static int tsdbPutTagIdxTid(STagIdxCol *pCol, const void *val, int32_t tid) {
+  int32_t     len = 0;
+  const void *key = tsdbGetTagIdxKey(pCol->type, val, &len);
+
+  SArray **ppTids = (SArray **)taosHashGet(pCol->pHash, key, len);
+  SArray  *pTids = NULL;
+  if (ppTids == NULL) {
+    pTids = taosArrayInit(4, sizeof(int32_t));
+    if (pTids == NULL || taosHashPut(pCol->pHash, key, len, &pTids, sizeof(pTids)) < 0) {
+      terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+      taosArrayDestroy(&pTids);
+      return -1;
+    }
+  } else {
+    pTids = *ppTids;
+  }
+
+  // Tables are mostly created and restored in tid order, so appending is the common case
+  size_t   size = taosArrayGetSize(pTids);
+  int32_t *p = NULL;
+  if (size == 0 || *(int32_t *)taosArrayGetLast(pTids) < tid) {
+    p = taosArrayPush(pTids, &tid);
+  } else if ((p = taosArraySearch(pTids, &tid, tsdbCompareTid, TD_GE)) != NULL && *p != tid) {
+    p = taosArrayInsert(pTids, TARRAY_ELEM_IDX(pTids, p), &tid);
+  }
+
+  if (p == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  return 0;
+}
+
+static void tsdbDelTagIdxTid(STagIdxCol *pCol, const void *val, int32_t tid) {
+  int32_t     len = 0;
+  const void *key = tsdbGetTagIdxKey(pCol->type, val, &len);
+
+  SArray **ppTids = (SArray **)taosHashGet(pCol->pHash, key, len);
+  if (ppTids == NULL) return;
+
+  SArray  *pTids = *ppTids;
+  int32_t *p = taosArraySearch(pTids, &tid, tsdbCompareTid, TD_EQ);
+  if (p == NULL) return;
+
+  taosArrayRemove(pTids, TARRAY_ELEM_IDX(pTids, p));
+  if (taosArrayGetSize(pTids) == 0) {
+    taosArrayDestroy(&pTids);
+    taosHashRemove(pCol->pHash, key, len);
+  }
+}
+
+static int tsdbCompareTid(const void *a, const void *b) {
+  int32_t x = *(const int32_t *)a;
+  int32_t y = *(const int32_t *)b;
+  if (x < y) return -1;
+  if (x > y) return 1;
+  return 0;
+}
+
+// Ascending without duplicates, the order of the lists in the index
+static bool tsdbIsTidsSorted(const SArray *pTids) {
+  for (size_t i = 1; i < taosArrayGetSize(pTids); i++) {
+    if (*(int32_t *)taosArrayGet(pTids, i - 1) >= *(int32_t *)taosArrayGet(pTids, i)) return false;
+  }
+  return true;
+}
+
+static void tsdbSortTids(SArray *pTids) {
+  if (tsdbIsTidsSorted(pTids)) return;
+
+  taosArraySort(pTids, tsdbCompareTid);
+  taosArrayRemoveDuplicate(pTids, tsdbCompareTid, NULL);
+}
+
+static SArray *tsdbSortTidsCopy(const SArray *pTids) {
+  SArray *pCopy = taosArrayDup(pTids);
+  if (pCopy == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  tsdbSortTids(pCopy);
+  return pCopy;
+}
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include "os.h"
+#include "taosdef.h"
+#include "tglobal.h"
+#include "tsdb.h"
+
+#include "tsdbTestUtil.h"
+
+namespace {
+
+const int32_t entryLen = 1000;
+
+// a cache of ten entries of entryLen bytes, eight of them fit in the protected segment
+class TsdbBlkCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // the bytes the cache accounts for an entry, measured on a cache of its own
+    void *pProbe = tsdbTestNewBlkCache(1 << 20);
+    ASSERT_NE(pProbe, nullptr);
+    tsdbTestPutBlkCache(pProbe, 0, 1, 0, entryLen);
+    int64_t protSize = 0;
+    tsdbTestBlkCacheGen(pProbe, &esize, &protSize);
+    tsdbTestFreeBlkCache(pProbe);
+    ASSERT_GT(esize, entryLen);
+
+    pCache = tsdbTestNewBlkCache(10 * esize);
+    ASSERT_NE(pCache, nullptr);
+    gen = tsdbTestBlkCacheGen(pCache, &size, &protSize);
+  }
+
+  void TearDown() override { tsdbTestFreeBlkCache(pCache); }
+
+  void put(int64_t offset) { tsdbTestPutBlkCache(pCache, gen, 1, offset, entryLen); }
+
+  bool get(int64_t offset) {
+    int32_t len = tsdbTestGetBlkCache(pCache, gen, 1, offset);
+    EXPECT_NE(len, -2) << "offset " << offset;
+    return len == entryLen;
+  }
+
+  int64_t cacheSize() {
+    int64_t protSize = 0;
+    tsdbTestBlkCacheGen(pCache, &size, &protSize);
+    return size;
+  }
+
+  int64_t protSize() {
+    int64_t protSize = 0;
+    tsdbTestBlkCacheGen(pCache, &size, &protSize);
+    return protSize;
+  }
+
+  void *   pCache = nullptr;
+  uint32_t gen = 0;
+  int64_t  esize = 0;
+  int64_t  size = 0;
+};
+
+}  // namespace
+
+TEST_F(TsdbBlkCacheTest, promoteOnSecondHit) {
+  for (int64_t offset = 1; offset <= 3; offset++) put(offset);
+  EXPECT_EQ(cacheSize(), 3 * esize);
+  EXPECT_EQ(protSize(), 0);
+
+  // the put is the first reference, the first get promotes and the next ones only refresh
+  EXPECT_TRUE(get(1));
+  EXPECT_EQ(protSize(), esize);
+  EXPECT_TRUE(get(1));
+  EXPECT_EQ(protSize(), esize);
+  EXPECT_TRUE(get(2));
+  EXPECT_EQ(protSize(), 2 * esize);
+  EXPECT_EQ(cacheSize(), 3 * esize);
+
+  EXPECT_FALSE(get(4));
+  EXPECT_EQ(tsdbTestGetBlkCache(pCache, gen, 2, 1), -1);
+  EXPECT_EQ(protSize(), 2 * esize);
+
+  // the same key twice keeps the first entry
+  put(1);
+  EXPECT_EQ(cacheSize(), 3 * esize);
+}
+
+TEST_F(TsdbBlkCacheTest, evictAtCapacity) {
+  for (int64_t offset = 1; offset <= 10; offset++) put(offset);
+  EXPECT_EQ(cacheSize(), 10 * esize);
+  EXPECT_TRUE(get(1));
+  EXPECT_TRUE(get(2));
+
+  // a scan of new blocks only goes through the probation segment
+  for (int64_t offset = 11; offset <= 30; offset++) {
+    put(offset);
+    EXPECT_LE(cacheSize(), 10 * esize);
+  }
+  EXPECT_EQ(cacheSize(), 10 * esize);
+  EXPECT_EQ(protSize(), 2 * esize);
+  EXPECT_TRUE(get(1));
+  EXPECT_TRUE(get(2));
+  for (int64_t offset = 3; offset <= 22; offset++) EXPECT_FALSE(get(offset)) << "offset " << offset;
+  for (int64_t offset = 23; offset <= 30; offset++) EXPECT_TRUE(get(offset)) << "offset " << offset;
+
+  // an entry larger than a quarter of the cache is not kept
+  tsdbTestPutBlkCache(pCache, gen, 1, 100, (int32_t)(3 * esize));
+  EXPECT_EQ(tsdbTestGetBlkCache(pCache, gen, 1, 100), -1);
+  EXPECT_EQ(cacheSize(), 10 * esize);
+}
+
+TEST_F(TsdbBlkCacheTest, demoteFromProtected) {
+  for (int64_t offset = 1; offset <= 10; offset++) put(offset);
+  for (int64_t offset = 1; offset <= 10; offset++) {
+    EXPECT_TRUE(get(offset));
+    EXPECT_LE(protSize(), 8 * esize);
+  }
+
+  // the least recently used entries went back to probation, and the oldest of them goes first
+  EXPECT_EQ(protSize(), 8 * esize);
+  EXPECT_EQ(cacheSize(), 10 * esize);
+  put(11);
+  EXPECT_EQ(cacheSize(), 10 * esize);
+  EXPECT_FALSE(get(1));
+  EXPECT_TRUE(get(2));
+  EXPECT_TRUE(get(11));
+}
+
+TEST_F(TsdbBlkCacheTest, invalidateOnNewGeneration) {
+  put(1);
+  put(2);
+  EXPECT_TRUE(get(1));
+
+  // a file set changed, nothing of the old generation is served
+  uint32_t oldGen = gen;
+  tsdbTestInvalidateBlkCache(pCache);
+  int64_t protSize = 0;
+  gen = tsdbTestBlkCacheGen(pCache, &size, &protSize);
+  EXPECT_EQ(gen, oldGen + 1);
+  EXPECT_EQ(size, 0);
+  EXPECT_EQ(protSize, 0);
+  EXPECT_EQ(tsdbTestGetBlkCache(pCache, oldGen, 1, 1), -1);
+  EXPECT_FALSE(get(1));
+  EXPECT_FALSE(get(2));
+
+  // a reader that opened its file set before the change does not put its blocks back
+  tsdbTestPutBlkCache(pCache, oldGen, 1, 3, entryLen);
+  EXPECT_EQ(cacheSize(), 0);
+  EXPECT_EQ(tsdbTestGetBlkCache(pCache, oldGen, 1, 3), -1);
+
+  put(3);
+  EXPECT_TRUE(get(3));
+}
+
+TEST_F(TsdbBlkCacheTest, cacheColumns) {
+  EXPECT_EQ(tsdbTestBlkCacheCols(pCache, gen, 1, 100), 0);
+
+  tsdbTestInvalidateBlkCache(pCache);
+  EXPECT_EQ(tsdbTestBlkCacheCols(pCache, gen, 1, 100), -1);
+}
+
+// the .head file index parts cached by a read are not those of the file set that replaces it
+TEST(TsdbBlkIdxCacheTest, invalidateOnFileSetChange) {
+  int32_t oldIdxCacheSize = tsdbBlkIdxCacheSize;
+  bool    oldForceCompact = tsdbForceCompactFile;
+  tsdbBlkIdxCacheSize = 1;
+  ASSERT_EQ(tsdbInitCommitQueue(), 0);
+
+  char dir[PATH_MAX];
+  snprintf(dir, sizeof(dir), "%s/tsdbBlkIdxCacheTestXXXXXX", tsTempDir);
+  ASSERT_NE(mkdtemp(dir), nullptr) << strerror(errno);
+
+  STsdbRepo *pRepo = tsdbTestOpenRepo(dir, 0);
+  ASSERT_NE(pRepo, nullptr);
+  void *pIdxCache = tsdbTestBlkIdxCache(pRepo);
+  ASSERT_NE(pIdxCache, nullptr);
+
+  // rows of one file set, the rows of a key are those of its last insert
+  std::map<int64_t, int32_t> rows;
+  auto insert = [&](int from, int to, int step) {
+    std::vector<int64_t> keys;
+    std::vector<int32_t> vals;
+    for (int i = from; i < to; i += step) {
+      keys.push_back(tsdbTestBaseKey() + i * 1000L);
+      vals.push_back(i);
+      rows[keys.back()] = i;
+    }
+    ASSERT_EQ(tsdbTestInsert(pRepo, keys.data(), vals.data(), (int)keys.size()), 0);
+  };
+
+  std::vector<int64_t> readKeys(20000);
+  std::vector<int32_t> readVals(20000);
+  int                  nSubBlocks = 0;
+  auto check = [&]() {
+    for (int n = 0; n < 2; n++) {
+      int nRows = tsdbTestReadFSets(pRepo, readKeys.data(), readVals.data(), (int)readKeys.size(), &nSubBlocks);
+      ASSERT_EQ(nRows, (int)rows.size()) << "read " << n;
+      int i = 0;
+      for (auto it = rows.begin(); it != rows.end(); ++it, i++) {
+        ASSERT_EQ(readKeys[i], it->first) << "read " << n << " row " << i;
+        ASSERT_EQ(readVals[i], it->second) << "read " << n << " row " << i;
+      }
+    }
+  };
+
+  int64_t  size = 0, protSize = 0;
+  uint32_t gen = tsdbTestBlkCacheGen(pIdxCache, &size, &protSize);
+
+  insert(0, 10000, 2);
+  ASSERT_EQ(tsdbSyncCommit(pRepo), 0);
+  check();
+  uint32_t newGen = tsdbTestBlkCacheGen(pIdxCache, &size, &protSize);
+  EXPECT_NE(newGen, gen);
+  EXPECT_GT(size, 0);
+  EXPECT_GT(protSize, 0);
+
+  // the new rows fall in the last block of the committed file set, they are written as a sub-block of it
+  gen = newGen;
+  insert(9601, 9801, 2);
+  ASSERT_EQ(tsdbSyncCommit(pRepo), 0);
+  check();
+  newGen = tsdbTestBlkCacheGen(pIdxCache, &size, &protSize);
+  EXPECT_NE(newGen, gen);
+  EXPECT_GT(nSubBlocks, 0);
+
+  // the compaction merges the sub-blocks
+  gen = newGen;
+  tsdbForceCompactFile = true;
+  ASSERT_EQ(tsdbCompact(pRepo), 0);
+  ASSERT_EQ(tsdbSyncCommit(pRepo), 0);
+  check();
+  newGen = tsdbTestBlkCacheGen(pIdxCache, &size, &protSize);
+  EXPECT_NE(newGen, gen);
+  EXPECT_EQ(nSubBlocks, 0);
+
+  tsdbTestCloseRepo(pRepo, false);
+  tsdbDestroyCommitQueue();
+  taosRemoveDir(dir);
+  tsdbForceCompactFile = oldForceCompact;
+  tsdbBlkIdxCacheSize = oldIdxCacheSize;
+}
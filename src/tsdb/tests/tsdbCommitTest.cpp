@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <dirent.h>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "os.h"
+#include "taosdef.h"
+#include "tglobal.h"
+#include "tsdb.h"
+
+#include "tsdbTestUtil.h"
+
+namespace {
+
+// relative path of every file under dir and its content
+void readFiles(const std::string &dir, const std::string &rel, std::map<std::string, std::string> &files) {
+  DIR *pDir = opendir((dir + "/" + rel).c_str());
+  ASSERT_NE(pDir, nullptr) << dir << "/" << rel;
+
+  struct dirent *pEntry;
+  while ((pEntry = readdir(pDir)) != NULL) {
+    std::string name = pEntry->d_name;
+    if (name == "." || name == "..") continue;
+
+    std::string path = rel.empty() ? name : rel + "/" + name;
+    if (pEntry->d_type == DT_DIR) {
+      readFiles(dir, path, files);
+    } else {
+      std::ifstream     in(dir + "/" + path, std::ios::binary);
+      std::stringstream ss;
+      ss << in.rdbuf();
+      files[path] = ss.str();
+    }
+  }
+  closedir(pDir);
+}
+
+class TsdbCommitTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    oldCommitThreads = tsNumOfCommitThreads;
+    oldFSetThreads = tsdbCommitFSetThreads;
+    oldMemColBuffer = tsdbMemColBuffer;
+  }
+
+  void TearDown() override {
+    tsNumOfCommitThreads = oldCommitThreads;
+    tsdbCommitFSetThreads = oldFSetThreads;
+    tsdbMemColBuffer = oldMemColBuffer;
+  }
+
+  void insert(STsdbRepo *pRepo, const std::map<int64_t, int32_t> &rows) {
+    std::vector<int64_t> keys;
+    std::vector<int32_t> vals;
+    for (auto it = rows.begin(); it != rows.end(); ++it) {
+      keys.push_back(it->first);
+      vals.push_back(it->second);
+    }
+    ASSERT_EQ(tsdbTestInsert(pRepo, keys.data(), vals.data(), (int)keys.size()), 0);
+  }
+
+  // writes the same rows over several file sets into a new repository in dir, commits them, writes rows into the
+  // committed file sets and into new ones and commits again
+  void writeRepo(const char *dir, int32_t fsetThreads) {
+    tsdbCommitFSetThreads = fsetThreads;
+    ASSERT_EQ(tsdbInitCommitQueue(), 0);
+
+    STsdbRepo *pRepo = tsdbTestOpenRepo(dir, 1);
+    ASSERT_NE(pRepo, nullptr);
+
+    int64_t day = 86400000L;
+    int64_t first = tsdbTestBaseKey() - 80 * day;
+
+    std::map<int64_t, int32_t> rows;
+    for (int i = 0; i < 20000; i++) {
+      rows[first + i * (75 * day / 20000)] = i;
+    }
+    insert(pRepo, rows);
+    ASSERT_EQ(tsdbSyncCommit(pRepo), 0);
+
+    srand(1);
+    rows.clear();
+    for (int i = 0; i < 5000; i++) {
+      rows[first + (rand() % 80) * day + rand() % day] = 100000 + i;
+    }
+    insert(pRepo, rows);
+
+    tsdbTestCloseRepo(pRepo, true);
+    tsdbDestroyCommitQueue();
+  }
+
+  int32_t oldCommitThreads;
+  int32_t oldFSetThreads;
+  int32_t oldMemColBuffer;
+};
+
+}  // namespace
+
+TEST_F(TsdbCommitTest, commitFileSetsInParallel) {
+  tsNumOfCommitThreads = 4;
+
+  for (int32_t colBuf = 0; colBuf <= 1; colBuf++) {
+    SCOPED_TRACE(testing::Message() << "memColumnBuffer " << colBuf);
+    tsdbMemColBuffer = colBuf;
+
+    char serialDir[PATH_MAX], parallelDir[PATH_MAX];
+    snprintf(serialDir, sizeof(serialDir), "%s/tsdbCommitTestXXXXXX", tsTempDir);
+    snprintf(parallelDir, sizeof(parallelDir), "%s/tsdbCommitTestXXXXXX", tsTempDir);
+    ASSERT_NE(mkdtemp(serialDir), nullptr) << strerror(errno);
+    ASSERT_NE(mkdtemp(parallelDir), nullptr) << strerror(errno);
+
+    writeRepo(serialDir, 1);
+    writeRepo(parallelDir, 4);
+
+    // the same files with the same content
+    std::map<std::string, std::string> serialFiles, parallelFiles;
+    readFiles(serialDir, "vnode/vnode1/tsdb", serialFiles);
+    readFiles(parallelDir, "vnode/vnode1/tsdb", parallelFiles);
+
+    int nDataFiles = 0;
+    for (auto it = serialFiles.begin(); it != serialFiles.end(); ++it) {
+      if (it->first.find(".data") != std::string::npos) nDataFiles++;
+    }
+    EXPECT_GT(nDataFiles, 4);
+
+    ASSERT_EQ(serialFiles.size(), parallelFiles.size());
+    for (auto it = serialFiles.begin(); it != serialFiles.end(); ++it) {
+      ASSERT_EQ(parallelFiles.count(it->first), 1) << it->first;
+      EXPECT_TRUE(parallelFiles[it->first] == it->second) << it->first << " differs";
+    }
+
+    taosRemoveDir(serialDir);
+    taosRemoveDir(parallelDir);
+    if (HasFatalFailure()) return;
+  }
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "os.h"
+#include "taosdef.h"
+#include "tscompression.h"
+#include "tglobal.h"
+
+#include "tsdbTestUtil.h"
+
+namespace {
+
+class TsdbDecodeTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    snprintf(dir, sizeof(dir), "%s/tsdbDecodeTestXXXXXX", tsTempDir);
+    ASSERT_NE(mkdtemp(dir), nullptr) << strerror(errno);
+  }
+
+  void TearDown() override { rmdir(dir); }
+
+  char dir[PATH_MAX];
+};
+
+}  // namespace
+
+TEST_F(TsdbDecodeTest, decodeColumnsInParallel) {
+  int8_t comps[] = {NO_COMPRESSION, ONE_STAGE_COMP, TWO_STAGE_COMP};
+  int    threads[] = {0, 1, 3, 7};
+  int    ncols[] = {2, 8, 33, 128};
+  char   msg[256] = {0};
+
+  for (size_t c = 0; c < tListLen(comps); c++) {
+    for (size_t t = 0; t < tListLen(threads); t++) {
+      for (size_t n = 0; n < tListLen(ncols); n++) {
+        ASSERT_EQ(tsdbTestDecodeBlock(dir, ncols[n], 4096, comps[c], threads[t], msg, sizeof(msg)), 0)
+            << msg << ", compression " << (int)comps[c] << " threads " << threads[t] << " columns " << ncols[n];
+      }
+    }
+  }
+
+  // a block that is not full
+  ASSERT_EQ(tsdbTestDecodeBlock(dir, 16, 17, TWO_STAGE_COMP, 3, msg, sizeof(msg)), 0) << msg;
+}
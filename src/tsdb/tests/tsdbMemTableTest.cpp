@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <iostream>
+#include <map>
+#include <vector>
+#include <iterator>
+
+#include "os.h"
+#include "taosdef.h"
+#include "tglobal.h"
+
+#include "tsdbTestUtil.h"
+
+namespace {
+
+class TsdbMemTableTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    snprintf(dir, sizeof(dir), "%s/tsdbMemTableTestXXXXXX", tsTempDir);
+    ASSERT_NE(mkdtemp(dir), nullptr) << strerror(errno);
+    oldMemColBuffer = tsdbMemColBuffer;
+    base = tsdbTestBaseKey();
+  }
+
+  void TearDown() override {
+    tsdbMemColBuffer = oldMemColBuffer;
+    taosRemoveDir(dir);
+  }
+
+  // the rows of a submit block are sorted and unique, as the client sends them
+  void insert(STsdbRepo *pRepo, const std::map<int64_t, int32_t> &rows) {
+    std::vector<int64_t> keys;
+    std::vector<int32_t> vals;
+    for (auto it = rows.begin(); it != rows.end(); ++it) {
+      keys.push_back(it->first);
+      vals.push_back(it->second);
+      if (expect.count(it->first) == 0 || update != 0) expect[it->first] = it->second;
+    }
+    ASSERT_EQ(tsdbTestInsert(pRepo, keys.data(), vals.data(), (int)keys.size()), 0);
+  }
+
+  // every way of reading the memtable gives the expected rows
+  void checkMem(STsdbRepo *pRepo) {
+    int                  n = (int)expect.size();
+    std::vector<int64_t> keys(n + 1);
+    std::vector<int32_t> vals(n + 1);
+
+    ASSERT_EQ(tsdbTestIterMem(pRepo, INT64_MIN, TSDB_ORDER_ASC, keys.data(), vals.data(), n + 1), n);
+    int i = 0;
+    for (auto it = expect.begin(); it != expect.end(); ++it, ++i) {
+      ASSERT_EQ(keys[i], it->first) << "row " << i;
+      ASSERT_EQ(vals[i], it->second) << "row " << i;
+    }
+
+    ASSERT_EQ(tsdbTestIterMem(pRepo, INT64_MAX, TSDB_ORDER_DESC, keys.data(), vals.data(), n + 1), n);
+    i = 0;
+    for (auto it = expect.rbegin(); it != expect.rend(); ++it, ++i) {
+      ASSERT_EQ(keys[i], it->first) << "row " << i;
+      ASSERT_EQ(vals[i], it->second) << "row " << i;
+    }
+
+    // from a key in the middle, which may not be there
+    int64_t mid = expect.begin()->first + (expect.rbegin()->first - expect.begin()->first) / 2 + 1;
+    int     nAsc = (int)std::distance(expect.lower_bound(mid), expect.end());
+    int     nDesc = (int)std::distance(expect.begin(), expect.upper_bound(mid));
+    ASSERT_EQ(tsdbTestIterMem(pRepo, mid, TSDB_ORDER_ASC, keys.data(), vals.data(), n + 1), nAsc);
+    ASSERT_EQ(keys[0], expect.lower_bound(mid)->first);
+    ASSERT_EQ(tsdbTestIterMem(pRepo, mid, TSDB_ORDER_DESC, keys.data(), vals.data(), n + 1), nDesc);
+    ASSERT_EQ(keys[0], std::prev(expect.upper_bound(mid))->first);
+
+    // as the commit reads it, in batches that end inside chunks or runs
+    int batches[] = {1, 7, 100, 4096};
+    for (size_t b = 0; b < tListLen(batches); b++) {
+      ASSERT_EQ(tsdbTestLoadMem(pRepo, INT64_MAX, batches[b], keys.data(), vals.data(), n + 1), n)
+          << "batch " << batches[b];
+      i = 0;
+      for (auto it = expect.begin(); it != expect.end(); ++it, ++i) {
+        ASSERT_EQ(keys[i], it->first) << "batch " << batches[b] << " row " << i;
+        ASSERT_EQ(vals[i], it->second) << "batch " << batches[b] << " row " << i;
+      }
+    }
+
+    // up to a key in the middle, with and without a bound on the rows, and without a bound from a key in the middle
+    ASSERT_EQ(tsdbTestLoadMem(pRepo, mid, 100, keys.data(), vals.data(), n + 1), nDesc);
+    ASSERT_EQ(tsdbTestCountMem(pRepo, INT64_MIN, mid), nDesc);
+    ASSERT_EQ(tsdbTestCountMem(pRepo, INT64_MIN, INT64_MAX), n);
+    ASSERT_EQ(tsdbTestCountMem(pRepo, mid, INT64_MAX), nAsc);
+  }
+
+  char                       dir[PATH_MAX];
+  int32_t                    oldMemColBuffer;
+  int64_t                    base;
+  int8_t                     update = 0;
+  std::map<int64_t, int32_t> expect;
+};
+
+}  // namespace
+
+TEST_F(TsdbMemTableTest, appendInOrderRows) {
+  tsdbMemColBuffer = 1;
+  STsdbRepo *pRepo = tsdbTestOpenRepo(dir, update);
+  ASSERT_NE(pRepo, nullptr);
+
+  // several submits, enough rows to fill chunks of every size
+  for (int s = 0; s < 10; s++) {
+    std::map<int64_t, int32_t> rows;
+    for (int i = 0; i < 1000; i++) {
+      rows[base + (s * 1000 + i) * 1000L] = s * 1000 + i;
+    }
+    insert(pRepo, rows);
+  }
+
+  EXPECT_EQ(tsdbTestMemColRows(pRepo), 10000);
+  EXPECT_EQ(tsdbTestMemSkipListRows(pRepo), 0);
+  checkMem(pRepo);
+
+  tsdbTestCloseRepo(pRepo, false);
+}
+
+TEST_F(TsdbMemTableTest, mergeOutOfOrderRows) {
+  int8_t updates[] = {0, 1};
+  for (size_t u = 0; u < tListLen(updates); u++) {
+    for (int32_t colBuf = 0; colBuf <= 1; colBuf++) {
+      SCOPED_TRACE(testing::Message() << "update " << (int)updates[u] << " memColumnBuffer " << colBuf);
+      taosRemoveDir(dir);
+      taosMkDir(dir, 0755);
+      expect.clear();
+      update = updates[u];
+      tsdbMemColBuffer = colBuf;
+
+      STsdbRepo *pRepo = tsdbTestOpenRepo(dir, update);
+      ASSERT_NE(pRepo, nullptr);
+
+      // in-order rows with gaps, then rows in the gaps, updates of appended rows and more in-order rows
+      std::map<int64_t, int32_t> rows;
+      for (int i = 0; i < 3000; i++) {
+        rows[base + i * 10000L] = i;
+      }
+      insert(pRepo, rows);
+
+      srand(1);
+      rows.clear();
+      for (int i = 0; i < 500; i++) {
+        rows[base + (rand() % 3000) * 10000L + ((i % 2 == 0) ? 5000 : 0)] = 100000 + i;
+      }
+      insert(pRepo, rows);
+
+      rows.clear();
+      for (int i = 3000; i < 4000; i++) {
+        rows[base + i * 10000L] = i;
+      }
+      insert(pRepo, rows);
+
+      if (colBuf) {
+        EXPECT_GT(tsdbTestMemColRows(pRepo), 0);
+      } else {
+        EXPECT_EQ(tsdbTestMemColRows(pRepo), 0);
+      }
+      EXPECT_GT(tsdbTestMemSkipListRows(pRepo), 0);
+      checkMem(pRepo);
+
+      tsdbTestCloseRepo(pRepo, false);
+      if (HasFatalFailure()) return;
+    }
+  }
+}
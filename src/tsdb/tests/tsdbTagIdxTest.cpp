@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include "os.h"
+#include "tarray.h"
+
+// tsdbTagIdx.h needs tsdbint.h, which does not compile as C++
+extern "C" {
+int     tsdbIntersectTids(SArray* pTids, const SArray* pOther);
+SArray* tsdbMergeTids(SArray* pTids, const SArray* pOther);
+}
+
+namespace {
+
+SArray* toArray(const std::vector<int32_t>& tids) {
+  SArray* pArray = (SArray*)taosArrayInit(tids.size() + 1, sizeof(int32_t));
+  for (size_t i = 0; i < tids.size(); i++) {
+    taosArrayPush(pArray, &tids[i]);
+  }
+  return pArray;
+}
+
+std::vector<int32_t> toVector(const SArray* pArray) {
+  std::vector<int32_t> tids;
+  for (size_t i = 0; i < taosArrayGetSize(pArray); i++) {
+    tids.push_back(*(int32_t*)taosArrayGet(pArray, i));
+  }
+  return tids;
+}
+
+std::vector<int32_t> intersect(const std::vector<int32_t>& a, const std::vector<int32_t>& b) {
+  SArray* pTids = toArray(a);
+  SArray* pOther = toArray(b);
+
+  EXPECT_EQ(tsdbIntersectTids(pTids, pOther), 0);
+  EXPECT_EQ(toVector(pOther), b);
+
+  std::vector<int32_t> res = toVector(pTids);
+  taosArrayDestroy(&pTids);
+  taosArrayDestroy(&pOther);
+  return res;
+}
+
+std::vector<int32_t> merge(const std::vector<int32_t>& a, const std::vector<int32_t>& b) {
+  SArray* pOther = toArray(b);
+  SArray* pTids = tsdbMergeTids(toArray(a), pOther);
+
+  EXPECT_NE(pTids, nullptr);
+  EXPECT_EQ(toVector(pOther), b);
+
+  std::vector<int32_t> res = toVector(pTids);
+  taosArrayDestroy(&pTids);
+  taosArrayDestroy(&pOther);
+  return res;
+}
+
+typedef std::vector<int32_t> Tids;
+
+}  // namespace
+
+TEST(TsdbTagIdxTest, emptyTids) {
+  EXPECT_EQ(intersect({}, {}), Tids({}));
+  EXPECT_EQ(intersect({}, {1, 2}), Tids({}));
+  EXPECT_EQ(intersect({1, 2}, {}), Tids({}));
+
+  EXPECT_EQ(merge({}, {}), Tids({}));
+  EXPECT_EQ(merge({}, {1, 2}), Tids({1, 2}));
+  EXPECT_EQ(merge({1, 2}, {}), Tids({1, 2}));
+
+  // a value missing from the index has no list
+  SArray* pTids = toArray({1, 2});
+  EXPECT_EQ(tsdbIntersectTids(pTids, NULL), 0);
+  EXPECT_EQ(toVector(pTids), Tids({}));
+  taosArrayDestroy(&pTids);
+
+  pTids = tsdbMergeTids(toArray({1, 2}), NULL);
+  EXPECT_EQ(toVector(pTids), Tids({1, 2}));
+  taosArrayDestroy(&pTids);
+}
+
+TEST(TsdbTagIdxTest, disjointTids) {
+  EXPECT_EQ(intersect({1, 3, 5}, {2, 4, 6}), Tids({}));
+  EXPECT_EQ(intersect({1, 2}, {10, 11}), Tids({}));
+  EXPECT_EQ(intersect({10, 11}, {1, 2}), Tids({}));
+
+  EXPECT_EQ(merge({1, 3, 5}, {2, 4, 6}), Tids({1, 2, 3, 4, 5, 6}));
+  EXPECT_EQ(merge({1, 2}, {10, 11}), Tids({1, 2, 10, 11}));
+  EXPECT_EQ(merge({10, 11}, {1, 2}), Tids({1, 2, 10, 11}));
+  EXPECT_EQ(merge({0, INT32_MAX - 1}, {1}), Tids({0, 1, INT32_MAX - 1}));
+}
+
+TEST(TsdbTagIdxTest, overlappingTids) {
+  EXPECT_EQ(intersect({1, 2, 3}, {1, 2, 3}), Tids({1, 2, 3}));
+  EXPECT_EQ(intersect({1, 2, 3, 7}, {2, 3, 4}), Tids({2, 3}));
+  EXPECT_EQ(intersect({5}, {1, 5, 9}), Tids({5}));
+
+  EXPECT_EQ(merge({1, 2, 3}, {1, 2, 3}), Tids({1, 2, 3}));
+  EXPECT_EQ(merge({1, 2, 3, 7}, {2, 3, 4}), Tids({1, 2, 3, 4, 7}));
+}
+
+TEST(TsdbTagIdxTest, duplicateTids) {
+  EXPECT_EQ(intersect({1, 1, 2, 3}, {1, 3, 3}), Tids({1, 3}));
+  EXPECT_EQ(intersect({4, 4}, {4, 4}), Tids({4}));
+
+  EXPECT_EQ(merge({2, 2, 5}, {1, 5, 5}), Tids({1, 2, 5}));
+  EXPECT_EQ(merge({4, 4}, {}), Tids({4}));
+}
+
+TEST(TsdbTagIdxTest, unsortedTids) {
+  EXPECT_EQ(intersect({5, 1, 3}, {3, 9, 1}), Tids({1, 3}));
+  EXPECT_EQ(intersect({1, 3, 5}, {9, 5, 1}), Tids({1, 5}));
+  EXPECT_EQ(intersect({9, 5, 1}, {1, 3, 5}), Tids({1, 5}));
+
+  EXPECT_EQ(merge({5, 1}, {4, 1, 9}), Tids({1, 4, 5, 9}));
+  EXPECT_EQ(merge({3, 1, 3}, {}), Tids({1, 3}));
+  EXPECT_EQ(merge({}, {3, 1, 3}), Tids({1, 3}));
+}
+
+TEST(TsdbTagIdxTest, randomTids) {
+  srand(1);
+  for (int round = 0; round < 200; round++) {
+    Tids a, b;
+    for (int i = rand() % 300; i > 0; i--) a.push_back(rand() % 500);
+    for (int i = rand() % 300; i > 0; i--) b.push_back(rand() % 500);
+    if (round % 2 == 0) {
+      std::sort(a.begin(), a.end());
+      a.erase(std::unique(a.begin(), a.end()), a.end());
+      std::sort(b.begin(), b.end());
+      b.erase(std::unique(b.begin(), b.end()), b.end());
+    }
+
+    std::set<int32_t> sa(a.begin(), a.end()), sb(b.begin(), b.end());
+    Tids              inter, uni;
+    std::set_intersection(sa.begin(), sa.end(), sb.begin(), sb.end(), std::back_inserter(inter));
+    std::set_union(sa.begin(), sa.end(), sb.begin(), sb.end(), std::back_inserter(uni));
+
+    EXPECT_EQ(intersect(a, b), inter) << "round " << round;
+    EXPECT_EQ(merge(a, b), uni) << "round " << round;
+  }
+}
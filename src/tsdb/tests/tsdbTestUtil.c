@@ -0,0 +1,484 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tsdbint.h"
+#include "tsdbTestUtil.h"
+
+static int tsdbTestOpenDFile(SDFile *pDFile, const char *fname) {
+  memset(pDFile, 0, sizeof(*pDFile));
+  tstrncpy(pDFile->f.aname, fname, sizeof(pDFile->f.aname));
+  pDFile->fd = open(fname, O_RDWR | O_CREAT | O_TRUNC, 0755);
+  return pDFile->fd;
+}
+
+int tsdbTestDecodeBlock(const char *dir, int ncols, int rows, int8_t comp, int threads, char *msg, int msgLen) {
+  char dataFile[PATH_MAX], smadFile[PATH_MAX];
+  snprintf(dataFile, sizeof(dataFile), "%s/v1f1.data", dir);
+  snprintf(smadFile, sizeof(smadFile), "%s/v1f1.smad", dir);
+
+  STsdbRepo repo;
+  memset(&repo, 0, sizeof(repo));
+  repo.config.compression = comp;
+  repo.config.maxRowsPerFileBlock = rows;
+  repo.config.minRowsPerFileBlock = 1;
+
+  STable table;
+  memset(&table, 0, sizeof(table));
+  table.tableId.uid = 1;
+
+  STSchemaBuilder builder;
+  tdInitTSchemaBuilder(&builder, 0);
+  tdAddColToSchema(&builder, TSDB_DATA_TYPE_TIMESTAMP, 0, sizeof(TSKEY));
+  for (int i = 1; i < ncols; i++) {
+    tdAddColToSchema(&builder, TSDB_DATA_TYPE_DOUBLE, i, sizeof(double));
+  }
+  STSchema *pSchema = tdGetSchemaFromBuilder(&builder);
+  tdDestroyTSchemaBuilder(&builder);
+
+  SDataCols *pCols = tdNewDataCols(ncols, rows);
+  tdInitDataCols(pCols, pSchema);
+
+  // timestamps with a fixed step and random walk values, close to what sensors write
+  srand(ncols);
+  for (int i = 0; i < ncols; i++) {
+    SDataCol *pCol = pCols->cols + i;
+    double    v = rand() % 100;
+
+    tdAllocMemForCol(pCol, rows);
+    for (int r = 0; r < rows; r++) {
+      if (i == 0) {
+        ((TSKEY *)pCol->pData)[r] = 1600000000000L + r * 1000;
+      } else {
+        v += (rand() % 200 - 100) / 100.0;
+        ((double *)pCol->pData)[r] = v;
+      }
+    }
+    pCol->len = pCol->bytes * rows;
+  }
+  pCols->numOfRows = rows;
+
+  SDFile dFile, aFile;
+  SBlock block = {0};
+  SReadH readh = {0};
+  void * pBuf = NULL, *pCBuf = NULL, *pExBuf = NULL;
+  bool   poolInited = false;
+  int    ret = -1;
+
+  dFile.fd = -1;
+  aFile.fd = -1;
+  if (tsdbTestOpenDFile(&dFile, dataFile) < 0 || tsdbTestOpenDFile(&aFile, smadFile) < 0) {
+    snprintf(msg, msgLen, "failed to open test files since %s", strerror(errno));
+    goto _over;
+  }
+
+  if (tsdbWriteBlockImpl(&repo, &table, &dFile, &aFile, pCols, &block, false, true, &pBuf, &pCBuf, &pExBuf) < 0) {
+    snprintf(msg, msgLen, "failed to write block since %s", tstrerror(terrno));
+    goto _over;
+  }
+
+  tsdbBlkDecodeThreads = threads;
+  if (tsdbInitDecodePool() < 0) {
+    snprintf(msg, msgLen, "failed to init decode pool since %s", tstrerror(terrno));
+    goto _over;
+  }
+  poolInited = true;
+
+  tsdbInitReadH(&readh, &repo);
+  tdInitDataCols(readh.pDCols[0], pSchema);
+  tdInitDataCols(readh.pDCols[1], pSchema);
+  readh.rSet.files[TSDB_FILE_DATA] = dFile;
+
+  // load it twice, so that the buffers of the read handle are reused
+  for (int i = 0; i < 2; i++) {
+    if (tsdbLoadBlockData(&readh, &block, NULL) < 0) {
+      snprintf(msg, msgLen, "failed to load block since %s", tstrerror(terrno));
+      goto _over;
+    }
+
+    SDataCols *pRCols = readh.pDCols[0];
+    if (pRCols->numOfRows != rows) {
+      snprintf(msg, msgLen, "%d rows loaded, %d written", pRCols->numOfRows, rows);
+      goto _over;
+    }
+
+    for (int c = 0; c < ncols; c++) {
+      if (pRCols->cols[c].len != pCols->cols[c].len ||
+          memcmp(pRCols->cols[c].pData, pCols->cols[c].pData, pCols->cols[c].len) != 0) {
+        snprintf(msg, msgLen, "column %d is not decoded to what was written", c);
+        goto _over;
+      }
+    }
+  }
+
+  ret = 0;
+
+_over:
+  if (dFile.fd >= 0) close(dFile.fd);
+  if (aFile.fd >= 0) close(aFile.fd);
+  if (readh.pRepo != NULL) tsdbDestroyReadH(&readh);
+  if (poolInited) tsdbDestroyDecodePool();
+  tdFreeDataCols(pCols);
+  tdFreeSchema(pSchema);
+  taosTZfree(pBuf);
+  taosTZfree(pCBuf);
+  taosTZfree(pExBuf);
+  remove(dataFile);
+  remove(smadFile);
+
+  return ret;
+}
+
+#define TSDB_TEST_BINARY_LEN 16
+
+static STSchema *tsdbTestSchema() {
+  STSchemaBuilder builder;
+  tdInitTSchemaBuilder(&builder, 0);
+  tdAddColToSchema(&builder, TSDB_DATA_TYPE_TIMESTAMP, PRIMARYKEY_TIMESTAMP_COL_INDEX, sizeof(TSKEY));
+  tdAddColToSchema(&builder, TSDB_DATA_TYPE_INT, 1, sizeof(int32_t));
+  tdAddColToSchema(&builder, TSDB_DATA_TYPE_BINARY, 2, TSDB_TEST_BINARY_LEN + VARSTR_HEADER_SIZE);
+  STSchema *pSchema = tdGetSchemaFromBuilder(&builder);
+  tdDestroyTSchemaBuilder(&builder);
+  return pSchema;
+}
+
+STsdbRepo *tsdbTestOpenRepo(const char *dir, int8_t update) {
+  SDiskCfg disk = {0};
+  tstrncpy(disk.dir, dir, sizeof(disk.dir));
+  disk.level = 0;
+  disk.primary = 1;
+  if (tfsInit(&disk, 1) < 0) return NULL;
+
+  if (tfsMkdir("vnode") < 0 || tfsMkdir("vnode/vnode1") < 0 || tsdbCreateRepo(1) < 0) {
+    tfsDestroy();
+    return NULL;
+  }
+
+  STsdbCfg cfg;
+  memset(&cfg, -1, sizeof(cfg));
+  cfg.tsdbId = 1;
+  cfg.cacheBlockSize = 16;
+  cfg.totalBlocks = 6;
+  cfg.keep = cfg.keep1 = cfg.keep2 = TSDB_DEFAULT_KEEP;
+  cfg.update = update;
+  cfg.cacheLastRow = 0;
+
+  STsdbAppH appH = {0};
+  STsdbRepo *pRepo = tsdbOpenRepo(&cfg, &appH);
+  if (pRepo == NULL) {
+    tfsDestroy();
+    return NULL;
+  }
+
+  STableCfg *pTableCfg = calloc(1, sizeof(STableCfg));
+  pTableCfg->type = TSDB_NORMAL_TABLE;
+  pTableCfg->name = strdup("t1");
+  pTableCfg->tableId.tid = TSDB_TEST_TID;
+  pTableCfg->tableId.uid = TSDB_TEST_UID;
+  pTableCfg->superUid = TSDB_INVALID_SUPER_TABLE_ID;
+  pTableCfg->schema = tsdbTestSchema();
+
+  int code = tsdbCreateTable(pRepo, pTableCfg);
+  tsdbClearTableCfg(pTableCfg);
+  if (code < 0) {
+    tsdbTestCloseRepo(pRepo, false);
+    return NULL;
+  }
+
+  return pRepo;
+}
+
+void tsdbTestCloseRepo(STsdbRepo *pRepo, bool toCommit) {
+  tsdbCloseRepo(pRepo, toCommit ? 1 : 0);
+  tfsDestroy();
+}
+
+int64_t tsdbTestBaseKey() {
+  int64_t day = tsTickPerDay[TSDB_TIME_PRECISION_MILLI];
+  return (taosGetTimestampMs() / day - 3) * day;
+}
+
+int tsdbTestInsert(STsdbRepo *pRepo, const int64_t *keys, const int32_t *vals, int nRows) {
+  STSchema *pSchema = tsdbTestSchema();
+  int       rowBytes = memRowMaxBytesFromSchema(pSchema);
+
+  SSubmitMsg *pMsg = calloc(1, sizeof(SSubmitMsg) + sizeof(SSubmitBlk) + (size_t)rowBytes * nRows);
+  SSubmitBlk *pBlock = (SSubmitBlk *)pMsg->blocks;
+
+  for (int i = 0; i < nRows; i++) {
+    SMemRow row = POINTER_SHIFT(pBlock->data, pBlock->dataLen);
+    memRowSetType(row, SMEM_ROW_DATA);
+    SDataRow dRow = memRowDataBody(row);
+    tdInitDataRow(dRow, pSchema);
+
+    char str[VARSTR_HEADER_SIZE + TSDB_TEST_BINARY_LEN];
+    varDataSetLen(str, snprintf(varDataVal(str), TSDB_TEST_BINARY_LEN, "s%d", vals[i]));
+
+    tdAppendColVal(dRow, &keys[i], TSDB_DATA_TYPE_TIMESTAMP, schemaColAt(pSchema, 0)->offset);
+    tdAppendColVal(dRow, &vals[i], TSDB_DATA_TYPE_INT, schemaColAt(pSchema, 1)->offset);
+    tdAppendColVal(dRow, str, TSDB_DATA_TYPE_BINARY, schemaColAt(pSchema, 2)->offset);
+    pBlock->dataLen += memRowTLen(row);
+  }
+
+  int32_t length = (int32_t)(sizeof(SSubmitMsg) + sizeof(SSubmitBlk) + pBlock->dataLen);
+  pBlock->uid = htobe64(TSDB_TEST_UID);
+  pBlock->tid = htonl(TSDB_TEST_TID);
+  pBlock->sversion = htonl(schemaVersion(pSchema));
+  pBlock->dataLen = htonl(pBlock->dataLen);
+  pBlock->numOfRows = htons((int16_t)nRows);
+  pMsg->length = htonl(length);
+  pMsg->numOfBlocks = htonl(1);
+
+  int code = tsdbInsertData(pRepo, pMsg, NULL, NULL);
+
+  free(pMsg);
+  tdFreeSchema(pSchema);
+  return code;
+}
+
+static STableData *tsdbTestTableData(STsdbRepo *pRepo) {
+  SMemTable *pMem = pRepo->mem;
+  if (pMem == NULL || TSDB_TEST_TID >= pMem->maxTables) return NULL;
+
+  return pMem->tData[TSDB_TEST_TID];
+}
+
+int64_t tsdbTestMemColRows(STsdbRepo *pRepo) {
+  STableData *pTableData = tsdbTestTableData(pRepo);
+  return (pTableData == NULL || pTableData->pColBuf == NULL) ? 0 : pTableData->pColBuf->numOfRows;
+}
+
+int64_t tsdbTestMemSkipListRows(STsdbRepo *pRepo) {
+  STableData *pTableData = tsdbTestTableData(pRepo);
+  return (pTableData == NULL) ? 0 : (int64_t)SL_SIZE(pTableData->pData);
+}
+
+// a row is consistent if its s column is "s" followed by its v column
+static bool tsdbTestCheckVal(int32_t v, const void *str) {
+  char expect[TSDB_TEST_BINARY_LEN];
+  int  len = snprintf(expect, sizeof(expect), "s%d", v);
+  return varDataLen(str) == len && memcmp(varDataVal(str), expect, len) == 0;
+}
+
+int tsdbTestIterMem(STsdbRepo *pRepo, int64_t startKey, int32_t order, int64_t *keys, int32_t *vals, int maxRows) {
+  STableData *pTableData = tsdbTestTableData(pRepo);
+  if (pTableData == NULL) return 0;
+
+  STSchema *      pSchema = tsdbTestSchema();
+  STableDataIter *pIter = tsdbCreateTableDataIter(pTableData, &startKey, order);
+  int             nRows = 0;
+
+  while (nRows < maxRows && tsdbTableDataIterNext(pIter)) {
+    SMemRow row = tsdbTableDataIterGet(pIter);
+    if (row == NULL || !isDataRow(row) || memRowKey(row) != pIter->key) {
+      nRows = -1;
+      break;
+    }
+
+    SDataRow dRow = memRowDataBody(row);
+    keys[nRows] = memRowKey(row);
+    vals[nRows] = *(int32_t *)tdGetColOfRowBySchema(dRow, pSchema, 1);
+    if (!tsdbTestCheckVal(vals[nRows], tdGetColOfRowBySchema(dRow, pSchema, 2))) {
+      nRows = -1;
+      break;
+    }
+    nRows++;
+  }
+
+  tsdbDestroyTableDataIter(pIter);
+  tdFreeSchema(pSchema);
+  return nRows;
+}
+
+int tsdbTestLoadMem(STsdbRepo *pRepo, int64_t maxKey, int batchRows, int64_t *keys, int32_t *vals, int maxRows) {
+  STableData *pTableData = tsdbTestTableData(pRepo);
+  if (pTableData == NULL) return 0;
+
+  STable *        pTable = pRepo->tsdbMeta->tables[TSDB_TEST_TID];
+  STSchema *      pSchema = tsdbTestSchema();
+  SDataCols *     pCols = tdNewDataCols(schemaNCols(pSchema), batchRows);
+  STableDataIter *pIter = tsdbCreateTableDataIter(pTableData, NULL, TSDB_ORDER_ASC);
+  int             nRows = 0;
+
+  tsdbTableDataIterNext(pIter);
+  tdInitDataCols(pCols, pSchema);
+  while (nRows < maxRows && tsdbTableDataIterHasRow(pIter)) {
+    if (tsdbLoadDataFromCache(pTable, pIter, maxKey, batchRows, pCols, NULL, 0, pRepo->config.update != 0, NULL) < 0) {
+      nRows = -1;
+      break;
+    }
+    if (pCols->numOfRows == 0) break;
+
+    for (int i = 0; i < pCols->numOfRows && nRows < maxRows; i++) {
+      keys[nRows] = ((TSKEY *)pCols->cols[0].pData)[i];
+      vals[nRows] = ((int32_t *)pCols->cols[1].pData)[i];
+      if (!tsdbTestCheckVal(vals[nRows], tdGetColDataOfRow(&pCols->cols[2], i))) {
+        nRows = -1;
+        break;
+      }
+      nRows++;
+    }
+    if (nRows < 0) break;
+  }
+
+  tsdbDestroyTableDataIter(pIter);
+  tdFreeDataCols(pCols);
+  tdFreeSchema(pSchema);
+  return nRows;
+}
+
+int tsdbTestCountMem(STsdbRepo *pRepo, int64_t startKey, int64_t maxKey) {
+  STableData *pTableData = tsdbTestTableData(pRepo);
+  if (pTableData == NULL) return 0;
+
+  STable *        pTable = pRepo->tsdbMeta->tables[TSDB_TEST_TID];
+  STableDataIter *pIter = tsdbCreateTableDataIter(pTableData, &startKey, TSDB_ORDER_ASC);
+  SMergeInfo      mInfo;
+
+  tsdbTableDataIterNext(pIter);
+  int code = tsdbLoadDataFromCache(pTable, pIter, maxKey, INT32_MAX, NULL, NULL, 0, pRepo->config.update != 0, &mInfo);
+
+  tsdbDestroyTableDataIter(pIter);
+  return (code < 0) ? -1 : mInfo.rowsInserted;
+}
+
+void *tsdbTestNewBlkCache(int64_t capacity) { return tsdbNewBlkCache(capacity); }
+
+void tsdbTestFreeBlkCache(void *pCache) { tsdbFreeBlkCache(pCache); }
+
+void tsdbTestInvalidateBlkCache(void *pCache) { tsdbInvalidateBlkCache(pCache); }
+
+uint32_t tsdbTestBlkCacheGen(void *pCache, int64_t *size, int64_t *protSize) {
+  STsdbBlkCache *pBlkCache = pCache;
+
+  pthread_mutex_lock(&(pBlkCache->lock));
+  *size = pBlkCache->size;
+  *protSize = pBlkCache->protSize;
+  pthread_mutex_unlock(&(pBlkCache->lock));
+
+  return tsdbGetBlkCacheGen(pBlkCache);
+}
+
+void tsdbTestPutBlkCache(void *pCache, uint32_t gen, int32_t fid, int64_t offset, int32_t len) {
+  SBlkCacheKey key;
+  tsdbInitBlkCacheKey(&key, gen, fid, false, offset, 0);
+
+  char *pBuf = malloc(len);
+  memset(pBuf, (uint8_t)offset, len);
+  tsdbPutBlkCacheBuf(pCache, &key, pBuf, len);
+  free(pBuf);
+}
+
+int32_t tsdbTestGetBlkCache(void *pCache, uint32_t gen, int32_t fid, int64_t offset) {
+  SBlkCacheKey key;
+  tsdbInitBlkCacheKey(&key, gen, fid, false, offset, 0);
+
+  void *  pBuf = NULL;
+  int32_t len = 0;
+  if (!tsdbGetBlkCacheBuf(pCache, &key, &pBuf, &len)) {
+    taosTZfree(pBuf);
+    return -1;
+  }
+
+  for (int32_t i = 0; i < len; i++) {
+    if (((uint8_t *)pBuf)[i] != (uint8_t)offset) {
+      len = -2;
+      break;
+    }
+  }
+
+  taosTZfree(pBuf);
+  return len;
+}
+
+int tsdbTestBlkCacheCols(void *pCache, uint32_t gen, int32_t fid, int rows) {
+  STSchema * pSchema = tsdbTestSchema();
+  SDataCols *pCols = tdNewDataCols(schemaNCols(pSchema), rows);
+  SDataCols *pRead = tdNewDataCols(schemaNCols(pSchema), rows);
+  tdInitDataCols(pCols, pSchema);
+  tdInitDataCols(pRead, pSchema);
+
+  for (int i = 0; i < rows; i++) {
+    int32_t v = i * 7;
+    char    str[VARSTR_HEADER_SIZE + TSDB_TEST_BINARY_LEN];
+    varDataSetLen(str, snprintf(varDataVal(str), TSDB_TEST_BINARY_LEN, "s%d", v));
+    dataColAppendVal(&pCols->cols[1], &v, i, rows, 0);
+    dataColAppendVal(&pCols->cols[2], str, i, rows, 0);
+  }
+
+  int ret = 0;
+  for (int c = 1; c <= 2 && ret == 0; c++) {
+    SBlkCacheKey key;
+    tsdbInitBlkCacheKey(&key, gen, fid, false, 0, pCols->cols[c].colId);
+    tsdbPutBlkCacheCol(pCache, &key, &pCols->cols[c], rows);
+    if (!tsdbGetBlkCacheCol(pCache, &key, &pRead->cols[c], rows, rows)) ret = -1;
+  }
+
+  for (int i = 0; i < rows && ret == 0; i++) {
+    int32_t v = ((int32_t *)pRead->cols[1].pData)[i];
+    if (v != i * 7 || !tsdbTestCheckVal(v, tdGetColDataOfRow(&pRead->cols[2], i))) ret = -2;
+  }
+
+  tdFreeDataCols(pCols);
+  tdFreeDataCols(pRead);
+  tdFreeSchema(pSchema);
+  return ret;
+}
+
+void *tsdbTestBlkIdxCache(STsdbRepo *pRepo) { return pRepo->pBlkIdxCache; }
+
+int tsdbTestReadFSets(STsdbRepo *pRepo, int64_t *keys, int32_t *vals, int maxRows, int *nSubBlocks) {
+  STable *   pTable = tsdbGetTableByUid(pRepo->tsdbMeta, TSDB_TEST_UID);
+  SReadH     readh;
+  SFSIter    fsIter;
+  SDFileSet *pSet;
+  int        nRows = 0;
+
+  if (pTable == NULL || tsdbInitReadH(&readh, pRepo) < 0) return -1;
+
+  *nSubBlocks = 0;
+  tsdbFSIterInit(&fsIter, REPO_FS(pRepo), TSDB_FS_ITER_FORWARD);
+  while ((pSet = tsdbFSIterNext(&fsIter)) != NULL && nRows >= 0) {
+    if (tsdbSetAndOpenReadFSet(&readh, pSet) < 0 || tsdbLoadBlockIdx(&readh) < 0 ||
+        tsdbSetReadTable(&readh, pTable) < 0 || (readh.pBlkIdx != NULL && tsdbLoadBlockInfo(&readh, NULL, NULL) < 0)) {
+      nRows = -1;
+    }
+
+    for (uint32_t b = 0; nRows >= 0 && readh.pBlkIdx != NULL && b < readh.pBlkIdx->numOfBlocks; b++) {
+      SBlock *pBlock = readh.pBlkInfo->blocks + b;
+      if (pBlock->numOfSubBlocks > 1) (*nSubBlocks)++;
+
+      SDataCols *pCols = readh.pDCols[0];
+      if (tsdbLoadBlockData(&readh, pBlock, NULL) < 0 || nRows + pCols->numOfRows > maxRows) {
+        nRows = -1;
+        break;
+      }
+
+      for (int i = 0; i < pCols->numOfRows; i++) {
+        keys[nRows] = ((TSKEY *)pCols->cols[0].pData)[i];
+        vals[nRows] = ((int32_t *)pCols->cols[1].pData)[i];
+        if (!tsdbTestCheckVal(vals[nRows], tdGetColDataOfRow(&pCols->cols[2], i))) {
+          nRows = -1;
+          break;
+        }
+        nRows++;
+      }
+    }
+
+    tsdbCloseAndUnsetFSet(&readh);
+  }
+
+  tsdbDestroyReadH(&readh);
+  return nRows;
+}
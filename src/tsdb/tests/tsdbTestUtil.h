@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_TSDB_TEST_UTIL_H
+#define TDENGINE_TSDB_TEST_UTIL_H
+
+// The tsdb internal headers are C only, the tests reach the internals through these helpers.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "os.h"
+
+/**
+ * Writes one block of a timestamp column and ncols - 1 double columns into dir, loads it back twice on a decode pool
+ * of the given number of threads and compares every column with what was written.
+ * @return 0 if they are the same, -1 with the reason in msg otherwise
+ */
+int tsdbTestDecodeBlock(const char *dir, int ncols, int rows, int8_t comp, int threads, char *msg, int msgLen);
+
+/*
+ * A repository of vnode 1 under dir, with one normal table (ts timestamp, v int, s binary(16)). The s column of a row
+ * is always "s" followed by v, so that the var data path is checked together with the fixed length one.
+ */
+typedef struct STsdbRepo STsdbRepo;
+
+#define TSDB_TEST_TID 1
+#define TSDB_TEST_UID 1
+
+STsdbRepo *tsdbTestOpenRepo(const char *dir, int8_t update);
+void       tsdbTestCloseRepo(STsdbRepo *pRepo, bool toCommit);
+
+/**
+ * The first key of the test data, a few days back from now aligned to a day, so that it is the same for every
+ * repository of a test and within the keep range.
+ */
+int64_t tsdbTestBaseKey();
+
+/**
+ * Inserts the rows in one submit block, in the given order.
+ */
+int tsdbTestInsert(STsdbRepo *pRepo, const int64_t *keys, const int32_t *vals, int nRows);
+
+/**
+ * Number of rows of the test table in the column buffer and in the skiplist of the memtable.
+ */
+int64_t tsdbTestMemColRows(STsdbRepo *pRepo);
+int64_t tsdbTestMemSkipListRows(STsdbRepo *pRepo);
+
+/**
+ * Reads the rows of the test table in the memtable row by row with a table data iterator from startKey.
+ * @return number of rows read, or -1 if a row is not consistent
+ */
+int tsdbTestIterMem(STsdbRepo *pRepo, int64_t startKey, int32_t order, int64_t *keys, int32_t *vals, int maxRows);
+
+/**
+ * Reads the rows of the test table in the memtable up to maxKey as the commit does, batchRows rows at most at a time.
+ * @return number of rows read, or -1 if a row is not consistent
+ */
+int tsdbTestLoadMem(STsdbRepo *pRepo, int64_t maxKey, int batchRows, int64_t *keys, int32_t *vals, int maxRows);
+
+/**
+ * Counts the rows of the test table in the memtable from startKey up to maxKey as the commit does when it only checks
+ * for rows, without a bound on the number of rows.
+ */
+int tsdbTestCountMem(STsdbRepo *pRepo, int64_t startKey, int64_t maxKey);
+
+/*
+ * A block cache of capacity bytes. Its entries are keyed by generation, fid and offset, and the len bytes of an entry
+ * are all the low byte of its offset.
+ */
+void *tsdbTestNewBlkCache(int64_t capacity);
+void  tsdbTestFreeBlkCache(void *pCache);
+void  tsdbTestInvalidateBlkCache(void *pCache);
+
+/**
+ * Generation of the cache, and the bytes of all its entries and of those in the protected segment.
+ */
+uint32_t tsdbTestBlkCacheGen(void *pCache, int64_t *size, int64_t *protSize);
+
+void tsdbTestPutBlkCache(void *pCache, uint32_t gen, int32_t fid, int64_t offset, int32_t len);
+
+/**
+ * @return len of the entry, -1 if it is not cached, -2 if its bytes are not those put
+ */
+int32_t tsdbTestGetBlkCache(void *pCache, uint32_t gen, int32_t fid, int64_t offset);
+
+/**
+ * Puts rows values of an int column and of a binary column into the cache and reads them back into new columns.
+ * @return 0 if they are the same, -1 if one is not cached, -2 if one is not the same
+ */
+int tsdbTestBlkCacheCols(void *pCache, uint32_t gen, int32_t fid, int rows);
+
+/**
+ * The cache of decoded .head file index parts of the repository, NULL if it is disabled.
+ */
+void *tsdbTestBlkIdxCache(STsdbRepo *pRepo);
+
+/**
+ * Reads the rows of the test table in the file sets of the repository block by block, through the block index of the
+ * .head files as a query does, and counts the blocks with sub-blocks.
+ * @return number of rows read, or -1 if a row is not consistent or the blocks cannot be read
+ */
+int tsdbTestReadFSets(STsdbRepo *pRepo, int64_t *keys, int32_t *vals, int maxRows, int *nSubBlocks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_TSDB_TEST_UTIL_H
@@ -92,6 +92,22 @@ int32_t compareStrContainJson(const void* pLeft, const void* pRight);
 int32_t compareJsonVal(const void* pLeft, const void* pRight);
 int32_t jsonCompareUnit(const char* f1, const char* f2, bool* canReturn);
 
+/*
+ * A MATCH, NMATCH or LIKE pattern compiled once for all the values of a query. Patterns that are a plain literal,
+ * possibly anchored or wrapped in '%', are matched as the prefix, suffix, substring or whole value without running
+ * the regex or the wildcard engine.
+ *
+ * The pattern of LIKE has the type of the values, the one of MATCH and NMATCH is always a multibyte string. NULL is
+ * returned for an invalid regex, the caller then falls back to the comparison functions.
+ */
+typedef struct SCompiledPattern SCompiledPattern;
+
+SCompiledPattern* compilePattern(int32_t type, int32_t optr, const char* pattern, int32_t len);
+void              freeCompiledPattern(SCompiledPattern* pPattern);
+
+// 0 if the value of type binary or nchar satisfies the pattern, 1 otherwise
+int32_t compareCompiledPattern(const SCompiledPattern* pPattern, const void* pLeft);
+
 #ifdef __cplusplus
 }
 #endif
@@ -33,6 +33,9 @@ extern "C" {
 #define NO_COMPRESSION 0
 #define ONE_STAGE_COMP 1
 #define TWO_STAGE_COMP 2
+#define TWO_STAGE_COMP_ZSTD 3  // two stages with zstd at zstdLevel as the second stage instead of LZ4
+
+#define IS_TWO_STAGE_COMP(a) ((a) == TWO_STAGE_COMP || (a) == TWO_STAGE_COMP_ZSTD)
 
 //
 // compressed data first byte foramt
@@ -46,16 +49,41 @@ extern "C" {
 
 // compression algorithm save first byte higher 7 bit
 #define ALGO_SZ_LOSSY     1 // SZ compress 
+#define ALGO_TS_BITPACK   2 // timestamps of a fixed interval or with bit packed deltas
+#define ALGO_FLT_DECIMAL  3 // floats and doubles as bit packed integers scaled by a power of ten
+#define ALGO_INT_BITPACK  4 // integers in bit packed miniblocks above a base
+#define ALGO_STR_DICT     5 // var data as its distinct values and the bit packed code of each row
+#define ALGO_ZSTD         6 // the second stage with zstd, LZ4 is told by the first byte being 1
 
 #define HEAD_MODE(x)  x%2
 #define HEAD_ALGO(x)  x/2
 
+// The statistics of some rows of a compressed column, as the statisFunc of the type gives them for the decoded rows:
+// the sum, minimum and maximum of the unsigned types are uint64_t and the indexes count from the first row.
+typedef struct SCompStatis {
+  int64_t sum;
+  int64_t min;
+  int64_t max;
+  int32_t minIndex;
+  int32_t maxIndex;
+  int32_t numOfNull;
+} SCompStatis;
+
 extern int tsCompressINTImp(const char *const input, const int nelements, char *const output, const char type);
 extern int tsDecompressINTImp(const char *const input, const int nelements, char *const output, const char type);
 extern int tsCompressBoolImp(const char *const input, const int nelements, char *const output);
 extern int tsDecompressBoolImp(const char *const input, const int nelements, char *const output);
 extern int tsCompressStringImp(const char *const input, int inputSize, char *const output, int outputSize);
 extern int tsDecompressStringImp(const char *const input, int compressedSize, char *const output, int outputSize);
+extern int tsCompressStringZstdImp(const char *const input, int inputSize, char *const output, int outputSize,
+                                   uint32_t dictId);
+extern uint32_t tsZstdTrainDict(const char *const samples, const size_t *sampleSizes, int nsamples, int dictCapacity);
+extern int tsCompressStringDictImp(const char *const input, int inputSize, const int nelements, char *const output,
+                                   int outputSize, char *const buffer, int bufferSize);
+extern int tsDecompressStringDictImp(const char *const input, int compressedSize, const int nelements,
+                                     char *const output, int outputSize, uint8_t *codes);
+extern int tsCompressedStatis(const char *const input, int compressedSize, const int nelements, int start, int end,
+                              int8_t type, char algorithm, char *const buffer, int bufferSize, SCompStatis *pStatis);
 extern int tsCompressTimestampImp(const char *const input, const int nelements, char *const output);
 extern int tsDecompressTimestampImp(const char *const input, const int nelements, char *const output);
 extern int tsCompressDoubleImp(const char *const input, const int nelements, char *const output);
@@ -77,13 +105,23 @@ int tsCompressInit();
 void tsCompressExit();
 #endif
 
+// The second stage of the two stage compression, the first byte of the output tells the decompression which it is
+static FORCE_INLINE int tsCompressSecondStage(const char *const input, int inputSize, char *const output, int outputSize,
+                                              char algorithm) {
+  if (algorithm == TWO_STAGE_COMP_ZSTD) {
+    return tsCompressStringZstdImp(input, inputSize, output, outputSize, 0);
+  }
+
+  return tsCompressStringImp(input, inputSize, output, outputSize);
+}
+
 static FORCE_INLINE int tsCompressTinyint(const char *const input, int inputSize, const int nelements, char *const output, int outputSize, char algorithm,
                       char *const buffer, int bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsCompressINTImp(input, nelements, output, TSDB_DATA_TYPE_TINYINT);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (IS_TWO_STAGE_COMP(algorithm)) {
     int len = tsCompressINTImp(input, nelements, buffer, TSDB_DATA_TYPE_TINYINT);
-    return tsCompressStringImp(buffer, len, output, outputSize);
+    return tsCompressSecondStage(buffer, len, output, outputSize, algorithm);
   } else {
     assert(0);
     return -1;
@@ -94,7 +132,7 @@ static FORCE_INLINE int tsDecompressTinyint(const char *const input, int compres
                         int outputSize, char algorithm, char *const buffer, int bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsDecompressINTImp(input, nelements, output, TSDB_DATA_TYPE_TINYINT);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (IS_TWO_STAGE_COMP(algorithm)) {
     if (tsDecompressStringImp(input, compressedSize, buffer, bufferSize) < 0) return -1;
     return tsDecompressINTImp(buffer, nelements, output, TSDB_DATA_TYPE_TINYINT);
   } else {
@@ -107,9 +145,9 @@ static FORCE_INLINE int tsCompressSmallint(const char *const input, int inputSiz
                        char *const buffer, int bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsCompressINTImp(input, nelements, output, TSDB_DATA_TYPE_SMALLINT);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (IS_TWO_STAGE_COMP(algorithm)) {
     int len = tsCompressINTImp(input, nelements, buffer, TSDB_DATA_TYPE_SMALLINT);
-    return tsCompressStringImp(buffer, len, output, outputSize);
+    return tsCompressSecondStage(buffer, len, output, outputSize, algorithm);
   } else {
     assert(0);
     return -1;
@@ -120,7 +158,7 @@ static FORCE_INLINE int tsDecompressSmallint(const char *const input, int compre
                          int outputSize, char algorithm, char *const buffer, int bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsDecompressINTImp(input, nelements, output, TSDB_DATA_TYPE_SMALLINT);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (IS_TWO_STAGE_COMP(algorithm)) {
     if (tsDecompressStringImp(input, compressedSize, buffer, bufferSize) < 0) return -1;
     return tsDecompressINTImp(buffer, nelements, output, TSDB_DATA_TYPE_SMALLINT);
   } else {
@@ -133,9 +171,9 @@ static FORCE_INLINE int tsCompressInt(const char *const input, int inputSize, co
                   char *const buffer, int bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsCompressINTImp(input, nelements, output, TSDB_DATA_TYPE_INT);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (IS_TWO_STAGE_COMP(algorithm)) {
     int len = tsCompressINTImp(input, nelements, buffer, TSDB_DATA_TYPE_INT);
-    return tsCompressStringImp(buffer, len, output, outputSize);
+    return tsCompressSecondStage(buffer, len, output, outputSize, algorithm);
   } else {
     assert(0);
     return -1;
@@ -146,7 +184,7 @@ static FORCE_INLINE int tsDecompressInt(const char *const input, int compressedS
                     int outputSize, char algorithm, char *const buffer, int bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsDecompressINTImp(input, nelements, output, TSDB_DATA_TYPE_INT);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (IS_TWO_STAGE_COMP(algorithm)) {
     if (tsDecompressStringImp(input, compressedSize, buffer, bufferSize) < 0) return -1;
     return tsDecompressINTImp(buffer, nelements, output, TSDB_DATA_TYPE_INT);
   } else {
@@ -159,9 +197,9 @@ static FORCE_INLINE int tsCompressBigint(const char *const input, int inputSize,
                      char algorithm, char *const buffer, int bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsCompressINTImp(input, nelements, output, TSDB_DATA_TYPE_BIGINT);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (IS_TWO_STAGE_COMP(algorithm)) {
     int len = tsCompressINTImp(input, nelements, buffer, TSDB_DATA_TYPE_BIGINT);
-    return tsCompressStringImp(buffer, len, output, outputSize);
+    return tsCompressSecondStage(buffer, len, output, outputSize, algorithm);
   } else {
     assert(0);
     return -1;
@@ -172,7 +210,7 @@ static FORCE_INLINE int tsDecompressBigint(const char *const input, int compress
                        int outputSize, char algorithm, char *const buffer, int bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsDecompressINTImp(input, nelements, output, TSDB_DATA_TYPE_BIGINT);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (IS_TWO_STAGE_COMP(algorithm)) {
     if (tsDecompressStringImp(input, compressedSize, buffer, bufferSize) < 0) return -1;
     return tsDecompressINTImp(buffer, nelements, output, TSDB_DATA_TYPE_BIGINT);
   } else {
@@ -185,9 +223,9 @@ static FORCE_INLINE int tsCompressBool(const char *const input, int inputSize, c
                    char algorithm, char *const buffer, int bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsCompressBoolImp(input, nelements, output);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (IS_TWO_STAGE_COMP(algorithm)) {
     int len = tsCompressBoolImp(input, nelements, buffer);
-    return tsCompressStringImp(buffer, len, output, outputSize);
+    return tsCompressSecondStage(buffer, len, output, outputSize, algorithm);
   } else {
     assert(0);
     return -1;
@@ -198,7 +236,7 @@ static FORCE_INLINE int tsDecompressBool(const char *const input, int compressed
                      int outputSize, char algorithm, char *const buffer, int bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsDecompressBoolImp(input, nelements, output);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (IS_TWO_STAGE_COMP(algorithm)) {
     if (tsDecompressStringImp(input, compressedSize, buffer, bufferSize) < 0) return -1;
     return tsDecompressBoolImp(buffer, nelements, output);
   } else {
@@ -209,14 +247,35 @@ static FORCE_INLINE int tsDecompressBool(const char *const input, int compressed
 
 static FORCE_INLINE int tsCompressString(const char *const input, int inputSize, const int nelements, char *const output, int outputSize,
                      char algorithm, char *const buffer, int bufferSize) {
-  return tsCompressStringImp(input, inputSize, output, outputSize);
+  int len = tsCompressStringDictImp(input, inputSize, nelements, output, outputSize, buffer, bufferSize);
+
+  // The dictionary encoding is only smaller than LZ4, zstd has to be tried too
+  if (len > 0 && algorithm == TWO_STAGE_COMP_ZSTD && bufferSize >= outputSize) {
+    int zlen = tsCompressStringZstdImp(input, inputSize, buffer, bufferSize, 0);
+    if (zlen < len) {
+      memcpy(output, buffer, zlen);
+      return zlen;
+    }
+  }
+  if (len > 0) return len;
+
+  return tsCompressSecondStage(input, inputSize, output, outputSize, algorithm);
 }
 
 static FORCE_INLINE int tsDecompressString(const char *const input, int compressedSize, const int nelements, char *const output,
                        int outputSize, char algorithm, char *const buffer, int bufferSize) {
+  if (HEAD_ALGO((uint8_t)input[0]) == ALGO_STR_DICT) {
+    return tsDecompressStringDictImp(input, compressedSize, nelements, output, outputSize, NULL);
+  }
+
   return tsDecompressStringImp(input, compressedSize, output, outputSize);
 }
 
+// The number of distinct values of a dictionary encoded string column, 0 if it is not dictionary encoded
+static FORCE_INLINE int tsGetStringDictSize(const char *const input) {
+  return (HEAD_ALGO((uint8_t)input[0]) == ALGO_STR_DICT) ? (uint8_t)input[1] + 1 : 0;
+}
+
 static FORCE_INLINE int tsCompressFloat(const char *const input, int inputSize, const int nelements, char *const output, int outputSize,
                     char algorithm, char *const buffer, int bufferSize) {
 #ifdef TD_TSZ
@@ -228,9 +287,9 @@ static FORCE_INLINE int tsCompressFloat(const char *const input, int inputSize,
 #endif    
     if (algorithm == ONE_STAGE_COMP) {
       return tsCompressFloatImp(input, nelements, output);
-    } else if (algorithm == TWO_STAGE_COMP) {
+    } else if (IS_TWO_STAGE_COMP(algorithm)) {
       int len = tsCompressFloatImp(input, nelements, buffer);
-      return tsCompressStringImp(buffer, len, output, outputSize);
+      return tsCompressSecondStage(buffer, len, output, outputSize, algorithm);
     } else {
       assert(0);
       return -1;
@@ -251,7 +310,7 @@ static FORCE_INLINE int tsDecompressFloat(const char *const input, int compresse
     // decompress lossless
     if (algorithm == ONE_STAGE_COMP) {
       return tsDecompressFloatImp(input, nelements, output);
-    } else if (algorithm == TWO_STAGE_COMP) {
+    } else if (IS_TWO_STAGE_COMP(algorithm)) {
       if (tsDecompressStringImp(input, compressedSize, buffer, bufferSize) < 0) return -1;
       return tsDecompressFloatImp(buffer, nelements, output);
     } else {
@@ -275,9 +334,9 @@ static FORCE_INLINE int tsCompressDouble(const char *const input, int inputSize,
     // lossless mode
     if (algorithm == ONE_STAGE_COMP) {
       return tsCompressDoubleImp(input, nelements, output);
-    } else if (algorithm == TWO_STAGE_COMP) {
+    } else if (IS_TWO_STAGE_COMP(algorithm)) {
       int len = tsCompressDoubleImp(input, nelements, buffer);
-      return tsCompressStringImp(buffer, len, output, outputSize);
+      return tsCompressSecondStage(buffer, len, output, outputSize, algorithm);
     } else {
       assert(0);
       return -1;
@@ -298,7 +357,7 @@ static FORCE_INLINE int tsDecompressDouble(const char *const input, int compress
     // decompress lossless
     if (algorithm == ONE_STAGE_COMP) {
       return tsDecompressDoubleImp(input, nelements, output);
-    } else if (algorithm == TWO_STAGE_COMP) {
+    } else if (IS_TWO_STAGE_COMP(algorithm)) {
       if (tsDecompressStringImp(input, compressedSize, buffer, bufferSize) < 0) return -1;
       return tsDecompressDoubleImp(buffer, nelements, output);
     } else {
@@ -340,9 +399,9 @@ static FORCE_INLINE int tsCompressTimestamp(const char *const input, int inputSi
                         char algorithm, char *const buffer, int bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsCompressTimestampImp(input, nelements, output);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (IS_TWO_STAGE_COMP(algorithm)) {
     int len = tsCompressTimestampImp(input, nelements, buffer);
-    return tsCompressStringImp(buffer, len, output, outputSize);
+    return tsCompressSecondStage(buffer, len, output, outputSize, algorithm);
   } else {
     assert(0);
     return -1;
@@ -353,7 +412,7 @@ static FORCE_INLINE int tsDecompressTimestamp(const char *const input, int compr
                           int outputSize, char algorithm, char *const buffer, int bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsDecompressTimestampImp(input, nelements, output);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (IS_TWO_STAGE_COMP(algorithm)) {
     if (tsDecompressStringImp(input, compressedSize, buffer, bufferSize) < 0) return -1;
     return tsDecompressTimestampImp(buffer, nelements, output);
   } else {
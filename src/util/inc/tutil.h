@@ -36,6 +36,7 @@ char *  strntolower(char *dst, const char *src, int32_t n);
 char *  strntolower_s(char *dst, const char *src, int32_t n);
 int64_t strnatoi(char *num, int32_t len);
 char *  strbetween(char *string, char *begin, char *end);
+bool    strinlist(const char *list, const char *item, char delim);
 char *  paGetToken(char *src, char **token, int32_t *tokenLen);
 
 int32_t taosByteArrayToHexStr(char bytes[], int32_t len, char hexstr[]);
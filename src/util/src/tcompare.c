@@ -586,6 +586,312 @@ int32_t compareWStrPatternComp(const void* pLeft, const void* pRight) {
   return (ret == TSDB_PATTERN_MATCH) ? 0 : 1;
 }
 
+enum {
+  PATTERN_FAST_NONE = 0,  // evaluated by the regex or the wildcard engine
+  PATTERN_FAST_EQUAL,
+  PATTERN_FAST_PREFIX,
+  PATTERN_FAST_SUFFIX,
+  PATTERN_FAST_CONTAIN,
+};
+
+#define PATTERN_STACK_BUF_UNITS 64
+
+struct SCompiledPattern {
+  int8_t    type;     // type of the compared values, binary or nchar
+  uint8_t   optr;
+  int8_t    fast;     // PATTERN_FAST_*
+  int32_t   len;      // number of units of the literal
+  char     *literal;  // bytes of a MATCH literal, compared case sensitively
+  uint32_t *folded;   // lower case units of a LIKE literal, compared case insensitively
+  char     *pattern;  // the LIKE pattern, terminated by a 0 unit
+  bool      compiled;
+  regex_t   regex;
+};
+
+static FORCE_INLINE uint32_t patternUnitAt(const char *s, int32_t i, int32_t width) {
+  if (width == 1) {
+    return (uint8_t)s[i];
+  }
+
+  uint32_t c;
+  memcpy(&c, s + i * TSDB_NCHAR_SIZE, TSDB_NCHAR_SIZE);
+  return c;
+}
+
+static FORCE_INLINE uint32_t patternFold(uint32_t c, int32_t width) {
+  return (width == 1) ? (uint32_t)tolower((int)c) : (uint32_t)towlower(c);
+}
+
+// Number of units before the first 0 unit, the engines stop there as well
+static int32_t patternUnitLen(const char *s, int32_t bytes, int32_t width) {
+  if (width == 1) {
+    return (int32_t)strnlen(s, bytes);
+  }
+
+  int32_t n = bytes / TSDB_NCHAR_SIZE;
+  for (int32_t i = 0; i < n; ++i) {
+    if (patternUnitAt(s, i, width) == 0) {
+      return i;
+    }
+  }
+
+  return n;
+}
+
+// A regex of plain characters, anchored or not, is the literal to find at the head, the tail, anywhere or as the
+// whole value
+static void patternSetRegexLiteral(SCompiledPattern *pPattern, const char *pattern, int32_t len) {
+  bool head = (len > 0 && pattern[0] == '^');
+  bool tail = (len > (int32_t)head && pattern[len - 1] == '$');
+
+  const char *literal = pattern + head;
+  int32_t     n = len - head - tail;
+  if (n <= 0 || strnlen(literal, n) < (size_t)n || strcspn(literal, ".[]()*+?{}|\\^$") < (size_t)n) {
+    return;
+  }
+
+  pPattern->literal = malloc(n);
+  if (pPattern->literal == NULL) {
+    return;
+  }
+
+  memcpy(pPattern->literal, literal, n);
+  pPattern->len = n;
+  pPattern->fast = head ? (tail ? PATTERN_FAST_EQUAL : PATTERN_FAST_PREFIX) : (tail ? PATTERN_FAST_SUFFIX : PATTERN_FAST_CONTAIN);
+}
+
+// A LIKE pattern whose only wildcards are leading or trailing '%' is a literal as well
+static void patternSetLikeLiteral(SCompiledPattern *pPattern, const char *pattern, int32_t len, int32_t width) {
+  int32_t s = 0, e = len;
+  while (s < e && patternUnitAt(pattern, s, width) == '%') {
+    ++s;
+  }
+
+  bool head = (s > 0);
+  while (e > s && patternUnitAt(pattern, e - 1, width) == '%') {
+    --e;
+  }
+
+  bool tail = (e < len);
+  for (int32_t i = s; i < e; ++i) {
+    uint32_t c = patternUnitAt(pattern, i, width);
+    if (c == '%' || c == '_' || c == '\\') {
+      return;
+    }
+  }
+
+  pPattern->folded = malloc((e - s + 1) * sizeof(uint32_t));
+  if (pPattern->folded == NULL) {
+    return;
+  }
+
+  for (int32_t i = s; i < e; ++i) {
+    pPattern->folded[i - s] = patternFold(patternUnitAt(pattern, i, width), width);
+  }
+
+  pPattern->len = e - s;
+  pPattern->fast = head ? (tail ? PATTERN_FAST_CONTAIN : PATTERN_FAST_SUFFIX) : (tail ? PATTERN_FAST_PREFIX : PATTERN_FAST_EQUAL);
+}
+
+SCompiledPattern *compilePattern(int32_t type, int32_t optr, const char *pattern, int32_t len) {
+  if ((type != TSDB_DATA_TYPE_BINARY && type != TSDB_DATA_TYPE_NCHAR) ||
+      (optr != TSDB_RELATION_MATCH && optr != TSDB_RELATION_NMATCH && optr != TSDB_RELATION_LIKE)) {
+    return NULL;
+  }
+
+  SCompiledPattern *pPattern = calloc(1, sizeof(SCompiledPattern));
+  if (pPattern == NULL) {
+    return NULL;
+  }
+
+  pPattern->type = (int8_t)type;
+  pPattern->optr = (uint8_t)optr;
+
+  if (optr == TSDB_RELATION_LIKE) {
+    int32_t width = (type == TSDB_DATA_TYPE_NCHAR) ? TSDB_NCHAR_SIZE : 1;
+    int32_t n = patternUnitLen(pattern, len, width);
+
+    pPattern->pattern = calloc(n + 1, width);
+    if (pPattern->pattern == NULL) {
+      freeCompiledPattern(pPattern);
+      return NULL;
+    }
+
+    memcpy(pPattern->pattern, pattern, n * width);
+    patternSetLikeLiteral(pPattern, pattern, n, width);
+    return pPattern;
+  }
+
+  // regex are always matched against multibyte strings, nchar values are converted first
+  char *str = calloc(len + 1, 1);
+  if (str == NULL) {
+    freeCompiledPattern(pPattern);
+    return NULL;
+  }
+
+  memcpy(str, pattern, len);
+
+  char msgbuf[256] = {0};
+  int  code = regcomp(&pPattern->regex, str, REG_EXTENDED);
+  if (code != 0) {
+    regerror(code, &pPattern->regex, msgbuf, sizeof(msgbuf));
+    uError("Failed to compile regex pattern %s. reason %s", str, msgbuf);
+    regfree(&pPattern->regex);
+    free(str);
+    freeCompiledPattern(pPattern);
+    return NULL;
+  }
+
+  pPattern->compiled = true;
+  patternSetRegexLiteral(pPattern, str, len);
+  free(str);
+  return pPattern;
+}
+
+static FORCE_INLINE bool patternLiteralAt(const SCompiledPattern *pPattern, const char *s, int32_t pos, int32_t width) {
+  if (pPattern->literal != NULL) {
+    return memcmp(s + pos, pPattern->literal, pPattern->len) == 0;
+  }
+
+  for (int32_t i = 0; i < pPattern->len; ++i) {
+    if (patternFold(patternUnitAt(s, pos + i, width), width) != pPattern->folded[i]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static bool patternMatchLiteral(const SCompiledPattern *pPattern, const char *s, int32_t n, int32_t width) {
+  int32_t m = pPattern->len;
+  if (m > n) {
+    return false;
+  }
+
+  switch (pPattern->fast) {
+    case PATTERN_FAST_EQUAL:
+      return m == n && patternLiteralAt(pPattern, s, 0, width);
+    case PATTERN_FAST_PREFIX:
+      return patternLiteralAt(pPattern, s, 0, width);
+    case PATTERN_FAST_SUFFIX:
+      return patternLiteralAt(pPattern, s, n - m, width);
+    default:
+      break;
+  }
+
+  if (m == 0) {
+    return true;
+  }
+
+  if (pPattern->literal != NULL) {
+    const char *p = s;
+    const char *end = s + n - m;
+    while (p <= end && (p = memchr(p, pPattern->literal[0], end - p + 1)) != NULL) {
+      if (memcmp(p, pPattern->literal, m) == 0) {
+        return true;
+      }
+      ++p;
+    }
+
+    return false;
+  }
+
+  for (int32_t i = 0; i <= n - m; ++i) {
+    if (patternLiteralAt(pPattern, s, i, width)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static bool patternMatchRegex(const SCompiledPattern *pPattern, const char *val, int32_t len) {
+  char  stackBuf[PATTERN_STACK_BUF_UNITS * TSDB_NCHAR_SIZE];
+  int32_t size = len + TSDB_NCHAR_SIZE;
+  char *str = (size <= (int32_t)sizeof(stackBuf)) ? stackBuf : malloc(size);
+  if (str == NULL) {
+    return false;
+  }
+
+  bool matched = false;
+  if (pPattern->type == TSDB_DATA_TYPE_NCHAR) {
+    len = taosUcs4ToMbs((void *)val, len, str);
+    if (len < 0) {
+      uError("Failed to convert nchar value to match regex");
+      goto _end;
+    }
+  } else {
+    memcpy(str, val, len);
+  }
+
+  str[len] = 0;
+  if (pPattern->fast != PATTERN_FAST_NONE) {
+    matched = patternMatchLiteral(pPattern, str, (int32_t)strnlen(str, len), 1);
+  } else {
+    matched = (regexec(&pPattern->regex, str, 0, NULL, 0) == 0);
+  }
+
+  if (pPattern->optr == TSDB_RELATION_NMATCH) {
+    matched = !matched;
+  }
+
+_end:
+  if (str != stackBuf) {
+    free(str);
+  }
+
+  return matched;
+}
+
+static bool patternMatchLike(const SCompiledPattern *pPattern, const char *val, int32_t len) {
+  SPatternCompareInfo info = PATTERN_COMPARE_INFO_INITIALIZER;
+  int32_t width = (pPattern->type == TSDB_DATA_TYPE_NCHAR) ? TSDB_NCHAR_SIZE : 1;
+
+  if (pPattern->fast != PATTERN_FAST_NONE) {
+    return patternMatchLiteral(pPattern, val, patternUnitLen(val, len, width), width);
+  }
+
+  // the engines read the value up to a terminating 0 unit
+  uint32_t stackBuf[PATTERN_STACK_BUF_UNITS];
+  int32_t  size = len + TSDB_NCHAR_SIZE;
+  char    *str = (size <= (int32_t)sizeof(stackBuf)) ? (char *)stackBuf : calloc(1, size);
+  if (str == NULL) {
+    return false;
+  }
+
+  memcpy(str, val, len);
+  memset(str + len, 0, TSDB_NCHAR_SIZE);
+
+  int32_t ret = (width == 1) ? patternMatch(pPattern->pattern, str, len, &info)
+                             : WCSPatternMatch((uint32_t *)pPattern->pattern, (uint32_t *)str, len / TSDB_NCHAR_SIZE, &info);
+  if (str != (char *)stackBuf) {
+    free(str);
+  }
+
+  return ret == TSDB_PATTERN_MATCH;
+}
+
+int32_t compareCompiledPattern(const SCompiledPattern *pPattern, const void *pLeft) {
+  bool matched = (pPattern->optr == TSDB_RELATION_LIKE) ? patternMatchLike(pPattern, varDataVal(pLeft), varDataLen(pLeft))
+                                                        : patternMatchRegex(pPattern, varDataVal(pLeft), varDataLen(pLeft));
+  return matched ? 0 : 1;
+}
+
+void freeCompiledPattern(SCompiledPattern *pPattern) {
+  if (pPattern == NULL) {
+    return;
+  }
+
+  if (pPattern->compiled) {
+    regfree(&pPattern->regex);
+  }
+
+  tfree(pPattern->literal);
+  tfree(pPattern->folded);
+  tfree(pPattern->pattern);
+  free(pPattern);
+}
+
 __compar_fn_t getComparFunc(int32_t type, int32_t optr) {
   __compar_fn_t comparFn = NULL;
 
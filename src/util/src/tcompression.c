@@ -22,6 +22,10 @@
  *   (https://gist.github.com/mfuerstenau/ba870a29e16536fdbaba). Then the value is
  *   encoded using simple 8B method. For more information about simple 8B,
  *   refer to https://en.wikipedia.org/wiki/8b/10b_encoding.
+ *   When it is smaller, the integers are frame of reference encoded instead: miniblocks
+ *   of 128 values or of their differences are stored above a base with one bit width,
+ *   the few values beyond that width kept aside as exceptions, and unpacked with vector
+ *   instructions like the timestamps below.
  *
  *   NOTE : For bigint, only 59 bits can be used, which means data from -(2**59) to (2**59)-1
  *   are allowed.
@@ -36,7 +40,12 @@
  *   better when there are a lot of consecutive true values or false values.
  *
  * STRING Compression Algorithm:
- *   We us LZ4 method to compress the string type.
+ *   We us LZ4 method to compress the string type. Column blocks of a few distinct values are
+ *   stored as a dictionary of the values and the bit packed code of each row instead, when that
+ *   is smaller. Zstd may replace LZ4, here and as the second stage of the other types, where
+ *   the size matters more than the speed. It can use a dictionary trained on samples of short
+ *   strings, which the frame refers to by its id. Zstd is only built in with TD_TSZ, builds
+ *   without it fail to read the blocks it compressed.
  *
  * FLOAT Compression Algorithm:
  *   We use the same method with Akumuli to compress float and double types. The compression
@@ -44,6 +53,17 @@
  *   adjacent values. Then compare the number of leading zeros and trailing zeros. If the number
  *   of leading zeros are larger than the trailing zeros, then record the last serveral bytes
  *   of the XORed value with informations. If not, record the first corresponding bytes.
+ *   Blocks of values with a few decimal digits are stored as integers scaled by a power of ten
+ *   instead, bit packed in miniblocks like the timestamps below, when that is smaller. The values
+ *   which do not convert back exactly are kept as they are, so both methods are lossless.
+ *
+ * TIMESTAMP Compression Algorithm:
+ *   The delta of deltas are zig-zag encoded and stored in as few bytes as they need, with a
+ *   4 bit length for each of them. Blocks whose timestamps have a fixed interval are stored
+ *   as (start, step) instead, and blocks whose deltas stay in a 32 bit range as the minimum
+ *   delta and the bit packed deltas above it, whichever is the smallest. The bit packed
+ *   deltas are grouped into miniblocks of 128 values with one bit width, laid out in four
+ *   32 bit lanes so that they are unpacked with vector instructions.
  *
  */
 
@@ -51,11 +71,17 @@
 #include "lz4.h"
 #ifdef TD_TSZ  
   #include "td_sz.h"
+  #define ZSTD_STATIC_LINKING_ONLY  // ZSTD_getDictID_fromFrame
+  #include "zstd.h"
+  #include "zdict.h"
 #endif
 #include "taosdef.h"
 #include "tscompression.h"
 #include "tulog.h"
 #include "tglobal.h"
+#include "ttype.h"
+#include "hashfunc.h"
+#include "hash.h"
 
 
 static const int TEST_NUMBER = 1;
@@ -70,6 +96,8 @@ static const int TEST_NUMBER = 1;
 bool lossyFloat  = false;
 bool lossyDouble = false;
 
+static void tsZstdCleanup();
+
 // init call
 int tsCompressInit(){
   // config 
@@ -95,6 +123,7 @@ int tsCompressInit(){
 // exit call
 void tsCompressExit(){
    tdszExit();
+   tsZstdCleanup();
 }
 
 #endif
@@ -102,15 +131,97 @@ void tsCompressExit(){
 /*
  * Compress Integer (Simple8B).
  */
-int tsCompressINTImp(const char *const input, const int nelements, char *const output, const char type) {
-  // Selector value:              0    1   2   3   4   5   6   7   8  9  10  11
-  // 12  13  14  15
-  char bit_per_integer[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
-  int  selector_to_elems[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
-  char bit_to_selector[] = {0,  2,  3,  4,  5,  6,  7,  8,  9,  10, 10, 11, 11, 12, 12, 12, 13, 13, 13, 13, 13,
-                            14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
-                            15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15};
+// Selector value:              0    1   2   3   4   5   6   7   8  9  10  11
+// 12  13  14  15
+static const char bit_per_integer[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
+static const int  selector_to_elems[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
+static const char bit_to_selector[] = {0,  2,  3,  4,  5,  6,  7,  8,  9,  10, 10, 11, 11, 12, 12, 12, 13, 13, 13, 13, 13,
+                                       14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+                                       15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15};
+
+static int tsCompressINTBitPackImp(const char *const input, const int nelements, char *const output, const char type,
+                                   int word_length);
+static int tsDecompressINTBitPackImp(const char *const input, const int nelements, char *const output, const char type,
+                                     int word_length);
+
+static FORCE_INLINE int64_t tsGetINTValue(const char *const input, int i, const char type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:
+      return (int64_t)(*((int8_t *)input + i));
+    case TSDB_DATA_TYPE_SMALLINT:
+      return (int64_t)(*((int16_t *)input + i));
+    case TSDB_DATA_TYPE_INT:
+      return (int64_t)(*((int32_t *)input + i));
+    default:
+      return (int64_t)(*((int64_t *)input + i));
+  }
+}
 
+// Picks the selector of the word holding the values from i on, returns false if a difference is too large for any
+static bool tsSimple8bSelect(const char *const input, int i, const int nelements, const char type, int64_t prev_value,
+                             char *pSelector, int *pElems) {
+  char    selector = 0;
+  int     elems = 0;
+  int64_t prev_value_tmp = prev_value;
+
+  for (int j = i; j < nelements; j++) {
+    // Read data from the input stream and convert it to INT64 type.
+    int64_t curr_value = tsGetINTValue(input, j, type);
+    // Get difference.
+    if (!safeInt64Add(curr_value, -prev_value_tmp)) return false;
+
+    int64_t diff = curr_value - prev_value_tmp;
+    // Zigzag encode the value.
+    uint64_t zigzag_value = ZIGZAG_ENCODE(int64_t, diff);
+
+    if (zigzag_value >= SIMPLE8B_MAX_INT64) return false;
+
+    int64_t tmp_bit;
+    if (zigzag_value == 0) {
+      // Take care here, __builtin_clzl give wrong anser for value 0;
+      tmp_bit = 0;
+    } else {
+      tmp_bit = (LONG_BYTES * BITS_PER_BYTE) - BUILDIN_CLZL(zigzag_value);
+    }
+
+    if (elems + 1 <= selector_to_elems[(int)selector] && elems + 1 <= selector_to_elems[(int)(bit_to_selector[(int)tmp_bit])]) {
+      // If can hold another one.
+      selector = selector > bit_to_selector[(int)tmp_bit] ? selector : bit_to_selector[(int)tmp_bit];
+      elems++;
+    } else {
+      // if cannot hold another one.
+      while (elems < selector_to_elems[(int)selector]) selector++;
+      elems = selector_to_elems[(int)selector];
+      break;
+    }
+    prev_value_tmp = curr_value;
+  }
+
+  *pSelector = selector;
+  *pElems = elems;
+  return true;
+}
+
+// Size of the simple8b encoding, only counted until it goes beyond limit
+static int tsSimple8bSize(const char *const input, const int nelements, const char type, int word_length, int limit) {
+  int     byte_limit = nelements * word_length + 1;
+  int     len = 1;
+  int64_t prev_value = 0;
+
+  for (int i = 0; i < nelements && len <= limit;) {
+    char selector = 0;
+    int  elems = 0;
+    if (!tsSimple8bSelect(input, i, nelements, type, prev_value, &selector, &elems)) return byte_limit;
+
+    i += elems;
+    prev_value = tsGetINTValue(input, i - 1, type);
+    len += LONG_BYTES;
+  }
+
+  return MIN(len, byte_limit);
+}
+
+int tsCompressINTImp(const char *const input, const int nelements, char *const output, const char type) {
   // get the byte limit.
   int word_length = 0;
   switch (type) {
@@ -131,83 +242,26 @@ int tsCompressINTImp(const char *const input, const int nelements, char *const o
       return -1;
   }
 
+  if (tsIntBitPack && !is_bigendian()) {
+    int len = tsCompressINTBitPackImp(input, nelements, output, type, word_length);
+    if (len > 0) return len;
+  }
+
   int     byte_limit = nelements * word_length + 1;
   int     opos = 1;
   int64_t prev_value = 0;
 
   for (int i = 0; i < nelements;) {
-    char    selector = 0;
-    char    bit = 0;
-    int     elems = 0;
-    int64_t prev_value_tmp = prev_value;
-
-    for (int j = i; j < nelements; j++) {
-      // Read data from the input stream and convert it to INT64 type.
-      int64_t curr_value = 0;
-      switch (type) {
-        case TSDB_DATA_TYPE_TINYINT:
-          curr_value = (int64_t)(*((int8_t *)input + j));
-          break;
-        case TSDB_DATA_TYPE_SMALLINT:
-          curr_value = (int64_t)(*((int16_t *)input + j));
-          break;
-        case TSDB_DATA_TYPE_INT:
-          curr_value = (int64_t)(*((int32_t *)input + j));
-          break;
-        case TSDB_DATA_TYPE_BIGINT:
-          curr_value = (int64_t)(*((int64_t *)input + j));
-          break;
-      }
-      // Get difference.
-      if (!safeInt64Add(curr_value, -prev_value_tmp)) goto _copy_and_exit;
+    char selector = 0;
+    int  elems = 0;
 
-      int64_t diff = curr_value - prev_value_tmp;
-      // Zigzag encode the value.
-      uint64_t zigzag_value = ZIGZAG_ENCODE(int64_t, diff);
-
-      if (zigzag_value >= SIMPLE8B_MAX_INT64) goto _copy_and_exit;
-
-      int64_t tmp_bit;
-      if (zigzag_value == 0) {
-        // Take care here, __builtin_clzl give wrong anser for value 0;
-        tmp_bit = 0;
-      } else {
-        tmp_bit = (LONG_BYTES * BITS_PER_BYTE) - BUILDIN_CLZL(zigzag_value);
-      }
-
-      if (elems + 1 <= selector_to_elems[(int)selector] && elems + 1 <= selector_to_elems[(int)(bit_to_selector[(int)tmp_bit])]) {
-        // If can hold another one.
-        selector = selector > bit_to_selector[(int)tmp_bit] ? selector : bit_to_selector[(int)tmp_bit];
-        elems++;
-        bit = bit_per_integer[(int)selector];
-      } else {
-        // if cannot hold another one.
-        while (elems < selector_to_elems[(int)selector]) selector++;
-        elems = selector_to_elems[(int)selector];
-        bit = bit_per_integer[(int)selector];
-        break;
-      }
-      prev_value_tmp = curr_value;
-    }
+    if (!tsSimple8bSelect(input, i, nelements, type, prev_value, &selector, &elems)) goto _copy_and_exit;
 
+    char     bit = bit_per_integer[(int)selector];
     uint64_t buffer = 0;
     buffer |= (uint64_t)selector;
     for (int k = 0; k < elems; k++) {
-      int64_t curr_value = 0; /* get current values */
-      switch (type) {
-        case TSDB_DATA_TYPE_TINYINT:
-          curr_value = (int64_t)(*((int8_t *)input + i));
-          break;
-        case TSDB_DATA_TYPE_SMALLINT:
-          curr_value = (int64_t)(*((int16_t *)input + i));
-          break;
-        case TSDB_DATA_TYPE_INT:
-          curr_value = (int64_t)(*((int32_t *)input + i));
-          break;
-        case TSDB_DATA_TYPE_BIGINT:
-          curr_value = (int64_t)(*((int64_t *)input + i));
-          break;
-      }
+      int64_t  curr_value = tsGetINTValue(input, i, type); /* get current values */
       int64_t  diff = curr_value - prev_value;
       uint64_t zigzag_value = ZIGZAG_ENCODE(int64_t, diff);
       buffer |= ((zigzag_value & INT64MASK(bit)) << (bit * k + 4));
@@ -252,17 +306,16 @@ int tsDecompressINTImp(const char *const input, const int nelements, char *const
       return -1;
   }
 
+  if (HEAD_ALGO((uint8_t)input[0]) == ALGO_INT_BITPACK) {
+    return tsDecompressINTBitPackImp(input, nelements, output, type, word_length);
+  }
+
   // If not compressed.
   if (input[0] == 1) {
     memcpy(output, input + 1, nelements * word_length);
     return nelements * word_length;
   }
 
-  // Selector value:              0    1   2   3   4   5   6   7   8  9  10  11
-  // 12  13  14  15
-  char bit_per_integer[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
-  int  selector_to_elems[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
-
   const char *ip = input + 1;
   int         count = 0;
   int         _pos = 0;
@@ -425,6 +478,158 @@ int tsDecompressBoolRLEImp(const char *const input, const int nelements, char *c
   }
 }
 
+/* ----------------------------------------------Zstd Compression
+ * ---------------------------------------------- */
+#ifdef TD_TSZ
+// A trained dictionary, the compression one is bound to the zstd level when the dictionary is trained
+typedef struct {
+  ZSTD_CDict *cdict;
+  ZSTD_DDict *ddict;
+} SZstdDict;
+
+// Creating a context costs more than compressing a block, each thread keeps its own and frees them when it exits
+typedef struct {
+  ZSTD_CCtx *cctx;
+  ZSTD_DCtx *dctx;
+} SZstdCtx;
+
+static threadlocal SZstdCtx tsZstdCtx = {NULL, NULL};
+static pthread_key_t        tsZstdCtxKey;
+static bool                 tsZstdCtxKeyValid = false;
+static pthread_once_t       tsZstdCtxKeyInit = PTHREAD_ONCE_INIT;
+
+static SHashObj      *tsZstdDicts = NULL;  // dictionary id -> SZstdDict, never removed
+static pthread_once_t tsZstdDictsInit = PTHREAD_ONCE_INIT;
+
+static void tsZstdInitDicts() {
+  tsZstdDicts = taosHashInit(16, taosGetDefaultHashFunction(TSDB_DATA_TYPE_UINT), false, HASH_ENTRY_LOCK);
+}
+
+static SZstdDict *tsZstdGetDict(uint32_t dictId) {
+  pthread_once(&tsZstdDictsInit, tsZstdInitDicts);
+  return (tsZstdDicts == NULL) ? NULL : (SZstdDict *)taosHashGet(tsZstdDicts, &dictId, sizeof(dictId));
+}
+
+static void tsZstdFreeCtx(void *param) {
+  SZstdCtx *pCtx = (SZstdCtx *)param;
+  ZSTD_freeCCtx(pCtx->cctx);
+  ZSTD_freeDCtx(pCtx->dctx);
+  pCtx->cctx = NULL;
+  pCtx->dctx = NULL;
+}
+
+static void tsZstdInitCtxKey() { tsZstdCtxKeyValid = (pthread_key_create(&tsZstdCtxKey, tsZstdFreeCtx) == 0); }
+
+// The key destructor frees the contexts of a thread when it exits, it is set when the first one is created
+static void tsZstdKeepCtx() {
+  pthread_once(&tsZstdCtxKeyInit, tsZstdInitCtxKey);
+  if (tsZstdCtxKeyValid) pthread_setspecific(tsZstdCtxKey, &tsZstdCtx);
+}
+
+static ZSTD_CCtx *tsZstdGetCCtx() {
+  if (tsZstdCtx.cctx == NULL && (tsZstdCtx.cctx = ZSTD_createCCtx()) != NULL) tsZstdKeepCtx();
+  return tsZstdCtx.cctx;
+}
+
+static ZSTD_DCtx *tsZstdGetDCtx() {
+  if (tsZstdCtx.dctx == NULL && (tsZstdCtx.dctx = ZSTD_createDCtx()) != NULL) tsZstdKeepCtx();
+  return tsZstdCtx.dctx;
+}
+
+// The main thread does not run the key destructors when the process exits, so its contexts are freed here
+static void tsZstdCleanup() {
+  tsZstdFreeCtx(&tsZstdCtx);
+  if (tsZstdCtxKeyValid) pthread_setspecific(tsZstdCtxKey, NULL);
+}
+
+static int tsDecompressZstdImp(const char *const input, int compressedSize, char *const output, int outputSize) {
+  ZSTD_DCtx *dctx = tsZstdGetDCtx();
+  if (dctx == NULL) {
+    uError("Failed to decompress string with zstd algorithm since out of memory");
+    return -1;
+  }
+
+  size_t   len = 0;
+  uint32_t dictId = ZSTD_getDictID_fromFrame(input, compressedSize);
+  if (dictId != 0) {
+    SZstdDict *pDict = tsZstdGetDict(dictId);
+    if (pDict == NULL) {
+      uError("Failed to decompress string with zstd algorithm since dictionary %u is not loaded", dictId);
+      return -1;
+    }
+    len = ZSTD_decompress_usingDDict(dctx, output, outputSize, input, compressedSize, pDict->ddict);
+  } else {
+    len = ZSTD_decompressDCtx(dctx, output, outputSize, input, compressedSize);
+  }
+
+  if (ZSTD_isError(len)) {
+    uError("Failed to decompress string with zstd algorithm since %s", ZSTD_getErrorName(len));
+    return -1;
+  }
+
+  return (int)len;
+}
+#endif
+
+// The same output as tsCompressStringImp with zstd at tsZstdLevel instead of LZ4, using the trained dictionary dictId
+// unless it is 0. It falls back to LZ4 when zstd is not built in or does not make the input smaller.
+int tsCompressStringZstdImp(const char *const input, int inputSize, char *const output, int outputSize,
+                            uint32_t dictId) {
+#ifdef TD_TSZ
+  ZSTD_CCtx *cctx = tsZstdGetCCtx();
+  if (cctx != NULL) {
+    SZstdDict *pDict = (dictId != 0) ? tsZstdGetDict(dictId) : NULL;
+    size_t     len = 0;
+
+    if (pDict != NULL) {
+      len = ZSTD_compress_usingCDict(cctx, output + 1, outputSize - 1, input, inputSize, pDict->cdict);
+    } else {
+      len = ZSTD_compressCCtx(cctx, output + 1, outputSize - 1, input, inputSize, tsZstdLevel);
+    }
+
+    if (!ZSTD_isError(len) && len < (size_t)inputSize) {
+      output[0] = (ALGO_ZSTD << 1) | MODE_COMPRESS;
+      return (int)len + 1;
+    }
+  }
+#endif
+
+  return tsCompressStringImp(input, inputSize, output, outputSize);
+}
+
+// Trains a zstd dictionary of at most dictCapacity bytes on the samples, which are put one after another, and keeps it
+// for compression and decompression. Returns the id of the dictionary, 0 if it cannot be trained.
+uint32_t tsZstdTrainDict(const char *const samples, const size_t *sampleSizes, int nsamples, int dictCapacity) {
+#ifdef TD_TSZ
+  char *dict = malloc(dictCapacity);
+  if (dict == NULL) return 0;
+
+  size_t size = ZDICT_trainFromBuffer(dict, dictCapacity, samples, sampleSizes, nsamples);
+  if (ZDICT_isError(size)) {
+    uWarn("failed to train zstd dictionary from %d samples since %s", nsamples, ZDICT_getErrorName(size));
+    free(dict);
+    return 0;
+  }
+
+  uint32_t dictId = ZDICT_getDictID(dict, size);
+  if (tsZstdGetDict(dictId) == NULL) {
+    SZstdDict zdict = {ZSTD_createCDict(dict, size, tsZstdLevel), ZSTD_createDDict(dict, size)};
+    if (tsZstdDicts == NULL || zdict.cdict == NULL || zdict.ddict == NULL ||
+        taosHashPut(tsZstdDicts, &dictId, sizeof(dictId), &zdict, sizeof(zdict)) != 0) {
+      ZSTD_freeCDict(zdict.cdict);
+      ZSTD_freeDDict(zdict.ddict);
+      // another thread may have trained the same dictionary meanwhile
+      if (tsZstdGetDict(dictId) == NULL) dictId = 0;
+    }
+  }
+
+  free(dict);
+  return dictId;
+#else
+  return 0;
+#endif
+}
+
 /* ----------------------------------------------String Compression
  * ---------------------------------------------- */
 // Note: the size of the output must be larger than input_size + 1 and
@@ -458,6 +663,11 @@ int tsDecompressStringImp(const char *const input, int compressedSize, char *con
     }
 
     return decompressed_size;
+#ifdef TD_TSZ
+  } else if ((uint8_t)input[0] == ((ALGO_ZSTD << 1) | MODE_COMPRESS)) {  // an invalid indicator without TD_TSZ
+    /* It is compressed by zstd algorithm */
+    return tsDecompressZstdImp(input + 1, compressedSize - 1, output, outputSize);
+#endif
   } else if (input[0] == 0) {
     /* It is not compressed by LZ4 algorithm */
     memcpy(output, input + 1, compressedSize - 1);
@@ -468,8 +678,645 @@ int tsDecompressStringImp(const char *const input, int compressedSize, char *con
   }
 }
 
+/* --------------------------------------------Bit Packing
+ * ---------------------------------------------- */
+// A full miniblock of w bit values is stored as w 128 bit words, value i being in the 32 bit lane i % 4. All lanes are
+// then shifted by the same amounts when unpacked, which the compiler turns into vector shifts. The last miniblock of a
+// column is usually not full, its values are packed one after another.
+#define BP_BLOCK_VALUES 128
+#define BP_LANES        4
+#define BP_BYTES(n, w)  (((n) * (w) + BITS_PER_BYTE - 1) / BITS_PER_BYTE)
+
+// unrolled, the word and the shift of every step are constants and the branches are gone
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 8
+#define BP_UNROLL _Pragma("GCC unroll 32")
+#else
+#define BP_UNROLL
+#endif
+
+// The values must fit in w bits
+static FORCE_INLINE void tsBitPackBlockImp(const uint32_t *in, const int w, uint32_t *words) {
+  BP_UNROLL
+  for (int j = 0; j < BP_BLOCK_VALUES / BP_LANES; j++) {
+    int bit = j * w;
+    int k = bit / 32, s = bit % 32;
+
+    for (int lane = 0; lane < BP_LANES; lane++) {
+      words[k * BP_LANES + lane] |= in[j * BP_LANES + lane] << s;
+      if (s + w > 32) words[(k + 1) * BP_LANES + lane] |= in[j * BP_LANES + lane] >> (32 - s);
+    }
+  }
+}
+
+static FORCE_INLINE void tsBitUnpackBlockImp(const uint32_t *words, const int w, uint32_t *out) {
+  const uint32_t mask = (uint32_t)INT64MASK(w);
+
+  BP_UNROLL
+  for (int j = 0; j < BP_BLOCK_VALUES / BP_LANES; j++) {
+    int bit = j * w;
+    int k = bit / 32, s = bit % 32;
+
+    for (int lane = 0; lane < BP_LANES; lane++) {
+      uint32_t v = words[k * BP_LANES + lane] >> s;
+      if (s + w > 32) v |= words[(k + 1) * BP_LANES + lane] << (32 - s);
+      out[j * BP_LANES + lane] = v & mask;
+    }
+  }
+}
+
+#define BP_PACK_CASE(w) \
+  case w:               \
+    tsBitPackBlockImp(in, w, words); \
+    break;
+
+#define BP_UNPACK_CASE(w) \
+  case w:                 \
+    tsBitUnpackBlockImp(words, w, out); \
+    break;
+
+static void tsBitPackBlock(const uint32_t *in, int w, char *const output) {
+  uint32_t words[BP_BLOCK_VALUES] = {0};
+
+  // one copy for each width, like the unpacking below
+  switch (w) {
+    BP_PACK_CASE(0)  BP_PACK_CASE(1)  BP_PACK_CASE(2)  BP_PACK_CASE(3)  BP_PACK_CASE(4)
+    BP_PACK_CASE(5)  BP_PACK_CASE(6)  BP_PACK_CASE(7)  BP_PACK_CASE(8)  BP_PACK_CASE(9)
+    BP_PACK_CASE(10) BP_PACK_CASE(11) BP_PACK_CASE(12) BP_PACK_CASE(13) BP_PACK_CASE(14)
+    BP_PACK_CASE(15) BP_PACK_CASE(16) BP_PACK_CASE(17) BP_PACK_CASE(18) BP_PACK_CASE(19)
+    BP_PACK_CASE(20) BP_PACK_CASE(21) BP_PACK_CASE(22) BP_PACK_CASE(23) BP_PACK_CASE(24)
+    BP_PACK_CASE(25) BP_PACK_CASE(26) BP_PACK_CASE(27) BP_PACK_CASE(28) BP_PACK_CASE(29)
+    BP_PACK_CASE(30) BP_PACK_CASE(31) BP_PACK_CASE(32)
+    default:
+      assert(0);
+  }
+
+  memcpy(output, words, BP_BYTES(BP_BLOCK_VALUES, w));
+}
+
+static void tsBitUnpackBlock(const char *const input, int w, uint32_t *out) {
+  uint32_t words[BP_BLOCK_VALUES];
+  memcpy(words, input, BP_BYTES(BP_BLOCK_VALUES, w));
+
+  // one copy for each width, the shifts of which are constants
+  switch (w) {
+    BP_UNPACK_CASE(0)  BP_UNPACK_CASE(1)  BP_UNPACK_CASE(2)  BP_UNPACK_CASE(3)  BP_UNPACK_CASE(4)
+    BP_UNPACK_CASE(5)  BP_UNPACK_CASE(6)  BP_UNPACK_CASE(7)  BP_UNPACK_CASE(8)  BP_UNPACK_CASE(9)
+    BP_UNPACK_CASE(10) BP_UNPACK_CASE(11) BP_UNPACK_CASE(12) BP_UNPACK_CASE(13) BP_UNPACK_CASE(14)
+    BP_UNPACK_CASE(15) BP_UNPACK_CASE(16) BP_UNPACK_CASE(17) BP_UNPACK_CASE(18) BP_UNPACK_CASE(19)
+    BP_UNPACK_CASE(20) BP_UNPACK_CASE(21) BP_UNPACK_CASE(22) BP_UNPACK_CASE(23) BP_UNPACK_CASE(24)
+    BP_UNPACK_CASE(25) BP_UNPACK_CASE(26) BP_UNPACK_CASE(27) BP_UNPACK_CASE(28) BP_UNPACK_CASE(29)
+    BP_UNPACK_CASE(30) BP_UNPACK_CASE(31) BP_UNPACK_CASE(32)
+    default:
+      assert(0);
+  }
+}
+
+static int tsBitPackTail(const uint32_t *in, int nelements, int w, char *const output) {
+  uint64_t acc = 0;
+  int      nbits = 0, pos = 0;
+
+  for (int i = 0; i < nelements; i++) {
+    acc |= (uint64_t)in[i] << nbits;
+    for (nbits += w; nbits >= BITS_PER_BYTE; nbits -= BITS_PER_BYTE) {
+      output[pos++] = (char)acc;
+      acc >>= BITS_PER_BYTE;
+    }
+  }
+  if (nbits > 0) output[pos++] = (char)acc;
+
+  return pos;
+}
+
+static void tsBitUnpackTail(const char *const input, int nelements, int w, uint32_t *out) {
+  uint64_t acc = 0;
+  int      nbits = 0, pos = 0;
+
+  for (int i = 0; i < nelements; i++) {
+    for (; nbits < w; nbits += BITS_PER_BYTE) {
+      acc |= (uint64_t)(uint8_t)input[pos++] << nbits;
+    }
+    out[i] = (uint32_t)(acc & INT64MASK(w));
+    acc >>= w;
+    nbits -= w;
+  }
+}
+
+static int tsBitPack(const uint32_t *in, int nelements, int w, char *const output) {
+  if (nelements == BP_BLOCK_VALUES) {
+    tsBitPackBlock(in, w, output);
+    return BP_BYTES(BP_BLOCK_VALUES, w);
+  }
+
+  return tsBitPackTail(in, nelements, w, output);
+}
+
+static int tsBitUnpack(const char *const input, int nelements, int w, uint32_t *out) {
+  if (nelements == BP_BLOCK_VALUES) {
+    tsBitUnpackBlock(input, w, out);
+  } else {
+    tsBitUnpackTail(input, nelements, w, out);
+  }
+
+  return BP_BYTES(nelements, w);
+}
+
+/* --------------------------------------------Frame of Reference Miniblocks
+ * ---------------------------------------------- */
+// A miniblock of up to 128 integers is stored as a base, the bit width of the integers above it and the bit packed
+// integers, then the positions and the raw values of its exceptions, the values too far from the base which are
+// packed as 0. With FOR_DELTA set next to the bit width, the integers are the differences to the previous values.
+#define FOR_BLOCK_HEAD  (LONG_BYTES + CHAR_BYTES * 2)  // base, bit width and flags, number of exceptions
+#define FOR_WIDTH_MASK  0x3F
+#define FOR_DELTA       0x80
+#define FOR_BLOCK_BYTES(nvalues, w, nexc, bytes) \
+  (FOR_BLOCK_HEAD + BP_BYTES(nvalues, w) + (nexc) * (CHAR_BYTES + (bytes)))
+
+// The raw value of exception k is the first bytes at raw + excs[k] * stride
+static int tsForPackBlock(int64_t base, int flags, const uint32_t *deltas, int nvalues, int w, const uint8_t *excs,
+                          int nexc, const char *const raw, int stride, int bytes, char *const output) {
+  memcpy(output, &base, LONG_BYTES);
+  output[LONG_BYTES] = (char)(w | flags);
+  output[LONG_BYTES + CHAR_BYTES] = (char)nexc;
+
+  int pos = FOR_BLOCK_HEAD;
+  pos += tsBitPack(deltas, nvalues, w, output + pos);
+  for (int k = 0; k < nexc; k++) {
+    output[pos++] = (char)excs[k];
+  }
+  for (int k = 0; k < nexc; k++, pos += bytes) {
+    memcpy(output + pos, raw + excs[k] * stride, bytes);
+  }
+
+  return pos;
+}
+
+// Unpacks the integers of a miniblock above its base, returns the size up to the exceptions
+static int tsForUnpackBlock(const char *const input, int nvalues, int64_t *base, int *flags, int *nexc,
+                            uint32_t *deltas) {
+  int w = (uint8_t)input[LONG_BYTES] & FOR_WIDTH_MASK;
+
+  memcpy(base, input, LONG_BYTES);
+  *flags = (uint8_t)input[LONG_BYTES] & ~FOR_WIDTH_MASK;
+  *nexc = (uint8_t)input[LONG_BYTES + CHAR_BYTES];
+
+  if (w == 0) {
+    memset(deltas, 0, nvalues * sizeof(uint32_t));
+    return FOR_BLOCK_HEAD;
+  }
+
+  return FOR_BLOCK_HEAD + tsBitUnpack(input + FOR_BLOCK_HEAD, nvalues, w, deltas);
+}
+
+// Puts the exceptions back at output + position * stride, returns their size
+static int tsForPatchExceptions(const char *const input, int nexc, int bytes, char *const output, int stride) {
+  for (int k = 0; k < nexc; k++) {
+    memcpy(output + (uint8_t)input[k] * stride, input + nexc + k * bytes, bytes);
+  }
+
+  return nexc * (CHAR_BYTES + bytes);
+}
+
+/* --------------------------------------------Integer Bit Packing
+ * ---------------------------------------------- */
+// Each miniblock keeps its integers either as they are or as the differences to the previous values, whichever is
+// the smallest, with the bit width that makes the miniblock the smallest once the values beyond it are exceptions.
+// Everything is computed modulo the width of the type, so unsigned columns, which are compressed as the signed type of
+// the same width, come out right. The null values of both kinds are left out of the base, they are far from the rest.
+typedef struct {
+  uint64_t base;
+  int      flags;
+  int      w;
+  int      len;
+} SIntForChoice;
+
+static FORCE_INLINE int64_t tsIntForSigned(uint64_t v, int bits) {
+  return (int64_t)(v << (LONG_BYTES * BITS_PER_BYTE - bits)) >> (LONG_BYTES * BITS_PER_BYTE - bits);
+}
+
+// Keeps in pBest the base and the bit width for x if they make a smaller miniblock
+static void tsIntForTry(const uint64_t *x, int nvalues, uint64_t base, uint64_t mask, int bytes, int flags,
+                        SIntForChoice *pBest) {
+  int hist[LONG_BYTES * BITS_PER_BYTE + 1] = {0};
+
+  for (int i = 0; i < nvalues; i++) {
+    uint64_t d = (x[i] - base) & mask;
+    hist[(d == 0) ? 0 : (LONG_BYTES * BITS_PER_BYTE - BUILDIN_CLZL(d))]++;
+  }
+
+  int nexc = nvalues;
+  for (int w = 0; w <= 32; w++) {
+    nexc -= hist[w];
+
+    int len = FOR_BLOCK_BYTES(nvalues, w, nexc, bytes);
+    if (len < pBest->len) {
+      pBest->base = base;
+      pBest->flags = flags;
+      pBest->w = w;
+      pBest->len = len;
+    }
+  }
+}
+
+// Returns the size of the miniblock, or -1 if it goes beyond limit. prev is the value before the miniblock.
+static int tsIntForPackBlock(const uint64_t *vals, uint64_t prev, int nvalues, int bits, int bytes, char *const output,
+                             int limit) {
+  uint64_t mask = (bits == LONG_BYTES * BITS_PER_BYTE) ? UINT64_MAX : INT64MASK(bits);
+  uint64_t smin = (uint64_t)1 << (bits - 1);
+  uint64_t diffs[BP_BLOCK_VALUES];
+  int64_t  minValue = INT64_MAX, minDiff = INT64_MAX;
+  uint64_t minUValue = UINT64_MAX;
+  bool     prevNull = (prev == smin || prev == mask);
+
+  for (int i = 0; i < nvalues; i++) {
+    bool isNull = (vals[i] == smin || vals[i] == mask);
+
+    diffs[i] = (vals[i] - ((i == 0) ? prev : vals[i - 1])) & mask;
+    if (!isNull) {
+      minValue = MIN(minValue, tsIntForSigned(vals[i], bits));
+      minUValue = MIN(minUValue, vals[i]);
+      if (!prevNull) minDiff = MIN(minDiff, tsIntForSigned(diffs[i], bits));
+    }
+    prevNull = isNull;
+  }
+
+  // the signed and the unsigned minimum only differ if the values have both signs
+  SIntForChoice best = {.len = INT32_MAX};
+  tsIntForTry(vals, nvalues, (uint64_t)minValue & mask, mask, bytes, 0, &best);
+  if (((uint64_t)minValue & mask) != (minUValue & mask)) {
+    tsIntForTry(vals, nvalues, minUValue & mask, mask, bytes, 0, &best);
+  }
+  tsIntForTry(diffs, nvalues, (uint64_t)minDiff & mask, mask, bytes, FOR_DELTA, &best);
+  if (best.len >= limit) return -1;
+
+  const uint64_t *x = (best.flags & FOR_DELTA) ? diffs : vals;
+  uint32_t        deltas[BP_BLOCK_VALUES];
+  uint8_t         excs[BP_BLOCK_VALUES];
+  int             nexc = 0;
+
+  for (int i = 0; i < nvalues; i++) {
+    uint64_t d = (x[i] - best.base) & mask;
+    if (d >> best.w) {
+      excs[nexc++] = (uint8_t)i;
+      d = 0;
+    }
+    deltas[i] = (uint32_t)d;
+  }
+
+  return tsForPackBlock((int64_t)best.base, best.flags, deltas, nvalues, best.w, excs, nexc, (const char *)x,
+                        LONG_BYTES, bytes, output);
+}
+
+// Returns 0 if the simple8b encoding is at least as small
+static int tsCompressINTBitPackImp(const char *const input, const int nelements, char *const output, const char type,
+                                   int word_length) {
+  int      bits = word_length * BITS_PER_BYTE;
+  uint64_t mask = (bits == LONG_BYTES * BITS_PER_BYTE) ? UINT64_MAX : INT64MASK(bits);
+  int      limit = nelements * word_length + 1;
+  int      pos = CHAR_BYTES;
+  uint64_t prev = 0;
+  uint64_t vals[BP_BLOCK_VALUES];
+
+  output[0] = (ALGO_INT_BITPACK << 1) | MODE_COMPRESS;
+
+  for (int start = 0; start < nelements; start += BP_BLOCK_VALUES) {
+    int nvalues = MIN(BP_BLOCK_VALUES, nelements - start);
+
+    for (int i = 0; i < nvalues; i++) {
+      vals[i] = (uint64_t)tsGetINTValue(input, start + i, type) & mask;
+    }
+
+    int len = tsIntForPackBlock(vals, prev, nvalues, bits, word_length, output + pos, limit - pos);
+    if (len < 0) return 0;
+    pos += len;
+    prev = vals[nvalues - 1];
+  }
+
+  // the simple8b encoding, if chosen, is written over this one
+  return (tsSimple8bSize(input, nelements, type, word_length, pos) > pos) ? pos : 0;
+}
+
+#define INT_FOR_VALUES(T, UT)                           \
+  for (int i = 0; i < nvalues; i++) {                   \
+    ((T *)ovalues)[i] = (T)((UT)base + (UT)deltas[i]); \
+  }
+
+#define INT_FOR_PREFIX_SUM(T)       \
+  for (int i = 0; i < nvalues; i++) { \
+    prev += diffs[i];                 \
+    ((T *)ovalues)[i] = (T)prev;      \
+  }
+
+static int tsDecompressINTBitPackImp(const char *const input, const int nelements, char *const output, const char type,
+                                     int word_length) {
+  int      pos = CHAR_BYTES;
+  int64_t  base = 0;
+  int      flags = 0, nexc = 0;
+  uint64_t prev = 0;
+  uint32_t deltas[BP_BLOCK_VALUES];
+  uint64_t diffs[BP_BLOCK_VALUES];
+
+  for (int start = 0; start < nelements; start += BP_BLOCK_VALUES) {
+    int   nvalues = MIN(BP_BLOCK_VALUES, nelements - start);
+    char *ovalues = output + start * word_length;
+
+    pos += tsForUnpackBlock(input + pos, nvalues, &base, &flags, &nexc, deltas);
+
+    if (flags & FOR_DELTA) {
+      for (int i = 0; i < nvalues; i++) {
+        diffs[i] = (uint64_t)base + deltas[i];
+      }
+      pos += tsForPatchExceptions(input + pos, nexc, word_length, (char *)diffs, LONG_BYTES);
+
+      switch (type) {
+        case TSDB_DATA_TYPE_TINYINT:
+          INT_FOR_PREFIX_SUM(int8_t);
+          break;
+        case TSDB_DATA_TYPE_SMALLINT:
+          INT_FOR_PREFIX_SUM(int16_t);
+          break;
+        case TSDB_DATA_TYPE_INT:
+          INT_FOR_PREFIX_SUM(int32_t);
+          break;
+        default:
+          INT_FOR_PREFIX_SUM(int64_t);
+          break;
+      }
+    } else {
+      switch (type) {
+        case TSDB_DATA_TYPE_TINYINT:
+          INT_FOR_VALUES(int8_t, uint8_t);
+          break;
+        case TSDB_DATA_TYPE_SMALLINT:
+          INT_FOR_VALUES(int16_t, uint16_t);
+          break;
+        case TSDB_DATA_TYPE_INT:
+          INT_FOR_VALUES(int32_t, uint32_t);
+          break;
+        default:
+          INT_FOR_VALUES(int64_t, uint64_t);
+          break;
+      }
+      pos += tsForPatchExceptions(input + pos, nexc, word_length, ovalues, word_length);
+
+      prev = 0;
+      memcpy(&prev, ovalues + (nvalues - 1) * word_length, word_length);
+    }
+  }
+
+  return nelements * word_length;
+}
+
+/* --------------------------------------------String Dictionary Compression
+ * ---------------------------------------------- */
+// The var data of a column block with at most TSDB_STR_DICT_MAX_VALUES distinct values is stored as the number of
+// values, the bit width of their codes, the values in the order they first appear and the code of each row bit packed
+// in miniblocks. The codes are kept by the readers, so that the filters of a query compare each value only once.
+#define STR_DICT_HEAD  (CHAR_BYTES * 3)  // head, number of values - 1, bit width of the codes
+#define STR_DICT_SLOTS (TSDB_STR_DICT_MAX_VALUES * 2)
+
+static int tsStringDictCodesSize(int nelements, int w) {
+  int nfull = nelements / BP_BLOCK_VALUES;
+  return nfull * BP_BYTES(BP_BLOCK_VALUES, w) + BP_BYTES(nelements - nfull * BP_BLOCK_VALUES, w);
+}
+
+// Returns the size of the dictionary form or of the LZ4 form when that is smaller, written into output, or 0 if the
+// input is not the var data of nelements rows or has too many distinct values. The LZ4 form is built in buffer.
+int tsCompressStringDictImp(const char *const input, int inputSize, const int nelements, char *const output,
+                            int outputSize, char *const buffer, int bufferSize) {
+  if (!tsStringDictEncode || buffer == NULL || nelements <= 0 || nelements > TSDB_MAX_MAX_ROW_FBLOCK) return 0;
+
+  uint8_t  codes[TSDB_MAX_MAX_ROW_FBLOCK];
+  int32_t  offsets[TSDB_STR_DICT_MAX_VALUES];  // of the values in input
+  uint16_t slots[STR_DICT_SLOTS] = {0};        // code + 1 of the value hashed there, 0 if empty
+  int      nvalues = 0, dictLen = 0, pos = 0, prev = -1;
+
+  for (int i = 0; i < nelements; i++) {
+    if (pos + VARSTR_HEADER_SIZE > inputSize) return 0;
+
+    const char *val = input + pos;
+    int         tlen = varDataTLen(val);
+    if (pos + tlen > inputSize) return 0;
+
+    // runs of one value are common, the hash is only needed when the value changes
+    if (prev >= 0 && varDataTLen(input + offsets[prev]) == tlen && memcmp(input + offsets[prev], val, tlen) == 0) {
+      codes[i] = (uint8_t)prev;
+      pos += tlen;
+      continue;
+    }
+
+    uint32_t h = MurmurHash3_32(val, tlen) & (STR_DICT_SLOTS - 1);
+    for (; slots[h] != 0; h = (h + 1) & (STR_DICT_SLOTS - 1)) {
+      const char *dval = input + offsets[slots[h] - 1];
+      if (varDataTLen(dval) == tlen && memcmp(dval, val, tlen) == 0) break;
+    }
+
+    if (slots[h] == 0) {
+      if (nvalues == TSDB_STR_DICT_MAX_VALUES) return 0;
+      offsets[nvalues] = pos;
+      dictLen += tlen;
+      slots[h] = (uint16_t)(++nvalues);
+    }
+
+    prev = slots[h] - 1;
+    codes[i] = (uint8_t)prev;
+    pos += tlen;
+  }
+
+  // a fixed size layout, like the query results, is not var data one after another
+  if (pos != inputSize) return 0;
+
+  int w = (nvalues == 1) ? 0 : (32 - BUILDIN_CLZ((uint32_t)(nvalues - 1)));
+  int len = STR_DICT_HEAD + dictLen + tsStringDictCodesSize(nelements, w);
+  if (len > inputSize || len > outputSize) return 0;
+
+  // the LZ4 form wins when it is smaller, long runs of a few values compress well
+  int zcap = MIN(len - 2, bufferSize - 1);
+  int zlen = (zcap > 0) ? LZ4_compress_default(input, buffer + 1, inputSize, zcap) : 0;
+  if (zlen > 0) {
+    output[0] = 1;
+    memcpy(output + 1, buffer + 1, zlen);
+    return zlen + 1;
+  }
+
+  output[0] = (ALGO_STR_DICT << 1) | MODE_COMPRESS;
+  output[1] = (char)(nvalues - 1);
+  output[2] = (char)w;
+  pos = STR_DICT_HEAD;
+  for (int v = 0; v < nvalues; v++) {
+    int tlen = varDataTLen(input + offsets[v]);
+    memcpy(output + pos, input + offsets[v], tlen);
+    pos += tlen;
+  }
+
+  uint32_t block[BP_BLOCK_VALUES];
+  for (int start = 0; start < nelements; start += BP_BLOCK_VALUES) {
+    int nvals = MIN(BP_BLOCK_VALUES, nelements - start);
+    for (int i = 0; i < nvals; i++) {
+      block[i] = codes[start + i];
+    }
+    pos += tsBitPack(block, nvals, w, output + pos);
+  }
+
+  assert(pos == len);
+  return len;
+}
+
+// Returns the size of the var data, the code of each row is also written into codes if it is not NULL
+int tsDecompressStringDictImp(const char *const input, int compressedSize, const int nelements, char *const output,
+                              int outputSize, uint8_t *codes) {
+  const char *values[TSDB_STR_DICT_MAX_VALUES];
+  int         nvalues = (uint8_t)input[1] + 1;
+  int         w = (uint8_t)input[2];
+  int         pos = STR_DICT_HEAD;
+
+  for (int v = 0; v < nvalues; v++) {
+    if (pos + VARSTR_HEADER_SIZE > compressedSize) goto _err;
+    values[v] = input + pos;
+    pos += varDataTLen(input + pos);
+  }
+
+  if (w > BITS_PER_BYTE || pos + tsStringDictCodesSize(nelements, w) != compressedSize) goto _err;
+
+  uint32_t block[BP_BLOCK_VALUES];
+  int      opos = 0;
+  for (int start = 0; start < nelements; start += BP_BLOCK_VALUES) {
+    int nvals = MIN(BP_BLOCK_VALUES, nelements - start);
+    pos += tsBitUnpack(input + pos, nvals, w, block);
+
+    for (int i = 0; i < nvals; i++) {
+      if (block[i] >= (uint32_t)nvalues) goto _err;
+
+      const char *val = values[block[i]];
+      int         tlen = varDataTLen(val);
+      if (opos + tlen > outputSize) goto _err;
+
+      memcpy(output + opos, val, tlen);
+      opos += tlen;
+    }
+
+    if (codes != NULL) {
+      for (int i = 0; i < nvals; i++) {
+        codes[start + i] = (uint8_t)block[i];
+      }
+    }
+  }
+
+  return opos;
+
+_err:
+  uError("Invalid dictionary encoded string, compressed size:%d rows:%d", compressedSize, nelements);
+  return -1;
+}
+
 /* --------------------------------------------Timestamp Compression
  * ---------------------------------------------- */
+#define TS_BITPACK_REGULAR 0  // start, step
+#define TS_BITPACK_DELTA   1  // start, minimum delta, a bit width for each miniblock and the miniblocks
+#define TS_BITPACK_HEAD    (CHAR_BYTES * 2 + LONG_BYTES * 2)
+
+// Returns 0 if the old encoding is at least as small
+static int tsCompressTimestampBitPackImp(const char *const input, const int nelements, char *const output) {
+  int64_t *istream = (int64_t *)input;
+  int64_t  minDelta = INT64_MAX, maxDelta = INT64_MIN;
+
+  if (nelements < 2 || istream[0] == INT64_MIN) return 0;
+
+  // size of the delta of delta encoding, see below
+  int64_t prevDelta = -istream[0];
+  int     oldLen = 1 + (nelements + 1) / 2;
+  for (int i = 0; i < nelements; i++) {
+    int64_t prevValue = (i == 0) ? istream[0] : istream[i - 1];
+    if (!safeInt64Add(istream[i], -prevValue)) return 0;
+
+    int64_t delta = istream[i] - prevValue;
+    if (!safeInt64Add(delta, -prevDelta)) {
+      oldLen = nelements * LONG_BYTES + 1;
+    } else if (oldLen <= nelements * LONG_BYTES) {
+      uint64_t zigzag = ZIGZAG_ENCODE(int64_t, delta - prevDelta);
+      oldLen += (zigzag == 0) ? 0 : (LONG_BYTES - BUILDIN_CLZL(zigzag) / BITS_PER_BYTE);
+    }
+    prevDelta = delta;
+
+    if (i > 0) {
+      minDelta = MIN(minDelta, delta);
+      maxDelta = MAX(maxDelta, delta);
+    }
+  }
+  oldLen = MIN(oldLen, nelements * LONG_BYTES + 1);
+
+  if (TS_BITPACK_HEAD >= oldLen || (uint64_t)maxDelta - (uint64_t)minDelta > UINT32_MAX) return 0;
+
+  output[0] = (ALGO_TS_BITPACK << 1) | MODE_COMPRESS;
+  output[1] = (minDelta == maxDelta) ? TS_BITPACK_REGULAR : TS_BITPACK_DELTA;
+  memcpy(output + CHAR_BYTES * 2, istream, LONG_BYTES);
+  memcpy(output + CHAR_BYTES * 2 + LONG_BYTES, &minDelta, LONG_BYTES);
+  if (output[1] == TS_BITPACK_REGULAR) return TS_BITPACK_HEAD;
+
+  int      nblocks = (nelements - 1 + BP_BLOCK_VALUES - 1) / BP_BLOCK_VALUES;
+  int      pos = TS_BITPACK_HEAD + nblocks;
+  uint32_t deltas[BP_BLOCK_VALUES];
+
+  for (int b = 0; b < nblocks; b++) {
+    int      start = 1 + b * BP_BLOCK_VALUES;
+    int      nvalues = MIN(BP_BLOCK_VALUES, nelements - start);
+    uint32_t bits = 0;
+
+    for (int i = 0; i < nvalues; i++) {
+      deltas[i] = (uint32_t)((uint64_t)(istream[start + i] - istream[start + i - 1]) - (uint64_t)minDelta);
+      bits |= deltas[i];
+    }
+
+    int w = (bits == 0) ? 0 : (32 - BUILDIN_CLZ(bits));
+    if (pos + BP_BYTES(nvalues, w) >= oldLen) return 0;
+
+    output[TS_BITPACK_HEAD + b] = (char)w;
+    pos += tsBitPack(deltas, nvalues, w, output + pos);
+  }
+
+  return pos;
+}
+
+static int tsDecompressTimestampBitPackImp(const char *const input, const int nelements, char *const output) {
+  int64_t *ostream = (int64_t *)output;
+  int64_t  value = 0, minDelta = 0;
+
+  memcpy(&value, input + CHAR_BYTES * 2, LONG_BYTES);
+  memcpy(&minDelta, input + CHAR_BYTES * 2 + LONG_BYTES, LONG_BYTES);
+
+  if (input[1] == TS_BITPACK_REGULAR) {
+    for (int i = 0; i < nelements; i++) {
+      ostream[i] = value + minDelta * i;
+    }
+    return nelements * LONG_BYTES;
+  }
+
+  int      nblocks = (nelements - 1 + BP_BLOCK_VALUES - 1) / BP_BLOCK_VALUES;
+  int      pos = TS_BITPACK_HEAD + nblocks;
+  uint32_t deltas[BP_BLOCK_VALUES];
+
+  ostream[0] = value;
+  for (int b = 0; b < nblocks; b++) {
+    int      nvalues = MIN(BP_BLOCK_VALUES, nelements - 1 - b * BP_BLOCK_VALUES);
+    int      w = (uint8_t)input[TS_BITPACK_HEAD + b];
+    int64_t *ovalues = ostream + 1 + b * BP_BLOCK_VALUES;
+
+    if (w == 0) {  // a regular run
+      for (int i = 0; i < nvalues; i++) {
+        ovalues[i] = value + minDelta * (i + 1);
+      }
+    } else {
+      pos += tsBitUnpack(input + pos, nvalues, w, deltas);
+      for (int i = 0; i < nvalues; i++) {
+        value += minDelta + (int64_t)deltas[i];
+        ovalues[i] = value;
+      }
+    }
+    value = ovalues[nvalues - 1];
+  }
+
+  return nelements * LONG_BYTES;
+}
+
 // TODO: Take care here, we assumes little endian encoding.
 int tsCompressTimestampImp(const char *const input, const int nelements, char *const output) {
   int _pos = 1;
@@ -477,6 +1324,11 @@ int tsCompressTimestampImp(const char *const input, const int nelements, char *c
 
   if (nelements == 0) return 0;
 
+  if (tsTimestampBitPack && !is_bigendian()) {
+    int len = tsCompressTimestampBitPackImp(input, nelements, output);
+    if (len > 0) return len;
+  }
+
   int64_t *istream = (int64_t *)input;
 
   int64_t  prev_value = istream[0];
@@ -631,11 +1483,474 @@ int tsDecompressTimestampImp(const char *const input, const int nelements, char
       if (opos == nelements) return nelements * LONG_BYTES;
     }
 
+  } else if (HEAD_ALGO((uint8_t)input[0]) == ALGO_TS_BITPACK) {
+    return tsDecompressTimestampBitPackImp(input, nelements, output);
   } else {
     assert(0);
     return -1;
   }
 }
+/* --------------------------------------------Compressed Domain Statistics
+ * ---------------------------------------------- */
+// The statistics of rows [start, end] of a column are computed from its encoded form, one miniblock at a time in a
+// buffer of 128 values instead of the decoded column. Constant miniblocks and timestamps of a fixed interval are not
+// even unpacked, nor are the bytes of booleans. Only bit packed integers and timestamps and booleans are supported.
+
+static FORCE_INLINE void tsStatisAddRun(SCompStatis *pStatis, uint64_t v, int n, int index, bool isUnsigned) {
+  pStatis->sum = (int64_t)((uint64_t)pStatis->sum + v * (uint64_t)n);
+
+  if (isUnsigned ? ((uint64_t)pStatis->min > v) : (pStatis->min > (int64_t)v)) {
+    pStatis->min = (int64_t)v;
+    pStatis->minIndex = index;
+  }
+
+  if (isUnsigned ? ((uint64_t)pStatis->max < v) : (pStatis->max < (int64_t)v)) {
+    pStatis->max = (int64_t)v;
+    pStatis->maxIndex = index;
+  }
+}
+
+// vals holds the values of the rows from first, the signed ones sign extended
+static void tsStatisAddValues(SCompStatis *pStatis, const uint64_t *vals, int first, int start, int end, uint64_t null,
+                              bool isUnsigned) {
+  int lo = MAX(start, first), hi = MIN(end + 1, first + BP_BLOCK_VALUES);
+
+  for (int i = lo; i < hi; i++) {
+    if (vals[i - first] == null) {
+      pStatis->numOfNull++;
+    } else {
+      tsStatisAddRun(pStatis, vals[i - first], 1, i - start, isUnsigned);
+    }
+  }
+}
+
+static int tsStatisINTBitPackImp(const char *const input, const int nelements, int start, int end, int word_length,
+                                 bool isUnsigned, SCompStatis *pStatis) {
+  int      bits = word_length * BITS_PER_BYTE;
+  uint64_t mask = (bits == LONG_BYTES * BITS_PER_BYTE) ? UINT64_MAX : INT64MASK(bits);
+  uint64_t null = isUnsigned ? mask : (uint64_t)tsIntForSigned((uint64_t)1 << (bits - 1), bits);
+  int      pos = CHAR_BYTES;
+  uint64_t prev = 0;
+  uint32_t deltas[BP_BLOCK_VALUES];
+  uint64_t vals[BP_BLOCK_VALUES];
+
+  for (int first = 0; first <= end; first += BP_BLOCK_VALUES) {
+    int     nvalues = MIN(BP_BLOCK_VALUES, nelements - first);
+    int     w = (uint8_t)input[pos + LONG_BYTES] & FOR_WIDTH_MASK;
+    int     flags = (uint8_t)input[pos + LONG_BYTES] & ~FOR_WIDTH_MASK;
+    int     nexc = (uint8_t)input[pos + LONG_BYTES + CHAR_BYTES];
+    int64_t base = 0;
+
+    memcpy(&base, input + pos, LONG_BYTES);
+
+    // a miniblock of one value, or of differences of 0 to the previous one
+    if (w == 0 && nexc == 0 && (!(flags & FOR_DELTA) || base == 0)) {
+      uint64_t v = (flags & FOR_DELTA) ? prev : ((uint64_t)base & mask);
+      uint64_t x = isUnsigned ? v : (uint64_t)tsIntForSigned(v, bits);
+      int      lo = MAX(start, first), hi = MIN(end + 1, first + nvalues);
+
+      if (hi > lo && x == null) {
+        pStatis->numOfNull += hi - lo;
+      } else if (hi > lo) {
+        tsStatisAddRun(pStatis, x, hi - lo, lo - start, isUnsigned);
+      }
+
+      pos += FOR_BLOCK_HEAD;
+      prev = v;
+      continue;
+    }
+
+    pos += tsForUnpackBlock(input + pos, nvalues, &base, &flags, &nexc, deltas);
+    if (flags & FOR_DELTA) {
+      for (int i = 0; i < nvalues; i++) {
+        vals[i] = (uint64_t)base + deltas[i];
+      }
+      pos += tsForPatchExceptions(input + pos, nexc, word_length, (char *)vals, LONG_BYTES);
+      for (int i = 0; i < nvalues; i++) {
+        prev += vals[i];
+        vals[i] = prev & mask;
+      }
+    } else {
+      for (int i = 0; i < nvalues; i++) {
+        vals[i] = ((uint64_t)base + deltas[i]) & mask;
+      }
+      pos += tsForPatchExceptions(input + pos, nexc, word_length, (char *)vals, LONG_BYTES);
+    }
+    prev = vals[nvalues - 1];
+
+    if (first + nvalues <= start) continue;
+    if (!isUnsigned) {
+      for (int i = 0; i < nvalues; i++) {
+        vals[i] = (uint64_t)tsIntForSigned(vals[i], bits);
+      }
+    }
+    tsStatisAddValues(pStatis, vals, first, start, end, null, isUnsigned);
+  }
+
+  return 0;
+}
+
+static int tsStatisTimestampBitPackImp(const char *const input, const int nelements, int start, int end,
+                                       SCompStatis *pStatis) {
+  int64_t  value = 0, minDelta = 0;
+  uint32_t deltas[BP_BLOCK_VALUES];
+  uint64_t vals[BP_BLOCK_VALUES];
+
+  memcpy(&value, input + CHAR_BYTES * 2, LONG_BYTES);
+  memcpy(&minDelta, input + CHAR_BYTES * 2 + LONG_BYTES, LONG_BYTES);
+
+  if (input[1] == TS_BITPACK_REGULAR) {
+    int      n = end - start + 1;
+    uint64_t lo = (uint64_t)value + (uint64_t)minDelta * start;
+    uint64_t hi = lo + (uint64_t)minDelta * (n - 1);
+    if ((int64_t)lo == INT64_MIN || (int64_t)hi == INT64_MIN) return -1;
+
+    // the first of equal values keeps the index
+    pStatis->sum = (int64_t)(lo * n + (uint64_t)minDelta * ((uint64_t)n * (n - 1) / 2));
+    pStatis->min = (int64_t)((minDelta >= 0) ? lo : hi);
+    pStatis->max = (int64_t)((minDelta >= 0) ? hi : lo);
+    pStatis->minIndex = (minDelta >= 0) ? 0 : n - 1;
+    pStatis->maxIndex = (minDelta > 0) ? n - 1 : 0;
+    return 0;
+  }
+
+  int pos = TS_BITPACK_HEAD + (nelements - 1 + BP_BLOCK_VALUES - 1) / BP_BLOCK_VALUES;
+
+  vals[0] = (uint64_t)value;
+  tsStatisAddValues(pStatis, vals, 0, start, MIN(end, 0), (uint64_t)INT64_MIN, false);
+
+  for (int b = 0; 1 + b * BP_BLOCK_VALUES <= end; b++) {
+    int first = 1 + b * BP_BLOCK_VALUES;
+    int nvalues = MIN(BP_BLOCK_VALUES, nelements - first);
+    int w = (uint8_t)input[TS_BITPACK_HEAD + b];
+
+    if (w == 0) {
+      for (int i = 0; i < nvalues; i++) {
+        vals[i] = (uint64_t)value + (uint64_t)minDelta * (i + 1);
+      }
+    } else {
+      pos += tsBitUnpack(input + pos, nvalues, w, deltas);
+      for (int i = 0; i < nvalues; i++) {
+        vals[i] = (uint64_t)value + (uint64_t)minDelta + deltas[i];
+        value = (int64_t)vals[i];
+      }
+    }
+    value = (int64_t)vals[nvalues - 1];
+
+    if (first + nvalues > start) {
+      tsStatisAddValues(pStatis, vals, first, start, end, (uint64_t)INT64_MIN, false);
+    }
+  }
+
+  return 0;
+}
+
+// The number of bits set in x, whose bits are all at even positions
+static FORCE_INLINE int tsBoolCount(uint8_t x) {
+  x = (x & 0x33) + ((x >> 2) & 0x33);
+  return (x & 0x0F) + (x >> 4);
+}
+
+// Each byte holds 4 booleans of 2 bits, 1 for true, 2 for null and 0 for false. Once both values are seen, whole bytes
+// are counted at once.
+static int tsStatisBoolImp(const char *const input, int start, int end, SCompStatis *pStatis) {
+  int64_t trues = 0;
+
+  for (int i = start; i <= end;) {
+    uint8_t b = (uint8_t)input[i / 4];
+
+    if (i % 4 == 0 && i + 3 <= end && pStatis->min == 0 && pStatis->max == 1) {
+      uint8_t lo = b & 0x55, hi = (b >> 1) & 0x55;
+      trues += tsBoolCount(lo & ~hi);
+      pStatis->numOfNull += tsBoolCount(hi & ~lo);
+      i += 4;
+      continue;
+    }
+
+    uint8_t ele = (b >> (2 * (i % 4))) & INT8MASK(2);
+    if (ele == 2) {
+      pStatis->numOfNull++;
+    } else {
+      trues += (ele == 1);
+      tsStatisAddRun(pStatis, (ele == 1), 1, i - start, false);
+    }
+    i++;
+  }
+
+  pStatis->sum = trues;
+  return 0;
+}
+
+// Returns 0 and the statistics of rows [start, end], or -1 if the encoding of the column does not allow it
+int tsCompressedStatis(const char *const input, int compressedSize, const int nelements, int start, int end,
+                       int8_t type, char algorithm, char *const buffer, int bufferSize, SCompStatis *pStatis) {
+  const char *data = input;
+  bool        isUnsigned = IS_UNSIGNED_NUMERIC_TYPE(type);
+
+  if (start < 0 || start > end || end >= nelements || is_bigendian()) return -1;
+
+  memset(pStatis, 0, sizeof(SCompStatis));
+  pStatis->min = isUnsigned ? (int64_t)UINT64_MAX : INT64_MAX;
+  pStatis->max = isUnsigned ? 0 : INT64_MIN;
+
+  if (IS_TWO_STAGE_COMP(algorithm)) {
+    if (buffer == NULL || tsDecompressStringImp(input, compressedSize, buffer, bufferSize) < 0) return -1;
+    data = buffer;
+  } else if (algorithm != ONE_STAGE_COMP) {
+    return -1;
+  }
+
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+      return tsStatisBoolImp(data, start, end, pStatis);
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_UTINYINT:
+    case TSDB_DATA_TYPE_USMALLINT:
+    case TSDB_DATA_TYPE_UINT:
+    case TSDB_DATA_TYPE_UBIGINT:
+      if (HEAD_ALGO((uint8_t)data[0]) != ALGO_INT_BITPACK) return -1;
+      return tsStatisINTBitPackImp(data, nelements, start, end, tDataTypes[type].bytes, isUnsigned, pStatis);
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      if (HEAD_ALGO((uint8_t)data[0]) != ALGO_TS_BITPACK) return -1;
+      return tsStatisTimestampBitPackImp(data, nelements, start, end, pStatis);
+    default:
+      return -1;
+  }
+}
+
+/* --------------------------------------------Decimal Float Compression
+ * ---------------------------------------------- */
+// Most float and double columns hold readings of a few decimal digits. Such a value v is stored as the integer
+// d = round(v * 10^e), e being one exponent for the whole block picked from a sample of the values, as long as
+// d / 10^e gives back exactly the same bits. The integers are then frame of reference encoded in miniblocks of 128
+// values, with their minimum as the base. The values that do not round trip, like nulls, NaN, -0.0 or values with
+// more digits, are the exceptions of the miniblocks.
+#define FLT_DECIMAL_HEAD      (CHAR_BYTES * 2)  // head, exponent
+#define FLT_DECIMAL_SAMPLES   32
+#define FLT_DECIMAL_MAX_DIGIT 2251799813685248.0  // 2^51, the integers are rounded by the magic number below
+#define FLT_DECIMAL_ROUND     6755399441055744.0  // 2^52 + 2^51
+#define DOUBLE_DECIMAL_MAX_E  18
+#define FLOAT_DECIMAL_MAX_E   10
+
+static const double tsDecimalPow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8, 1e9,
+                                        1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18};
+
+static FORCE_INLINE bool tsDoubleToDecimal(double v, double f, int64_t *d) {
+  double s = v * f;
+  if (!(s > -FLT_DECIMAL_MAX_DIGIT && s < FLT_DECIMAL_MAX_DIGIT)) return false;  // NaN fails here as well
+
+  *d = (int64_t)((s + FLT_DECIMAL_ROUND) - FLT_DECIMAL_ROUND);
+  double r = (double)(*d) / f;
+  return memcmp(&r, &v, DOUBLE_BYTES) == 0;
+}
+
+static FORCE_INLINE bool tsFloatToDecimal(float v, double f, int64_t *d) {
+  double s = (double)v * f;
+  if (!(s > -FLT_DECIMAL_MAX_DIGIT && s < FLT_DECIMAL_MAX_DIGIT)) return false;
+
+  *d = (int64_t)((s + FLT_DECIMAL_ROUND) - FLT_DECIMAL_ROUND);
+  float r = (float)((double)(*d) / f);
+  return memcmp(&r, &v, FLOAT_BYTES) == 0;
+}
+
+// The exponent most of the sampled values round trip with, -1 if it is less than half of them
+static int tsGetDecimalExponent(const char *const input, const int nelements, int maxE, bool isFloat) {
+  int     hits[DOUBLE_DECIMAL_MAX_E + 1] = {0};
+  int     step = MAX(1, nelements / FLT_DECIMAL_SAMPLES);
+  int     nsamples = 0;
+  int64_t d = 0;
+
+  for (int i = 0; i < nelements && nsamples < FLT_DECIMAL_SAMPLES; i += step, nsamples++) {
+    for (int e = 0; e <= maxE; e++) {
+      bool ok = isFloat ? tsFloatToDecimal(((float *)input)[i], tsDecimalPow10[e], &d)
+                        : tsDoubleToDecimal(((double *)input)[i], tsDecimalPow10[e], &d);
+      hits[e] += ok;
+    }
+  }
+
+  int best = 0;
+  for (int e = 1; e <= maxE; e++) {
+    if (hits[e] > hits[best]) best = e;  // the smallest exponent of the ties keeps the integers small
+  }
+
+  return (hits[best] * 2 < nsamples) ? -1 : best;
+}
+
+// Returns the size of the miniblock, or -1 if it goes beyond limit or its integers span more than 32 bits
+static int tsDecimalPackBlock(int64_t *ints, const uint8_t *excs, int nexc, const char *const values, int bytes,
+                              int nvalues, char *const output, int limit) {
+  int64_t  minValue = INT64_MAX, maxValue = INT64_MIN;
+  uint32_t deltas[BP_BLOCK_VALUES];
+
+  for (int i = 0, k = 0; i < nvalues; i++) {
+    if (k < nexc && excs[k] == i) {
+      k++;
+      continue;
+    }
+    minValue = MIN(minValue, ints[i]);
+    maxValue = MAX(maxValue, ints[i]);
+  }
+
+  if (nexc == nvalues) minValue = maxValue = 0;
+  if ((uint64_t)maxValue - (uint64_t)minValue > UINT32_MAX) return -1;
+
+  uint32_t bits = 0;
+  for (int i = 0, k = 0; i < nvalues; i++) {
+    if (k < nexc && excs[k] == i) {  // exceptions take the minimum so that they do not widen the miniblock
+      deltas[i] = 0;
+      k++;
+    } else {
+      deltas[i] = (uint32_t)((uint64_t)ints[i] - (uint64_t)minValue);
+      bits |= deltas[i];
+    }
+  }
+
+  int w = (bits == 0) ? 0 : (32 - BUILDIN_CLZ(bits));
+  if (FOR_BLOCK_BYTES(nvalues, w, nexc, bytes) >= limit) return -1;
+
+  return tsForPackBlock(minValue, 0, deltas, nvalues, w, excs, nexc, values, bytes, bytes, output);
+}
+
+// The integers are below 2^51, so the minimum and a delta are added exactly as doubles. The deltas are converted as
+// signed 32 bit integers, which unlike 64 bit or unsigned ones have a vector conversion.
+#define FLT_DECIMAL_VALUE(base, delta) ((double)(int32_t)((delta) - 0x80000000u) + (base))
+
+// Size of the XOR encoding of the double and float compression below, for the XOR of a value of the given bits with
+// the previous one
+static FORCE_INLINE int tsFloatXorBytes(uint64_t diff, int bits) {
+  if (diff == 0) return 1;
+
+  int zeros = MAX(BUILDIN_CTZL(diff), BUILDIN_CLZL(diff) - (LONG_BYTES * BITS_PER_BYTE - bits));
+  return MAX(1, bits / BITS_PER_BYTE - zeros / BITS_PER_BYTE);
+}
+
+// Returns 0 if the XOR encoding is at least as small
+static int tsCompressDoubleDecimalImp(const char *const input, const int nelements, char *const output) {
+  int e = tsGetDecimalExponent(input, nelements, DOUBLE_DECIMAL_MAX_E, false);
+  if (e < 0) return 0;
+
+  double  *istream = (double *)input;
+  double   f = tsDecimalPow10[e];
+  int      limit = nelements * DOUBLE_BYTES + 1;
+  int      xorLen = 1 + (nelements + 1) / 2 + nelements % 2;
+  int      pos = FLT_DECIMAL_HEAD;
+  uint64_t prev = 0;
+  int64_t  ints[BP_BLOCK_VALUES];
+  uint8_t  excs[BP_BLOCK_VALUES];
+
+  output[0] = (ALGO_FLT_DECIMAL << 1) | MODE_COMPRESS;
+  output[1] = (char)e;
+
+  for (int start = 0; start < nelements; start += BP_BLOCK_VALUES) {
+    int nvalues = MIN(BP_BLOCK_VALUES, nelements - start);
+    int nexc = 0;
+
+    for (int i = 0; i < nvalues; i++) {
+      uint64_t bits = 0;
+      memcpy(&bits, istream + start + i, DOUBLE_BYTES);
+      xorLen += tsFloatXorBytes(bits ^ prev, LONG_BYTES * BITS_PER_BYTE);
+      prev = bits;
+
+      if (!tsDoubleToDecimal(istream[start + i], f, ints + i)) excs[nexc++] = (uint8_t)i;
+    }
+
+    int len = tsDecimalPackBlock(ints, excs, nexc, (const char *)(istream + start), DOUBLE_BYTES, nvalues,
+                                 output + pos, limit - pos);
+    if (len < 0) return 0;
+    pos += len;
+  }
+
+  return (pos < xorLen) ? pos : 0;
+}
+
+static int tsDecompressDoubleDecimalImp(const char *const input, const int nelements, char *const output) {
+  double  *ostream = (double *)output;
+  double   f = tsDecimalPow10[(uint8_t)input[1]];
+  int      pos = FLT_DECIMAL_HEAD;
+  int64_t  minValue = 0;
+  int      flags = 0, nexc = 0;
+  uint32_t deltas[BP_BLOCK_VALUES];
+
+  for (int start = 0; start < nelements; start += BP_BLOCK_VALUES) {
+    int     nvalues = MIN(BP_BLOCK_VALUES, nelements - start);
+    double *ovalues = ostream + start;
+
+    pos += tsForUnpackBlock(input + pos, nvalues, &minValue, &flags, &nexc, deltas);
+    double base = (double)minValue + 2147483648.0;
+    for (int i = 0; i < nvalues; i++) {
+      ovalues[i] = FLT_DECIMAL_VALUE(base, deltas[i]) / f;
+    }
+    pos += tsForPatchExceptions(input + pos, nexc, DOUBLE_BYTES, (char *)ovalues, DOUBLE_BYTES);
+  }
+
+  return nelements * DOUBLE_BYTES;
+}
+
+// Returns 0 if the XOR encoding is at least as small
+static int tsCompressFloatDecimalImp(const char *const input, const int nelements, char *const output) {
+  int e = tsGetDecimalExponent(input, nelements, FLOAT_DECIMAL_MAX_E, true);
+  if (e < 0) return 0;
+
+  float   *istream = (float *)input;
+  double   f = tsDecimalPow10[e];
+  int      limit = nelements * FLOAT_BYTES + 1;
+  int      xorLen = 1 + (nelements + 1) / 2 + nelements % 2;
+  int      pos = FLT_DECIMAL_HEAD;
+  uint32_t prev = 0;
+  int64_t  ints[BP_BLOCK_VALUES];
+  uint8_t  excs[BP_BLOCK_VALUES];
+
+  output[0] = (ALGO_FLT_DECIMAL << 1) | MODE_COMPRESS;
+  output[1] = (char)e;
+
+  for (int start = 0; start < nelements; start += BP_BLOCK_VALUES) {
+    int nvalues = MIN(BP_BLOCK_VALUES, nelements - start);
+    int nexc = 0;
+
+    for (int i = 0; i < nvalues; i++) {
+      uint32_t bits = 0;
+      memcpy(&bits, istream + start + i, FLOAT_BYTES);
+      xorLen += tsFloatXorBytes(bits ^ prev, FLOAT_BYTES * BITS_PER_BYTE);
+      prev = bits;
+
+      if (!tsFloatToDecimal(istream[start + i], f, ints + i)) excs[nexc++] = (uint8_t)i;
+    }
+
+    int len = tsDecimalPackBlock(ints, excs, nexc, (const char *)(istream + start), FLOAT_BYTES, nvalues,
+                                 output + pos, limit - pos);
+    if (len < 0) return 0;
+    pos += len;
+  }
+
+  return (pos < xorLen) ? pos : 0;
+}
+
+static int tsDecompressFloatDecimalImp(const char *const input, const int nelements, char *const output) {
+  float   *ostream = (float *)output;
+  double   f = tsDecimalPow10[(uint8_t)input[1]];
+  int      pos = FLT_DECIMAL_HEAD;
+  int64_t  minValue = 0;
+  int      flags = 0, nexc = 0;
+  uint32_t deltas[BP_BLOCK_VALUES];
+
+  for (int start = 0; start < nelements; start += BP_BLOCK_VALUES) {
+    int    nvalues = MIN(BP_BLOCK_VALUES, nelements - start);
+    float *ovalues = ostream + start;
+
+    pos += tsForUnpackBlock(input + pos, nvalues, &minValue, &flags, &nexc, deltas);
+    double base = (double)minValue + 2147483648.0;
+    for (int i = 0; i < nvalues; i++) {
+      ovalues[i] = (float)(FLT_DECIMAL_VALUE(base, deltas[i]) / f);
+    }
+    pos += tsForPatchExceptions(input + pos, nexc, FLOAT_BYTES, (char *)ovalues, FLOAT_BYTES);
+  }
+
+  return nelements * FLOAT_BYTES;
+}
+
 /* --------------------------------------------Double Compression
  * ---------------------------------------------- */
 void encodeDoubleValue(uint64_t diff, uint8_t flag, char *const output, int *const pos) {
@@ -651,6 +1966,11 @@ void encodeDoubleValue(uint64_t diff, uint8_t flag, char *const output, int *con
 }
 
 int tsCompressDoubleImp(const char *const input, const int nelements, char *const output) {
+  if (tsFloatDecimalPack && !is_bigendian()) {
+    int len = tsCompressDoubleDecimalImp(input, nelements, output);
+    if (len > 0) return len;
+  }
+
   int byte_limit = nelements * DOUBLE_BYTES + 1;
   int opos = 1;
 
@@ -750,6 +2070,10 @@ int tsDecompressDoubleImp(const char *const input, const int nelements, char *co
   // output stream
   double *ostream = (double *)output;
 
+  if (HEAD_ALGO((uint8_t)input[0]) == ALGO_FLT_DECIMAL) {
+    return tsDecompressDoubleDecimalImp(input, nelements, output);
+  }
+
   if (input[0] == 1) {
     memcpy(output, input + 1, nelements * DOUBLE_BYTES);
     return nelements * DOUBLE_BYTES;
@@ -799,6 +2123,11 @@ void encodeFloatValue(uint32_t diff, uint8_t flag, char *const output, int *cons
 }
 
 int tsCompressFloatImp(const char *const input, const int nelements, char *const output) {
+  if (tsFloatDecimalPack && !is_bigendian()) {
+    int len = tsCompressFloatDecimalImp(input, nelements, output);
+    if (len > 0) return len;
+  }
+
   float *istream = (float *)input;
   int    byte_limit = nelements * FLOAT_BYTES + 1;
   int    opos = 1;
@@ -896,6 +2225,10 @@ uint32_t decodeFloatValue(const char *const input, int *const ipos, uint8_t flag
 int tsDecompressFloatImp(const char *const input, const int nelements, char *const output) {
   float *ostream = (float *)output;
 
+  if (HEAD_ALGO((uint8_t)input[0]) == ALGO_FLT_DECIMAL) {
+    return tsDecompressFloatDecimalImp(input, nelements, output);
+  }
+
   if (input[0] == 1) {
     memcpy(output, input + 1, nelements * FLOAT_BYTES);
     return nelements * FLOAT_BYTES;
@@ -400,6 +400,24 @@ char *strbetween(char *string, char *begin, char *end) {
   return result;
 }
 
+// true if item is one of the entries of list, which are separated by delim
+bool strinlist(const char *list, const char *item, char delim) {
+  int32_t len = (int32_t)strlen(item);
+  if (len == 0) {
+    return false;
+  }
+
+  for (const char *p = strstr(list, item); p != NULL; p = strstr(p + 1, item)) {
+    bool head = (p == list || *(p - 1) == delim);
+    bool tail = (p[len] == 0 || p[len] == delim);
+    if (head && tail) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 int32_t taosByteArrayToHexStr(char bytes[], int32_t len, char hexstr[]) {
   int32_t i;
   char    hexval[16] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
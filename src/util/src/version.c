@@ -0,0 +1,7 @@
+char version[12] = "2.7.0.0";
+char compatible_version[12] = "2.0.0.0";
+char gitinfo[48] = "85819d7a2b2c92de0c347514de293f375ca96578";
+char gitinfoOfInternal[48] = "85819d7a2b2c92de0c347514de293f375ca96578";
+char buildinfo[64] = "Built at 2026-10-18 13:02:24";
+
+void libtaos_2_7_0_0_Linux_x32_stable() {};
@@ -0,0 +1,611 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tscompression.h"
+#include "tglobal.h"
+#include "ttype.h"
+
+namespace {
+
+// Compress with one stage and both second stages and check the timestamps come back unchanged, returns the compressed size of one stage
+int checkTimestamps(const std::vector<int64_t> &ts) {
+  int   n = (int)ts.size();
+  int   size = n * LONG_BYTES;
+  int   bufSize = size + COMP_OVERFLOW_BYTES + 1024;
+  char *comp = (char *)calloc(1, bufSize);
+  char *buf = (char *)calloc(1, bufSize);
+  char *out = (char *)calloc(1, bufSize);
+  int   len1 = 0;
+
+  for (char algo = ONE_STAGE_COMP; algo <= TWO_STAGE_COMP_ZSTD; algo++) {
+    int len = tsCompressTimestamp((const char *)ts.data(), size, n, comp, bufSize, algo, buf, bufSize);
+    EXPECT_GT(len, 0);
+    if (algo == ONE_STAGE_COMP) len1 = len;
+
+    memset(out, 0, bufSize);
+    EXPECT_EQ(tsDecompressTimestamp(comp, len, n, out, bufSize, algo, buf, bufSize), size);
+    EXPECT_EQ(memcmp(out, ts.data(), size), 0) << "rows:" << n << " algo:" << (int)algo;
+  }
+
+  free(comp);
+  free(buf);
+  free(out);
+  return len1;
+}
+
+// The same for floats or doubles, the null values and the NaN are compared by their bits
+template <typename T>
+int checkFloats(const std::vector<T> &values) {
+  int   n = (int)values.size();
+  int   size = n * (int)sizeof(T);
+  int   bufSize = size + COMP_OVERFLOW_BYTES + 1024;
+  char *comp = (char *)calloc(1, bufSize);
+  char *buf = (char *)calloc(1, bufSize);
+  char *out = (char *)calloc(1, bufSize);
+  int   len1 = 0;
+
+  for (char algo = ONE_STAGE_COMP; algo <= TWO_STAGE_COMP_ZSTD; algo++) {
+    int len = (sizeof(T) == DOUBLE_BYTES)
+                  ? tsCompressDouble((const char *)values.data(), size, n, comp, bufSize, algo, buf, bufSize)
+                  : tsCompressFloat((const char *)values.data(), size, n, comp, bufSize, algo, buf, bufSize);
+    EXPECT_GT(len, 0);
+    if (algo == ONE_STAGE_COMP) len1 = len;
+
+    memset(out, 0, bufSize);
+    int ret = (sizeof(T) == DOUBLE_BYTES) ? tsDecompressDouble(comp, len, n, out, bufSize, algo, buf, bufSize)
+                                          : tsDecompressFloat(comp, len, n, out, bufSize, algo, buf, bufSize);
+    EXPECT_EQ(ret, size);
+    EXPECT_EQ(memcmp(out, values.data(), size), 0) << "rows:" << n << " algo:" << (int)algo;
+  }
+
+  free(comp);
+  free(buf);
+  free(out);
+  return len1;
+}
+
+template <typename T>
+void checkFloatCases(int n, std::mt19937_64 &rnd, T null) {
+  std::vector<T> sensor(n), same(n), nulls(n), digits(n), random(n), wide(n);
+
+  for (int i = 0; i < n; i++) {
+    sensor[i] = (T)(2000 + (int64_t)(rnd() % 300)) / 100;
+    same[i] = (T)3.25;
+    nulls[i] = (rnd() % 5 == 0) ? null : ((rnd() % 7 == 0) ? (T)-0.0 : (T)(int64_t)(rnd() % 1000) / 10);
+    digits[i] = (T)((int64_t)(rnd() % 1000000) - 500000) / 10000;
+    random[i] = (T)(rnd() % 1000000007) / 3;
+    wide[i] = (i % 2) ? (T)1e12 : (T)(int64_t)(rnd() % 100);
+  }
+
+  checkFloats(sensor);
+  checkFloats(same);
+  checkFloats(nulls);
+  checkFloats(digits);
+  checkFloats(random);
+  checkFloats(wide);
+}
+
+// The same for the integer types, the type is the one the column is compressed as
+int checkIntegers(const std::vector<int64_t> &values, int8_t type) {
+  int   n = (int)values.size();
+  int   bytes = tDataTypes[type].bytes;
+  int   size = n * bytes;
+  int   bufSize = size + COMP_OVERFLOW_BYTES + 1024;
+  char *in = (char *)calloc(1, bufSize);
+  char *comp = (char *)calloc(1, bufSize);
+  char *buf = (char *)calloc(1, bufSize);
+  char *out = (char *)calloc(1, bufSize);
+  int   len1 = 0;
+
+  for (int i = 0; i < n; i++) {
+    memcpy(in + i * bytes, &values[i], bytes);  // truncated, like the values of a column of the type
+  }
+
+  for (char algo = ONE_STAGE_COMP; algo <= TWO_STAGE_COMP_ZSTD; algo++) {
+    int len = tDataTypes[type].compFunc(in, size, n, comp, bufSize, algo, buf, bufSize);
+    EXPECT_GT(len, 0);
+    if (algo == ONE_STAGE_COMP) len1 = len;
+
+    memset(out, 0, bufSize);
+    EXPECT_EQ(tDataTypes[type].decompFunc(comp, len, n, out, bufSize, algo, buf, bufSize), size);
+    EXPECT_EQ(memcmp(out, in, size), 0) << "rows:" << n << " type:" << (int)type << " algo:" << (int)algo;
+  }
+
+  free(in);
+  free(comp);
+  free(buf);
+  free(out);
+  return len1;
+}
+
+void setVarStr(char *buf, const char *str) {
+  varDataSetLen(buf, strlen(str));
+  memcpy(varDataVal(buf), str, strlen(str));
+}
+
+// The var data of a binary column block, the values one after another, with the null value for NULL
+std::string makeVarData(const std::vector<const char *> &values) {
+  std::string data;
+
+  for (size_t i = 0; i < values.size(); i++) {
+    char buf[VARSTR_HEADER_SIZE + 64] = {0};
+    if (values[i] == NULL) {
+      setVardataNull(buf, TSDB_DATA_TYPE_BINARY);
+    } else {
+      setVarStr(buf, values[i]);
+    }
+    data.append(buf, varDataTLen(buf));
+  }
+
+  return data;
+}
+
+// The same for strings, the codes of a dictionary must give each distinct value one code
+int checkStrings(const std::vector<const char *> &values) {
+  int         n = (int)values.size();
+  std::string data = makeVarData(values);
+  int         size = (int)data.size();
+  int         bufSize = size + COMP_OVERFLOW_BYTES + 1024;
+  char       *comp = (char *)calloc(1, bufSize);
+  char       *buf = (char *)calloc(1, bufSize);
+  char       *out = (char *)calloc(1, bufSize);
+
+  int len = tsCompressString(data.data(), size, n, comp, bufSize, TWO_STAGE_COMP, buf, bufSize);
+  EXPECT_GT(len, 0);
+  EXPECT_EQ(tsDecompressString(comp, len, n, out, bufSize, TWO_STAGE_COMP, buf, bufSize), size);
+  EXPECT_EQ(memcmp(out, data.data(), size), 0) << "rows:" << n;
+
+  int nvalues = tsGetStringDictSize(comp);
+  if (nvalues > 0) {
+    std::vector<uint8_t>     codes(n);
+    std::vector<std::string> dict(nvalues);
+
+    memset(out, 0, bufSize);
+    EXPECT_EQ(tsDecompressStringDictImp(comp, len, n, out, bufSize, codes.data()), size);
+
+    const char *p = out;
+    for (int i = 0; i < n; i++) {
+      std::string val(p, varDataTLen(p));
+      EXPECT_LT(codes[i], nvalues);
+      if (dict[codes[i]].empty()) dict[codes[i]] = val;
+      EXPECT_EQ(dict[codes[i]], val) << "row:" << i;
+      p += varDataTLen(p);
+    }
+
+    for (int v = 1; v < nvalues; v++) {
+      EXPECT_NE(dict[v - 1], dict[v]);
+    }
+  }
+
+  free(comp);
+  free(buf);
+  free(out);
+  return len;
+}
+
+}  // namespace
+
+TEST(testCase, compressTimestampTest) {
+  std::mt19937_64 rnd(0);
+  int             rows[] = {1, 2, 3, 127, 128, 129, 130, 257, 1000, 4096};
+  int8_t          oldBitPack = tsTimestampBitPack;
+
+  for (int8_t bitPack = 0; bitPack <= 1; bitPack++) {
+    tsTimestampBitPack = bitPack;
+
+    for (int r = 0; r < (int)tListLen(rows); r++) {
+      int                  n = rows[r];
+      std::vector<int64_t> regular(n), jitter(n), gaps(n), wide(n), desc(n);
+
+      for (int i = 0; i < n; i++) {
+        regular[i] = 1600000000000L + i * 1000L;
+        jitter[i] = 1600000000000L + i * 1000L + (int64_t)(rnd() % 7);
+        gaps[i] = (i == 0) ? 1600000000000L : gaps[i - 1] + 1 + (int64_t)(rnd() % 3) * ((i % 300 == 0) ? 3600000 : 1);
+        wide[i] = (i == 0) ? -5 : wide[i - 1] + (int64_t)(rnd() % 0x3FFFFFFFFFL);
+        desc[i] = 1600000000000000000L - i * 1000000007L;
+      }
+
+      checkTimestamps(regular);
+      checkTimestamps(jitter);
+      checkTimestamps(gaps);
+      checkTimestamps(wide);
+      checkTimestamps(desc);
+
+      // the bit packed forms are only used when they are smaller
+      if (n >= 128) {
+        int len = checkTimestamps(regular);
+        if (bitPack) {
+          EXPECT_EQ(len, 2 * CHAR_BYTES + 2 * LONG_BYTES);
+        } else {
+          EXPECT_GT(len, n / 2);
+        }
+      }
+    }
+  }
+
+  tsTimestampBitPack = oldBitPack;
+}
+
+TEST(testCase, compressFloatTest) {
+  std::mt19937_64 rnd(0);
+  int             rows[] = {1, 2, 3, 127, 128, 129, 130, 257, 1000, 4096};
+  uint32_t        fnullBits = TSDB_DATA_FLOAT_NULL;
+  uint64_t        dnullBits = TSDB_DATA_DOUBLE_NULL;
+  float           fnull = 0;
+  double          dnull = 0;
+  int8_t          oldDecimal = tsFloatDecimalPack;
+
+  memcpy(&fnull, &fnullBits, sizeof(fnull));
+  memcpy(&dnull, &dnullBits, sizeof(dnull));
+
+  for (int8_t decimal = 0; decimal <= 1; decimal++) {
+    tsFloatDecimalPack = decimal;
+
+    for (int r = 0; r < (int)tListLen(rows); r++) {
+      checkFloatCases<float>(rows[r], rnd, fnull);
+      checkFloatCases<double>(rows[r], rnd, dnull);
+    }
+
+    // readings of two decimal digits need 10 bits each instead of at least 2 bytes
+    std::vector<double> sensor(4096);
+    for (int i = 0; i < (int)sensor.size(); i++) {
+      sensor[i] = (double)(2000 + (int64_t)(rnd() % 1000)) / 100;
+    }
+
+    int len = checkFloats(sensor);
+    if (decimal) {
+      EXPECT_LT(len, (int)sensor.size() * 3 / 2);
+    } else {
+      EXPECT_GT(len, (int)sensor.size() * 2);
+    }
+  }
+
+  tsFloatDecimalPack = oldDecimal;
+}
+
+TEST(testCase, compressIntTest) {
+  std::mt19937_64 rnd(0);
+  int             rows[] = {1, 2, 3, 127, 128, 129, 130, 257, 1000, 4096};
+  int8_t          types[] = {TSDB_DATA_TYPE_TINYINT,  TSDB_DATA_TYPE_SMALLINT,  TSDB_DATA_TYPE_INT,
+                             TSDB_DATA_TYPE_BIGINT,   TSDB_DATA_TYPE_UTINYINT,  TSDB_DATA_TYPE_USMALLINT,
+                             TSDB_DATA_TYPE_UINT,     TSDB_DATA_TYPE_UBIGINT};
+  int8_t          oldBitPack = tsIntBitPack;
+
+  for (int8_t bitPack = 0; bitPack <= 1; bitPack++) {
+    tsIntBitPack = bitPack;
+
+    for (int t = 0; t < (int)tListLen(types); t++) {
+      int8_t  type = types[t];
+      int     bits = tDataTypes[type].bytes * BITS_PER_BYTE;
+      int64_t null = 0;
+      setNull((char *)&null, type, tDataTypes[type].bytes);
+
+      for (int r = 0; r < (int)tListLen(rows); r++) {
+        int                  n = rows[r];
+        std::vector<int64_t> status(n), gauge(n), counter(n), nulls(n), wide(n), sign(n);
+
+        for (int i = 0; i < n; i++) {
+          status[i] = (int64_t)(rnd() % 8);
+          gauge[i] = 100 + (int64_t)(rnd() % 20);
+          counter[i] = (i == 0) ? 0 : counter[i - 1] + (int64_t)(rnd() % 5);
+          nulls[i] = (rnd() % 10 == 0) ? null : gauge[i];
+          wide[i] = (int64_t)rnd();
+          sign[i] = (int64_t)(rnd() % 40) - 20 + ((bits == 8) ? 0 : 120);  // crosses 127 as unsigned tinyint
+        }
+
+        checkIntegers(status, type);
+        checkIntegers(gauge, type);
+        checkIntegers(counter, type);
+        checkIntegers(nulls, type);
+        checkIntegers(wide, type);
+        checkIntegers(sign, type);
+      }
+    }
+
+    // a gauge with a few nulls packs in 5 bits a value, the nulls cost a simple8b word each
+    std::vector<int64_t> gauge(4096);
+    for (int i = 0; i < (int)gauge.size(); i++) {
+      gauge[i] = (rnd() % 50 == 0) ? INT32_MIN : 1000 + (int64_t)(rnd() % 30);
+    }
+
+    int len = checkIntegers(gauge, TSDB_DATA_TYPE_INT);
+    if (bitPack) {
+      EXPECT_LT(len, (int)gauge.size() * 7 / 8);
+    } else {
+      EXPECT_GT(len, (int)gauge.size());
+    }
+  }
+
+  tsIntBitPack = oldBitPack;
+}
+
+TEST(testCase, compressStringTest) {
+  std::mt19937_64 rnd(0);
+  int             rows[] = {1, 2, 3, 127, 128, 129, 130, 257, 1000, 4096};
+  const char     *status[] = {"running", "stopped", "error", "starting", "maintenance"};
+  char            names[300][16];
+  int8_t          oldDict = tsStringDictEncode;
+
+  for (int v = 0; v < (int)tListLen(names); v++) {
+    snprintf(names[v], sizeof(names[v]), "device_%d", v * 7919);
+  }
+
+  for (int8_t dict = 0; dict <= 1; dict++) {
+    tsStringDictEncode = dict;
+
+    for (int r = 0; r < (int)tListLen(rows); r++) {
+      int                       n = rows[r];
+      std::vector<const char *> states(n), same(n), nulls(n), runs(n), full(n), over(n), unique(n);
+
+      for (int i = 0; i < n; i++) {
+        states[i] = status[rnd() % tListLen(status)];
+        same[i] = "ok";
+        nulls[i] = (rnd() % 4 == 0) ? NULL : status[rnd() % 2];
+        runs[i] = status[(i / 100) % tListLen(status)];
+        full[i] = names[i % 256];
+        over[i] = names[i % 257];
+        unique[i] = names[i % tListLen(names)];
+      }
+
+      checkStrings(states);
+      checkStrings(same);
+      checkStrings(nulls);
+      checkStrings(runs);
+      checkStrings(full);
+      checkStrings(over);
+      checkStrings(unique);
+
+      // more than TSDB_STR_DICT_MAX_VALUES distinct values are never a dictionary
+      std::string data = makeVarData(over);
+      std::vector<char> comp(data.size() + 1024), buf(data.size() + 1024);
+      tsCompressString(data.data(), (int)data.size(), n, comp.data(), (int)comp.size(), TWO_STAGE_COMP, buf.data(),
+                       (int)buf.size());
+      EXPECT_EQ(tsGetStringDictSize(comp.data()), 0);
+    }
+
+    // a few states picked at random need 3 bits a row, LZ4 needs several bytes for each of them
+    std::vector<const char *> states(4096);
+    for (int i = 0; i < (int)states.size(); i++) {
+      states[i] = status[rnd() % tListLen(status)];
+    }
+
+    int len = checkStrings(states);
+    if (dict) {
+      EXPECT_LT(len, (int)states.size() / 2);
+    } else {
+      EXPECT_GT(len, (int)states.size());
+    }
+  }
+
+  // values in fixed size slots, like the query results, are not taken for a column block
+  std::vector<char> slots(128 * 16, 0), comp(128 * 16 + 1024), buf(128 * 16 + 1024);
+  for (int i = 0; i < 128; i++) {
+    setVarStr(slots.data() + i * 16, status[i % 2]);
+  }
+  int len = tsCompressString(slots.data(), (int)slots.size(), 128, comp.data(), (int)comp.size(), ONE_STAGE_COMP,
+                             buf.data(), (int)buf.size());
+  EXPECT_EQ(tsGetStringDictSize(comp.data()), 0);
+  EXPECT_EQ(tsDecompressString(comp.data(), len, 128, buf.data(), (int)buf.size(), ONE_STAGE_COMP, NULL, 0),
+            (int)slots.size());
+  EXPECT_EQ(memcmp(buf.data(), slots.data(), slots.size()), 0);
+
+  tsStringDictEncode = oldDict;
+}
+
+namespace {
+
+// The statistics of rows [start, end] taken from the compressed column must be the ones statisFunc gives for the
+// decoded rows. Returns the number of ranges the encoding supported, none if it is not one of the supported ones.
+int checkStatis(const char *in, int n, int8_t type, bool supported) {
+  int   bytes = tDataTypes[type].bytes;
+  int   size = n * bytes;
+  int   bufSize = size + COMP_OVERFLOW_BYTES + 1024;
+  char *comp = (char *)calloc(1, bufSize);
+  char *buf = (char *)calloc(1, bufSize);
+  int   count = 0;
+
+  std::vector<std::pair<int, int>> ranges = {{0, n - 1}, {0, 0}, {n - 1, n - 1}, {n / 3, n - n / 3 - 1}};
+  for (int i = 0; i < 20; i++) {
+    int a = rand() % n, b = rand() % n;
+    ranges.push_back({std::min(a, b), std::max(a, b)});
+  }
+
+  for (char algo = ONE_STAGE_COMP; algo <= TWO_STAGE_COMP_ZSTD; algo++) {
+    int len = tDataTypes[type].compFunc(in, size, n, comp, bufSize, algo, buf, bufSize);
+    EXPECT_GT(len, 0);
+
+    for (auto &range : ranges) {
+      int         start = range.first, end = range.second;
+      SCompStatis statis;
+      int ret = tsCompressedStatis(comp, len, n, start, end, type, algo, buf, bufSize, &statis);
+      if (!supported) {
+        EXPECT_EQ(ret, -1) << "rows:" << n << " type:" << (int)type;
+      }
+      if (ret < 0) continue;
+
+      int64_t min = 0, max = 0, sum = 0;
+      int16_t minIndex = 0, maxIndex = 0, numOfNull = 0;
+      tDataTypes[type].statisFunc(in + start * bytes, end - start + 1, &min, &max, &sum, &minIndex, &maxIndex,
+                                  &numOfNull);
+
+      EXPECT_EQ(statis.numOfNull, numOfNull) << "type:" << (int)type << " range:" << start << "," << end;
+      EXPECT_EQ(statis.sum, sum) << "type:" << (int)type << " range:" << start << "," << end;
+      if (numOfNull < end - start + 1) {
+        EXPECT_EQ(statis.min, min) << "type:" << (int)type << " range:" << start << "," << end;
+        EXPECT_EQ(statis.max, max) << "type:" << (int)type << " range:" << start << "," << end;
+        EXPECT_EQ(statis.minIndex, minIndex) << "type:" << (int)type << " range:" << start << "," << end;
+        EXPECT_EQ(statis.maxIndex, maxIndex) << "type:" << (int)type << " range:" << start << "," << end;
+      }
+      count++;
+    }
+  }
+
+  free(comp);
+  free(buf);
+  return count;
+}
+
+}  // namespace
+
+TEST(testCase, compressedStatisTest) {
+  std::mt19937_64 rnd(0);
+  int             rows[] = {1, 2, 129, 1000, 4096};
+  int8_t          types[] = {TSDB_DATA_TYPE_TINYINT,  TSDB_DATA_TYPE_SMALLINT,  TSDB_DATA_TYPE_INT,
+                             TSDB_DATA_TYPE_BIGINT,   TSDB_DATA_TYPE_UTINYINT,  TSDB_DATA_TYPE_USMALLINT,
+                             TSDB_DATA_TYPE_UINT,     TSDB_DATA_TYPE_UBIGINT};
+  int8_t          oldBitPack = tsIntBitPack;
+
+  srand(0);
+  for (int r = 0; r < (int)tListLen(rows); r++) {
+    int   n = rows[r];
+    char *in = (char *)calloc(n, LONG_BYTES);
+
+    // integers: constant runs, counters, gauges with a few nulls, random values and a gauge constant every other miniblock
+    for (int t = 0; t < (int)tListLen(types); t++) {
+      int8_t type = types[t];
+      int    bytes = tDataTypes[type].bytes;
+
+      for (int shape = 0; shape < 5; shape++) {
+        int64_t prev = 0;
+        for (int i = 0; i < n; i++) {
+          int64_t v = 100 + (int64_t)(rnd() % 20);
+          switch (shape) {
+            case 0: v = ((i / 300) % 2) ? 7 : -3; break;
+            case 1: v = prev += (int64_t)(rnd() % 5); break;
+            case 3: v = (int64_t)rnd(); break;
+            case 4: v = ((i / 128) % 2) ? v : 42; break;
+            default: break;
+          }
+          memcpy(in + i * bytes, &v, bytes);
+          if (rnd() % 50 == 0 && (shape == 2 || (shape == 4 && (i / 128) % 2))) setNull(in + i * bytes, type, bytes);
+        }
+
+        // simple8b is kept where it is smaller, as for constant runs, counters and the nulls of unsigned types
+        tsIntBitPack = 1;
+        int count = checkStatis(in, n, type, true);
+        if (n >= 1000 && (shape == 2 || shape == 4) && !IS_UNSIGNED_NUMERIC_TYPE(type)) {
+          EXPECT_GT(count, 0) << "type:" << (int)type << " shape:" << shape;
+        }
+        tsIntBitPack = 0;
+        checkStatis(in, n, type, false);
+      }
+    }
+    tsIntBitPack = oldBitPack;
+
+    // timestamps of a fixed interval and with jitter
+    int8_t oldTsBitPack = tsTimestampBitPack;
+    tsTimestampBitPack = 1;
+    for (int shape = 0; shape < 3; shape++) {
+      for (int i = 0; i < n; i++) {
+        int64_t ts = (shape == 2) ? 1600000000000L - i * 1000L : 1600000000000L + i * 1000L;
+        if (shape == 1) ts += (int64_t)(rnd() % 7);
+        memcpy(in + i * LONG_BYTES, &ts, LONG_BYTES);
+      }
+      int count = checkStatis(in, n, TSDB_DATA_TYPE_TIMESTAMP, true);
+      if (n > 128) {
+        EXPECT_GT(count, 0);
+      }
+    }
+    tsTimestampBitPack = oldTsBitPack;
+
+    // booleans with nulls, and all true
+    for (int i = 0; i < n; i++) {
+      in[i] = (rnd() % 10 == 0) ? TSDB_DATA_BOOL_NULL : (int8_t)(rnd() % 2);
+    }
+    EXPECT_GT(checkStatis(in, n, TSDB_DATA_TYPE_BOOL, true), 0);
+    memset(in, 1, n);
+    EXPECT_GT(checkStatis(in, n, TSDB_DATA_TYPE_BOOL, true), 0);
+
+    // floats are decoded
+    for (int i = 0; i < n; i++) {
+      *(double *)(in + i * DOUBLE_BYTES) = (double)(rnd() % 1000) / 10;
+    }
+    checkStatis(in, n, TSDB_DATA_TYPE_DOUBLE, false);
+
+    free(in);
+  }
+}
+
+TEST(testCase, compressZstdTest) {
+  std::mt19937_64           rnd(0);
+  int                       n = 4096;
+  std::vector<const char *> values(n);
+  char                      names[1000][32];
+
+  for (int v = 0; v < (int)tListLen(names); v++) {
+    snprintf(names[v], sizeof(names[v]), "sensor-%05d.rack-%02d", (int)(rnd() % 100000), v % 40);
+  }
+  for (int i = 0; i < n; i++) {
+    values[i] = names[rnd() % tListLen(names)];
+  }
+
+  std::string       data = makeVarData(values);
+  int               size = (int)data.size();
+  std::vector<char> comp(size + 1024), buf(size + 1024), out(size + 1024);
+
+  int lz4 = tsCompressString(data.data(), size, n, comp.data(), (int)comp.size(), TWO_STAGE_COMP, buf.data(),
+                             (int)buf.size());
+  int len = tsCompressString(data.data(), size, n, comp.data(), (int)comp.size(), TWO_STAGE_COMP_ZSTD, buf.data(),
+                             (int)buf.size());
+  EXPECT_GT(len, 0);
+  EXPECT_EQ(tsDecompressString(comp.data(), len, n, out.data(), (int)out.size(), TWO_STAGE_COMP, buf.data(),
+                               (int)buf.size()),
+            size);
+  EXPECT_EQ(memcmp(out.data(), data.data(), size), 0);
+#ifdef TD_TSZ
+  EXPECT_EQ(HEAD_ALGO((uint8_t)comp[0]), ALGO_ZSTD);
+  EXPECT_LT(len, lz4);
+
+  // a dictionary trained on the values, each of them a sample, is referred to by the frame
+  std::vector<size_t> sizes(n);
+  for (int i = 0; i < n; i++) {
+    sizes[i] = VARSTR_HEADER_SIZE + strlen(values[i]);
+  }
+  uint32_t dictId = tsZstdTrainDict(data.data(), sizes.data(), n, 4096);
+  ASSERT_NE(dictId, 0u);
+
+  // a short block, for which a dictionary is meant
+  int small = 0;
+  for (int i = 0; i < 16; i++) small += (int)sizes[i];
+
+  int plain = tsCompressStringZstdImp(data.data(), small, comp.data(), (int)comp.size(), 0);
+  len = tsCompressStringZstdImp(data.data(), small, comp.data(), (int)comp.size(), dictId);
+  EXPECT_LT(len, plain);
+  EXPECT_EQ(tsDecompressStringImp(comp.data(), len, out.data(), (int)out.size()), small);
+  EXPECT_EQ(memcmp(out.data(), data.data(), small), 0);
+#endif
+}
+
+// each thread creates its own zstd contexts, which are freed when it exits, and the threads started later create new ones
+TEST(testCase, compressZstdThreadsTest) {
+  std::string data;
+  for (int i = 0; i < 2000; i++) data += "sensor-" + std::to_string(i % 37) + ".rack-" + std::to_string(i % 11) + ";";
+  int size = (int)data.size();
+
+  for (int round = 0; round < 2; round++) {
+    std::vector<std::thread> threads;
+    std::vector<int>         results(4, 0);
+    for (int t = 0; t < (int)results.size(); t++) {
+      threads.emplace_back([&data, &results, size, t]() {
+        std::vector<char> comp(size + 1024), out(size + 1024);
+        for (int i = 0; i < 10; i++) {
+          int len = tsCompressStringZstdImp(data.data(), size, comp.data(), (int)comp.size(), 0);
+          if (len <= 0 || tsDecompressStringImp(comp.data(), len, out.data(), (int)out.size()) != size ||
+              memcmp(out.data(), data.data(), size) != 0) {
+            return;
+          }
+        }
+        results[t] = 1;
+      });
+    }
+    for (auto &thread : threads) thread.join();
+    for (int t = 0; t < (int)results.size(); t++) {
+      EXPECT_EQ(results[t], 1) << "round:" << round << " thread:" << t;
+    }
+  }
+}
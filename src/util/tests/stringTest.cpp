@@ -239,4 +239,23 @@ TEST(testCase, string_strnchr_test) {
 
 //   char a16[] = "'-'.";
 //   EXPECT_TRUE(strnchr(a16, '.', strlen(a16), true) != NULL);
-// }
\ No newline at end of file
+// }
+TEST(testCase, string_inlist_test) {
+  // an entry matches as a whole, not as the prefix or the suffix of another one
+  EXPECT_FALSE(strinlist("abc,xab", "ab", ','));
+  EXPECT_TRUE(strinlist("abc,xab,ab", "ab", ','));
+  EXPECT_TRUE(strinlist("ab,abc,xab", "ab", ','));
+  EXPECT_TRUE(strinlist("abc,ab,xab", "ab", ','));
+  EXPECT_TRUE(strinlist("abc,xab", "xab", ','));
+  EXPECT_FALSE(strinlist("abc,xab", "b", ','));
+
+  // a single entry
+  EXPECT_TRUE(strinlist("ab", "ab", ','));
+  EXPECT_FALSE(strinlist("ab", "a", ','));
+  EXPECT_FALSE(strinlist("ab", "abc", ','));
+
+  // an empty list or item
+  EXPECT_FALSE(strinlist("", "ab", ','));
+  EXPECT_FALSE(strinlist("ab", "", ','));
+  EXPECT_FALSE(strinlist("", "", ','));
+}
@@ -60,6 +60,7 @@ typedef struct {
   void *   wqueue;    // write queue
   void *   qqueue;    // read query queue
   void *   fqueue;    // read fetch/cancel queue
+  void *   bqueue;    // read query queue of the batch class, NULL if there is no such class
   void *   wal;
   void *   tsdb;
   int64_t  sync;
@@ -28,6 +28,7 @@ int32_t vnodeWriteToRQueue(void *pVnode, void *pCont, int32_t contLen, int8_t qt
 void    vnodeFreeFromRQueue(void *pVnode, SVReadMsg *pRead);
 int32_t vnodeProcessRead(void *pVnode, SVReadMsg *pRead);
 void    vnodeWaitReadCompleted(SVnodeObj *pVnode);
+void    vnodeGetQueryQueueStatis(SVnodeStatisInfo *pInfo);
 
 #ifdef __cplusplus
 }
@@ -301,7 +301,9 @@ int32_t vnodeOpen(int32_t vgId) {
   pVnode->wqueue = dnodeAllocVWriteQueue(pVnode);
   pVnode->qqueue = dnodeAllocVQueryQueue(pVnode);
   pVnode->fqueue = dnodeAllocVFetchQueue(pVnode);
-  if (pVnode->wqueue == NULL || pVnode->qqueue == NULL || pVnode->fqueue == NULL) {
+  pVnode->bqueue = dnodeAllocVBatchQueue(pVnode);
+  if (pVnode->wqueue == NULL || pVnode->qqueue == NULL || pVnode->fqueue == NULL ||
+      (tsBatchQueryThreads > 0 && pVnode->bqueue == NULL)) {
     vnodeCleanUp(pVnode);
     return terrno;
   }
@@ -554,6 +556,11 @@ void vnodeDestroy(SVnodeObj *pVnode) {
     pVnode->fqueue = NULL;
   }
 
+  if (pVnode->bqueue) {
+    dnodeFreeVBatchQueue(pVnode->bqueue);
+    pVnode->bqueue = NULL;
+  }
+
   tfree(pVnode->rootDir);
 
   if (pVnode->dropped) {
@@ -16,6 +16,7 @@
 #define _DEFAULT_SOURCE
 #include "os.h"
 #include "dnode.h"
+#include "query.h"
 #include "vnodeStatus.h"
 #include "vnodeBackup.h"
 #include "vnodeWorker.h"
@@ -30,6 +31,8 @@ static void    vnodeCleanupHash(void);
 static void    vnodeIncRef(void *ptNode);
 
 static SStep tsVnodeSteps[] = {
+  {"tsdb-decode",  tsdbInitDecodePool,  tsdbDestroyDecodePool},
+  {"query-parallel", qInitParallelPool, qCleanupParallelPool},
   {"vnode-backup", vnodeInitBackup,    vnodeCleanupBackup},
   {"vnode-worker", vnodeInitMWorker,    vnodeCleanupMWorker},
   {"vnode-write",  vnodeInitWrite,      vnodeCleanupWrite},
@@ -24,6 +24,11 @@
 
 int32_t vNumOfExistedQHandle;   // current initialized and existed query handle in current dnode
 
+// the time query queue items of each class wait before a query thread takes them, reset when they are read
+static int64_t tsQueryNum[TSDB_QUERY_CLASS_NUM] = {0};
+static int64_t tsQueryWaitUs[TSDB_QUERY_CLASS_NUM] = {0};
+static int64_t tsQueryMaxWaitUs[TSDB_QUERY_CLASS_NUM] = {0};
+
 static int32_t (*vnodeProcessReadMsgFp[TSDB_MSG_TYPE_MAX])(SVnodeObj *pVnode, SVReadMsg *pRead);
 static int32_t  vnodeProcessQueryMsg(SVnodeObj *pVnode, SVReadMsg *pRead);
 static int32_t  vnodeProcessFetchMsg(SVnodeObj *pVnode, SVReadMsg *pRead);
@@ -38,6 +43,44 @@ int32_t vnodeInitRead(void) {
 
 void vnodeCleanupRead() {}
 
+void vnodeGetQueryQueueStatis(SVnodeStatisInfo *pInfo) {
+  for (int32_t i = 0; i < TSDB_QUERY_CLASS_NUM; ++i) {
+    pInfo->queryNum[i] = atomic_exchange_64(&tsQueryNum[i], 0);
+    pInfo->queryWaitUs[i] = atomic_exchange_64(&tsQueryWaitUs[i], 0);
+    pInfo->queryMaxWaitUs[i] = atomic_exchange_64(&tsQueryMaxWaitUs[i], 0);
+  }
+}
+
+static void vnodeAddQueryWait(int8_t queryClass, int64_t queuedUs) {
+  int64_t waitUs = taosGetTimestampUs() - queuedUs;
+  atomic_add_fetch_64(&tsQueryNum[queryClass], 1);
+  atomic_add_fetch_64(&tsQueryWaitUs[queryClass], waitUs);
+
+  int64_t maxWaitUs = atomic_load_64(&tsQueryMaxWaitUs[queryClass]);
+  while (waitUs > maxWaitUs) {
+    int64_t old = atomic_val_compare_exchange_64(&tsQueryMaxWaitUs[queryClass], maxWaitUs, waitUs);
+    if (old == maxWaitUs) {
+      break;
+    }
+    maxWaitUs = old;
+  }
+}
+
+// the queries of the users listed in batchQueryUsers are of the batch class
+static int8_t vnodeGetQueryClass(SVReadMsg *pRead) {
+  if (tsBatchQueryThreads <= 0 || tsBatchQueryUsers[0] == 0 || pRead->rpcHandle == NULL ||
+      pRead->code == TSDB_CODE_RPC_NETWORK_UNAVAIL) {
+    return TSDB_QUERY_CLASS_INTERACTIVE;
+  }
+
+  SRpcConnInfo connInfo = {0};
+  if (rpcGetConnInfo(pRead->rpcHandle, &connInfo) != 0) {
+    return TSDB_QUERY_CLASS_INTERACTIVE;
+  }
+
+  return strinlist(tsBatchQueryUsers, connInfo.user, ',') ? TSDB_QUERY_CLASS_BATCH : TSDB_QUERY_CLASS_INTERACTIVE;
+}
+
 //
 // After the fetch request enters the vnode queue, if the vnode cannot provide services, the process function are
 // still required, or there will be a deadlock, so we don’t do any check here, but put the check codes before the
@@ -119,6 +162,7 @@ static SVReadMsg *vnodeBuildVReadMsg(SVnodeObj *pVnode, void *pCont, int32_t con
   }
 
   pRead->qtype = qtype;
+  pRead->queuedUs = taosGetTimestampUs();
   atomic_add_fetch_32(&pVnode->refCount, 1);
 
   return pRead;
@@ -149,6 +193,11 @@ int32_t vnodeWriteToRQueue(void *vparam, void *pCont, int32_t contLen, int8_t qt
     vTrace("vgId:%d, write into vfetch queue, refCount:%d queued:%d", pVnode->vgId, pVnode->refCount,
            pVnode->queuedRMsg);
     return taosWriteQitem(pVnode->fqueue, qtype, pRead);
+  } else if (pVnode->bqueue != NULL && contLen == 0 && qtype == TAOS_QTYPE_QUERY &&
+             qGetQueryClass(*(void **)pCont) == TSDB_QUERY_CLASS_BATCH) {
+    vTrace("vgId:%d, write into vbatch queue, refCount:%d queued:%d", pVnode->vgId, pVnode->refCount,
+           pVnode->queuedRMsg);
+    return taosWriteQitem(pVnode->bqueue, qtype, pRead);
   } else {
     vTrace("vgId:%d, write into vquery queue, refCount:%d queued:%d", pVnode->vgId, pVnode->refCount,
            pVnode->queuedRMsg);
@@ -209,6 +258,30 @@ static int32_t vnodeDumpQueryResult(SRspRet *pRet, void *pVnode, uint64_t qId, v
   return code;
 }
 
+/**
+ * Executes the query, a query that stops at a yield point is put back at the tail of the query queue so that the
+ * messages queued behind it go first. The new queue item takes over the qhandle.
+ *
+ * @return true if the query is put back into the queue
+ */
+static bool vnodeExecQuery(SVnodeObj *pVnode, SVReadMsg *pRead, void **qhandle, uint64_t *qId, bool *buildRes) {
+  *buildRes = qTableQuery(*qhandle, qId);
+  if (!qQueryYielded(*qhandle)) {
+    return false;
+  }
+
+  if (vnodePutItemIntoReadQueue(pVnode, qhandle, pRead->rpcAhandle) == TSDB_CODE_SUCCESS) {
+    vTrace("vgId:%d, QInfo:%p, query yields and is put back into vread queue", pVnode->vgId, *qhandle);
+    return true;
+  }
+
+  // it cannot go on without a queue item, kill it and execute it once more to build its response
+  vError("vgId:%d, QInfo:%p, failed to put yielded query back into vread queue, kill it", pVnode->vgId, *qhandle);
+  qKillQuery(*qhandle);
+  *buildRes = qTableQuery(*qhandle, qId);
+  return false;
+}
+
 static void vnodeBuildNoResultQueryRsp(SRspRet *pRet) {
   pRet->rsp = (SRetrieveTableRsp *)rpcMallocCont(sizeof(SRetrieveTableRsp));
   pRet->len = sizeof(SRetrieveTableRsp);
@@ -239,7 +312,13 @@ static int32_t vnodeProcessQueryMsg(SVnodeObj *pVnode, SVReadMsg *pRead) {
   if (contLen != 0) {
     qinfo_t pQInfo = NULL;
     uint64_t qId = genQueryId();
-    code = qCreateQueryInfo(pVnode->tsdb, pVnode->vgId, pQueryTableMsg, &pQInfo, qId);
+    int8_t   queryClass = vnodeGetQueryClass(pRead);
+
+    // the query msg itself always waits in the query queue of the interactive class, and is counted there whatever
+    // the class of the query is, see query_queue_info of the monitor
+    vnodeAddQueryWait(TSDB_QUERY_CLASS_INTERACTIVE, pRead->queuedUs);
+
+    code = qCreateQueryInfo(pVnode->tsdb, pVnode->vgId, pQueryTableMsg, &pQInfo, qId, queryClass);
 
     SQueryTableRsp *pRsp = (SQueryTableRsp *)rpcMallocCont(sizeof(SQueryTableRsp));
     pRsp->code = code;
@@ -297,14 +376,18 @@ static int32_t vnodeProcessQueryMsg(SVnodeObj *pVnode, SVReadMsg *pRead) {
     uint64_t qId = 0;
 
     vTrace("vgId:%d, QInfo:%p, dnode continues to exec query", pVnode->vgId, *qhandle);
+    vnodeAddQueryWait(qGetQueryClass(*qhandle), pRead->queuedUs);
+
+    bool buildRes = false;
+    if (vnodeExecQuery(pVnode, pRead, qhandle, &qId, &buildRes)) {  // do execute query
+      return code;
+    }
 
     // In the retrieve blocking model, only 50% CPU will be used in query processing
     if (tsRetrieveBlockingModel) {
-      qTableQuery(*qhandle, &qId);  // do execute query
       qReleaseQInfo(pVnode->qMgmt, (void **)&qhandle, false);
     } else {
       bool freehandle = false;
-      bool buildRes = qTableQuery(*qhandle, &qId);  // do execute query
 
       // build query rsp, the retrieve request has reached here already
       if (buildRes) {
@@ -23,6 +23,7 @@
 #include "ttimer.h"
 #include "dnode.h"
 #include "vnodeStatus.h"
+#include "vnodeRead.h"
 
 #define MAX_QUEUED_MSG_NUM 100000
 #define MAX_QUEUED_MSG_SIZE 1024*1024*1024  //1GB
@@ -452,6 +453,8 @@ SVnodeStatisInfo vnodeGetStatisInfo() {
   info.submitReqSucNum = atomic_exchange_64(&tsSubmitReqSucNum, 0);
   info.submitRowNum = atomic_exchange_64(&tsSubmitRowNum, 0);
   info.submitRowSucNum = atomic_exchange_64(&tsSubmitRowSucNum, 0);
+  tsdbGetBlkCacheStatis(&info.blkCacheHit, &info.blkCacheMiss);
+  vnodeGetQueryQueueStatis(&info);
 
   return info;
 }
@@ -28,6 +28,7 @@ python3 ./test.py -f insert/insertDynamicColBeforeVal.py
 python3 ./test.py -f insert/in_function.py
 python3 ./test.py -f insert/modify_column.py
 #python3 ./test.py -f insert/line_insert.py
+python3 ./test.py -f insert/schemalessStmtInsert.py
 python3 ./test.py -f insert/specialSql.py
 python3 ./test.py -f insert/timestamp.py
 
@@ -249,6 +250,10 @@ python3 ./test.py -f query/queryInsertValue.py
 python3 ./test.py -f query/queryConnection.py
 python3 ./test.py -f query/queryCountCSVData.py
 python3 ./test.py -f query/natualInterval.py
+python3 ./test.py -f query/queryParallel.py
+python3 ./test.py -f query/queryYield.py
+python3 ./test.py -f query/encodedAggregate.py
+python3 ./test.py -f query/lateMaterialization.py
 python3 ./test.py -f query/bug1471.py
 #python3 ./test.py -f query/dataLossTest.py
 python3 ./test.py -f query/bug1874.py
@@ -0,0 +1,119 @@
+###################################################################
+#           Copyright (c) 2021 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+import sys
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.types import TDSmlProtocolType, TDSmlTimestampType
+
+
+class TDTestCase:
+    # bind the points to a multiple table statement instead of printing them into SQL
+    updatecfgDict = {'clientCfg': {'smlDirectInsert': 1}}
+
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+        self._conn = conn
+
+    def line(self, tb, t1, ts, v):
+        # every fifth point leaves out the nchar column and every seventh the double column
+        fields = ["c_b=%s" % ("t" if v % 2 else "f"),
+                  "c_i8=%di8" % (v % 100 - 50),
+                  "c_i16=%di16" % (v % 30000),
+                  "c_i32=%di32" % (v * 3),
+                  "c_i64=%di64" % (v * 1000000007),
+                  "c_u8=%du8" % (v % 200),
+                  "c_f32=%d.5f32" % (v % 1000),
+                  "c_bin=\"b%d\"" % v]
+        if v % 7 != 0:
+            fields.append("c_f64=%d.25f64" % v)
+        if v % 5 != 0:
+            fields.append("c_nch=L\"n%d\"" % v)
+        return "stb,ID=%s,t1=%d,t2=%s %s %d" % (tb, t1, tb, ",".join(fields), ts)
+
+    def checkRow(self, row, v):
+        tdSql.checkData(row, 0, v % 2 == 1)
+        tdSql.checkData(row, 1, v % 100 - 50)
+        tdSql.checkData(row, 2, v % 30000)
+        tdSql.checkData(row, 3, v * 3)
+        tdSql.checkData(row, 4, v * 1000000007)
+        tdSql.checkData(row, 5, v % 200)
+        tdSql.checkData(row, 6, v % 1000 + 0.5)
+        tdSql.checkData(row, 7, "b%d" % v)
+        tdSql.checkData(row, 8, None if v % 7 == 0 else v + 0.25)
+        tdSql.checkData(row, 9, None if v % 5 == 0 else "n%d" % v)
+
+    def run(self):
+        print("running {}".format(__file__))
+        tdSql.execute("drop database if exists test")
+        tdSql.execute("create database if not exists test precision 'ms'")
+        tdSql.execute('use test')
+
+        ts = 1626006833639
+
+        # several child tables of one super table in one batch, interleaved
+        lines = []
+        for i in range(300):
+            lines.append(self.line("ctb%d" % (i % 3), i % 3, ts + i, i))
+        self._conn.schemaless_insert(lines, TDSmlProtocolType.LINE.value, TDSmlTimestampType.MILLI_SECOND.value)
+
+        tdSql.query("select count(*) from stb")
+        tdSql.checkData(0, 0, 300)
+        tdSql.query("show tables")
+        tdSql.checkRows(3)
+        for i in range(3):
+            tdSql.query("select count(*) from stb where t1 = '%d' and t2 = 'ctb%d'" % (i, i))
+            tdSql.checkData(0, 0, 100)
+
+        cols = "c_b, c_i8, c_i16, c_i32, c_i64, c_u8, c_f32, c_bin, c_f64, c_nch"
+        for i in range(3):
+            tdSql.query("select %s from stb where t2 = 'ctb%d' order by ts" % (cols, i))
+            tdSql.checkRows(100)
+            for row in range(100):
+                self.checkRow(row, row * 3 + i)
+
+        # the same points again overwrite the rows, and points of existing tables with a new column alter the super table
+        self._conn.schemaless_insert(lines, TDSmlProtocolType.LINE.value, TDSmlTimestampType.MILLI_SECOND.value)
+        self._conn.schemaless_insert(["stb,ID=ctb0,t1=0,t2=ctb0 c_i32=7i32,c_new=8i64 %d" % (ts + 1000)],
+                                     TDSmlProtocolType.LINE.value, TDSmlTimestampType.MILLI_SECOND.value)
+        tdSql.execute('reset query cache')
+        tdSql.query("select count(*) from stb")
+        tdSql.checkData(0, 0, 301)
+        tdSql.query("select c_i32, c_new, c_bin from stb where t2 = 'ctb0' and ts = %d" % (ts + 1000))
+        tdSql.checkData(0, 0, 7)
+        tdSql.checkData(0, 1, 8)
+        tdSql.checkData(0, 2, None)
+
+        # more points of one table than a statement executes at once
+        lines = []
+        for i in range(36000):
+            lines.append(self.line("big", 9, ts + i, i))
+        self._conn.schemaless_insert(lines, TDSmlProtocolType.LINE.value, TDSmlTimestampType.MILLI_SECOND.value)
+
+        tdSql.query("select count(*), sum(c_i32) from stb where t2 = 'big'")
+        tdSql.checkData(0, 0, 36000)
+        tdSql.checkData(0, 1, sum(range(36000)) * 3)
+        for v in [0, 32766, 32767, 35999]:
+            tdSql.query("select %s from stb where t2 = 'big' and ts = %d" % (cols, ts + v))
+            tdSql.checkRows(1)
+            self.checkRow(0, v)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
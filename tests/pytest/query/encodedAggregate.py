@@ -0,0 +1,114 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+import sys
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+
+class TDTestCase:
+    # the blocks cut by the time range are decoded, until the dnode is restarted to aggregate them on their encoded columns
+    updatecfgDict = {'encodedAggregate': 0}
+
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+
+        self.ts = 1600000000000
+        self.numOfTables = 8
+        self.numOfRows = 30000
+        self.step = 100
+
+        # the bounds fall inside file blocks, and the narrow range inside one block
+        s = self.ts + 12345 * self.step + 37
+        e = self.ts + 23456 * self.step + 61
+        n = self.ts + 5000 * self.step + 3
+        aggs = "count(*), count(c3), sum(c1), min(c1), max(c1), avg(c2), spread(c2), sum(c3), min(c4), max(c5), " \
+               "min(c6), max(c6), sum(c7)"
+        self.queries = [
+            "select %s from ct0 where ts >= %d and ts < %d" % (aggs, s, e),
+            "select %s from ct1 where ts > %d and ts <= %d" % (aggs, n, n + 300 * self.step),
+            "select %s from ct2 where ts >= %d" % (aggs, s),
+            "select %s from ct3 where ts < %d" % (aggs, e),
+            "select %s from stb where ts >= %d and ts < %d" % (aggs, s, e),
+            "select %s from stb where ts >= %d and ts < %d group by t1" % (aggs, s, e),
+            "select %s from stb where ts >= %d and ts < %d interval(7s)" % (aggs, s, e),
+            "select %s from ct4 where ts >= %d and ts < %d interval(13s) order by ts desc" % (aggs, s, e),
+            "select count(*), sum(c1), max(c2) from stb where ts >= %d and ts < %d interval(1m) group by tbname" % (s, e),
+            # the rows in memory overlap the last blocks of ct5 only
+            "select %s from ct5 where ts >= %d and ts < %d" % (aggs, s, self.ts + self.numOfRows * self.step + 5000),
+            "select %s from ct6 where ts >= %d and ts < %d" % (aggs, s, self.ts + self.numOfRows * self.step + 5000),
+        ]
+
+    def insertData(self):
+        tdSql.execute("create table stb (ts timestamp, c1 int, c2 double, c3 bigint, c4 smallint, c5 tinyint, "
+                      "c6 float, c7 int unsigned) tags (t1 int)")
+        for t in range(self.numOfTables):
+            tdSql.execute("create table ct%d using stb tags (%d)" % (t, t))
+
+        # one row in eleven has a null c3, the other columns repeat so that they are encoded in several ways
+        for t in range(self.numOfTables):
+            for start in range(0, self.numOfRows, 1000):
+                values = []
+                for i in range(start, min(start + 1000, self.numOfRows)):
+                    c3 = "null" if (i + t) % 11 == 0 else "%d" % (i * 1000003 - 7000000000)
+                    values.append("(%d, %d, %f, %s, %d, %d, %f, %d)" %
+                                  (self.ts + i * self.step, (i * 31 + t) % 1000 - 500, ((i + t) % 400) * 0.25, c3,
+                                   i % 30000 - 15000, (i // 100) % 200 - 100, (i % 97) * 1.5, i * 7))
+                tdSql.execute("insert into ct%d values %s" % (t, " ".join(values)))
+
+    def runQueries(self):
+        results = []
+        for sql in self.queries:
+            tdSql.query(sql)
+            results.append(list(tdSql.queryResult))
+        return results
+
+    # the rows are committed to file blocks when the dnode stops, then rows of ct5 go to memory again, the second
+    # time as duplicates of the committed ones
+    def restartDnode(self, encodedAggr):
+        tdDnodes.stop(1)
+        tdDnodes.cfg(1, 'encodedAggregate', encodedAggr)
+        tdDnodes.start(1)
+        tdSql.execute("use db")
+
+        last = self.ts + (self.numOfRows - 1) * self.step
+        tdSql.execute("insert into ct5 values (%d, 1, 1.0, 1, 1, 1, 1.0, 1) (%d, 2, 2.0, 2, 2, 2, 2.0, 2)" %
+                      (last - 50 * self.step + 1, last + 10))
+
+    def run(self):
+        tdSql.prepare()
+        tdSql.execute("use db")
+        self.insertData()
+        self.restartDnode(0)
+
+        # the decoded blocks are the reference of the encoded ones
+        decoded = self.runQueries()
+
+        self.restartDnode(1)
+        for sql, expected, actual in zip(self.queries, decoded, self.runQueries()):
+            if expected != actual:
+                tdLog.exit("%s: %s of encodedAggregate 1 differ from %s of encodedAggregate 0" %
+                           (sql, actual[:3], expected[:3]))
+            tdLog.info("%s: %d rows of encodedAggregate 1 are the same as those of encodedAggregate 0" %
+                       (sql, len(actual)))
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
@@ -0,0 +1,107 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+import sys
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+
+class TDTestCase:
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+
+        self.ts = 1600000000000
+        self.numOfTables = 4
+        self.numOfRows = 20000
+
+        # (columns, table, filter, tail, expected rows). The rows of c1 are in order, so that a range of c1 leaves out
+        # some rows of one block and no row of the others, the blocks out of the range are discarded by their statistics.
+        # c6 is 0 or 10 in the first half of the rows, so the statistics of their blocks keep them for c6 = 5 and the
+        # filter leaves out all their rows. ct0 has two more rows in memory.
+        n = self.numOfRows
+        self.queries = [
+            ("ts, c2, c3, c4", "ct0", "c1 > 12345", "", n - 12346 + 2),
+            ("ts, c2, c3, c4", "ct3", "c6 = 5", "", len([i for i in range(n // 2, n) if i % 11 == 5])),
+            ("ts, c2, c3, c4", "ct1", "c6 = 5 and c1 < 8000", "", 0),
+            ("ts, c2, c3, c4", "ct1", "c5 = 3", "", len([i for i in range(n) if i % 7 == 3])),
+            ("ts, c2, c3, c4", "ct2", "c1 >= 0", "", n),
+            ("ts, c2, c3, c4", "ct3", "c1 < 0", "", 0),
+            ("ts, c2, c4", "ct0", "c1 > 12345 and c5 = 3", "order by ts desc",
+             len([i for i in range(12346, n) if i % 7 == 3]) + 1),
+            ("count(c2), sum(c4), min(c4), max(c2), last(c3)", "ct1", "c5 = 3", "", 1),
+            ("ts, c2, c3, c4, t1", "stb", "c1 > 15000 and c5 < 2", "", 4 * len([i for i in range(15001, n) if i % 7 < 2])),
+            ("ts, c4, c3", "ct2", "c1 > 5000 and c1 < 5100", "limit 20 offset 5", 20),
+            ("ts, c2, c4", "ct1", "c3 = 's7'", "", len([i for i in range(n) if i % 50 == 7])),
+            ("ts, c2, c3", "ct2", "c4 is null", "", len([i for i in range(n) if i % 9 == 0])),
+            # the rows in memory are merged with the last block
+            ("ts, c2, c3, c4", "ct0", "c1 > 19990", "", 9 + 2),
+        ]
+
+    def insertData(self):
+        tdSql.execute("create table stb (ts timestamp, c1 int, c2 double, c3 binary(16), c4 int, c5 tinyint, c6 int) "
+                      "tags (t1 int)")
+        for t in range(self.numOfTables):
+            tdSql.execute("create table ct%d using stb tags (%d)" % (t, t))
+
+        for t in range(self.numOfTables):
+            for start in range(0, self.numOfRows, 1000):
+                values = []
+                for i in range(start, min(start + 1000, self.numOfRows)):
+                    c4 = "null" if i % 9 == 0 else "%d" % (i * 3 - 1000)
+                    c6 = (i % 2) * 10 if i < self.numOfRows // 2 else i % 11
+                    values.append("(%d, %d, %f, 's%d', %s, %d, %d)" %
+                                  (self.ts + i * 100, i, (i % 400) * 0.25, i % 50, c4, i % 7, c6))
+                tdSql.execute("insert into ct%d values %s" % (t, " ".join(values)))
+
+    # a filter on every scanned column loads all columns of a block before filtering it, the rows it adds are the
+    # same as those of the filter alone
+    def fullLoadFilter(self, cond):
+        return "(%s) and c2 >= 0 and c3 like 's%%' and (c4 > -1000000 or c4 is null) and c5 >= 0 and c6 >= 0" % cond
+
+    def query(self, cols, table, cond, tail):
+        tdSql.query("select %s from %s where %s %s" % (cols, table, cond, tail))
+        return tdSql.queryRows, sorted(tdSql.queryResult, key=str) if table == "stb" else list(tdSql.queryResult)
+
+    def run(self):
+        tdSql.prepare()
+        tdSql.execute("use db")
+        self.insertData()
+
+        # the rows are committed to file blocks when the dnode stops
+        tdDnodes.stop(1)
+        tdDnodes.start(1)
+        tdSql.execute("use db")
+        tdSql.execute("insert into ct0 values (%d, 20005, 1.5, 's99', null, 3, 5) (%d, 20006, 2.5, 's98', 7, 4, 6)" %
+                      (self.ts + self.numOfRows * 100 + 50, self.ts + self.numOfRows * 100 + 150))
+
+        for cols, table, cond, tail, expected in self.queries:
+            rows, late = self.query(cols, table, cond, tail)
+            if rows != expected:
+                tdLog.exit("%s where %s %s: %d rows, expected %d" % (table, cond, tail, rows, expected))
+
+            _, full = self.query(cols, table, self.fullLoadFilter(cond), tail)
+            if late != full:
+                tdLog.exit("%s where %s %s: the rows of the filter columns loaded first differ from those of a full "
+                           "load" % (table, cond, tail))
+            tdLog.info("%s where %s %s: %d rows are the same as those of a full load" % (table, cond, tail, rows))
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
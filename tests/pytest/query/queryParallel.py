@@ -0,0 +1,146 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+import sys
+import taos
+import threading
+import time
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+
+class TDTestCase:
+    # the super table queries run on the query worker thread only, until the dnode is restarted with a parallel pool
+    updatecfgDict = {'queryParallelThreads': 0}
+
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+
+        self.ts = 1600000000000
+        self.numOfTables = 32
+        self.numOfRows = 50000
+        self.queries = [
+            "select count(*), sum(c1), min(c1), max(c1), avg(c2), spread(c1), first(c1), last(c2) from stb",
+            "select count(*), sum(c1), min(c2), max(c2), last(c1) from stb where c1 > 100 and t1 < 20",
+            "select count(*), sum(c1), max(c2), first(c1) from stb group by t1",
+            "select count(*), sum(c1), min(c1), max(c2), avg(c2) from stb interval(10s)",
+            "select count(*), sum(c1), last(c2) from stb where ts >= %d and ts < %d interval(1s)" % (self.ts, self.ts + 20000),
+            "select count(*), max(c1), avg(c2) from stb interval(30s) group by t1",
+            "select count(*), sum(c1) from stb interval(1m) group by tbname",
+            "select count(*), sum(c1), max(c2) from stb where t1 in (3, 5, 7) interval(5s)",
+            "select count(*), stddev(c1) from stb group by t1",
+        ]
+
+    def insertData(self):
+        tdSql.execute("create table stb (ts timestamp, c1 int, c2 double) tags (t1 int)")
+        for t in range(self.numOfTables):
+            tdSql.execute("create table ct%d using stb tags (%d)" % (t, t))
+
+        # each child table has rows at a different step, so that the windows of the tables do not line up
+        for t in range(self.numOfTables):
+            step = 100 + t * 7
+            for start in range(0, self.numOfRows, 1000):
+                values = ["(%d, %d, %f)" % (self.ts + i * step, (i * 31 + t) % 1000, ((i + t) % 400) * 0.25)
+                          for i in range(start, min(start + 1000, self.numOfRows))]
+                tdSql.execute("insert into ct%d values %s" % (t, " ".join(values)))
+
+    def runQueries(self):
+        results = []
+        for sql in self.queries:
+            tdSql.query(sql)
+            results.append(list(tdSql.queryResult))
+        return results
+
+    def restartDnode(self, threads):
+        tdDnodes.stop(1)
+        tdDnodes.cfg(1, 'queryParallelThreads', threads)
+        tdDnodes.cfg(1, 'queryParallelDegree', 4)
+        tdDnodes.start(1)
+        tdSql.execute("use db")
+
+    def killQuery(self, killed):
+        conn = taos.connect(host='127.0.0.1', config=tdDnodes.getSimCfgPath())
+        cursor = conn.cursor()
+        for i in range(400):
+            cursor.execute("show queries")
+            queries = cursor.fetchall()
+            if queries:
+                try:
+                    cursor.execute("kill query %s" % queries[0][0])
+                    killed.append(queries[0][0])
+                except Exception as e:
+                    tdLog.info("query %s not killed: %s" % (queries[0][0], e))
+                break
+            time.sleep(0.01)
+        cursor.close()
+        conn.close()
+
+    def run(self):
+        tdSql.prepare()
+        tdSql.execute("use db")
+        self.insertData()
+
+        # the serial plan is the reference of the plan split into morsels
+        serial = self.runQueries()
+        tdSql.query("select count(*) from stb")
+        tdSql.checkData(0, 0, self.numOfTables * self.numOfRows)
+
+        self.restartDnode(4)
+        for sql, expected, actual in zip(self.queries, serial, self.runQueries()):
+            if expected != actual:
+                tdLog.exit("%s: %d rows of the parallel plan differ from the %d rows of the serial plan" %
+                           (sql, len(actual), len(expected)))
+            tdLog.info("%s: %d rows of the parallel plan are the same as those of the serial plan" % (sql, len(actual)))
+
+        # a query killed while its morsels are still running on the pool, the dnode must answer the next queries
+        sql = "select count(*), sum(c1), min(c1), max(c2), avg(c2), spread(c2) from stb interval(1a) group by tbname"
+        numOfKilled = 0
+        for i in range(10):
+            killed = []
+            t = threading.Thread(target=self.killQuery, args=(killed,))
+            t.start()
+            try:
+                tdSql.query(sql)
+                tdLog.info("query %d finished before it was killed" % i)
+            except Exception as e:
+                if "Query terminated" not in str(e):
+                    tdLog.exit("query %d failed with %s" % (i, e))
+            t.join()
+            if killed:
+                numOfKilled += 1
+            tdSql.query("select count(*) from stb")
+            tdSql.checkData(0, 0, self.numOfTables * self.numOfRows)
+
+        if numOfKilled == 0:
+            tdLog.exit("no query was killed while it was running")
+
+        for i in range(10):
+            tdSql.query("show queries")
+            if tdSql.queryRows == 0:
+                break
+            time.sleep(0.5)
+        tdSql.checkRows(0)
+
+        if self.runQueries() != serial:
+            tdLog.exit("the parallel plan returns other results after queries were killed")
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
@@ -0,0 +1,122 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+import sys
+import taos
+import threading
+import time
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+
+class TDTestCase:
+    # the queries run to their end first, and yield every millisecond once the dnode is restarted
+    updatecfgDict = {'queryYieldTime': 0}
+
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+
+        self.ts = 1600000000000
+        self.numOfTables = 16
+        self.numOfRows = 50000
+        self.queries = [
+            "select count(*), sum(c1), min(c1), max(c2), avg(c2), spread(c1), first(c1), last(c2) from ct0",
+            "select count(*), sum(c1), max(c2) from ct1 where c1 > 100",
+            "select count(*), sum(c1), min(c1), max(c2), avg(c2), spread(c1), first(c1), last(c2) from stb",
+            "select count(*), sum(c1), max(c2), first(c1) from stb group by t1",
+            "select count(*), sum(c1), min(c1), max(c2), avg(c2) from ct2 interval(1s)",
+            "select count(*), sum(c1), min(c1), max(c2), avg(c2) from stb interval(10s)",
+            "select count(*), sum(c1), last(c2) from stb where c1 < 500 interval(1s) group by tbname",
+        ]
+
+    def insertData(self, db):
+        tdSql.execute("create database %s" % db)
+        tdSql.execute("use %s" % db)
+        tdSql.execute("create table stb (ts timestamp, c1 int, c2 double) tags (t1 int)")
+        for t in range(self.numOfTables):
+            tdSql.execute("create table ct%d using stb tags (%d)" % (t, t))
+
+        for t in range(self.numOfTables):
+            step = 100 + t * 7
+            for start in range(0, self.numOfRows, 1000):
+                values = ["(%d, %d, %f)" % (self.ts + i * step, (i * 31 + t) % 1000, ((i + t) % 400) * 0.25)
+                          for i in range(start, min(start + 1000, self.numOfRows))]
+                tdSql.execute("insert into ct%d values %s" % (t, " ".join(values)))
+
+    def runQueries(self):
+        results = []
+        for sql in self.queries:
+            tdSql.query(sql)
+            results.append(list(tdSql.queryResult))
+        return results
+
+    def restartDnode(self, yieldTime):
+        tdDnodes.stop(1)
+        tdDnodes.cfg(1, 'queryYieldTime', yieldTime)
+        tdDnodes.start(1)
+        tdSql.execute("use db")
+
+    def queryDroppedDb(self, errors):
+        conn = taos.connect(host='127.0.0.1', config=tdDnodes.getSimCfgPath())
+        cursor = conn.cursor()
+        try:
+            cursor.execute("select count(*), sum(c1), min(c1), max(c2), avg(c2) from db2.stb interval(1a)")
+            cursor.fetchall()
+        except Exception as e:
+            errors.append(str(e))
+        cursor.close()
+        conn.close()
+
+    def run(self):
+        self.insertData("db")
+
+        # the results of the queries which run to their end are the reference of those which yield
+        expected = self.runQueries()
+
+        self.restartDnode(1)
+        for sql, rows, actual in zip(self.queries, expected, self.runQueries()):
+            if rows != actual:
+                tdLog.exit("%s: %d rows of queryYieldTime 1 differ from the %d rows of queryYieldTime 0" %
+                           (sql, len(actual), len(rows)))
+            tdLog.info("%s: %d rows of queryYieldTime 1 are the same as those of queryYieldTime 0" % (sql, len(actual)))
+
+        # a query cannot be put back into the queue of a vnode that is dropped while it yields, it is killed and
+        # answers with what it has, or with an error
+        for i in range(3):
+            self.insertData("db2")
+            tdSql.execute("use db")
+
+            errors = []
+            t = threading.Thread(target=self.queryDroppedDb, args=(errors,))
+            t.start()
+            time.sleep(0.3 + 0.2 * i)
+            tdSql.execute("drop database db2")
+            t.join()
+            tdLog.info("query %d on the dropped database: %s" % (i, errors[0] if errors else "completed"))
+
+            tdSql.query("select count(*) from stb")
+            tdSql.checkData(0, 0, self.numOfTables * self.numOfRows)
+
+        if self.runQueries() != expected:
+            tdLog.exit("the queries return other results after the database of a yielded query was dropped")
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())